@@ -170,7 +170,7 @@ int main(int argc, char *argv[])
         cout << i+1 << ". Layer " << layer.getName () << " contains "
              << layer.getGeometryCount () << " geometries" << endl;
 
-        auto attribs = layer.getAttributesTags ();
+        const auto& attribs = layer.getAttributesTags ();
         if(!attribs.empty ())
             cout << "Layer attributes:" << endl;
         for( const auto& attr : attribs )
@@ -196,7 +196,7 @@ int main(int argc, char *argv[])
                 cout.copyfmt(init);
             }
 
-            auto geom_attrs = geom->getBlockAttributes ();
+            const auto& geom_attrs = geom->getBlockAttributes ();
             for( const auto& attdef : geom_attrs )
             {
                 cout << "Attrib name: " << attdef.getTag () << endl;
@@ -0,0 +1,302 @@
+/*******************************************************************************
+ *  Project: libopencad
+ *  Purpose: OpenSource CAD formats support library
+ *  Author: Alexandr Borzykh, mush3d at gmail.com
+ *  Author: Dmitry Baryshnikov, bishop.dev@gmail.com
+ *  Language: C++
+ *******************************************************************************
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2016 Alexandr Borzykh
+ *  Copyright (c) 2016 NextGIS, <info@nextgis.com>
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ ******************************************************************************/
+
+#include "opencad_api.h"
+#include "cadgeometry.h"
+#include "dwg/r2000.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+using namespace std;
+
+/**
+ * @brief Exposes DWGFileR2000 reading stages, to time them one by one
+ */
+class BenchDWGFile : public DWGFileR2000
+{
+public:
+    explicit BenchDWGFile( CADFileIO * poFileIO ) : DWGFileR2000( poFileIO )
+    {
+        bReadingUnsupportedGeometries = false;
+    }
+
+    bool OpenIO()
+    {
+        return pFileIO->IsOpened() || pFileIO->Open( CADFileIO::read | CADFileIO::binary );
+    }
+
+    int ReadPreamble()
+    {
+        int nResult = ReadSectionLocators();
+        if( nResult == CADErrorCodes::SUCCESS )
+            nResult = ReadHeader( READ_FAST );
+        if( nResult == CADErrorCodes::SUCCESS )
+            nResult = ReadClasses( READ_FAST );
+        return nResult;
+    }
+
+    int RunCreateFileMap()
+    {
+        return CreateFileMap();
+    }
+
+    int RunReadTables()
+    {
+        return ReadTables( READ_FAST );
+    }
+
+    size_t GetObjectsCount() const
+    {
+        return oObjectIndex.GetCount();
+    }
+};
+
+struct BenchResult
+{
+    string osName;
+    double dfSeconds;
+    size_t nItems;
+    long   nPeakRSS; // process peak once the stage has finished, KB
+};
+
+static double Seconds( const chrono::steady_clock::time_point& oStart )
+{
+    return chrono::duration<double>( chrono::steady_clock::now() - oStart ).count();
+}
+
+/**
+ * @brief Peak resident set size of the process in kilobytes, 0 if unknown
+ */
+static long PeakRSS()
+{
+#ifdef _WIN32
+    return 0;
+#else
+    struct rusage stUsage;
+    if( getrusage( RUSAGE_SELF, &stUsage ) != 0 )
+        return 0;
+#ifdef __APPLE__
+    return stUsage.ru_maxrss / 1024;
+#else
+    return stUsage.ru_maxrss;
+#endif
+#endif
+}
+
+/**
+ * @brief Run oRun nRepeat times and keep the best time. oRun returns number of
+ * processed items or -1 on error, and the time of the measured part. Peak RSS
+ * is sampled right after the runs, it never goes down, so a stage shows more
+ * than the previous one only if it needed more memory.
+ */
+static bool Measure( vector<BenchResult>& aoResults, const string& osName, int nRepeat,
+                     const function<long( double& )>& oRun )
+{
+    BenchResult stResult = { osName, -1.0, 0, 0 };
+    for( int i = 0; i < nRepeat; ++i )
+    {
+        double dfSeconds = 0.0;
+        long nItems = oRun( dfSeconds );
+        if( nItems < 0 )
+            return false;
+        if( stResult.dfSeconds < 0 || dfSeconds < stResult.dfSeconds )
+            stResult.dfSeconds = dfSeconds;
+        stResult.nItems = static_cast<size_t>( nItems );
+    }
+    stResult.nPeakRSS = PeakRSS();
+    aoResults.push_back( stResult );
+    return true;
+}
+
+static long FileSize( const char * pszFileName )
+{
+    FILE * pFile = fopen( pszFileName, "rb" );
+    if( pFile == nullptr )
+        return -1;
+    fseek( pFile, 0, SEEK_END );
+    long nSize = ftell( pFile );
+    fclose( pFile );
+    return nSize;
+}
+
+enum BenchStage
+{
+    STAGE_MAP,
+    STAGE_TABLES
+};
+
+/**
+ * @brief Open file stage by stage, timing only the asked one
+ */
+static long TimeStage( const char * pszFileName, BenchStage eStage, double& dfSeconds )
+{
+    unique_ptr<BenchDWGFile> poFile( new BenchDWGFile( GetDefaultFileIO( pszFileName ) ) );
+    if( !poFile->OpenIO() || poFile->ReadPreamble() != CADErrorCodes::SUCCESS )
+        return -1;
+
+    auto oStart = chrono::steady_clock::now();
+    if( poFile->RunCreateFileMap() != CADErrorCodes::SUCCESS )
+        return -1;
+    if( eStage == STAGE_MAP )
+    {
+        dfSeconds = Seconds( oStart );
+        return static_cast<long>( poFile->GetObjectsCount() );
+    }
+
+    oStart = chrono::steady_clock::now();
+    if( poFile->RunReadTables() != CADErrorCodes::SUCCESS )
+        return -1;
+    // layers are filled with entities on first access
+    size_t nGeometries = 0;
+    for( size_t i = 0; i < poFile->GetLayersCount(); ++i )
+        nGeometries += poFile->GetLayer( i ).getGeometryCount();
+    dfSeconds = Seconds( oStart );
+    return static_cast<long>( nGeometries );
+}
+
+static int Usage()
+{
+    printf( "Usage: opencad_bench [-n repeat] file_name [file_name ...]\n"
+            "Times file opening stages and geometry reading, the best of\n"
+            "repeat runs is reported (default 3).\n" );
+    return EXIT_FAILURE;
+}
+
+int main( int argc, char * argv[] )
+{
+    int nRepeat = 3;
+    vector<const char *> apszFiles;
+    for( int i = 1; i < argc; ++i )
+    {
+        if( strcmp( argv[i], "-n" ) == 0 && i + 1 < argc )
+            nRepeat = max( 1, atoi( argv[++i] ) );
+        else if( argv[i][0] == '-' )
+            return Usage();
+        else
+            apszFiles.push_back( argv[i] );
+    }
+    if( apszFiles.empty() )
+        return Usage();
+
+    printf( "%-36s %-18s %10s %10s %14s %12s %10s\n", "file", "stage", "ms", "items", "items/s", "MB/s",
+            "peak KB" );
+
+    int nFailures = 0;
+    for( const char * pszFileName : apszFiles )
+    {
+        long nFileSize = FileSize( pszFileName );
+        const char * pszBaseName = max( strrchr( pszFileName, '/' ), strrchr( pszFileName, '\\' ) );
+        pszBaseName = pszBaseName ? pszBaseName + 1 : pszFileName;
+
+        vector<BenchResult> aoResults;
+        bool bOk = nFileSize > 0;
+        bOk = bOk && Measure( aoResults, "OpenCADFile", nRepeat,
+                              [&]( double& dfSeconds ) -> long
+                              {
+                                  auto oStart = chrono::steady_clock::now();
+                                  unique_ptr<CADFile> poFile( OpenCADFile( pszFileName, CADFile::READ_FAST ) );
+                                  dfSeconds = Seconds( oStart );
+                                  return poFile ? static_cast<long>( poFile->GetLayersCount() ) : -1;
+                              } );
+        bOk = bOk && Measure( aoResults, "CreateFileMap", nRepeat,
+                              [&]( double& dfSeconds ) { return TimeStage( pszFileName, STAGE_MAP, dfSeconds ); } );
+        bOk = bOk && Measure( aoResults, "ReadLayersTable", nRepeat,
+                              [&]( double& dfSeconds ) { return TimeStage( pszFileName, STAGE_TABLES, dfSeconds ); } );
+        bOk = bOk && Measure( aoResults, "getGeometry sweep", nRepeat,
+                              [&]( double& dfSeconds ) -> long
+                              {
+                                  unique_ptr<CADFile> poFile( OpenCADFile( pszFileName, CADFile::READ_FAST ) );
+                                  if( !poFile )
+                                      return -1;
+                                  auto oStart = chrono::steady_clock::now();
+                                  long nCount = 0;
+                                  for( size_t i = 0; i < poFile->GetLayersCount(); ++i )
+                                  {
+                                      CADLayer& oLayer = poFile->GetLayer( i );
+                                      for( size_t j = 0; j < oLayer.getGeometryCount(); ++j )
+                                      {
+                                          CADGeometry * poGeometry = oLayer.getGeometry( j );
+                                          if( poGeometry )
+                                              ++nCount;
+                                          delete poGeometry;
+                                      }
+                                  }
+                                  dfSeconds = Seconds( oStart );
+                                  return nCount;
+                              } );
+        bOk = bOk && Measure( aoResults, "EntityCursor sweep", nRepeat,
+                              [&]( double& dfSeconds ) -> long
+                              {
+                                  unique_ptr<CADFile> poFile( OpenCADFile( pszFileName, CADFile::READ_FAST ) );
+                                  if( !poFile )
+                                      return -1;
+                                  auto oStart = chrono::steady_clock::now();
+                                  long nCount = 0;
+                                  size_t iLayer = 0;
+                                  CADFile::EntityCursor oCursor( poFile.get() );
+                                  while( CADGeometry * poGeometry = oCursor.Next( iLayer ) )
+                                  {
+                                      ++nCount;
+                                      delete poGeometry;
+                                  }
+                                  dfSeconds = Seconds( oStart );
+                                  return nCount;
+                              } );
+        if( !bOk )
+        {
+            printf( "%-36s failed to read\n", pszBaseName );
+            ++nFailures;
+            continue;
+        }
+
+        for( const BenchResult& stResult : aoResults )
+        {
+            double dfSeconds = max( stResult.dfSeconds, 1e-9 );
+            printf( "%-36s %-18s %10.3f %10zu %14.0f %12.2f %10ld\n", pszBaseName, stResult.osName.c_str(),
+                    stResult.dfSeconds * 1000.0, stResult.nItems, stResult.nItems / dfSeconds,
+                    nFileSize / dfSeconds / ( 1024.0 * 1024.0 ), stResult.nPeakRSS );
+        }
+    }
+
+    return nFailures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
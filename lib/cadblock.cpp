@@ -0,0 +1,139 @@
+/*******************************************************************************
+ *  Project: libopencad
+ *  Purpose: OpenSource CAD formats support library
+ *  Author: Alexandr Borzykh, mush3d at gmail.com
+ *  Author: Dmitry Baryshnikov, bishop.dev@gmail.com
+ *  Language: C++
+ *******************************************************************************
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2016 Alexandr Borzykh
+ *  Copyright (c) 2016 NextGIS, <info@nextgis.com>
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ ******************************************************************************/
+#include "cadblock.h"
+
+//------------------------------------------------------------------------------
+// CADBlockReference
+//------------------------------------------------------------------------------
+
+CADBlockReference::CADBlockReference() : blockHandle( 0 ), insertHandle( 0 )
+{
+}
+
+long CADBlockReference::getBlockHandle() const
+{
+    return blockHandle;
+}
+
+void CADBlockReference::setBlockHandle( long value )
+{
+    blockHandle = value;
+}
+
+long CADBlockReference::getInsertHandle() const
+{
+    return insertHandle;
+}
+
+void CADBlockReference::setInsertHandle( long value )
+{
+    insertHandle = value;
+}
+
+Matrix CADBlockReference::getTransformation() const
+{
+    return transformation;
+}
+
+void CADBlockReference::setTransformation( const Matrix& value )
+{
+    transformation = value;
+}
+
+const vector<CADAttrib>& CADBlockReference::getAttributes() const
+{
+    return attributes;
+}
+
+void CADBlockReference::setAttributes( vector<CADAttrib> value )
+{
+    attributes = std::move( value );
+}
+
+//------------------------------------------------------------------------------
+// CADBlock
+//------------------------------------------------------------------------------
+
+CADBlock::CADBlock( long handleIn, const string& nameIn, const CADVector& basePointIn ) :
+    handle( handleIn ),
+    name( nameIn ),
+    basePoint( basePointIn )
+{
+}
+
+CADBlock::~CADBlock()
+{
+}
+
+long CADBlock::getHandle() const
+{
+    return handle;
+}
+
+string CADBlock::getName() const
+{
+    return name;
+}
+
+CADVector CADBlock::getBasePoint() const
+{
+    return basePoint;
+}
+
+size_t CADBlock::getGeometryCount() const
+{
+    return geometries.size();
+}
+
+const CADGeometry * CADBlock::getGeometry( size_t index ) const
+{
+    return geometries[index].get();
+}
+
+size_t CADBlock::getBlockReferenceCount() const
+{
+    return blockReferences.size();
+}
+
+const CADBlockReference& CADBlock::getBlockReference( size_t index ) const
+{
+    return blockReferences[index];
+}
+
+void CADBlock::addGeometry( CADGeometry * geometry )
+{
+    geometries.emplace_back( geometry );
+}
+
+void CADBlock::addBlockReference( const CADBlockReference& reference )
+{
+    blockReferences.push_back( reference );
+}
@@ -0,0 +1,110 @@
+/*******************************************************************************
+ *  Project: libopencad
+ *  Purpose: OpenSource CAD formats support library
+ *  Author: Alexandr Borzykh, mush3d at gmail.com
+ *  Author: Dmitry Baryshnikov, bishop.dev@gmail.com
+ *  Language: C++
+ *******************************************************************************
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2016 Alexandr Borzykh
+ *  Copyright (c) 2016 NextGIS, <info@nextgis.com>
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ ******************************************************************************/
+#ifndef CADBLOCK_H
+#define CADBLOCK_H
+
+#include "cadgeometry.h"
+
+#include <memory>
+
+using namespace std;
+
+/**
+ * @brief Block reference (INSERT) placing a block definition into the
+ * drawing. Geometries of the block are put in place with the transformation.
+ */
+class OCAD_EXTERN CADBlockReference
+{
+public:
+    CADBlockReference();
+
+    /**
+     * @brief returns handle of the block header, see CADFile::GetBlock()
+     */
+    long getBlockHandle() const;
+    void setBlockHandle( long value );
+
+    long getInsertHandle() const;
+    void setInsertHandle( long value );
+
+    Matrix getTransformation() const;
+    void   setTransformation( const Matrix& value );
+
+    const vector<CADAttrib>& getAttributes() const;
+    void                     setAttributes( vector<CADAttrib> value );
+protected:
+    long              blockHandle;
+    long              insertHandle;
+    Matrix            transformation;
+    vector<CADAttrib> attributes;
+};
+
+/**
+ * @brief Block definition with its geometries decoded once. Geometries are in
+ * block coordinates and shared by every reference of the block, so they must
+ * be copied before they are transformed.
+ */
+class OCAD_EXTERN CADBlock
+{
+public:
+    CADBlock( long handle, const string& name, const CADVector& basePoint );
+    ~CADBlock();
+
+    long      getHandle() const;
+    string    getName() const;
+    CADVector getBasePoint() const;
+
+    size_t              getGeometryCount() const;
+    const CADGeometry * getGeometry( size_t index ) const;
+    /**
+     * @brief Block references nested into this block, their transformations
+     * are relative to this block
+     */
+    size_t                   getBlockReferenceCount() const;
+    const CADBlockReference& getBlockReference( size_t index ) const;
+
+    /**
+     * @brief Add geometry, block takes the ownership
+     */
+    void addGeometry( CADGeometry * geometry );
+    void addBlockReference( const CADBlockReference& reference );
+protected:
+    CADBlock( const CADBlock& ) = delete;
+    CADBlock& operator=( const CADBlock& ) = delete;
+protected:
+    long                            handle;
+    string                          name;
+    CADVector                       basePoint;
+    vector<unique_ptr<CADGeometry>> geometries;
+    vector<CADBlockReference>       blockReferences;
+};
+
+#endif // CADBLOCK_H
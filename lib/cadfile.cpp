@@ -30,10 +30,64 @@
  *******************************************************************************/
 #include "cadfile.h"
 #include "opencad_api.h"
+#include "cadfilewindowio.h"
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
-CADFile::CADFile( CADFileIO * poFileIO )
+#include <sys/stat.h>
+
+/**
+ * @brief File io of the ReadAllGeometries() worker running in this thread.
+ * Owner is checked, so callbacks may safely read other files.
+ */
+struct CADWorkerFileIO
+{
+    const CADFile * poOwner;
+    CADFileIO     * poFileIO;
+};
+
+static const size_t DEFAULT_OBJECT_CACHE_SIZE = 4 * 1024 * 1024;
+
+static thread_local CADWorkerFileIO gWorkerFileIO = { nullptr, nullptr };
+
+/**
+ * @brief Sets file io of the current thread worker, the previous one is
+ * restored on destruction, on exception too.
+ */
+class CADWorkerFileIOGuard
+{
+public:
+    CADWorkerFileIOGuard( const CADFile * poOwner, CADFileIO * poFileIO ) : oPrevWorkerIO( gWorkerFileIO )
+    {
+        gWorkerFileIO = { poOwner, poFileIO };
+    }
+
+    ~CADWorkerFileIOGuard()
+    {
+        gWorkerFileIO = oPrevWorkerIO;
+    }
+
+    CADWorkerFileIOGuard( const CADWorkerFileIOGuard& ) = delete;
+    CADWorkerFileIOGuard& operator=( const CADWorkerFileIOGuard& ) = delete;
+
+protected:
+    CADWorkerFileIO oPrevWorkerIO;
+};
+
+CADFile::CADFile( CADFileIO * poFileIO ) :
+    bReadingUnsupportedGeometries( false ),
+    bUseObjectIndexCache( false ),
+    nHeaderCRC( 0 ),
+    oObjectCache( DEFAULT_OBJECT_CACHE_SIZE ),
+    bExpandBlockReferences( true )
 {
     pFileIO = poFileIO;
 }
@@ -83,9 +137,26 @@ int CADFile::ParseFile( enum OpenOptions eOptions, bool bReadUnsupportedGeometri
     nResultCode = ReadClasses( eOptions );
     if( nResultCode != CADErrorCodes::SUCCESS )
         return nResultCode;
-    nResultCode = CreateFileMap();
-    if( nResultCode != CADErrorCodes::SUCCESS )
-        return nResultCode;
+
+    CADObjectIndex::CacheKey stCacheKey;
+    std::string              osCachePath;
+    bool bCacheUsable = bUseObjectIndexCache && GetObjectIndexCacheKey( stCacheKey );
+    if( bCacheUsable )
+        osCachePath = std::string( pFileIO->GetFilePath() ) + ".ocadidx";
+
+    if( bCacheUsable && oObjectIndex.Load( osCachePath, stCacheKey ) )
+    {
+        DebugMsg( "Object map is loaded from %s\n", osCachePath.c_str() );
+    }
+    else
+    {
+        nResultCode = CreateFileMap();
+        if( nResultCode != CADErrorCodes::SUCCESS )
+            return nResultCode;
+        if( bCacheUsable && !oObjectIndex.Save( osCachePath, stCacheKey ) )
+            DebugMsg( "Failed to write object map cache %s\n", osCachePath.c_str() );
+    }
+
     nResultCode = ReadTables( eOptions );
     if( nResultCode != CADErrorCodes::SUCCESS )
         return nResultCode;
@@ -113,7 +184,469 @@ CADLayer& CADFile::GetLayer( size_t index )
     return oTables.GetLayer( index );
 }
 
+void CADFile::SetUseObjectIndexCache( bool bUse )
+{
+    bUseObjectIndexCache = bUse;
+}
+
+void CADFile::SetObjectCacheSize( size_t nBytes )
+{
+    oObjectCache.SetCapacity( nBytes );
+}
+
+size_t CADFile::GetObjectCacheHits() const
+{
+    return oObjectCache.GetHits();
+}
+
+size_t CADFile::GetObjectCacheMisses() const
+{
+    return oObjectCache.GetMisses();
+}
+
+std::shared_ptr<const CADObject> CADFile::GetCachedObject( long dObjectHandle, bool bHandlesOnly )
+{
+    std::shared_ptr<const CADObject> poObject = oObjectCache.Get( dObjectHandle, bHandlesOnly );
+    if( poObject == nullptr )
+    {
+        poObject.reset( GetObject( dObjectHandle, bHandlesOnly ) );
+        oObjectCache.Put( dObjectHandle, bHandlesOnly, poObject );
+    }
+    return poObject;
+}
+
+bool CADFile::GetObjectIndexCacheKey( CADObjectIndex::CacheKey& stKey ) const
+{
+    struct stat stFileStat;
+    if( stat( pFileIO->GetFilePath(), &stFileStat ) != 0 )
+        return false;
+
+    stKey.nFileSize         = static_cast<unsigned long long>( stFileStat.st_size );
+    stKey.nModificationTime = static_cast<long long>( stFileStat.st_mtime );
+    stKey.nHeaderCRC        = nHeaderCRC;
+    return true;
+}
+
 bool CADFile::isReadingUnsupportedGeometries()
 {
     return bReadingUnsupportedGeometries;
-}
\ No newline at end of file
+}
+
+void CADFile::SetGeometryFilter( const std::vector<CADObject::ObjectType>& aeTypes,
+                                 const std::vector<std::string>& asLayerNames )
+{
+    aeFilterTypes  = aeTypes;
+    asFilterLayers = asLayerNames;
+}
+
+bool CADFile::hasGeometryFilter() const
+{
+    return !aeFilterTypes.empty() || !asFilterLayers.empty();
+}
+
+bool CADFile::isGeometryTypeAccepted( CADObject::ObjectType eType ) const
+{
+    return aeFilterTypes.empty() ||
+           std::find( aeFilterTypes.begin(), aeFilterTypes.end(), eType ) != aeFilterTypes.end();
+}
+
+bool CADFile::isLayerAccepted( const std::string& osLayerName ) const
+{
+    // names read from file keep the terminating zero
+    return asFilterLayers.empty() ||
+           std::find( asFilterLayers.begin(), asFilterLayers.end(),
+                      std::string( osLayerName.c_str() ) ) != asFilterLayers.end();
+}
+
+void CADFile::SetExpandBlockReferences( bool bExpand )
+{
+    bExpandBlockReferences = bExpand;
+}
+
+bool CADFile::isExpandingBlockReferences() const
+{
+    return bExpandBlockReferences;
+}
+
+CADBlockReference CADFile::GetBlockReference( size_t iLayerIndex, long dBlockRefHandle )
+{
+    CADBlockReference oReference;
+    std::shared_ptr<const CADObject> poObject = GetCachedObject( dBlockRefHandle );
+    if( poObject == nullptr || poObject->getType() != CADObject::INSERT )
+        return oReference;
+
+    const CADInsertObject * poInsert = static_cast<const CADInsertObject *>( poObject.get() );
+    std::shared_ptr<const CADObject> poBlockHeader = GetCachedObject( poInsert->hBlockHeader.getAsLong() );
+    if( poBlockHeader == nullptr || poBlockHeader->getType() != CADObject::BLOCK_HEADER )
+        return oReference;
+
+    oReference.setBlockHandle( poInsert->hBlockHeader.getAsLong() );
+    oReference.setInsertHandle( dBlockRefHandle );
+    oReference.setTransformation( GetBlockReferenceTransformation( poInsert,
+            static_cast<const CADBlockHeaderObject *>( poBlockHeader.get() ) ) );
+    oReference.setAttributes( GetBlockReferenceAttributes( iLayerIndex, dBlockRefHandle ) );
+    return oReference;
+}
+
+Matrix CADFile::GetBlockReferenceTransformation( const CADInsertObject * poInsert,
+                                                 const CADBlockHeaderObject * poBlockHeader )
+{
+    // insertion point is in the object coordinate system of the reference
+    Matrix oTransformation;
+    oTransformation.extrude( poInsert->vectExtrusion );
+    oTransformation.translate( poInsert->vertInsertionPoint );
+    oTransformation.rotate( poInsert->dfRotation );
+    oTransformation.scale( poInsert->vertScales );
+    const CADVector& vertBasePoint = poBlockHeader->vertBasePoint;
+    oTransformation.translate( CADVector( -vertBasePoint.getX(), -vertBasePoint.getY(),
+                                          -vertBasePoint.getZ() ) );
+    return oTransformation;
+}
+
+std::shared_ptr<const CADBlock> CADFile::GetBlock( long dBlockHandle )
+{
+    {
+        std::lock_guard<std::mutex> oLock( oBlocksMutex );
+        auto iter = mapBlocks.find( dBlockHandle );
+        if( iter != mapBlocks.end() )
+            return iter->second;
+    }
+
+    std::shared_ptr<const CADObject> poObject = GetCachedObject( dBlockHandle );
+    if( poObject == nullptr || poObject->getType() != CADObject::BLOCK_HEADER )
+        return nullptr;
+    const CADBlockHeaderObject * poBlockHeader = static_cast<const CADBlockHeaderObject *>( poObject.get() );
+
+    std::shared_ptr<CADBlock> poBlock = std::make_shared<CADBlock>( dBlockHandle, poBlockHeader->sEntryName,
+                                                                    poBlockHeader->vertBasePoint );
+    long dCurrentEntHandle = 0;
+    long dLastEntHandle    = 0;
+    if( !poBlockHeader->hEntities.empty() )
+    {
+        dCurrentEntHandle = poBlockHeader->hEntities[0].getAsLong();
+        dLastEntHandle    = poBlockHeader->hEntities[poBlockHeader->hEntities.size() - 1].getAsLong();
+    }
+
+    std::vector<long> adLayerHandles;
+    for( size_t i = 0; i < GetLayersCount(); ++i )
+        adLayerHandles.push_back( GetLayer( i ).getHandle() );
+
+    while( dCurrentEntHandle != 0 )
+    {
+        CADEntityProbe stEntity;
+        if( !ProbeEntity( dCurrentEntHandle, stEntity ) )
+            break;
+
+        // entities are decoded with their own layer to resolve BYLAYER colors,
+        // ones on a layer missing from the table are left with no color
+        size_t iLayer = static_cast<size_t>(
+                std::find( adLayerHandles.begin(), adLayerHandles.end(), stEntity.nLayer ) - adLayerHandles.begin() );
+        CADObject::ObjectType eType = stEntity.eType;
+        if( eType == CADObject::INSERT )
+        {
+            CADBlockReference oReference = GetBlockReference( iLayer, dCurrentEntHandle );
+            if( oReference.getBlockHandle() != 0 )
+                poBlock->addBlockReference( oReference );
+        }
+        else if( isCommonEntityType( eType ) && isGeometryTypeAccepted( eType ) &&
+                 ( eType == CADObject::IMAGE || isReadingUnsupportedGeometries() ||
+                   isSupportedGeometryType( eType ) ) )
+        {
+            CADGeometry * poGeometry = GetGeometry( iLayer, dCurrentEntHandle );
+            if( poGeometry != nullptr )
+                poBlock->addGeometry( poGeometry );
+        }
+
+        if( dCurrentEntHandle == dLastEntHandle )
+            break;
+        if( stEntity.bNoLinks )
+            ++dCurrentEntHandle;
+        else
+            dCurrentEntHandle = stEntity.nNextEntity;
+    }
+
+    // Concurrent first calls may decode the block twice, the first one is kept.
+    std::lock_guard<std::mutex> oLock( oBlocksMutex );
+    return mapBlocks.emplace( dBlockHandle, poBlock ).first->second;
+}
+
+CADFileIO * CADFile::GetFileIO() const
+{
+    if( gWorkerFileIO.poOwner == this )
+        return gWorkerFileIO.poFileIO;
+    return pFileIO;
+}
+
+// objects of one read are at most this far from each other
+static const long READ_MAX_GAP = 16 * 1024;
+// read size limit, and size of the read past the last object start
+static const long READ_MAX_SIZE = 1024 * 1024;
+static const long READ_TAIL_SIZE = 4 * 1024;
+
+void CADFile::ReadInFileOrder( const std::vector<long>& adHandles, const std::function<void( size_t )>& oRead )
+{
+    // Objects missing in the file map go last, oRead will fail on them anyway.
+    std::vector<std::pair<long, size_t> > aoObjects;
+    aoObjects.reserve( adHandles.size() );
+    for( size_t i = 0; i < adHandles.size(); ++i )
+    {
+        long nOffset = 0;
+        if( !oObjectIndex.Find( adHandles[i], nOffset ) )
+            nOffset = std::numeric_limits<long>::max();
+        aoObjects.push_back( std::make_pair( nOffset, i ) );
+    }
+    std::sort( aoObjects.begin(), aoObjects.end() );
+
+    CADFileWindowIO      oWindowIO( GetFileIO() );
+    CADWorkerFileIOGuard oWorkerIOGuard( this, &oWindowIO );
+
+    size_t iReadEnd = 0;
+    for( size_t i = 0; i < aoObjects.size(); ++i )
+    {
+        long nOffset = aoObjects[i].first;
+        if( i == iReadEnd && nOffset != std::numeric_limits<long>::max() )
+        {
+            for( iReadEnd = i + 1; iReadEnd < aoObjects.size(); ++iReadEnd )
+            {
+                long nNextOffset = aoObjects[iReadEnd].first;
+                if( nNextOffset - aoObjects[iReadEnd - 1].first > READ_MAX_GAP ||
+                    nNextOffset + READ_TAIL_SIZE - nOffset > READ_MAX_SIZE )
+                    break;
+            }
+            long nLastOffset = aoObjects[iReadEnd - 1].first;
+            oWindowIO.SetWindow( nOffset, static_cast<size_t>( nLastOffset + READ_TAIL_SIZE - nOffset ) );
+        }
+        oRead( aoObjects[i].second );
+    }
+}
+
+int CADFile::ReadAllGeometries( size_t nThreads, const GeometryCallback& oCallback )
+{
+    if( nullptr == pFileIO || !pFileIO->IsOpened() )
+        return CADErrorCodes::FILE_OPEN_FAILED;
+
+    // Layer and geometry indexes of everything to read.
+    std::vector<std::pair<size_t, size_t> > aoGeometries;
+    for( size_t iLayer = 0; iLayer < GetLayersCount(); ++iLayer )
+    {
+        size_t nGeometryCount = GetLayer( iLayer ).getGeometryCount();
+        for( size_t i = 0; i < nGeometryCount; ++i )
+            aoGeometries.push_back( std::make_pair( iLayer, i ) );
+    }
+
+    if( nThreads == 0 )
+        nThreads = std::max( 1u, std::thread::hardware_concurrency() );
+    // No reason to start workers which will have nothing to do.
+    const size_t nChunkSize = 64;
+    nThreads = std::max( size_t( 1 ), std::min( nThreads, ( aoGeometries.size() + nChunkSize - 1 ) / nChunkSize ) );
+
+    // Calling thread works with pFileIO, every other one needs its own io.
+    std::vector<std::unique_ptr<CADFileIO> > apoWorkerIO;
+    for( size_t i = 1; i < nThreads; ++i )
+    {
+        CADFileIO * poWorkerIO = pFileIO->Clone();
+        if( nullptr == poWorkerIO )
+            break;
+        apoWorkerIO.push_back( std::unique_ptr<CADFileIO>( poWorkerIO ) );
+    }
+
+    std::atomic<size_t> nNextGeometry( 0 );
+    auto Worker = [&]( CADFileIO * poWorkerIO )
+    {
+        CADWorkerFileIOGuard oWorkerIOGuard( this, poWorkerIO );
+
+        size_t nStart;
+        while( ( nStart = nNextGeometry.fetch_add( nChunkSize ) ) < aoGeometries.size() )
+        {
+            size_t nEnd = std::min( nStart + nChunkSize, aoGeometries.size() );
+            for( size_t i = nStart; i < nEnd; ++i )
+            {
+                CADGeometry * poGeometry = GetLayer( aoGeometries[i].first ).getGeometry( aoGeometries[i].second );
+                if( nullptr != poGeometry )
+                    oCallback( aoGeometries[i].first, aoGeometries[i].second, poGeometry );
+            }
+        }
+    };
+
+    // The first exception thrown by a worker, others stop once it is caught,
+    // and it is rethrown after all of them have finished.
+    std::exception_ptr poWorkerException;
+    std::mutex         oExceptionMutex;
+    auto SafeWorker = [&]( CADFileIO * poWorkerIO )
+    {
+        try
+        {
+            Worker( poWorkerIO );
+        }
+        catch( ... )
+        {
+            nNextGeometry = aoGeometries.size();
+            std::lock_guard<std::mutex> oLock( oExceptionMutex );
+            if( !poWorkerException )
+                poWorkerException = std::current_exception();
+        }
+    };
+
+    {
+        // joins started threads even if starting another one throws
+        struct ThreadsJoiner
+        {
+            std::vector<std::thread> aoThreads;
+            ~ThreadsJoiner()
+            {
+                for( size_t i = 0; i < aoThreads.size(); ++i )
+                    aoThreads[i].join();
+            }
+        } oJoiner;
+        for( size_t i = 0; i < apoWorkerIO.size(); ++i )
+            oJoiner.aoThreads.push_back( std::thread( SafeWorker, apoWorkerIO[i].get() ) );
+        SafeWorker( pFileIO );
+    }
+    if( poWorkerException )
+        std::rethrow_exception( poWorkerException );
+
+    return CADErrorCodes::SUCCESS;
+}
+
+//
+// CADFile::EntityCursor
+//
+
+// guards against block references cycle in corrupted files
+static const size_t MAX_BLOCK_NESTING = 64;
+
+static CADEntityProbe GetEntityProbe( const CADEntityObject * poEntity )
+{
+    const CADHandle& hEntity = poEntity->stCed.hObjectHandle;
+    CADEntityProbe stEntity;
+    stEntity.eType       = poEntity->getType();
+    stEntity.nHandle     = hEntity.getAsLong();
+    stEntity.nOwner      = poEntity->stCed.bbEntMode == 0 ? poEntity->stChed.hOwner.getAsLong( hEntity ) : 0;
+    stEntity.nLayer      = poEntity->stChed.hLayer.getAsLong( hEntity );
+    stEntity.nNextEntity = poEntity->stChed.hNextEntity.getAsLong( hEntity );
+    stEntity.bNoLinks    = poEntity->stCed.bNoLinks;
+    return stEntity;
+}
+
+CADFile::EntityCursor::EntityCursor( CADFile * poFileIn ) : poFile( poFileIn )
+{
+    for( size_t i = 0; i < poFile->GetLayersCount(); ++i )
+    {
+        adLayerHandles.push_back( poFile->GetLayer( i ).getHandle() );
+        abLayerAccepted.push_back( poFile->isLayerAccepted( poFile->GetLayer( i ).getName() ) );
+    }
+
+    Frame stModelSpace;
+    poFile->oTables.GetModelSpaceEntities( stModelSpace.dCurrentEntity, stModelSpace.dLastEntity );
+    stModelSpace.dBlockRefHandle = 0;
+    stModelSpace.iLayerIndex     = 0;
+    astFrames.push_back( stModelSpace );
+}
+
+CADGeometry * CADFile::EntityCursor::Next( size_t& iLayerIndex )
+{
+    while( !astFrames.empty() )
+    {
+        Frame& stFrame = astFrames.back();
+        long dHandle = stFrame.dCurrentEntity;
+        if( dHandle == 0 )
+        {
+            astFrames.pop_back();
+            continue;
+        }
+
+        // With geometry filter entities are probed, so the rejected ones are
+        // never decoded. Otherwise the whole object is read, GetGeometry() will
+        // take it from cache.
+        CADEntityProbe                         stEntity;
+        std::shared_ptr<const CADEntityObject> poEntity;
+        if( poFile->hasGeometryFilter() )
+        {
+            if( !poFile->ProbeEntity( dHandle, stEntity ) )
+            {
+                astFrames.pop_back();
+                continue;
+            }
+        }
+        else
+        {
+            poEntity = std::static_pointer_cast<const CADEntityObject>( poFile->GetCachedObject( dHandle ) );
+            if( poEntity == nullptr )
+            {
+                astFrames.pop_back();
+                continue;
+            }
+            stEntity = GetEntityProbe( poEntity.get() );
+        }
+
+        if( dHandle == stFrame.dLastEntity )
+            stFrame.dCurrentEntity = 0;
+        else if( stEntity.bNoLinks )
+            ++stFrame.dCurrentEntity;
+        else
+            stFrame.dCurrentEntity = stEntity.nNextEntity;
+
+        size_t iLayer = stFrame.iLayerIndex;
+        bool   bInBlock = astFrames.size() > 1;
+        if( !bInBlock )
+        {
+            // entities of model space are assigned to their own layer, ones of
+            // a block to the layer of the block reference
+            auto iterLayer = std::find( adLayerHandles.begin(), adLayerHandles.end(), stEntity.nLayer );
+            if( iterLayer == adLayerHandles.end() )
+                continue;
+            iLayer = static_cast<size_t>( iterLayer - adLayerHandles.begin() );
+            if( !abLayerAccepted[iLayer] )
+                continue;
+        }
+
+        CADObject::ObjectType eType = stEntity.eType;
+        if( eType == CADObject::INSERT )
+        {
+            if( !poFile->isExpandingBlockReferences() )
+                continue;
+            std::shared_ptr<const CADInsertObject> poInsert = std::static_pointer_cast<const CADInsertObject>(
+                    poEntity != nullptr ? poEntity : poFile->GetCachedObject( dHandle ) );
+            if( poInsert == nullptr )
+                continue;
+            std::shared_ptr<const CADBlockHeaderObject> poBlockHeader =
+                    std::static_pointer_cast<const CADBlockHeaderObject>(
+                            poFile->GetCachedObject( poInsert->hBlockHeader.getAsLong() ) );
+            if( poBlockHeader == nullptr || poBlockHeader->hEntities.size() < 2 ||
+                astFrames.size() > MAX_BLOCK_NESTING )
+                continue;
+
+            Frame stBlock;
+            stBlock.dCurrentEntity  = poBlockHeader->hEntities[0].getAsLong();
+            stBlock.dLastEntity     = poBlockHeader->hEntities[poBlockHeader->hEntities.size() - 1].getAsLong();
+            stBlock.dBlockRefHandle = dHandle;
+            stBlock.iLayerIndex     = iLayer;
+            // nested reference is placed in the block of its parent reference
+            stBlock.oTransformation = stFrame.oTransformation.multiply(
+                    GetBlockReferenceTransformation( poInsert.get(), poBlockHeader.get() ) );
+            // Blocks can be empty (contain no objects)
+            if( stBlock.dCurrentEntity != stBlock.dLastEntity )
+                astFrames.push_back( stBlock );
+            continue;
+        }
+
+        if( !isCommonEntityType( eType ) )
+            continue;
+        if( eType != CADObject::IMAGE && !poFile->isReadingUnsupportedGeometries() &&
+            !isSupportedGeometryType( eType ) )
+            continue;
+        if( !poFile->isGeometryTypeAccepted( eType ) )
+            continue;
+
+        CADGeometry * poGeometry = poFile->GetGeometry( iLayer, dHandle, stFrame.dBlockRefHandle );
+        if( nullptr == poGeometry )
+            continue;
+        if( bInBlock )
+            poGeometry->transform( stFrame.oTransformation );
+
+        iLayerIndex = iLayer;
+        return poGeometry;
+    }
+
+    return nullptr;
+}
@@ -31,12 +31,20 @@
 #ifndef CADFILE_H
 #define CADFILE_H
 
+#include "cadblock.h"
 #include "cadfileio.h"
 #include "cadclasses.h"
 #include "cadtables.h"
 #include "caddictionary.h"
+#include "cadobjectcache.h"
+#include "cadobjectindex.h"
 
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 /**
  * @brief The abstract CAD file class
@@ -58,6 +66,50 @@ public:
         READ_FASTEST    /**< read only geometry and layers */
     };
 
+    /**
+     * @brief Receives geometries read by ReadAllGeometries(). It owns
+     * poGeometry and have to free it. May be called from several threads at once.
+     */
+    typedef std::function<void( size_t iLayerIndex, size_t iGeometryIndex, CADGeometry * poGeometry )>
+            GeometryCallback;
+
+    /**
+     * @brief Forward only reader of model space geometries in file order.
+     * Unlike CADLayer it doesn't collect entity handles, so memory use doesn't
+     * depend on the number of entities. Block references are expanded and their
+     * geometries are transformed the same way CADLayer::getGeometry() does, or
+     * skipped if SetExpandBlockReferences() is off. Images are returned too.
+     */
+    class OCAD_EXTERN EntityCursor
+    {
+    public:
+        explicit EntityCursor( CADFile * poFile );
+
+        /**
+         * @brief Read next geometry
+         * @param iLayerIndex Index of the geometry layer
+         * @return geometry or nullptr if there are no more geometries. The
+         * pointer have to be freed by user
+         */
+        CADGeometry * Next( size_t& iLayerIndex );
+
+    protected:
+        // entities chain of model space or of a referenced block
+        struct Frame
+        {
+            long   dCurrentEntity; // 0 when chain is over
+            long   dLastEntity;
+            long   dBlockRefHandle; // 0 for model space
+            size_t iLayerIndex;
+            Matrix oTransformation;
+        };
+
+        CADFile         * poFile;
+        std::vector<long> adLayerHandles;
+        std::vector<bool> abLayerAccepted;
+        std::vector<Frame> astFrames;
+    };
+
 public:
     CADFile( CADFileIO * poFileIO );
     virtual                 ~CADFile();
@@ -72,6 +124,68 @@ public:
     virtual size_t GetLayersCount() const;
     virtual CADLayer& GetLayer( size_t index );
 
+    /**
+     * @brief Read geometries of all layers using a pool of worker threads. Each
+     * worker reads through its own copy of file io (see CADFileIO::Clone()), if
+     * io can't be cloned fewer workers are used.
+     * @param nThreads Number of worker threads, 0 means hardware concurrency
+     * @param oCallback Called for every geometry read, nullptr geometries are
+     * skipped. An exception thrown by it stops all workers and is rethrown once
+     * they have finished.
+     * @return CADErrorCodes::SUCCESS if OK, or error code
+     */
+    virtual int ReadAllGeometries( size_t nThreads, const GeometryCallback& oCallback );
+
+    /**
+     * @brief Keep the object map in a sidecar file (file path + ".ocadidx") and
+     * load it on the next open instead of decoding the objects map section.
+     * Cache is keyed by file size, modification time and header CRC. Must be
+     * set before ParseFile().
+     * @param bUse Use cache if true
+     */
+    void SetUseObjectIndexCache( bool bUse );
+
+    /**
+     * @brief Set size of decoded objects cache. Block headers, inserts and
+     * polyline vertexes are read over and over again while reading layers.
+     * @param nBytes Cache size in bytes, 0 disables cache
+     */
+    void   SetObjectCacheSize( size_t nBytes );
+    size_t GetObjectCacheHits() const;
+    size_t GetObjectCacheMisses() const;
+
+    /**
+     * @brief Read only geometries of the given types on the given layers.
+     * Entities are checked by type and layer handle before they are decoded, the
+     * rejected ones are missing in layers, EntityCursor and ReadAllGeometries().
+     * Block references are expanded whatever the types are. Must be set before
+     * layers geometries are accessed.
+     * @param aeTypes Types of geometries to read, empty for any
+     * @param asLayerNames Names of layers to read, empty for any
+     */
+    void SetGeometryFilter( const std::vector<CADObject::ObjectType>& aeTypes,
+                            const std::vector<std::string>& asLayerNames );
+
+    /**
+     * @brief Expand block references into the geometries of layers, the
+     * default. Every reference decodes the block entities again, so drawings
+     * with many references of the same block are better read with expansion
+     * off: layers then list block references (see CADLayer::getBlockReference())
+     * and geometries of each block are decoded once by GetBlock(). Must be set
+     * before layers geometries are accessed.
+     * @param bExpand Expand block references if true
+     */
+    void SetExpandBlockReferences( bool bExpand );
+
+    /**
+     * @brief Get block definition with its geometries. The block is decoded on
+     * the first call and kept until the file is closed. Geometries pass
+     * SetGeometryFilter() types, nested block references are listed, not expanded.
+     * @param dBlockHandle Handle of the block header, see CADBlockReference::getBlockHandle()
+     * @return block or nullptr if it can't be read
+     */
+    std::shared_ptr<const CADBlock> GetBlock( long dBlockHandle );
+
     /**
      * @brief returns NamedObjectDictionary (root) of all others dictionaries
      * @return pointer to the root CADDictionary
@@ -90,6 +204,33 @@ protected:
      */
     virtual CADObject * GetObject( long dObjectHandle, bool bHandlesOnly = false ) = 0;
 
+    /**
+     * @brief Get CAD Object through decoded objects cache
+     * @param dObjectHandle Object handle
+     * @param bHandlesOnly set TRUE if object read with handles only will do.
+     * @return shared CADObject or nullptr. Object may be shared with other
+     * readers and must not be modified.
+     */
+    std::shared_ptr<const CADObject> GetCachedObject( long dObjectHandle, bool bHandlesOnly = false );
+
+    /**
+     * @brief Read entity type and the handles, which link it to the others.
+     * Faster than GetObject() with bHandlesOnly, as nothing is allocated.
+     * @param dObjectHandle Entity handle
+     * @param stProbe Read fields
+     * @return false if object can't be read or it isn't an entity
+     */
+    virtual bool ProbeEntity( long dObjectHandle, CADEntityProbe& stProbe ) = 0;
+
+    /**
+     * @brief Call oRead for every object in the order of objects in file.
+     * Objects lying close to each other are read from file at once, oRead reads
+     * them through GetFileIO() as usual.
+     * @param adHandles Object handles
+     * @param oRead Called with index of the handle in adHandles
+     */
+    void ReadInFileOrder( const std::vector<long>& adHandles, const std::function<void( size_t )>& oRead );
+
     /**
      * @brief read geometry from CAD file
      * @param size_t LayerIndex
@@ -99,6 +240,29 @@ protected:
      */
     virtual CADGeometry * GetGeometry( size_t iLayerIndex, long dHandle, long dBlockRefHandle = 0 ) = 0;
 
+    /**
+     * @brief read attributes attached to block reference
+     * @param iLayerIndex Layer index, as for GetGeometry()
+     * @param dBlockRefHandle Handle of BlockRef
+     * @return attributes, empty if there are none
+     */
+    virtual std::vector<CADAttrib> GetBlockReferenceAttributes( size_t iLayerIndex, long dBlockRefHandle ) = 0;
+
+    /**
+     * @brief read block reference with its transformation and attributes
+     * @param iLayerIndex Layer index, as for GetGeometry()
+     * @param dBlockRefHandle Handle of BlockRef
+     * @return block reference, block handle is 0 if it can't be read
+     */
+    CADBlockReference GetBlockReference( size_t iLayerIndex, long dBlockRefHandle );
+
+    /**
+     * @brief returns transformation from block to the block reference
+     * coordinates, block base point is moved to the insertion point
+     */
+    static Matrix GetBlockReferenceTransformation( const CADInsertObject * poInsert,
+                                                   const CADBlockHeaderObject * poBlockHeader );
+
     /**
      * @brief initially read some basic values and section locator
      * @return CADErrorCodes::SUCCESS if OK, or error code
@@ -137,6 +301,38 @@ protected:
      */
     bool isReadingUnsupportedGeometries();
 
+    /**
+     * @brief returns true if SetGeometryFilter() restricts anything
+     */
+    bool hasGeometryFilter() const;
+
+    /**
+     * @brief returns true if geometries of this type pass SetGeometryFilter()
+     */
+    bool isGeometryTypeAccepted( CADObject::ObjectType eType ) const;
+
+    /**
+     * @brief returns true if geometries of this layer pass SetGeometryFilter()
+     */
+    bool isLayerAccepted( const std::string& osLayerName ) const;
+
+    /**
+     * @brief returns value of SetExpandBlockReferences()
+     */
+    bool isExpandingBlockReferences() const;
+
+    /**
+     * @brief returns file io to read objects with. Inside ReadAllGeometries()
+     * workers it is the worker's own io, pFileIO otherwise.
+     */
+    CADFileIO * GetFileIO() const;
+
+    /**
+     * @brief Fill the object index cache key of the opened file
+     * @return false if the file can't be identified (e.g. it isn't on disk)
+     */
+    bool GetObjectIndexCacheKey( CADObjectIndex::CacheKey& stKey ) const;
+
 protected:
     CADFileIO * pFileIO;
     CADHeader  oHeader;
@@ -144,8 +340,16 @@ protected:
     CADTables  oTables;
 
 protected:
-    std::map<long, long> mapObjects; // object index <-> file offset
+    CADObjectIndex oObjectIndex; // object handle <-> file offset
     bool bReadingUnsupportedGeometries;
+    bool bUseObjectIndexCache;
+    unsigned short nHeaderCRC;
+    std::vector<CADObject::ObjectType> aeFilterTypes;
+    std::vector<std::string>           asFilterLayers;
+    CADObjectCache oObjectCache;
+    bool bExpandBlockReferences;
+    std::map<long, std::shared_ptr<const CADBlock> > mapBlocks; // block header handle <-> decoded block
+    std::mutex oBlocksMutex;
 };
 
 
@@ -30,6 +30,8 @@
  ******************************************************************************/
 #include "cadfileio.h"
 
+#include <cstring>
+
 CADFileIO::CADFileIO( const char * pszFileName )
 {
     m_soFilePath = pszFileName;
@@ -57,3 +59,27 @@ const char * CADFileIO::GetFilePath() const
 {
     return m_soFilePath.c_str();
 }
+
+const char * CADFileIO::GetView( long int /*offset*/, size_t /*size*/ )
+{
+    return nullptr;
+}
+
+size_t CADFileIO::ReadAt( long int offset, void * ptr, size_t size )
+{
+    const char * pabyData = GetView( offset, size );
+    if( pabyData != nullptr )
+    {
+        memcpy( ptr, pabyData, size );
+        return size;
+    }
+
+    if( Seek( offset, SeekOrigin::BEG ) != 0 )
+        return 0;
+    return Read( ptr, size );
+}
+
+CADFileIO * CADFileIO::Clone() const
+{
+    return nullptr;
+}
@@ -69,6 +69,27 @@ public:
     virtual size_t   Read( void * ptr, size_t size )            = 0;
     virtual size_t   Write( void * ptr, size_t size )           = 0;
     virtual void     Rewind()                                   = 0;
+    /**
+     * @brief Read size bytes starting at offset. Unlike Seek() and Read() it
+     * doesn't use file pointer, so the readers of one file don't disturb each
+     * other. Default implementation takes the data from GetView() or falls back
+     * to Seek() and Read(), which is not thread safe.
+     * @return number of bytes read, less than size at the end of file
+     */
+    virtual size_t   ReadAt( long int offset, void * ptr, size_t size );
+    /**
+     * @brief Direct read-only access to size bytes starting at offset.
+     * @return pointer to the data or nullptr if backend doesn't support it or
+     * the range is out of the file. Pointer is valid until Close().
+     */
+    virtual const char * GetView( long int offset, size_t size );
+    /**
+     * @brief Create independent io for the same file, opened for reading. Used
+     * to read one file from several threads.
+     * @return new io or nullptr if not supported. The pointer have to be freed by
+     * user
+     */
+    virtual CADFileIO  * Clone() const;
     const char * GetFilePath() const;
 
 protected:
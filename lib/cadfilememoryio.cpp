@@ -0,0 +1,172 @@
+/*******************************************************************************
+ *  Project: libopencad
+ *  Purpose: OpenSource CAD formats support library
+ *  Author: Alexandr Borzykh, mush3d at gmail.com
+ *  Author: Dmitry Baryshnikov, bishop.dev@gmail.com
+ *  Language: C++
+ *******************************************************************************
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2016 Alexandr Borzykh
+ *  Copyright (c) 2016 NextGIS, <info@nextgis.com>
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ ******************************************************************************/
+#include "cadfilememoryio.h"
+
+#include <algorithm>
+#include <cstring>
+
+CADFileMemoryIO::CADFileMemoryIO( const void * pData, size_t nSize, const char * pszFilePath ) :
+    CADFileIO( pszFilePath ),
+    m_pabyData( static_cast<const char *>( pData ) ),
+    m_nSize( pData != nullptr ? nSize : 0 ),
+    m_nPosition( 0 ),
+    m_bEof( false )
+{
+}
+
+CADFileMemoryIO::~CADFileMemoryIO()
+{
+}
+
+const char * CADFileMemoryIO::ReadLine()
+{
+    // TODO: getline
+    return nullptr;
+}
+
+bool CADFileMemoryIO::Eof()
+{
+    return m_bEof;
+}
+
+bool CADFileMemoryIO::Open( int mode )
+{
+    if( mode & OpenMode::write )
+        return false;
+
+    if( m_pabyData == nullptr || m_nSize == 0 )
+        return false;
+
+    m_nPosition = 0;
+    m_bEof      = false;
+    m_bIsOpened = true;
+
+    return m_bIsOpened;
+}
+
+bool CADFileMemoryIO::Close()
+{
+    // Buffer belongs to the caller, just forget the position.
+    m_nPosition = 0;
+    return CADFileIO::Close();
+}
+
+int CADFileMemoryIO::Seek( long offset, CADFileIO::SeekOrigin origin )
+{
+    long nBase = 0;
+    switch( origin )
+    {
+        case SeekOrigin::CUR:
+            nBase = static_cast<long>( m_nPosition );
+            break;
+        case SeekOrigin::END:
+            nBase = static_cast<long>( m_nSize );
+            break;
+        case SeekOrigin::BEG:
+            nBase = 0;
+            break;
+    }
+
+    long nNewPosition = nBase + offset;
+    if( !m_bIsOpened || nNewPosition < 0 )
+        return 1;
+
+    // Same as seekg(): seeking beyond the end is allowed, reading there is not.
+    m_nPosition = static_cast<size_t>( nNewPosition );
+    m_bEof      = false;
+    return 0;
+}
+
+long CADFileMemoryIO::Tell()
+{
+    if( !m_bIsOpened )
+        return -1;
+    return static_cast<long>( m_nPosition );
+}
+
+size_t CADFileMemoryIO::Read( void * ptr, size_t size )
+{
+    if( !m_bIsOpened )
+        return 0;
+
+    size_t nAvailable = m_nPosition < m_nSize ? m_nSize - m_nPosition : 0;
+    if( size > nAvailable )
+    {
+        size   = nAvailable;
+        m_bEof = true;
+    }
+
+    memcpy( ptr, m_pabyData + m_nPosition, size );
+    m_nPosition += size;
+    return size;
+}
+
+size_t CADFileMemoryIO::Write( void * /*ptr*/, size_t /*size*/ )
+{
+    // unsupported
+    return 0;
+}
+
+void CADFileMemoryIO::Rewind()
+{
+    m_nPosition = 0;
+    m_bEof      = false;
+}
+
+size_t CADFileMemoryIO::ReadAt( long offset, void * ptr, size_t size )
+{
+    if( !m_bIsOpened || offset < 0 || static_cast<size_t>( offset ) > m_nSize )
+        return 0;
+
+    size = std::min( size, m_nSize - static_cast<size_t>( offset ) );
+    memcpy( ptr, m_pabyData + offset, size );
+    return size;
+}
+
+const char * CADFileMemoryIO::GetView( long offset, size_t size )
+{
+    if( !m_bIsOpened || offset < 0 || static_cast<size_t>( offset ) > m_nSize ||
+        size > m_nSize - static_cast<size_t>( offset ) )
+        return nullptr;
+
+    return m_pabyData + offset;
+}
+
+CADFileIO * CADFileMemoryIO::Clone() const
+{
+    CADFileMemoryIO * poClone = new CADFileMemoryIO( m_pabyData, m_nSize, m_soFilePath.c_str() );
+    if( !poClone->Open( OpenMode::read | OpenMode::binary ) )
+    {
+        delete poClone;
+        return nullptr;
+    }
+    return poClone;
+}
@@ -0,0 +1,155 @@
+/*******************************************************************************
+ *  Project: libopencad
+ *  Purpose: OpenSource CAD formats support library
+ *  Author: Alexandr Borzykh, mush3d at gmail.com
+ *  Author: Dmitry Baryshnikov, bishop.dev@gmail.com
+ *  Language: C++
+ *******************************************************************************
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2016 Alexandr Borzykh
+ *  Copyright (c) 2016 NextGIS, <info@nextgis.com>
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ ******************************************************************************/
+#include "cadfilemmapio.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+CADFileMmapIO::CADFileMmapIO( const char * pszFilePath ) : CADFileMemoryIO( nullptr, 0, pszFilePath )
+#ifdef _WIN32
+    , m_hFile( INVALID_HANDLE_VALUE ),
+    m_hMapping( nullptr )
+#endif
+{
+}
+
+CADFileMmapIO::~CADFileMmapIO()
+{
+    // Base destructor can't reach our Close(), so unmap here.
+    if( IsOpened() )
+        Close();
+}
+
+bool CADFileMmapIO::Open( int mode )
+{
+    if( mode & OpenMode::write )
+        return false;
+
+    if( m_bIsOpened )
+        return true;
+
+#ifdef _WIN32
+    HANDLE hFile = CreateFileA( m_soFilePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr );
+    if( hFile == INVALID_HANDLE_VALUE )
+        return false;
+
+    LARGE_INTEGER nFileSize;
+    if( !GetFileSizeEx( hFile, &nFileSize ) || nFileSize.QuadPart == 0 )
+    {
+        CloseHandle( hFile );
+        return false;
+    }
+
+    HANDLE hMapping = CreateFileMappingA( hFile, nullptr, PAGE_READONLY, 0, 0, nullptr );
+    if( hMapping == nullptr )
+    {
+        CloseHandle( hFile );
+        return false;
+    }
+
+    void * pData = MapViewOfFile( hMapping, FILE_MAP_READ, 0, 0, 0 );
+    if( pData == nullptr )
+    {
+        CloseHandle( hMapping );
+        CloseHandle( hFile );
+        return false;
+    }
+
+    m_hFile    = hFile;
+    m_hMapping = hMapping;
+    m_nSize    = static_cast<size_t>( nFileSize.QuadPart );
+#else
+    int nFd = open( m_soFilePath.c_str(), O_RDONLY );
+    if( nFd < 0 )
+        return false;
+
+    struct stat stFileStat;
+    // mmap() refuses zero length mappings, leave such files to stream io.
+    if( fstat( nFd, &stFileStat ) != 0 || stFileStat.st_size <= 0 )
+    {
+        close( nFd );
+        return false;
+    }
+
+    void * pData = mmap( nullptr, static_cast<size_t>( stFileStat.st_size ), PROT_READ, MAP_PRIVATE,
+                         nFd, 0 );
+    // The mapping holds its own reference to the file.
+    close( nFd );
+    if( pData == MAP_FAILED )
+        return false;
+
+    m_nSize = static_cast<size_t>( stFileStat.st_size );
+#endif
+
+    m_pabyData   = static_cast<const char *>( pData );
+    m_nPosition  = 0;
+    m_bEof       = false;
+    m_bIsOpened  = true;
+
+    return m_bIsOpened;
+}
+
+bool CADFileMmapIO::Close()
+{
+    if( m_pabyData != nullptr )
+    {
+#ifdef _WIN32
+        UnmapViewOfFile( m_pabyData );
+        CloseHandle( m_hMapping );
+        CloseHandle( m_hFile );
+        m_hMapping = nullptr;
+        m_hFile    = INVALID_HANDLE_VALUE;
+#else
+        munmap( const_cast<char *>( m_pabyData ), m_nSize );
+#endif
+        m_pabyData = nullptr;
+    }
+    m_nSize = 0;
+    return CADFileMemoryIO::Close();
+}
+
+CADFileIO * CADFileMmapIO::Clone() const
+{
+    CADFileMmapIO * poClone = new CADFileMmapIO( m_soFilePath.c_str() );
+    if( !poClone->Open( OpenMode::read | OpenMode::binary ) )
+    {
+        delete poClone;
+        return nullptr;
+    }
+    return poClone;
+}
@@ -112,3 +112,24 @@ void CADFileStreamIO::Rewind()
 {
     m_oFileStream.seekg( 0, std::ios_base::beg );
 }
+
+size_t CADFileStreamIO::ReadAt( long offset, void * ptr, size_t size )
+{
+    std::lock_guard<std::mutex> oLock( m_oReadAtMutex );
+    // a read past the end of file before leaves the stream failed
+    m_oFileStream.clear();
+    if( !m_oFileStream.seekg( offset, std::ios_base::beg ).good() )
+        return 0;
+    return static_cast<size_t>(m_oFileStream.read( static_cast<char *>(ptr), static_cast<long>(size) ).gcount());
+}
+
+CADFileIO * CADFileStreamIO::Clone() const
+{
+    CADFileStreamIO * poClone = new CADFileStreamIO( m_soFilePath.c_str() );
+    if( !poClone->Open( OpenMode::read | OpenMode::binary ) )
+    {
+        delete poClone;
+        return nullptr;
+    }
+    return poClone;
+}
@@ -34,6 +34,7 @@
 #include "cadfileio.h"
 
 #include <fstream>
+#include <mutex>
 
 class CADFileStreamIO : public CADFileIO
 {
@@ -50,8 +51,11 @@ public:
     virtual size_t      Read(void* ptr, size_t size) override;
     virtual size_t      Write(void* ptr, size_t size) override;
     virtual void        Rewind() override;
+    virtual size_t      ReadAt(long int offset, void* ptr, size_t size) override;
+    virtual CADFileIO*  Clone() const override;
 protected:
     std::ifstream       m_oFileStream;
+    std::mutex          m_oReadAtMutex; // ReadAt() seeks shared stream
 };
 
 #endif // CADFILESTREAMIO_H
@@ -0,0 +1,140 @@
+/*******************************************************************************
+ *  Project: libopencad
+ *  Purpose: OpenSource CAD formats support library
+ *  Author: Alexandr Borzykh, mush3d at gmail.com
+ *  Author: Dmitry Baryshnikov, bishop.dev@gmail.com
+ *  Language: C++
+ *******************************************************************************
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2016 Alexandr Borzykh
+ *  Copyright (c) 2016 NextGIS, <info@nextgis.com>
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ ******************************************************************************/
+#include "cadfilewindowio.h"
+
+#include <cstring>
+
+CADFileWindowIO::CADFileWindowIO( CADFileIO * poBaseIO ) :
+    CADFileIO( poBaseIO->GetFilePath() ),
+    m_poBaseIO( poBaseIO ),
+    m_pabyWindow( nullptr ),
+    m_nWindowOffset( 0 ),
+    m_nWindowSize( 0 )
+{
+}
+
+CADFileWindowIO::~CADFileWindowIO()
+{
+}
+
+void CADFileWindowIO::SetWindow( long int offset, size_t size )
+{
+    m_nWindowOffset = offset;
+
+    // io which maps the file needs no copy
+    m_pabyWindow = m_poBaseIO->GetView( offset, size );
+    if( m_pabyWindow != nullptr )
+    {
+        m_nWindowSize = size;
+        return;
+    }
+
+    m_abyWindow.resize( size );
+    m_nWindowSize = m_poBaseIO->ReadAt( offset, m_abyWindow.data(), size );
+    m_pabyWindow = m_abyWindow.data();
+}
+
+const char * CADFileWindowIO::ReadLine()
+{
+    return m_poBaseIO->ReadLine();
+}
+
+bool CADFileWindowIO::Eof()
+{
+    return m_poBaseIO->Eof();
+}
+
+bool CADFileWindowIO::Open( int mode )
+{
+    return m_poBaseIO->Open( mode );
+}
+
+bool CADFileWindowIO::IsOpened() const
+{
+    return m_poBaseIO->IsOpened();
+}
+
+bool CADFileWindowIO::Close()
+{
+    m_pabyWindow  = nullptr;
+    m_nWindowSize = 0;
+    return m_poBaseIO->Close();
+}
+
+int CADFileWindowIO::Seek( long int offset, CADFileIO::SeekOrigin origin )
+{
+    return m_poBaseIO->Seek( offset, origin );
+}
+
+long int CADFileWindowIO::Tell()
+{
+    return m_poBaseIO->Tell();
+}
+
+size_t CADFileWindowIO::Read( void * ptr, size_t size )
+{
+    return m_poBaseIO->Read( ptr, size );
+}
+
+size_t CADFileWindowIO::Write( void * ptr, size_t size )
+{
+    return m_poBaseIO->Write( ptr, size );
+}
+
+void CADFileWindowIO::Rewind()
+{
+    m_poBaseIO->Rewind();
+}
+
+size_t CADFileWindowIO::ReadAt( long int offset, void * ptr, size_t size )
+{
+    const char * pabyData = GetView( offset, size );
+    if( pabyData != nullptr )
+    {
+        memcpy( ptr, pabyData, size );
+        return size;
+    }
+    return m_poBaseIO->ReadAt( offset, ptr, size );
+}
+
+CADFileIO * CADFileWindowIO::Clone() const
+{
+    return m_poBaseIO->Clone();
+}
+
+const char * CADFileWindowIO::GetView( long int offset, size_t size )
+{
+    if( m_pabyWindow != nullptr && offset >= m_nWindowOffset &&
+        static_cast<size_t>( offset - m_nWindowOffset ) <= m_nWindowSize &&
+        size <= m_nWindowSize - static_cast<size_t>( offset - m_nWindowOffset ) )
+        return m_pabyWindow + ( offset - m_nWindowOffset );
+    return m_poBaseIO->GetView( offset, size );
+}
@@ -43,59 +43,242 @@ using namespace std;
 
 Matrix::Matrix()
 {
-    matrix[0] = 1.0;
-    matrix[1] = 0.0;
-    matrix[2] = 0.0;
-    matrix[3] = 0.0;
-    matrix[4] = 1.0;
-    matrix[5] = 0.0;
-    matrix[6] = 0.0;
-    matrix[7] = 0.0;
-    matrix[8] = 1.0;
+    matrix = { { 1.0, 0.0, 0.0, 0.0,
+                 0.0, 1.0, 0.0, 0.0,
+                 0.0, 0.0, 1.0, 0.0 } };
 }
 
 void Matrix::translate( const CADVector& vector )
 {
-    double a00 = matrix[0], a01 = matrix[1], a02 = matrix[2], a10 = matrix[3], a11 = matrix[4], a12 = matrix[5], a20 = matrix[6], a21 = matrix[7], a22 = matrix[8];
-
-    matrix[6] = vector.getX() * a00 + vector.getY() * a10 + a20;
-    matrix[7] = vector.getX() * a01 + vector.getY() * a11 + a21;
-    matrix[8] = vector.getX() * a02 + vector.getY() * a12 + a22;
+    for( size_t row = 0; row < 3; ++row )
+    {
+        double * a = &matrix[row * 4];
+        a[3] += a[0] * vector.getX() + a[1] * vector.getY() + a[2] * vector.getZ();
+    }
 }
 
 void Matrix::rotate( double rotation )
 {
-    double              s                                                                                        = sin( rotation ), c = cos(
-            rotation ), a00                                                                                      = matrix[0], a01 = matrix[1], a02 = matrix[2], a10 = matrix[3], a11 = matrix[4], a12 = matrix[5];
-
-    matrix[0] = c * a00 + s * a10;
-    matrix[1] = c * a01 + s * a11;
-    matrix[2] = c * a02 + s * a12;
-
-    matrix[3] = c * a10 - s * a00;
-    matrix[4] = c * a11 - s * a01;
-    matrix[5] = c * a12 - s * a02;
+    double s = sin( rotation ), c = cos( rotation );
+    for( size_t row = 0; row < 3; ++row )
+    {
+        double * a = &matrix[row * 4];
+        double a0 = a[0], a1 = a[1];
+        a[0] = a0 * c + a1 * s;
+        a[1] = a1 * c - a0 * s;
+    }
 }
 
 void Matrix::scale( const CADVector& vector )
 {
-    matrix[0] *= vector.getX();
-    matrix[1] *= vector.getX();
-    matrix[2] *= vector.getX();
-    matrix[3] *= vector.getY();
-    matrix[4] *= vector.getY();
-    matrix[5] *= vector.getY();
+    for( size_t row = 0; row < 3; ++row )
+    {
+        double * a = &matrix[row * 4];
+        a[0] *= vector.getX();
+        a[1] *= vector.getY();
+        a[2] *= vector.getZ();
+    }
+}
+
+void Matrix::extrude( const CADVector& extrusion )
+{
+    double nx = extrusion.getX(), ny = extrusion.getY(), nz = extrusion.getZ();
+    double length = sqrt( nx * nx + ny * ny + nz * nz );
+    if( length == 0.0 )
+        return;
+    nx /= length;
+    ny /= length;
+    nz /= length;
+    if( nx == 0.0 && ny == 0.0 && nz == 1.0 )
+        return;
+
+    // Ax = Wy x N if N is close to world Z axis, Wz x N otherwise
+    double ax, ay, az;
+    if( fabs( nx ) < 1.0 / 64 && fabs( ny ) < 1.0 / 64 )
+    {
+        ax = nz;
+        ay = 0.0;
+        az = -nx;
+    }
+    else
+    {
+        ax = -ny;
+        ay = nx;
+        az = 0.0;
+    }
+    double axLength = sqrt( ax * ax + ay * ay + az * az );
+    ax /= axLength;
+    ay /= axLength;
+    az /= axLength;
+    // Ay = N x Ax
+    double bx = ny * az - nz * ay;
+    double by = nz * ax - nx * az;
+    double bz = nx * ay - ny * ax;
+
+    for( size_t row = 0; row < 3; ++row )
+    {
+        double * a = &matrix[row * 4];
+        double a0 = a[0], a1 = a[1], a2 = a[2];
+        a[0] = a0 * ax + a1 * ay + a2 * az;
+        a[1] = a0 * bx + a1 * by + a2 * bz;
+        a[2] = a0 * nx + a1 * ny + a2 * nz;
+    }
 }
 
 CADVector Matrix::multiply( const CADVector& vector ) const
 {
-    CADVector out;
-    out.setX( vector.getX() * matrix[0] + vector.getY() * matrix[1] + vector.getZ() * matrix[2] );
-    out.setY( vector.getX() * matrix[3] + vector.getY() * matrix[4] + vector.getZ() * matrix[5] );
-    out.setZ( vector.getX() * matrix[6] + vector.getY() * matrix[7] + vector.getZ() * matrix[8] );
+    CADVector out( vector );
+    multiply( &out, 1 );
+    return out;
+}
+
+void Matrix::multiply( CADVector * vectors, size_t count ) const
+{
+    // Coefficients are copied to locals, so the compiler doesn't reload them
+    // after every store and can vectorize the loop.
+    const double a00 = matrix[0], a01 = matrix[1], a02 = matrix[2], a03 = matrix[3];
+    const double a10 = matrix[4], a11 = matrix[5], a12 = matrix[6], a13 = matrix[7];
+    const double a20 = matrix[8], a21 = matrix[9], a22 = matrix[10], a23 = matrix[11];
+    for( size_t i = 0; i < count; ++i )
+    {
+        CADVector& vector = vectors[i];
+        const double x = vector.X, y = vector.Y, z = vector.Z;
+        vector.X = a00 * x + a01 * y + a02 * z + a03;
+        vector.Y = a10 * x + a11 * y + a12 * z + a13;
+        vector.Z = a20 * x + a21 * y + a22 * z + a23;
+    }
+}
+
+Matrix Matrix::multiply( const Matrix& other ) const
+{
+    Matrix out;
+    for( size_t row = 0; row < 3; ++row )
+    {
+        const double * a = &matrix[row * 4];
+        double * r = &out.matrix[row * 4];
+        for( size_t col = 0; col < 4; ++col )
+        {
+            r[col] = a[0] * other.matrix[col] + a[1] * other.matrix[4 + col] +
+                     a[2] * other.matrix[8 + col];
+        }
+        r[3] += a[3];
+    }
     return out;
 }
 
+//------------------------------------------------------------------------------
+// CADBoundingBox
+//------------------------------------------------------------------------------
+
+CADBoundingBox::CADBoundingBox() :
+    minX( numeric_limits<double>::infinity() ),
+    minY( numeric_limits<double>::infinity() ),
+    minZ( numeric_limits<double>::infinity() ),
+    maxX( -numeric_limits<double>::infinity() ),
+    maxY( -numeric_limits<double>::infinity() ),
+    maxZ( -numeric_limits<double>::infinity() )
+{
+}
+
+CADBoundingBox::CADBoundingBox( const CADVector& minIn, const CADVector& maxIn ) :
+    minX( minIn.getX() ), minY( minIn.getY() ), minZ( minIn.getZ() ),
+    maxX( maxIn.getX() ), maxY( maxIn.getY() ), maxZ( maxIn.getZ() )
+{
+}
+
+bool CADBoundingBox::isEmpty() const
+{
+    return minX > maxX || minY > maxY || minZ > maxZ;
+}
+
+CADVector CADBoundingBox::getMin() const
+{
+    return CADVector( minX, minY, minZ );
+}
+
+CADVector CADBoundingBox::getMax() const
+{
+    return CADVector( maxX, maxY, maxZ );
+}
+
+void CADBoundingBox::addPoint( const CADVector& point )
+{
+    addPoint( point.getX(), point.getY(), point.getZ() );
+}
+
+void CADBoundingBox::addPoint( double x, double y, double z )
+{
+    minX = min( minX, x );
+    minY = min( minY, y );
+    minZ = min( minZ, z );
+    maxX = max( maxX, x );
+    maxY = max( maxY, y );
+    maxZ = max( maxZ, z );
+}
+
+void CADBoundingBox::addBox( const CADBoundingBox& box )
+{
+    if( box.isEmpty() )
+        return;
+    addPoint( box.minX, box.minY, box.minZ );
+    addPoint( box.maxX, box.maxY, box.maxZ );
+}
+
+bool CADBoundingBox::intersectsXY( const CADBoundingBox& box ) const
+{
+    return !isEmpty() && !box.isEmpty() && minX <= box.maxX && box.minX <= maxX && minY <= box.maxY &&
+           box.minY <= maxY;
+}
+
+static const double dfHalfPi = 1.57079632679489661923;
+
+/**
+ * @brief Add rectangle [x0, x1] x [y0, y1] rotated by angle around origin
+ */
+static void AddRotatedRect( CADBoundingBox& box, const CADVector& origin, double x0, double y0, double x1,
+                            double y1, double angle )
+{
+    double c = cos( angle ), s = sin( angle );
+    const double corners[4][2] = { { x0, y0 }, { x1, y0 }, { x1, y1 }, { x0, y1 } };
+    for( const auto& corner : corners )
+    {
+        box.addPoint( origin.getX() + corner[0] * c - corner[1] * s,
+                      origin.getY() + corner[0] * s + corner[1] * c, origin.getZ() );
+    }
+}
+
+/**
+ * @brief Add polyline arc segment from p1 to p2. bulge is tangent of the quarter
+ * of the arc angle, its sign gives the direction.
+ */
+static void AddBulgedSegment( CADBoundingBox& box, const CADVector& p1, const CADVector& p2, double bulge )
+{
+    double dx = p2.getX() - p1.getX(), dy = p2.getY() - p1.getY();
+    double chord = sqrt( dx * dx + dy * dy );
+    if( chord == 0.0 )
+        return;
+
+    if( fabs( bulge ) <= 1.0 )
+    {
+        // Not more than a half circle: the arc is no farther from the chord
+        // than its sagitta.
+        double sagitta = fabs( bulge ) * chord / 2;
+        box.addPoint( min( p1.getX(), p2.getX() ) - sagitta, min( p1.getY(), p2.getY() ) - sagitta, p1.getZ() );
+        box.addPoint( max( p1.getX(), p2.getX() ) + sagitta, max( p1.getY(), p2.getY() ) + sagitta, p1.getZ() );
+        return;
+    }
+
+    // Larger arcs are bounded by their circle. Center is on the chord normal,
+    // on the side of the arc.
+    double radius = chord * ( 1 + bulge * bulge ) / ( 4 * fabs( bulge ) );
+    double offset = radius - fabs( bulge ) * chord / 2;
+    double side   = bulge > 0 ? 1.0 : -1.0;
+    double cx     = ( p1.getX() + p2.getX() ) / 2 - side * dy / chord * offset;
+    double cy     = ( p1.getY() + p2.getY() ) / 2 + side * dx / chord * offset;
+    box.addPoint( cx - radius, cy - radius, p1.getZ() );
+    box.addPoint( cx + radius, cy + radius, p1.getZ() );
+}
+
 //------------------------------------------------------------------------------
 // CADGeometry
 //------------------------------------------------------------------------------
@@ -135,24 +318,29 @@ void CADGeometry::setColor( RGBColor color )
     geometry_color = color;
 }
 
-vector<string> CADGeometry::getEED() const
+const vector<string>& CADGeometry::getEED() const
 {
     return asEED;
 }
 
 void CADGeometry::setEED( vector<string> eed )
 {
-    asEED = eed;
+    asEED = std::move( eed );
 }
 
-vector<CADAttrib> CADGeometry::getBlockAttributes() const
+const vector<CADAttrib>& CADGeometry::getBlockAttributes() const
 {
     return blockAttributes;
 }
 
-void CADGeometry::setBlockAttributes( const vector<CADAttrib>& data )
+void CADGeometry::setBlockAttributes( vector<CADAttrib> data )
+{
+    blockAttributes = std::move( data );
+}
+
+CADBoundingBox CADGeometry::getBoundingBox() const
 {
-    blockAttributes = data;
+    return CADBoundingBox();
 }
 
 //------------------------------------------------------------------------------
@@ -228,6 +416,13 @@ void CADPoint3D::transform( const Matrix& matrix )
     position = matrix.multiply( position );
 }
 
+CADBoundingBox CADPoint3D::getBoundingBox() const
+{
+    CADBoundingBox box;
+    box.addPoint( position );
+    return box;
+}
+
 //------------------------------------------------------------------------------
 // CADLine
 //------------------------------------------------------------------------------
@@ -277,6 +472,13 @@ void CADLine::transform( const Matrix& matrix )
     end.transform( matrix );
 }
 
+CADBoundingBox CADLine::getBoundingBox() const
+{
+    CADBoundingBox box = start.getBoundingBox();
+    box.addBox( end.getBoundingBox() );
+    return box;
+}
+
 //------------------------------------------------------------------------------
 // CADCircle
 //------------------------------------------------------------------------------
@@ -303,6 +505,14 @@ void CADCircle::print() const
 
 }
 
+CADBoundingBox CADCircle::getBoundingBox() const
+{
+    CADBoundingBox box;
+    box.addPoint( position.getX() - radius, position.getY() - radius, position.getZ() );
+    box.addPoint( position.getX() + radius, position.getY() + radius, position.getZ() );
+    return box;
+}
+
 //------------------------------------------------------------------------------
 // CADArc
 //------------------------------------------------------------------------------
@@ -339,6 +549,30 @@ void CADArc::print() const
     "\t" << endingAngle << "\n" << endl;
 }
 
+CADBoundingBox CADArc::getBoundingBox() const
+{
+    // ends of the arc and the points where it crosses the axes
+    double sweep = fmod( endingAngle - startingAngle, 4 * dfHalfPi );
+    if( sweep <= 0 )
+        sweep += 4 * dfHalfPi;
+
+    CADBoundingBox box;
+    box.addPoint( position.getX() + radius * cos( startingAngle ),
+                  position.getY() + radius * sin( startingAngle ), position.getZ() );
+    box.addPoint( position.getX() + radius * cos( startingAngle + sweep ),
+                  position.getY() + radius * sin( startingAngle + sweep ), position.getZ() );
+    for( int quadrant = 0; quadrant < 4; ++quadrant )
+    {
+        double angle = fmod( quadrant * dfHalfPi - startingAngle, 4 * dfHalfPi );
+        if( angle < 0 )
+            angle += 4 * dfHalfPi;
+        if( angle <= sweep )
+            box.addPoint( position.getX() + radius * cos( quadrant * dfHalfPi ),
+                          position.getY() + radius * sin( quadrant * dfHalfPi ), position.getZ() );
+    }
+    return box;
+}
+
 //------------------------------------------------------------------------------
 // CADPolyline3D
 //------------------------------------------------------------------------------
@@ -395,17 +629,22 @@ void CADPolyline3D::print() const
 
 void CADPolyline3D::transform( const Matrix& matrix )
 {
-    for( CADVector& vertex : vertexes )
-    {
-        vertex = matrix.multiply( vertex );
-    }
+    matrix.multiply( vertexes.data(), vertexes.size() );
+}
+
+CADBoundingBox CADPolyline3D::getBoundingBox() const
+{
+    CADBoundingBox box;
+    for( const CADVector& vertex : vertexes )
+        box.addPoint( vertex );
+    return box;
 }
 
 //------------------------------------------------------------------------------
 // CADLWPolyline
 //------------------------------------------------------------------------------
 
-CADLWPolyline::CADLWPolyline()
+CADLWPolyline::CADLWPolyline() : bHasZ( false )
 {
     geometryType = CADGeometry::LWPOLYLINE;
 }
@@ -430,6 +669,16 @@ const CADVector& CADLWPolyline::getVertex(size_t index) const
     return vertexes[index];
 }
 
+const vector<CADVector>& CADLWPolyline::getVertexes() const
+{
+    return vertexes;
+}
+
+void CADLWPolyline::setVertexes( vector<CADVector> value )
+{
+    vertexes = std::move( value );
+}
+
 bool CADLWPolyline::isClosed() const
 {
 	return bClosed;
@@ -480,14 +729,14 @@ void CADLWPolyline::setVectExtrusion( const CADVector& value )
     vectExtrusion = value;
 }
 
-vector<pair<double, double> > CADLWPolyline::getWidths() const
+const vector<pair<double, double> >& CADLWPolyline::getWidths() const
 {
     return widths;
 }
 
-void CADLWPolyline::setWidths( const vector<pair<double, double> >& value )
+void CADLWPolyline::setWidths( vector<pair<double, double> > value )
 {
-    widths = value;
+    widths = std::move( value );
 }
 
 bool CADLWPolyline::hasBulges() const
@@ -495,14 +744,14 @@ bool CADLWPolyline::hasBulges() const
 	return hasNonZeroBulges;
 }
 
-vector<double> CADLWPolyline::getBulges() const
+const vector<double>& CADLWPolyline::getBulges() const
 {
     return bulges;
 }
 
-void CADLWPolyline::setBulges( const vector<double>& value )
+void CADLWPolyline::setBulges( vector<double> value )
 {
-    bulges = value;
+    bulges = std::move( value );
 	hasNonZeroBulges = false;
 	for ( size_t i = 0; i < bulges.size(); i++ )
 	{
@@ -514,18 +763,39 @@ void CADLWPolyline::setBulges( const vector<double>& value )
 	}
 }
 
+bool CADLWPolyline::getBHasZ() const
+{
+    return bHasZ;
+}
+
+void CADLWPolyline::setBHasZ( bool value )
+{
+    bHasZ = value;
+}
+
 void CADLWPolyline::transform( const Matrix& matrix )
 {
-	for (CADVector& vertex : vertexes)
-	{
-		vertex = matrix.multiply(vertex);
-	}
+    matrix.multiply( vertexes.data(), vertexes.size() );
+    bHasZ = true;
+}
+
+CADBoundingBox CADLWPolyline::getBoundingBox() const
+{
+    CADBoundingBox box;
+    for( size_t i = 0; i < vertexes.size(); ++i )
+    {
+        box.addPoint( vertexes[i] );
+        size_t next = i + 1 < vertexes.size() ? i + 1 : 0;
+        if( i < bulges.size() && bulges[i] != 0.0 && ( next != 0 || bClosed ) )
+            AddBulgedSegment( box, vertexes[i], vertexes[next], bulges[i] );
+    }
+    return box;
 }
 
 //------------------------------------------------------------------------------
 // CADPolyline2D
 //------------------------------------------------------------------------------
-CADPolyline2D::CADPolyline2D()
+CADPolyline2D::CADPolyline2D() : bHasZ( false )
 {
 	geometryType = CADGeometry::POLYLINE2D;
 }
@@ -545,6 +815,16 @@ CADVector& CADPolyline2D::getVertex( size_t index )
 	return vertexes[index];
 }
 
+const vector<CADVector>& CADPolyline2D::getVertexes() const
+{
+	return vertexes;
+}
+
+void CADPolyline2D::setVertexes( vector<CADVector> value )
+{
+	vertexes = std::move( value );
+}
+
 bool CADPolyline2D::isClosed() const
 {
 	return bClosed;
@@ -605,14 +885,14 @@ void CADPolyline2D::setVectExtrusion( const CADVector& value )
 	vectExtrusion = value;
 }
 
-vector<pair<double, double> > CADPolyline2D::getWidths() const
+const vector<pair<double, double> >& CADPolyline2D::getWidths() const
 {
 	return widths;
 }
 
-void CADPolyline2D::setWidths( const vector<pair<double, double> >& value )
+void CADPolyline2D::setWidths( vector<pair<double, double> > value )
 {
-	widths = value;
+	widths = std::move( value );
 }
 
 bool CADPolyline2D::hasBulges() const
@@ -620,14 +900,14 @@ bool CADPolyline2D::hasBulges() const
 	return hasNonZeroBulges;
 }
 
-vector<double> CADPolyline2D::getBulges() const
+const vector<double>& CADPolyline2D::getBulges() const
 {
 	return bulges;
 }
 
-void CADPolyline2D::setBulges( const vector<double>& value )
+void CADPolyline2D::setBulges( vector<double> value )
 {
-	bulges = value;
+	bulges = std::move( value );
 	hasNonZeroBulges = false;
 	for ( size_t i = 0; i < bulges.size(); i++ )
 	{
@@ -639,6 +919,16 @@ void CADPolyline2D::setBulges( const vector<double>& value )
 	}	
 }
 
+bool CADPolyline2D::getBHasZ() const
+{
+    return bHasZ;
+}
+
+void CADPolyline2D::setBHasZ( bool value )
+{
+    bHasZ = value;
+}
+
 void CADPolyline2D::print() const
 {
 	cout << "|------Polyline2D-----|" << endl;
@@ -651,10 +941,21 @@ void CADPolyline2D::print() const
 
 void CADPolyline2D::transform( const Matrix& matrix )
 {
-	for (CADVector& vertex : vertexes)
-	{
-		vertex = matrix.multiply(vertex);
-	}
+    matrix.multiply( vertexes.data(), vertexes.size() );
+    bHasZ = true;
+}
+
+CADBoundingBox CADPolyline2D::getBoundingBox() const
+{
+    CADBoundingBox box;
+    for( size_t i = 0; i < vertexes.size(); ++i )
+    {
+        box.addPoint( vertexes[i] );
+        size_t next = i + 1 < vertexes.size() ? i + 1 : 0;
+        if( i < bulges.size() && bulges[i] != 0.0 && ( next != 0 || bClosed ) )
+            AddBulgedSegment( box, vertexes[i], vertexes[next], bulges[i] );
+    }
+    return box;
 }
 
 //------------------------------------------------------------------------------
@@ -693,6 +994,19 @@ void CADEllipse::print() const
     endl;
 }
 
+CADBoundingBox CADEllipse::getBoundingBox() const
+{
+    // box of the whole ellipse, minor axis is perpendicular to the major one in XY
+    double ax = vectSMAxis.getX(), ay = vectSMAxis.getY(), az = vectSMAxis.getZ();
+    double halfX = sqrt( ax * ax + axisRatio * axisRatio * ay * ay );
+    double halfY = sqrt( ay * ay + axisRatio * axisRatio * ax * ax );
+
+    CADBoundingBox box;
+    box.addPoint( position.getX() - halfX, position.getY() - halfY, position.getZ() - fabs( az ) );
+    box.addPoint( position.getX() + halfX, position.getY() + halfY, position.getZ() + fabs( az ) );
+    return box;
+}
+
 //------------------------------------------------------------------------------
 // CADText
 //------------------------------------------------------------------------------
@@ -748,6 +1062,14 @@ void CADText::print() const
     "Text value:\t" << textValue << "\n" << std::endl;
 }
 
+CADBoundingBox CADText::getBoundingBox() const
+{
+    // Font metrics are unknown, every character is taken as wide as high.
+    CADBoundingBox box;
+    AddRotatedRect( box, position, 0, 0, height * textValue.size(), height, rotationAngle );
+    return box;
+}
+
 //------------------------------------------------------------------------------
 // CADRay
 //------------------------------------------------------------------------------
@@ -773,6 +1095,18 @@ void CADRay::print() const
     "\nVector:" << "\t" << extrusion.getX() << "\t" << extrusion.getY() << "\n" << std::endl;
 }
 
+CADBoundingBox CADRay::getBoundingBox() const
+{
+    // infinite in the direction of the ray
+    const double inf = numeric_limits<double>::infinity();
+    CADBoundingBox box;
+    box.addPoint( position );
+    box.addPoint( extrusion.getX() == 0 ? position.getX() : extrusion.getX() > 0 ? inf : -inf,
+                  extrusion.getY() == 0 ? position.getY() : extrusion.getY() > 0 ? inf : -inf,
+                  extrusion.getZ() == 0 ? position.getZ() : extrusion.getZ() > 0 ? inf : -inf );
+    return box;
+}
+
 //------------------------------------------------------------------------------
 // CADHatch
 //------------------------------------------------------------------------------
@@ -817,10 +1151,22 @@ void CADSpline::print() const
 
 void CADSpline::transform( const Matrix& matrix )
 {
-    for( CADVector& pt : avertCtrlPoints )
-        pt = matrix.multiply( pt );
-    for( CADVector& pt : averFitPoints )
-        pt = matrix.multiply( pt );
+    matrix.multiply( avertCtrlPoints.data(), avertCtrlPoints.size() );
+    matrix.multiply( averFitPoints.data(), averFitPoints.size() );
+}
+
+CADBoundingBox CADSpline::getBoundingBox() const
+{
+    // spline lies inside the convex hull of its control points
+    CADBoundingBox box;
+    for( const CADVector& pt : avertCtrlPoints )
+        box.addPoint( pt );
+    if( avertCtrlPoints.empty() )
+    {
+        for( const CADVector& pt : averFitPoints )
+            box.addPoint( pt );
+    }
+    return box;
 }
 
 long CADSpline::getScenario() const
@@ -868,6 +1214,21 @@ void CADSpline::addFitPoint( const CADVector& point )
     averFitPoints.push_back( point );
 }
 
+void CADSpline::setControlPointsWeights( vector<double> value )
+{
+    ctrlPointsWeight = std::move( value );
+}
+
+void CADSpline::setControlPoints( vector<CADVector> value )
+{
+    avertCtrlPoints = std::move( value );
+}
+
+void CADSpline::setFitPoints( vector<CADVector> value )
+{
+    averFitPoints = std::move( value );
+}
+
 bool CADSpline::getWeight() const
 {
     return weight;
@@ -936,8 +1297,18 @@ void CADSolid::print() const
 void CADSolid::transform( const Matrix& matrix )
 {
     CADPoint3D::transform( matrix );
-    for( CADVector& corner : avertCorners )
-        corner = matrix.multiply( corner );
+    matrix.multiply( avertCorners.data(), avertCorners.size() );
+}
+
+CADBoundingBox CADSolid::getBoundingBox() const
+{
+    if( avertCorners.empty() )
+        return CADPoint3D::getBoundingBox();
+
+    CADBoundingBox box;
+    for( const CADVector& corner : avertCorners )
+        box.addPoint( corner );
+    return box;
 }
 
 double CADSolid::getElevation() const
@@ -955,7 +1326,7 @@ void CADSolid::addCorner( const CADVector& corner )
     avertCorners.push_back( corner );
 }
 
-vector<CADVector> CADSolid::getCorners()
+const vector<CADVector>& CADSolid::getCorners() const
 {
     return avertCorners;
 }
@@ -1064,8 +1435,18 @@ void CADImage::print() const
 void CADImage::transform( const Matrix& matrix )
 {
     vertInsertionPoint = matrix.multiply( vertInsertionPoint );
-    for( CADVector& pt : avertClippingPolygon )
-        pt             = matrix.multiply( pt );
+    matrix.multiply( avertClippingPolygon.data(), avertClippingPolygon.size() );
+}
+
+CADBoundingBox CADImage::getBoundingBox() const
+{
+    // Image direction vectors are not kept, image is taken as not rotated.
+    CADBoundingBox box;
+    box.addPoint( vertInsertionPoint );
+    box.addPoint( vertInsertionPoint.getX() + imageSize.getX() * pixelSizeInACADUnits.getX(),
+                  vertInsertionPoint.getY() + imageSize.getY() * pixelSizeInACADUnits.getY(),
+                  vertInsertionPoint.getZ() );
+    return box;
 }
 
 void CADImage::addClippingPoint( const CADVector& pt )
@@ -1118,6 +1499,20 @@ void CADMText::print() const
     position.getZ() << "\n" << "Text: " << textValue << "\n" << std::endl;
 }
 
+CADBoundingBox CADMText::getBoundingBox() const
+{
+    // Text hangs down from the insertion point (top left attachment), size
+    // from the extents if they are known.
+    double width      = max( rectWidth, extentsWidth );
+    double textHeight = extents > 0 ? extents : height;
+    if( width <= 0 )
+        return CADText::getBoundingBox();
+
+    CADBoundingBox box;
+    AddRotatedRect( box, position, 0, -textHeight, width, 0, rotationAngle );
+    return box;
+}
+
 //------------------------------------------------------------------------------
 // CADFace3D
 //------------------------------------------------------------------------------
@@ -1150,10 +1545,15 @@ void CADFace3D::print() const
 
 void CADFace3D::transform( const Matrix& matrix )
 {
-    for( CADVector& corner : avertCorners )
-    {
-        corner = matrix.multiply( corner );
-    }
+    matrix.multiply( avertCorners.data(), avertCorners.size() );
+}
+
+CADBoundingBox CADFace3D::getBoundingBox() const
+{
+    CADBoundingBox box;
+    for( const CADVector& corner : avertCorners )
+        box.addPoint( corner );
+    return box;
 }
 
 short CADFace3D::getInvisFlags() const
@@ -1188,8 +1588,15 @@ void CADPolylinePFace::print() const
 
 void CADPolylinePFace::transform( const Matrix& matrix )
 {
-    for( CADVector& vertex : vertexes )
-        vertex = matrix.multiply( vertex );
+    matrix.multiply( vertexes.data(), vertexes.size() );
+}
+
+CADBoundingBox CADPolylinePFace::getBoundingBox() const
+{
+    CADBoundingBox box;
+    for( const CADVector& vertex : vertexes )
+        box.addPoint( vertex );
+    return box;
 }
 
 void CADPolylinePFace::addVertex( const CADVector& vertex )
@@ -1213,6 +1620,20 @@ void CADXLine::print() const
     extrusion.getZ() << "\n" << endl;
 }
 
+CADBoundingBox CADXLine::getBoundingBox() const
+{
+    // infinite in both directions
+    const double inf = numeric_limits<double>::infinity();
+    CADBoundingBox box;
+    box.addPoint( extrusion.getX() == 0 ? position.getX() : -inf,
+                  extrusion.getY() == 0 ? position.getY() : -inf,
+                  extrusion.getZ() == 0 ? position.getZ() : -inf );
+    box.addPoint( extrusion.getX() == 0 ? position.getX() : inf,
+                  extrusion.getY() == 0 ? position.getY() : inf,
+                  extrusion.getZ() == 0 ? position.getZ() : inf );
+    return box;
+}
+
 //------------------------------------------------------------------------------
 // CADMLine
 //------------------------------------------------------------------------------
@@ -1237,10 +1658,17 @@ void CADMLine::print() const
 void CADMLine::transform( const Matrix& matrix )
 {
     CADPoint3D::transform( matrix );
-    for( CADVector& vertex : avertVertexes )
-    {
-        vertex = matrix.multiply( vertex );
-    }
+    matrix.multiply( avertVertexes.data(), avertVertexes.size() );
+}
+
+CADBoundingBox CADMLine::getBoundingBox() const
+{
+    CADBoundingBox box;
+    for( const CADVector& vertex : avertVertexes )
+        box.addPoint( vertex );
+    if( box.isEmpty() )
+        return CADPoint3D::getBoundingBox();
+    return box;
 }
 
 double CADMLine::getScale() const
@@ -1289,6 +1717,13 @@ void CADAttrib::transform( const Matrix& matrix )
     vertAlignmentPoint = matrix.multiply( vertAlignmentPoint );
 }
 
+CADBoundingBox CADAttrib::getBoundingBox() const
+{
+    CADBoundingBox box = CADText::getBoundingBox();
+    box.addPoint( vertAlignmentPoint );
+    return box;
+}
+
 double CADAttrib::getElevation() const
 {
     return dfElevation;
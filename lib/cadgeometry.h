@@ -43,18 +43,63 @@ class CADAttdef;
 class CADAttrib;
 
 /**
- * @brief The Matrix class
+ * @brief The Matrix class. 3D affine transformation, stored as 3x4 row-major
+ * matrix. translate(), rotate(), scale() and extrude() are applied to vectors
+ * before the transformations set up earlier, so block reference transformation
+ * is set up in the order: extrude, translate, rotate, scale.
  */
 class Matrix
 {
 public:
               Matrix();
     void      translate( const CADVector& vector );
+    /**
+     * @brief Rotate around Z axis, angle in radians
+     */
     void      rotate( double rotation );
     void      scale( const CADVector& vector );
+    /**
+     * @brief Transform from object coordinate system of the extrusion
+     * (arbitrary axis algorithm) to world coordinates
+     */
+    void      extrude( const CADVector& extrusion );
     CADVector multiply( const CADVector& vector ) const;
+    /**
+     * @brief Multiply count vectors in place
+     */
+    void      multiply( CADVector * vectors, size_t count ) const;
+    /**
+     * @brief Combine transformations, the result applies matrix first and
+     * this one then (nested block reference in its parent block reference)
+     */
+    Matrix    multiply( const Matrix& matrix ) const;
 protected:
-    array<double, 9> matrix;
+    array<double, 12> matrix;
+};
+
+/**
+ * @brief Axis aligned bounding box. Default constructed box is empty and grows
+ * with the points added to it. Unbounded geometries (rays, xlines) have
+ * infinite coordinates.
+ */
+class CADBoundingBox
+{
+public:
+              CADBoundingBox();
+              CADBoundingBox( const CADVector& minIn, const CADVector& maxIn );
+    bool      isEmpty() const;
+    CADVector getMin() const;
+    CADVector getMax() const;
+    void      addPoint( const CADVector& point );
+    void      addPoint( double x, double y, double z );
+    void      addBox( const CADBoundingBox& box );
+    /**
+     * @brief returns true if boxes overlap in XY plane, touching boxes overlap
+     */
+    bool      intersectsXY( const CADBoundingBox& box ) const;
+protected:
+    double minX, minY, minZ;
+    double maxX, maxY, maxZ;
 };
 
 /**
@@ -100,14 +145,22 @@ public:
     RGBColor          getColor() const;
     void              setColor( RGBColor color );// TODO: in 2004+ ACI is not the only way to set the color.
 
-    vector<CADAttrib> getBlockAttributes() const;
-    void              setBlockAttributes( const vector<CADAttrib>& value );
+    // Containers are returned by reference and taken by value, pass them to
+    // setters with std::move() to avoid copying.
+    const vector<CADAttrib>& getBlockAttributes() const;
+    void                     setBlockAttributes( vector<CADAttrib> value );
 
-    vector<string> getEED() const;
-    void           setEED( vector<string> eed );
+    const vector<string>& getEED() const;
+    void                  setEED( vector<string> eed );
 
     virtual void print() const                     = 0;
     virtual void transform( const Matrix& matrix ) = 0;
+    /**
+     * @brief Box which contains the whole geometry. It may be larger than the
+     * exact extent for curves and texts. Empty box if the geometry has no
+     * position, as CADUnknown.
+     */
+    virtual CADBoundingBox getBoundingBox() const;
 protected:
     vector<CADAttrib> blockAttributes; // attributes of block reference this geometry is attached to.
 
@@ -148,6 +201,7 @@ public:
 
     virtual void print() const override;
     virtual void transform( const Matrix& matrix ) override;
+    virtual CADBoundingBox getBoundingBox() const override;
 protected:
     CADVector position;
     CADVector extrusion;
@@ -171,6 +225,7 @@ public:
 
     virtual void print() const override;
     virtual void transform( const Matrix& matrix ) override;
+    virtual CADBoundingBox getBoundingBox() const override;
 protected:
     CADPoint3D start;
     CADPoint3D end;
@@ -187,6 +242,8 @@ public:
 	void	   addVertex(const CADVector& vertex);
 	size_t	   getVertexCount() const;
 	CADVector& getVertex(size_t index);
+	const vector<CADVector>& getVertexes() const;
+	void                     setVertexes( vector<CADVector> value );
 
 	bool isClosed() const;
 	void setClosed(bool state);
@@ -206,15 +263,23 @@ public:
 	CADVector getVectExtrusion() const;
 	void      setVectExtrusion( const CADVector& value );
 
-	vector<pair<double, double> > getWidths() const;
-	void                          setWidths(const vector<pair<double, double> >& value);
+	const vector<pair<double, double> >& getWidths() const;
+	void                                 setWidths( vector<pair<double, double> > value );
 
-	bool		   hasBulges() const; // true if any vertexes have non zero bulges
-	vector<double> getBulges() const;
-	void           setBulges(const vector<double>& value);
+	bool		          hasBulges() const; // true if any vertexes have non zero bulges
+	const vector<double>& getBulges() const;
+	void                  setBulges( vector<double> value );
+
+    /**
+     * @brief returns true if Z of vertexes is set, vertexes are 2D and lie on
+     * elevation until they are transformed
+     */
+    bool getBHasZ() const;
+    void setBHasZ( bool value );
 
 	virtual void print() const override;
 	virtual void transform( const Matrix& matrix ) override;
+	virtual CADBoundingBox getBoundingBox() const override;
 
 protected:
 	bool						  bClosed;
@@ -227,6 +292,7 @@ protected:
 	vector<double>				  bulges;
 	vector<pair<double, double> > widths; // start, end.
 	vector<CADVector>	          vertexes;
+	bool                          bHasZ;
 };
 
 
@@ -250,6 +316,7 @@ public:
 
     virtual void print() const override;
     virtual void transform( const Matrix& matrix ) override;
+    virtual CADBoundingBox getBoundingBox() const override;
 
 protected:
 	bool			  bClosed;
@@ -270,6 +337,8 @@ public:
 	size_t	   getVertexCount() const;
 	CADVector& getVertex(size_t index);
 	const CADVector& getVertex(size_t index) const;
+	const vector<CADVector>& getVertexes() const;
+	void                     setVertexes( vector<CADVector> value );
 
 	bool isClosed() const;
 	void setClosed(bool state);
@@ -283,15 +352,23 @@ public:
     CADVector getVectExtrusion() const;
     void      setVectExtrusion( const CADVector& value );
 
-    vector<pair<double, double> > getWidths() const;
-    void                          setWidths( const vector<pair<double, double> >& value );
+    const vector<pair<double, double> >& getWidths() const;
+    void                                 setWidths( vector<pair<double, double> > value );
 
-	bool		   hasBulges() const; // true if any vertexes have non zero bulges
-    vector<double> getBulges() const;
-    void           setBulges( const vector<double>& value );
+	bool		          hasBulges() const; // true if any vertexes have non zero bulges
+    const vector<double>& getBulges() const;
+    void                  setBulges( vector<double> value );
+
+    /**
+     * @brief returns true if Z of vertexes is set, vertexes are 2D and lie on
+     * elevation until they are transformed
+     */
+    bool getBHasZ() const;
+    void setBHasZ( bool value );
 
     virtual void print() const override;
 	virtual void transform(const Matrix& matrix) override;
+	virtual CADBoundingBox getBoundingBox() const override;
 
 protected:
 	bool						  bClosed;
@@ -302,6 +379,7 @@ protected:
     vector<double>                bulges;
     vector<pair<double, double> > widths; // start, end.
 	vector<CADVector>		      vertexes;
+    bool                          bHasZ;
 };
 
 /**
@@ -316,6 +394,7 @@ public:
     void   setRadius( double value );
 
     virtual void print() const override;
+    virtual CADBoundingBox getBoundingBox() const override;
 protected:
     double radius;
 };
@@ -341,6 +420,7 @@ public:
     void   setObliqueAngle( double value );
 
     virtual void print() const override;
+    virtual CADBoundingBox getBoundingBox() const override;
 protected:
     double obliqueAngle;
     double rotationAngle;
@@ -363,6 +443,7 @@ public:
     void   setEndingAngle( double value );
 
     virtual void print() const override;
+    virtual CADBoundingBox getBoundingBox() const override;
 protected:
     double startingAngle;
     double endingAngle;
@@ -383,6 +464,7 @@ public:
     void      setSMAxis( const CADVector& vectSMA );
 
     virtual void print() const override;
+    virtual CADBoundingBox getBoundingBox() const override;
 protected:
     CADVector vectSMAxis;
     double    axisRatio;
@@ -412,6 +494,9 @@ public:
     void addControlPointsWeight( double p_weight );
     void addControlPoint( const CADVector& point );
     void addFitPoint( const CADVector& point );
+    void setControlPointsWeights( vector<double> value );
+    void setControlPoints( vector<CADVector> value );
+    void setFitPoints( vector<CADVector> value );
 
     bool getWeight() const;
     void setWeight( bool value );
@@ -424,6 +509,7 @@ public:
 
     virtual void print() const override;
     virtual void transform( const Matrix& matrix ) override;
+    virtual CADBoundingBox getBoundingBox() const override;
 protected:
     long   scenario;
     bool   rational;
@@ -448,10 +534,11 @@ public:
     double getElevation() const;
     void   setElevation( double value );
     void   addCorner( const CADVector& corner );
-    vector<CADVector> getCorners();
+    const vector<CADVector>& getCorners() const;
 
     virtual void print() const override;
     virtual void transform( const Matrix& matrix ) override;
+    virtual CADBoundingBox getBoundingBox() const override;
 protected:
     double            elevation;
     vector<CADVector> avertCorners;
@@ -469,6 +556,7 @@ public:
     void      setVectVector( const CADVector& value );
 
     virtual void print() const override;
+    virtual CADBoundingBox getBoundingBox() const override;
 };
 
 /**
@@ -523,6 +611,7 @@ public:
 
     virtual void print() const override;
     virtual void transform( const Matrix& matrix ) override;
+    virtual CADBoundingBox getBoundingBox() const override;
 protected:
     CADVector     vertInsertionPoint;
     //CADVector vectUDirection;
@@ -566,6 +655,7 @@ public:
     void   setExtentsWidth( double value );
 
     virtual void print() const override;
+    virtual CADBoundingBox getBoundingBox() const override;
 protected:
     double rectWidth;
     double extents;
@@ -596,6 +686,7 @@ public:
 
     virtual void print() const override;
     virtual void transform( const Matrix& matrix ) override;
+    virtual CADBoundingBox getBoundingBox() const override;
 protected:
     vector<CADVector> avertCorners;
     short             invisFlags;
@@ -613,6 +704,7 @@ public:
 
     virtual void print() const override;
     virtual void transform( const Matrix& matrix ) override;
+    virtual CADBoundingBox getBoundingBox() const override;
 protected:
     vector<CADVector> vertexes;
 };
@@ -626,6 +718,7 @@ public:
     CADXLine();
 
     virtual void print() const override;
+    virtual CADBoundingBox getBoundingBox() const override;
 };
 
 /**
@@ -646,6 +739,7 @@ public:
 
     virtual void print() const override;
     virtual void transform( const Matrix& matrix ) override;
+    virtual CADBoundingBox getBoundingBox() const override;
 protected:
     double            scale;
     //char dJust;
@@ -676,6 +770,7 @@ public:
 
     virtual void print() const override;
     virtual void transform( const Matrix& matrix ) override;
+    virtual CADBoundingBox getBoundingBox() const override;
 protected:
     CADVector vertAlignmentPoint;
     double    dfElevation;
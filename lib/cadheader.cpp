@@ -147,59 +147,31 @@ static const CADHeaderConstantDetail CADHeaderConstantDetails[]{
 // CADHandle
 //------------------------------------------------------------------------------
 
-CADHandle::CADHandle( unsigned char codeIn ) : code( codeIn )
+CADHandle::CADHandle( unsigned char codeIn ) : code( codeIn ), size( 0 ), value( 0 )
 {
 }
 
-CADHandle::CADHandle( const CADHandle& other )
-{
-    code           = other.code;
-    handleOrOffset = other.handleOrOffset;
-}
-
-CADHandle& CADHandle::operator=( const CADHandle& other )
-{
-    if( this == & other )
-        return * this;
-    code           = other.code;
-    handleOrOffset = other.handleOrOffset;
-    return * this;
-}
-
 void CADHandle::addOffset( unsigned char val )
 {
-    handleOrOffset.push_back( val );
+    // Corrupted files may have handles longer than long, high bytes are
+    // shifted out then.
+    value = ( value << 8 ) | val;
+    if( size < 0xFF )
+        ++size;
 }
 
 long CADHandle::getAsLong( const CADHandle& ref_handle ) const
 {
-    long result = 0;
     switch( code )
     {
         case 0x06:
-        {
-            memcpy( & result, ref_handle.handleOrOffset.data(), ref_handle.handleOrOffset.size() );
-            SwapEndianness( result, ref_handle.handleOrOffset.size() );
-            return result + 1;
-        }
+            return ref_handle.getAsLong() + 1;
         case 0x08:
-        {
-            memcpy( & result, ref_handle.handleOrOffset.data(), ref_handle.handleOrOffset.size() );
-            SwapEndianness( result, ref_handle.handleOrOffset.size() );
-            return result - 1;
-        }
+            return ref_handle.getAsLong() - 1;
         case 0x0A:
-        {
-            memcpy( & result, ref_handle.handleOrOffset.data(), ref_handle.handleOrOffset.size() );
-            SwapEndianness( result, ref_handle.handleOrOffset.size() );
-            return result + this->getAsLong();
-        }
+            return ref_handle.getAsLong() + this->getAsLong();
         case 0x0C:
-        {
-            memcpy( & result, ref_handle.handleOrOffset.data(), ref_handle.handleOrOffset.size() );
-            SwapEndianness( result, ref_handle.handleOrOffset.size() );
-            return result - this->getAsLong();
-        }
+            return ref_handle.getAsLong() - this->getAsLong();
     }
 
     return this->getAsLong();
@@ -207,15 +179,12 @@ long CADHandle::getAsLong( const CADHandle& ref_handle ) const
 
 long CADHandle::getAsLong() const
 {
-    long result = 0;
-    memcpy( & result, handleOrOffset.data(), handleOrOffset.size() );
-    SwapEndianness( result, handleOrOffset.size() );
-    return result;
+    return static_cast<long>( value );
 }
 
 bool CADHandle::isNull() const
 {
-    return handleOrOffset.size() == 0 ? true : false;
+    return size == 0;
 }
 
 //------------------------------------------------------------------------------
@@ -414,19 +383,57 @@ CADVariant::CADVariant( time_t val, bool bIsTime )
 // CADHeader
 //------------------------------------------------------------------------------
 
-CADHeader::CADHeader()
+CADHeader::CADHeader() : pfnRawValueDecoder( nullptr )
 {
 }
 
-int CADHeader::addValue( short code, const CADVariant& val )
+int CADHeader::addSlot( short code, int nIndex, bool bRaw )
 {
-    if( valuesMap.find( code ) != valuesMap.end() )
+    // codes are non-negative CADHeaderConstants
+    if( code < 0 )
         return CADErrorCodes::VALUE_EXISTS;
 
-    valuesMap[code] = val;
+    size_t nSlot = static_cast<size_t>( code );
+    if( nSlot >= astValueSlots.size() )
+    {
+        ValueSlot stEmpty = { -1, false };
+        astValueSlots.resize( nSlot + 1, stEmpty );
+    }
+    if( astValueSlots[nSlot].nIndex != -1 )
+        return CADErrorCodes::VALUE_EXISTS;
+
+    astValueSlots[nSlot].nIndex = nIndex;
+    astValueSlots[nSlot].bRaw   = bRaw;
     return CADErrorCodes::SUCCESS;
 }
 
+int CADHeader::addValue( short code, const CADVariant& val )
+{
+    int nResult = addSlot( code, static_cast<int>( aoValues.size() ), false );
+    if( nResult == CADErrorCodes::SUCCESS )
+        aoValues.push_back( val );
+    return nResult;
+}
+
+void CADHeader::setRawData( std::vector<char>&& abyData, RawValueDecoder pfnDecoder )
+{
+    abyRawData         = std::move( abyData );
+    pfnRawValueDecoder = pfnDecoder;
+    for( RawValue& stValue : astRawValues )
+        stValue.poDecoded.reset();
+}
+
+int CADHeader::addRawValue( short code, size_t nBitOffset, short nRawType )
+{
+    int nResult = addSlot( code, static_cast<int>( astRawValues.size() ), true );
+    if( nResult == CADErrorCodes::SUCCESS )
+    {
+        RawValue stValue = { nBitOffset, nRawType, nullptr };
+        astRawValues.push_back( stValue );
+    }
+    return nResult;
+}
+
 int CADHeader::addValue( short code, const char * val )
 {
     return addValue( code, CADVariant( val ) );
@@ -472,10 +479,14 @@ int CADHeader::addValue( short code, long julianday, long milliseconds )
     // unix -> julian        return ( unixSecs / 86400.0 ) + 2440587.5;
     // julian -> unix        return (julian - 2440587.5) * 86400.0
 
+    return addValue( code, CADVariant( julianDayToTime( julianday, milliseconds ) ) );
+}
+
+time_t CADHeader::julianDayToTime( long julianday, long milliseconds )
+{
     double seconds     = double( milliseconds ) / 1000;
     double unix        = ( double( julianday ) - 2440587.5 ) * 86400.0;
-    time_t fullSeconds = static_cast<time_t>(unix + seconds);
-    return addValue( code, CADVariant( fullSeconds ) );
+    return static_cast<time_t>(unix + seconds);
 }
 
 int CADHeader::getGroupCode( short code ) const
@@ -491,11 +502,27 @@ int CADHeader::getGroupCode( short code ) const
 
 const CADVariant CADHeader::getValue( short code, const CADVariant& val ) const
 {
-    auto it = valuesMap.find( code );
-    if( it != valuesMap.end() )
-        return it->second;
-    else
+    if( code < 0 || static_cast<size_t>( code ) >= astValueSlots.size() )
         return val;
+
+    const ValueSlot& stSlot = astValueSlots[static_cast<size_t>( code )];
+    if( stSlot.nIndex == -1 )
+        return val;
+    if( !stSlot.bRaw )
+        return aoValues[stSlot.nIndex];
+    if( pfnRawValueDecoder == nullptr )
+        return val;
+
+    const RawValue& stRaw = astRawValues[stSlot.nIndex];
+    std::shared_ptr<const CADVariant> poValue = std::atomic_load( &stRaw.poDecoded );
+    if( !poValue )
+    {
+        // Concurrent first calls may decode the value twice, the last one is kept.
+        poValue = std::make_shared<CADVariant>(
+                pfnRawValueDecoder( abyRawData.data(), abyRawData.size(), stRaw.nBitOffset, stRaw.nRawType ) );
+        std::atomic_store( &stRaw.poDecoded, poValue );
+    }
+    return * poValue;
 }
 
 const char * CADHeader::getValueName( short code ) const
@@ -511,20 +538,26 @@ const char * CADHeader::getValueName( short code ) const
 void CADHeader::print() const
 {
     cout << "============ HEADER Section ============" << endl;
-    for( auto it : valuesMap )
+    for( size_t i = 0; i < astValueSlots.size(); ++i )
     {
-        cout << getValueName( it.first ) << ": " << it.second.getString() << endl;
+        if( astValueSlots[i].nIndex == -1 )
+            continue;
+        short code = static_cast<short>( i );
+        cout << getValueName( code ) << ": " << getValue( code ).getString() << endl;
     }
 }
 
 size_t CADHeader::getSize() const
 {
-    return valuesMap.size();
+    return aoValues.size() + astRawValues.size();
 }
 
 short CADHeader::getCode( int index ) const
 {
-    auto it = valuesMap.begin();
-    advance( it, index );
-    return it->first;
+    for( size_t i = 0; i < astValueSlots.size(); ++i )
+    {
+        if( astValueSlots[i].nIndex != -1 && index-- == 0 )
+            return static_cast<short>( i );
+    }
+    return -1;
 }
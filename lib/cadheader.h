@@ -33,24 +33,28 @@
 
 #include "opencad.h"
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 #include <ctime>
 
+/**
+ * @brief Handle or handle offset. Bytes are accumulated into a long as they
+ * are added, so handle is trivially copyable and never allocates.
+ */
 class OCAD_EXTERN CADHandle final
 {
 public:
     CADHandle( unsigned char codeIn = 0 );
-    CADHandle( const CADHandle& other );
-    CADHandle& operator=( const CADHandle& other );
 
     void addOffset( unsigned char val );
     bool isNull() const;
     long getAsLong() const;
     long getAsLong( const CADHandle& ref_handle ) const;
 protected:
-    unsigned char              code;
-    std::vector<unsigned char> handleOrOffset;
+    unsigned char code;
+    unsigned char size;  // count of added bytes
+    unsigned long value; // added bytes, big endian. Only the lowest sizeof(long) are kept.
 };
 
 class OCAD_EXTERN CADVariant final
@@ -670,6 +674,13 @@ public:
         MAX_HEADER_CONSTANT = 1000 /**< max + num for user constants */
 
     };
+public:
+    /**
+     * @brief Decodes value of nRawType stored at nBitOffset of the raw header
+     * data, see setRawData() and addRawValue().
+     */
+    typedef CADVariant (*RawValueDecoder)( const char * pabyData, size_t nSize, size_t nBitOffset,
+                                           short nRawType );
 public:
                      CADHeader();
     /**
@@ -688,14 +699,57 @@ public:
     int              addValue( short code, bool val );
     int              addValue( short code, double x, double y, double z = 0 );
     int              addValue( short code, long julianday, long milliseconds );
+    /**
+     * @brief Keep the raw header section, values added by addRawValue() are
+     * decoded from it by pfnDecoder on access only.
+     * @param abyData Raw header data
+     * @param pfnDecoder Format specific value decoder
+     */
+    void             setRawData( std::vector<char>&& abyData, RawValueDecoder pfnDecoder );
+    /**
+     * @brief Add new value which is not decoded yet
+     * @param code The code from constants enum
+     * @param nBitOffset Value position in the raw data
+     * @param nRawType Value type, understood by raw data decoder
+     * @return SUCCESS or some value from CADErrorCodes
+     */
+    int              addRawValue( short code, size_t nBitOffset, short nRawType );
     int              getGroupCode( short code ) const;
+    /**
+     * @brief Get value, raw values are decoded on the first call and kept.
+     * Thread safe.
+     * @param code The code from constants enum
+     * @param val Value to return if the header has no such code
+     */
     const CADVariant getValue( short code, const CADVariant& val = CADVariant() ) const;
     const char * getValueName( short code ) const;
     void   print() const;
     size_t getSize() const;
     short  getCode( int index ) const;
+    static time_t    julianDayToTime( long julianday, long milliseconds );
+protected:
+    struct RawValue
+    {
+        size_t nBitOffset;
+        short  nRawType;
+        // decoded value, set on the first access
+        mutable std::shared_ptr<const CADVariant> poDecoded;
+    };
+    // Slot in the code indexed table: nIndex of the value in aoValues or, if
+    // bRaw, in astRawValues. -1 if code is not set.
+    struct ValueSlot
+    {
+        int  nIndex;
+        bool bRaw;
+    };
+
+    int addSlot( short code, int nIndex, bool bRaw );
 protected:
-    std::map<short, CADVariant> valuesMap;
+    std::vector<ValueSlot>  astValueSlots;
+    std::vector<CADVariant> aoValues;
+    std::vector<RawValue>   astRawValues;
+    std::vector<char>       abyRawData;
+    RawValueDecoder         pfnRawValueDecoder;
 };
 
 #endif // CADHEADER_H
@@ -30,6 +30,7 @@
  *******************************************************************************/
 #include "cadlayer.h"
 #include "cadfile.h"
+#include "cadspatialindex.h"
 
 #include <cassert>
 #include <iostream>
@@ -148,21 +149,33 @@ void CADLayer::addHandle( long handle, CADObject::ObjectType type, long cadinser
 #endif //_DEBUG
     if( type == CADObject::ATTRIB || type == CADObject::ATTDEF )
     {
+        // filtered out attributes are not decoded at all
+        if( !pCADFile->isGeometryTypeAccepted( type ) )
+            return;
+
         unique_ptr<CADAttdef> attdef( static_cast< CADAttdef *>( pCADFile->GetGeometry( this->getId() - 1, handle ) ) );
+        if( attdef == nullptr )
+            return;
 
         attributesNames.insert( attdef->getTag() );
     }
 
+    if( type == CADObject::INSERT && !pCADFile->isExpandingBlockReferences() )
+    {
+        blockReferenceHandles.push_back( handle );
+        return;
+    }
+
     if( type == CADObject::INSERT )
     {
         // TODO: transform insert to block of objects (do we need to transform
         // coordinates according to insert point)?
-        unique_ptr<CADObject> insert( pCADFile->GetObject( handle, false ) );
-        CADInsertObject * pInsert = static_cast<CADInsertObject *>(insert.get());
+        shared_ptr<const CADObject> insert = pCADFile->GetCachedObject( handle );
+        const CADInsertObject * pInsert = static_cast<const CADInsertObject *>(insert.get());
         if( nullptr != pInsert )
         {
-            unique_ptr<CADObject> blockHeader( pCADFile->GetObject( pInsert->hBlockHeader.getAsLong(), false ) );
-            CADBlockHeaderObject * pBlockHeader = static_cast<CADBlockHeaderObject *>(blockHeader.get());
+            shared_ptr<const CADObject> blockHeader = pCADFile->GetCachedObject( pInsert->hBlockHeader.getAsLong() );
+            const CADBlockHeaderObject * pBlockHeader = static_cast<const CADBlockHeaderObject *>(blockHeader.get());
             if( nullptr != pBlockHeader )
             {
 #ifdef _DEBUG
@@ -178,21 +191,23 @@ void CADLayer::addHandle( long handle, CADObject::ObjectType type, long cadinser
                 if( dCurrentEntHandle == dLastEntHandle ) // Blocks can be empty (contain no objects)
                     return;
 
+                // nested reference is placed in the block of its parent reference
+                Matrix transformation = CADFile::GetBlockReferenceTransformation( pInsert, pBlockHeader );
+                auto iterParent = transformations.find( handle );
+                if( cadinserthandle != 0 && iterParent != transformations.end() )
+                    transformation = iterParent->second.multiply( transformation );
+
                 while( true )
                 {
-                    unique_ptr<CADEntityObject> entity( static_cast< CADEntityObject * >(
-                                                                pCADFile->GetObject( dCurrentEntHandle, true ) ) );
+                    CADEntityProbe entity;
+                    bool bEntityRead = pCADFile->ProbeEntity( dCurrentEntHandle, entity );
 
                     if( dCurrentEntHandle == dLastEntHandle )
                     {
-                        if( entity != nullptr )
+                        if( bEntityRead )
                         {
-                            addHandle( dCurrentEntHandle, entity->getType(), handle );
-                            Matrix mat;
-                            mat.translate( pInsert->vertInsertionPoint );
-                            mat.scale( pInsert->vertScales );
-                            mat.rotate( pInsert->dfRotation );
-                            transformations[dCurrentEntHandle] = mat;
+                            transformations[dCurrentEntHandle] = transformation;
+                            addHandle( dCurrentEntHandle, entity.eType, handle );
                             break;
                         } else
                         {
@@ -200,22 +215,19 @@ void CADLayer::addHandle( long handle, CADObject::ObjectType type, long cadinser
                         }
                     }
 
-                    if( entity != nullptr )
+                    if( bEntityRead )
                     {
-                        addHandle( dCurrentEntHandle, entity->getType(), handle );
-                        Matrix mat;
-                        mat.translate( pInsert->vertInsertionPoint );
-                        mat.scale( pInsert->vertScales );
-                        mat.rotate( pInsert->dfRotation );
-                        transformations[dCurrentEntHandle] = mat;
-
-                        if( entity->stCed.bNoLinks )
+                        transformations[dCurrentEntHandle] = transformation;
+                        addHandle( dCurrentEntHandle, entity.eType, handle );
+
+                        if( entity.bNoLinks )
                             ++dCurrentEntHandle;
                         else
-                            dCurrentEntHandle = entity->stChed.hNextEntity.getAsLong( entity->stCed.hObjectHandle );
+                            dCurrentEntHandle = entity.nNextEntity;
                     } else
                     {
                         assert ( 0 );
+                        break;
                     }
                 }
             }
@@ -225,6 +237,9 @@ void CADLayer::addHandle( long handle, CADObject::ObjectType type, long cadinser
 
     if( isCommonEntityType( type ) )
     {
+        if( !pCADFile->isGeometryTypeAccepted( type ) )
+            return;
+
         if( type == CADObject::IMAGE )
             imageHandles.push_back( handle );
         else
@@ -256,13 +271,20 @@ void CADLayer::addHandle( long handle, CADObject::ObjectType type, long cadinser
     }
 }
 
+void CADLayer::fillLayers() const
+{
+    pCADFile->oTables.FillLayers( pCADFile );
+}
+
 size_t CADLayer::getGeometryCount() const
 {
+    fillLayers();
     return geometryHandles.size();
 }
 
 CADGeometry * CADLayer::getGeometry( size_t index )
 {
+    fillLayers();
     auto handleBlockRefPair = geometryHandles[index];
     CADGeometry * pGeom = pCADFile->GetGeometry( this->getId() - 1, handleBlockRefPair.first,
                                                  handleBlockRefPair.second );
@@ -277,16 +299,83 @@ CADGeometry * CADLayer::getGeometry( size_t index )
     return pGeom;
 }
 
+vector<CADGeometry *> CADLayer::getGeometries( const vector<size_t>& indexes )
+{
+    fillLayers();
+    vector<long> handles;
+    handles.reserve( indexes.size() );
+    for( size_t index : indexes )
+        handles.push_back( geometryHandles[index].first );
+
+    vector<CADGeometry *> geometries( indexes.size(), nullptr );
+    pCADFile->ReadInFileOrder( handles, [&]( size_t i )
+    {
+        geometries[i] = getGeometry( indexes[i] );
+    } );
+    return geometries;
+}
+
+void CADLayer::buildSpatialIndex()
+{
+    fillLayers();
+    vector<long> handles;
+    handles.reserve( geometryHandles.size() );
+    for( const pair<long, long>& handleBlockRefPair : geometryHandles )
+        handles.push_back( handleBlockRefPair.first );
+
+    vector<CADBoundingBox> boxes( geometryHandles.size() );
+    pCADFile->ReadInFileOrder( handles, [&]( size_t i )
+    {
+        CADGeometry * geometry = getGeometry( i );
+        if( geometry != nullptr )
+            boxes[i] = geometry->getBoundingBox();
+        delete geometry;
+    } );
+
+    // Concurrent first queries may build it twice, the last one is kept.
+    atomic_store( &poSpatialIndex, shared_ptr<const CADSpatialIndex>( new CADSpatialIndex( boxes ) ) );
+}
+
+vector<size_t> CADLayer::queryIndexes( const CADBoundingBox& box )
+{
+    shared_ptr<const CADSpatialIndex> index = atomic_load( &poSpatialIndex );
+    if( !index )
+    {
+        buildSpatialIndex();
+        index = atomic_load( &poSpatialIndex );
+    }
+    return index->query( box );
+}
+
+vector<CADGeometry *> CADLayer::query( const CADBoundingBox& box )
+{
+    return getGeometries( queryIndexes( box ) );
+}
+
 size_t CADLayer::getImageCount() const
 {
+    fillLayers();
     return imageHandles.size();
 }
 
 CADImage * CADLayer::getImage( size_t index )
 {
+    fillLayers();
     return static_cast<CADImage *>(pCADFile->GetGeometry( this->getId() - 1, imageHandles[index] ));
 }
 
+size_t CADLayer::getBlockReferenceCount() const
+{
+    fillLayers();
+    return blockReferenceHandles.size();
+}
+
+CADBlockReference CADLayer::getBlockReference( size_t index )
+{
+    fillLayers();
+    return pCADFile->GetBlockReference( this->getId() - 1, blockReferenceHandles[index] );
+}
+
 bool CADLayer::addAttribute( const CADObject * pObject )
 {
     if( nullptr == pObject )
@@ -305,12 +394,14 @@ bool CADLayer::addAttribute( const CADObject * pObject )
     return false;
 }
 
-vector<CADObject::ObjectType> CADLayer::getGeometryTypes()
+const vector<CADObject::ObjectType>& CADLayer::getGeometryTypes()
 {
+    fillLayers();
     return geometryTypes;
 }
 
-unordered_set<string> CADLayer::getAttributesTags()
+const unordered_set<string>& CADLayer::getAttributesTags()
 {
+    fillLayers();
     return attributesNames;
 }
@@ -31,12 +31,14 @@
 #ifndef CADLAYER_H
 #define CADLAYER_H
 
+#include "cadblock.h"
 #include "cadgeometry.h"
 
 #include <memory>
 #include <unordered_set>
 
 class CADFile;
+class CADSpatialIndex;
 
 using namespace std;
 
@@ -74,23 +76,57 @@ public:
     long getHandle() const;
     void setHandle( long value );
 
-    unordered_set<string> getAttributesTags();
+    const unordered_set<string>& getAttributesTags();
 
     // cadinserthandle is 0 by default because if entity isn't a part of custom block - it's a part of ModelSpace block.
     void addHandle( long handle, enum CADObject::ObjectType type, long cadinserthandle = 0 );
 
     size_t getGeometryCount() const;
     CADGeometry * getGeometry( size_t index );
+    /**
+     * @brief Read several geometries at once. Geometries are read in the order
+     * of objects in file, objects lying close to each other with one file read.
+     * @param indexes Indexes of geometries, as for getGeometry()
+     * @return geometries in the order of indexes, nullptr if failed. Pointers
+     * have to be freed by user
+     */
+    vector<CADGeometry *> getGeometries( const vector<size_t>& indexes );
+    /**
+     * @brief Build spatial index of the geometry bounding boxes, every geometry
+     * is read once for it. If not called, the first query builds the index.
+     */
+    void buildSpatialIndex();
+    /**
+     * @brief Find geometries which bounding boxes intersect box in XY plane
+     * @param box Box to search, e.g. a map tile
+     * @return indexes of geometries in ascending order, as for getGeometry()
+     */
+    vector<size_t> queryIndexes( const CADBoundingBox& box );
+    /**
+     * @brief Read geometries which bounding boxes intersect box in XY plane
+     * @param box Box to search, e.g. a map tile
+     * @return geometries in the order of queryIndexes(), nullptr if failed.
+     * Pointers have to be freed by user
+     */
+    vector<CADGeometry *> query( const CADBoundingBox& box );
     size_t getImageCount() const;
     CADImage * getImage( size_t index );
+    /**
+     * @brief Block references of the layer, listed only if block references
+     * aren't expanded, see CADFile::SetExpandBlockReferences()
+     */
+    size_t getBlockReferenceCount() const;
+    CADBlockReference getBlockReference( size_t index );
 
     /**
      * @brief returns a vector of presented geometries types
      */
-    vector<CADObject::ObjectType> getGeometryTypes();
+    const vector<CADObject::ObjectType>& getGeometryTypes();
 
 protected:
     bool addAttribute( const CADObject * pObject );
+    // entities are attached to the layers on the first access, see CADTables::FillLayers()
+    void fillLayers() const;
 protected:
     string layerName;
     bool   frozen;
@@ -107,8 +143,11 @@ protected:
     unordered_set<string>                   attributesNames;
     vector<pair<long, long> >               geometryHandles; // second param is CADInsert handle, 0 if it's not a geometry in block ref.
     vector<long>                            imageHandles;
+    vector<long>                            blockReferenceHandles;
     vector<pair<long, map<string, long> > > geometryAttributes;
     map<long, Matrix>                       transformations;
+    // shared by copies of the layer, never changed once built
+    shared_ptr<const CADSpatialIndex>       poSpatialIndex;
 
     CADFile * pCADFile;
 };
@@ -0,0 +1,131 @@
+/*******************************************************************************
+ *  Project: libopencad
+ *  Purpose: OpenSource CAD formats support library
+ *  Author: Alexandr Borzykh, mush3d at gmail.com
+ *  Author: Dmitry Baryshnikov, bishop.dev@gmail.com
+ *  Language: C++
+ *******************************************************************************
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2016 Alexandr Borzykh
+ *  Copyright (c) 2016 NextGIS, <info@nextgis.com>
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ ******************************************************************************/
+
+#include "cadobjectcache.h"
+
+// memory taken by a decoded object besides its file data, and by the cache entry
+static const size_t CACHE_ENTRY_OVERHEAD = 128;
+
+CADObjectCache::CADObjectCache( size_t nCapacityIn ) :
+    nCapacity( nCapacityIn ),
+    nUsed( 0 ),
+    nHits( 0 ),
+    nMisses( 0 )
+{
+}
+
+std::shared_ptr<const CADObject> CADObjectCache::Get( long nHandle, bool bHandlesOnly )
+{
+    std::lock_guard<std::mutex> oLock( oMutex );
+
+    auto it = mapEntries.find( nHandle );
+    if( it == mapEntries.end() || ( it->second->bHandlesOnly && !bHandlesOnly ) )
+    {
+        ++nMisses;
+        return nullptr;
+    }
+
+    ++nHits;
+    lstEntries.splice( lstEntries.begin(), lstEntries, it->second );
+    return it->second->poObject;
+}
+
+void CADObjectCache::Put( long nHandle, bool bHandlesOnly, const std::shared_ptr<const CADObject>& poObject )
+{
+    std::lock_guard<std::mutex> oLock( oMutex );
+
+    if( nullptr == poObject || 0 == nCapacity )
+        return;
+
+    size_t nSize = CACHE_ENTRY_OVERHEAD;
+    if( poObject->getSize() > 0 )
+        nSize += static_cast<size_t>( poObject->getSize() );
+    if( nSize > nCapacity )
+        return;
+
+    auto it = mapEntries.find( nHandle );
+    if( it != mapEntries.end() )
+    {
+        if( bHandlesOnly && !it->second->bHandlesOnly )
+            return;
+        nUsed -= it->second->nSize;
+        lstEntries.erase( it->second );
+        mapEntries.erase( it );
+    }
+
+    Shrink( nCapacity - nSize );
+
+    CacheEntry stEntry = { nHandle, bHandlesOnly, nSize, poObject };
+    lstEntries.push_front( stEntry );
+    mapEntries[nHandle] = lstEntries.begin();
+    nUsed += nSize;
+}
+
+void CADObjectCache::Clear()
+{
+    std::lock_guard<std::mutex> oLock( oMutex );
+    Shrink( 0 );
+}
+
+void CADObjectCache::SetCapacity( size_t nCapacityIn )
+{
+    std::lock_guard<std::mutex> oLock( oMutex );
+    nCapacity = nCapacityIn;
+    Shrink( nCapacity );
+}
+
+size_t CADObjectCache::GetCapacity() const
+{
+    std::lock_guard<std::mutex> oLock( oMutex );
+    return nCapacity;
+}
+
+size_t CADObjectCache::GetHits() const
+{
+    std::lock_guard<std::mutex> oLock( oMutex );
+    return nHits;
+}
+
+size_t CADObjectCache::GetMisses() const
+{
+    std::lock_guard<std::mutex> oLock( oMutex );
+    return nMisses;
+}
+
+void CADObjectCache::Shrink( size_t nCapacityIn )
+{
+    while( nUsed > nCapacityIn && !lstEntries.empty() )
+    {
+        nUsed -= lstEntries.back().nSize;
+        mapEntries.erase( lstEntries.back().nHandle );
+        lstEntries.pop_back();
+    }
+}
@@ -0,0 +1,95 @@
+/*******************************************************************************
+ *  Project: libopencad
+ *  Purpose: OpenSource CAD formats support library
+ *  Author: Alexandr Borzykh, mush3d at gmail.com
+ *  Author: Dmitry Baryshnikov, bishop.dev@gmail.com
+ *  Language: C++
+ *******************************************************************************
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2016 Alexandr Borzykh
+ *  Copyright (c) 2016 NextGIS, <info@nextgis.com>
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ ******************************************************************************/
+#ifndef CADOBJECTCACHE_H
+#define CADOBJECTCACHE_H
+
+#include "cadobjects.h"
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+/**
+ * @brief Least recently used cache of decoded CAD objects, keyed by handle.
+ * Objects are shared with the callers and must not be modified. Size of an
+ * object is estimated by its size in file. Thread safe.
+ */
+class OCAD_EXTERN CADObjectCache
+{
+public:
+    /**
+     * @param nCapacity Maximum size of cached objects in bytes, 0 disables cache
+     */
+    explicit CADObjectCache( size_t nCapacity );
+
+    /**
+     * @brief Get object from cache
+     * @param nHandle Object handle
+     * @param bHandlesOnly Set true if the object read with handles only will do
+     * @return cached object or nullptr
+     */
+    std::shared_ptr<const CADObject> Get( long nHandle, bool bHandlesOnly );
+    /**
+     * @brief Put object to cache. Object read with handles only doesn't replace
+     * the full one.
+     */
+    void   Put( long nHandle, bool bHandlesOnly, const std::shared_ptr<const CADObject>& poObject );
+    void   Clear();
+
+    void   SetCapacity( size_t nCapacity );
+    size_t GetCapacity() const;
+    size_t GetHits() const;
+    size_t GetMisses() const;
+
+protected:
+    struct CacheEntry
+    {
+        long                             nHandle;
+        bool                             bHandlesOnly;
+        size_t                           nSize;
+        std::shared_ptr<const CADObject> poObject;
+    };
+    typedef std::list<CacheEntry> CacheList;
+
+    void Shrink( size_t nCapacity );
+
+protected:
+    mutable std::mutex                                oMutex;
+    CacheList                                         lstEntries; // most recently used first
+    std::unordered_map<long, CacheList::iterator>     mapEntries;
+    size_t                                            nCapacity;
+    size_t                                            nUsed;
+    size_t                                            nHits;
+    size_t                                            nMisses;
+};
+
+#endif // CADOBJECTCACHE_H
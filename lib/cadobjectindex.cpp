@@ -0,0 +1,221 @@
+/*******************************************************************************
+ *  Project: libopencad
+ *  Purpose: OpenSource CAD formats support library
+ *  Author: Alexandr Borzykh, mush3d at gmail.com
+ *  Author: Dmitry Baryshnikov, bishop.dev@gmail.com
+ *  Language: C++
+ *******************************************************************************
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2016 Alexandr Borzykh
+ *  Copyright (c) 2016 NextGIS, <info@nextgis.com>
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ ******************************************************************************/
+
+#include "cadobjectindex.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+static bool CompareHandles( const CADObjectIndex::Entry& a, const CADObjectIndex::Entry& b )
+{
+    return a.nHandle < b.nHandle;
+}
+
+static const char OBJECT_INDEX_CACHE_MAGIC[8] = { 'O', 'C', 'A', 'D', 'I', 'D', 'X', '1' };
+
+/**
+ * @brief Temporary file name next to osPath, unique among processes and
+ * threads writing the same cache. Time tells apart processes of different
+ * hosts sharing the directory.
+ */
+static std::string GetTemporaryPath( const std::string& osPath )
+{
+    static std::atomic<unsigned> nCounter( 0 );
+    long long nTime = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+#ifdef _WIN32
+    int nProcessId = _getpid();
+#else
+    int nProcessId = static_cast<int>( getpid() );
+#endif
+    std::ostringstream oName;
+    oName << osPath << "." << nProcessId << "." << nCounter++ << "." << std::hex << nTime << ".tmp";
+    return oName.str();
+}
+
+/**
+ * @brief Cache file header, followed by nCount entries
+ */
+struct CADObjectIndexCacheHeader
+{
+    char               achMagic[8];
+    unsigned long long nFileSize;
+    long long          nModificationTime;
+    unsigned long long nHeaderCRC;
+    unsigned long long nCount;
+};
+
+CADObjectIndex::CADObjectIndex() : bSorted( true )
+{
+}
+
+void CADObjectIndex::Clear()
+{
+    aEntries.clear();
+    bSorted = true;
+}
+
+void CADObjectIndex::Reserve( size_t nCount )
+{
+    aEntries.reserve( nCount );
+}
+
+void CADObjectIndex::Add( long nHandle, long nOffset )
+{
+    if( !aEntries.empty() && aEntries.back().nHandle >= nHandle )
+        bSorted = false;
+    Entry stEntry = { nHandle, nOffset };
+    aEntries.push_back( stEntry );
+}
+
+void CADObjectIndex::Finalize()
+{
+    if( !bSorted )
+    {
+        // stable, so the first offset added for a duplicated handle is kept
+        std::stable_sort( aEntries.begin(), aEntries.end(), CompareHandles );
+        aEntries.erase( std::unique( aEntries.begin(), aEntries.end(),
+                                     []( const Entry& a, const Entry& b )
+                                     { return a.nHandle == b.nHandle; } ),
+                        aEntries.end() );
+        bSorted = true;
+    }
+    aEntries.shrink_to_fit();
+}
+
+bool CADObjectIndex::Find( long nHandle, long& nOffset ) const
+{
+    Entry stKey = { nHandle, 0 };
+    auto it = std::lower_bound( aEntries.begin(), aEntries.end(), stKey, CompareHandles );
+    if( it == aEntries.end() || it->nHandle != nHandle )
+        return false;
+    nOffset = it->nOffset;
+    return true;
+}
+
+size_t CADObjectIndex::GetCount() const
+{
+    return aEntries.size();
+}
+
+const std::vector<CADObjectIndex::Entry>& CADObjectIndex::GetEntries() const
+{
+    return aEntries;
+}
+
+bool CADObjectIndex::Load( const std::string& osPath, const CacheKey& stKey )
+{
+    Clear();
+
+    std::ifstream oFile( osPath.c_str(), std::ios::in | std::ios::binary );
+    if( !oFile.is_open() )
+        return false;
+
+    CADObjectIndexCacheHeader stHeader;
+    if( !oFile.read( reinterpret_cast<char *>( &stHeader ), sizeof( stHeader ) ) )
+        return false;
+    if( memcmp( stHeader.achMagic, OBJECT_INDEX_CACHE_MAGIC, sizeof( OBJECT_INDEX_CACHE_MAGIC ) ) != 0 ||
+        stHeader.nFileSize != stKey.nFileSize || stHeader.nModificationTime != stKey.nModificationTime ||
+        stHeader.nHeaderCRC != stKey.nHeaderCRC )
+        return false;
+
+    // an object takes more than one byte of the file, anything bigger is damaged
+    if( stHeader.nCount > stKey.nFileSize )
+        return false;
+
+    aEntries.resize( static_cast<size_t>( stHeader.nCount ) );
+    if( !aEntries.empty() &&
+        !oFile.read( reinterpret_cast<char *>( aEntries.data() ), aEntries.size() * sizeof( Entry ) ) )
+    {
+        Clear();
+        return false;
+    }
+
+    for( size_t i = 1; i < aEntries.size(); ++i )
+    {
+        if( aEntries[i - 1].nHandle >= aEntries[i].nHandle )
+        {
+            Clear();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool CADObjectIndex::Save( const std::string& osPath, const CacheKey& stKey ) const
+{
+    CADObjectIndexCacheHeader stHeader;
+    memcpy( stHeader.achMagic, OBJECT_INDEX_CACHE_MAGIC, sizeof( OBJECT_INDEX_CACHE_MAGIC ) );
+    stHeader.nFileSize         = stKey.nFileSize;
+    stHeader.nModificationTime = stKey.nModificationTime;
+    stHeader.nHeaderCRC        = stKey.nHeaderCRC;
+    stHeader.nCount            = aEntries.size();
+
+    // write next to the target and rename, so concurrent readers never see
+    // a half written cache
+    std::string osTmpPath = GetTemporaryPath( osPath );
+    {
+        std::ofstream oFile( osTmpPath.c_str(), std::ios::out | std::ios::binary | std::ios::trunc );
+        if( !oFile.is_open() )
+            return false;
+        oFile.write( reinterpret_cast<const char *>( &stHeader ), sizeof( stHeader ) );
+        if( !aEntries.empty() )
+            oFile.write( reinterpret_cast<const char *>( aEntries.data() ), aEntries.size() * sizeof( Entry ) );
+        // close flushes, it may fail too
+        oFile.close();
+        if( oFile.fail() )
+        {
+            std::remove( osTmpPath.c_str() );
+            return false;
+        }
+    }
+
+#ifdef _WIN32
+    std::remove( osPath.c_str() );
+#endif
+    if( std::rename( osTmpPath.c_str(), osPath.c_str() ) != 0 )
+    {
+        std::remove( osTmpPath.c_str() );
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,103 @@
+/*******************************************************************************
+ *  Project: libopencad
+ *  Purpose: OpenSource CAD formats support library
+ *  Author: Alexandr Borzykh, mush3d at gmail.com
+ *  Author: Dmitry Baryshnikov, bishop.dev@gmail.com
+ *  Language: C++
+ *******************************************************************************
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2016 Alexandr Borzykh
+ *  Copyright (c) 2016 NextGIS, <info@nextgis.com>
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ ******************************************************************************/
+#ifndef CADOBJECTINDEX_H
+#define CADOBJECTINDEX_H
+
+#include "opencad.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Handle to file offset index of the CAD objects. Stored as a flat
+ * vector sorted by handle, the object map of a DWG file is written in
+ * ascending handle order so it's filled by appending.
+ */
+class OCAD_EXTERN CADObjectIndex
+{
+public:
+    struct Entry
+    {
+        long nHandle;
+        long nOffset;
+    };
+
+    /**
+     * @brief Identifies the file an index cache was written for
+     */
+    struct CacheKey
+    {
+        unsigned long long nFileSize;
+        long long          nModificationTime;
+        unsigned short     nHeaderCRC;
+    };
+
+public:
+    CADObjectIndex();
+
+    void   Clear();
+    void   Reserve( size_t nCount );
+    /**
+     * @brief Add handle to the index. Call Finalize() after the last one.
+     */
+    void   Add( long nHandle, long nOffset );
+    /**
+     * @brief Sort the index if handles were added out of order and drop
+     * duplicates, the first added offset wins.
+     */
+    void   Finalize();
+    /**
+     * @brief Look up the file offset of the handle
+     * @return false if the handle is not in the index
+     */
+    bool   Find( long nHandle, long& nOffset ) const;
+    size_t GetCount() const;
+    const std::vector<Entry>& GetEntries() const;
+
+    /**
+     * @brief Load index from the cache file written by Save()
+     * @return false if there is no cache, it is damaged or was written for
+     * another key. The index is left empty then.
+     */
+    bool   Load( const std::string& osPath, const CacheKey& stKey );
+    /**
+     * @brief Save index to the cache file. The file is written in native byte
+     * order and replaced atomically where the platform allows it.
+     */
+    bool   Save( const std::string& osPath, const CacheKey& stKey ) const;
+
+protected:
+    std::vector<Entry> aEntries;
+    bool               bSorted;
+};
+
+#endif // CADOBJECTINDEX_H
@@ -0,0 +1,252 @@
+/*******************************************************************************
+ *  Project: libopencad
+ *  Purpose: OpenSource CAD formats support library
+ *  Author: Alexandr Borzykh, mush3d at gmail.com
+ *  Author: Dmitry Baryshnikov, bishop.dev@gmail.com
+ *  Language: C++
+ *******************************************************************************
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2016 Alexandr Borzykh
+ *  Copyright (c) 2016 NextGIS, <info@nextgis.com>
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ ******************************************************************************/
+
+#include "cadobjectpool.h"
+
+#include <mutex>
+#include <new>
+#include <vector>
+
+// Pool is opt-in, see OCAD_OBJECT_POOL cmake option. Recycled blocks hide
+// use after free from address sanitizer, pool is off then too.
+#if !defined(OCAD_OBJECT_POOL) || defined(__SANITIZE_ADDRESS__)
+#define OCAD_NO_OBJECT_POOL
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define OCAD_NO_OBJECT_POOL
+#endif
+#endif
+
+#ifndef OCAD_NO_OBJECT_POOL
+namespace
+{
+
+const size_t BLOCK_ALIGNMENT   = 64;        // size classes step
+const size_t MAX_BLOCK_SIZE    = 1024;      // bigger objects go to the system allocator
+const size_t SIZE_CLASSES      = MAX_BLOCK_SIZE / BLOCK_ALIGNMENT;
+const size_t CHUNK_SIZE        = 64 * 1024;
+const size_t BATCH_SIZE        = 32;        // blocks moved between thread and shared lists at once
+const size_t MAX_THREAD_BLOCKS = 256;       // free blocks a thread keeps per size class
+
+struct FreeBlock
+{
+    FreeBlock * pNext;
+};
+
+struct FreeList
+{
+    FreeBlock * pHead;
+    size_t      nCount;
+
+    void Push( void * pBlock )
+    {
+        FreeBlock * poBlock = static_cast<FreeBlock *>( pBlock );
+        poBlock->pNext = pHead;
+        pHead = poBlock;
+        ++nCount;
+    }
+
+    void * Pop()
+    {
+        FreeBlock * poBlock = pHead;
+        pHead = poBlock->pNext;
+        --nCount;
+        return poBlock;
+    }
+};
+
+/**
+ * Free blocks shared by all threads, and the chunks blocks are split from.
+ */
+class SharedPool
+{
+public:
+    SharedPool() : pChunk( nullptr ), nChunkLeft( 0 )
+    {
+        for( FreeList& oList : aLists )
+            oList = { nullptr, 0 };
+    }
+
+    // move up to nBlocks free blocks to oList, splitting a new chunk if needed
+    void Take( size_t iClass, FreeList& oList, size_t nBlocks )
+    {
+        std::lock_guard<std::mutex> oLock( oMutex );
+        FreeList& oShared = aLists[iClass];
+        while( nBlocks > 0 && oShared.nCount > 0 )
+        {
+            oList.Push( oShared.Pop() );
+            --nBlocks;
+        }
+
+        size_t nBlockSize = ( iClass + 1 ) * BLOCK_ALIGNMENT;
+        while( nBlocks > 0 )
+        {
+            if( nChunkLeft < nBlockSize )
+            {
+                pChunk = static_cast<char *>( ::operator new( CHUNK_SIZE ) );
+                nChunkLeft = CHUNK_SIZE;
+                apChunks.push_back( pChunk );
+            }
+            oList.Push( pChunk );
+            pChunk += nBlockSize;
+            nChunkLeft -= nBlockSize;
+            --nBlocks;
+        }
+    }
+
+    // move up to nBlocks free blocks from oList
+    void Give( size_t iClass, FreeList& oList, size_t nBlocks )
+    {
+        std::lock_guard<std::mutex> oLock( oMutex );
+        FreeList& oShared = aLists[iClass];
+        while( nBlocks > 0 && oList.nCount > 0 )
+        {
+            oShared.Push( oList.Pop() );
+            --nBlocks;
+        }
+    }
+
+protected:
+    std::mutex          oMutex;
+    FreeList            aLists[SIZE_CLASSES];
+    char              * pChunk;
+    size_t              nChunkLeft;
+    std::vector<char *> apChunks;
+};
+
+SharedPool& GetSharedPool()
+{
+    // Never destroyed: objects may be freed by static destructors after the
+    // pool would have gone.
+    static SharedPool * poPool = new SharedPool();
+    return * poPool;
+}
+
+thread_local bool bThreadCacheDestroyed = false;
+
+/**
+ * Free blocks of a thread, given back to the shared pool when thread ends.
+ */
+class ThreadCache
+{
+public:
+    ThreadCache()
+    {
+        for( FreeList& oList : aLists )
+            oList = { nullptr, 0 };
+    }
+
+    ~ThreadCache()
+    {
+        for( size_t i = 0; i < SIZE_CLASSES; ++i )
+            GetSharedPool().Give( i, aLists[i], aLists[i].nCount );
+        bThreadCacheDestroyed = true;
+    }
+
+    FreeList aLists[SIZE_CLASSES];
+};
+
+ThreadCache * GetThreadCache()
+{
+    // objects freed by other thread local destructors go to the shared pool
+    if( bThreadCacheDestroyed )
+        return nullptr;
+    static thread_local ThreadCache oCache;
+    return & oCache;
+}
+
+} // namespace
+#endif // OCAD_NO_OBJECT_POOL
+
+void * CADObjectPool::Allocate( size_t nSize )
+{
+#ifdef OCAD_NO_OBJECT_POOL
+    return ::operator new( nSize );
+#else
+    if( nSize > MAX_BLOCK_SIZE )
+        return ::operator new( nSize );
+
+    size_t iClass = nSize == 0 ? 0 : ( nSize - 1 ) / BLOCK_ALIGNMENT;
+    ThreadCache * poCache = GetThreadCache();
+    if( poCache == nullptr )
+    {
+        FreeList oList = { nullptr, 0 };
+        GetSharedPool().Take( iClass, oList, 1 );
+        return oList.Pop();
+    }
+
+    FreeList& oList = poCache->aLists[iClass];
+    if( oList.nCount == 0 )
+        GetSharedPool().Take( iClass, oList, BATCH_SIZE );
+    return oList.Pop();
+#endif
+}
+
+void CADObjectPool::Free( void * pBlock, size_t nSize )
+{
+    if( pBlock == nullptr )
+        return;
+
+#ifdef OCAD_NO_OBJECT_POOL
+    (void) nSize;
+    ::operator delete( pBlock );
+#else
+    if( nSize > MAX_BLOCK_SIZE )
+    {
+        ::operator delete( pBlock );
+        return;
+    }
+
+    size_t iClass = nSize == 0 ? 0 : ( nSize - 1 ) / BLOCK_ALIGNMENT;
+    ThreadCache * poCache = GetThreadCache();
+    if( poCache == nullptr )
+    {
+        FreeList oList = { nullptr, 0 };
+        oList.Push( pBlock );
+        GetSharedPool().Give( iClass, oList, 1 );
+        return;
+    }
+
+    FreeList& oList = poCache->aLists[iClass];
+    oList.Push( pBlock );
+    if( oList.nCount > MAX_THREAD_BLOCKS )
+        GetSharedPool().Give( iClass, oList, BATCH_SIZE );
+#endif
+}
+
+bool CADObjectPool::IsEnabled()
+{
+#ifdef OCAD_NO_OBJECT_POOL
+    return false;
+#else
+    return true;
+#endif
+}
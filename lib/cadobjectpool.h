@@ -0,0 +1,57 @@
+/*******************************************************************************
+ *  Project: libopencad
+ *  Purpose: OpenSource CAD formats support library
+ *  Author: Alexandr Borzykh, mush3d at gmail.com
+ *  Author: Dmitry Baryshnikov, bishop.dev@gmail.com
+ *  Language: C++
+ *******************************************************************************
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2016 Alexandr Borzykh
+ *  Copyright (c) 2016 NextGIS, <info@nextgis.com>
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ ******************************************************************************/
+#ifndef CADOBJECTPOOL_H
+#define CADOBJECTPOOL_H
+
+#include <cstddef>
+
+/**
+ * @brief Recycling allocator of decoded CAD objects. Memory is taken from the
+ * system in big chunks, split to blocks of a few size classes. Freed blocks are
+ * kept in per thread lists and handed out to the next decoded objects, so bulk
+ * reading, which decodes and drops objects one by one, doesn't go to the system
+ * allocator for each of them. Chunks are never returned to the system, the
+ * pool is as big as the most of objects alive at once, so it is off unless the
+ * library is built with OCAD_OBJECT_POOL. Without it, and with address
+ * sanitizer, objects go to the system allocator. Thread safe.
+ */
+class CADObjectPool
+{
+public:
+    static void * Allocate( size_t nSize );
+    static void   Free( void * pBlock, size_t nSize );
+    /**
+     * @brief Returns true if freed blocks are recycled
+     */
+    static bool   IsEnabled();
+};
+
+#endif // CADOBJECTPOOL_H
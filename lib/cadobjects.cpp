@@ -30,45 +30,34 @@
  *******************************************************************************/
 
 #include "cadobjects.h"
+#include "cadobjectpool.h"
 
 #include <math.h>
 #include <algorithm>
+#include <limits>
+#include <type_traits>
 
 //------------------------------------------------------------------------------
 // CADVector
 //------------------------------------------------------------------------------
 #define EPSILON std::numeric_limits<double>::epsilon() * 16
 
-CADVector::CADVector( double x, double y ) : X( x ), Y( y ), Z( 0.0 ), bHasZ( false )
-{
-
-}
+static_assert( std::is_trivially_copyable<CADVector>::value, "vertex arrays are copied as plain memory" );
+static_assert( sizeof( CADVector ) == 3 * sizeof( double ), "CADVector has no padding" );
 
-CADVector::CADVector( double x, double y, double z ) : X( x ), Y( y ), Z( z ), bHasZ( true )
+CADVector::CADVector( double x, double y ) : X( x ), Y( y ), Z( 0.0 )
 {
 
 }
 
-CADVector::CADVector( const CADVector& other )
+CADVector::CADVector( double x, double y, double z ) : X( x ), Y( y ), Z( z )
 {
-    X     = other.X;
-    Y     = other.Y;
-    Z     = other.Z;
-    bHasZ = other.bHasZ;
-}
 
-bool CADVector::operator==( const CADVector& second )
-{
-    return ( fcmp( this->X, second.X ) && fcmp( this->Y, second.Y ) && fcmp( this->Z, second.Z ) );
 }
 
-CADVector CADVector::operator=( const CADVector& second )
+bool CADVector::operator==( const CADVector& second ) const
 {
-    X     = second.X;
-    Y     = second.Y;
-    Z     = second.Z;
-    bHasZ = second.bHasZ;
-    return * this;
+    return ( fcmp( this->X, second.X ) && fcmp( this->Y, second.Y ) && fcmp( this->Z, second.Z ) );
 }
 
 bool CADVector::fcmp( double x, double y )
@@ -76,16 +65,6 @@ bool CADVector::fcmp( double x, double y )
     return fabs( x - y ) < EPSILON ? true : false;
 }
 
-bool CADVector::getBHasZ() const
-{
-    return bHasZ;
-}
-
-void CADVector::setBHasZ( bool value )
-{
-    bHasZ = value;
-}
-
 double CADVector::getZ() const
 {
     return Z;
@@ -93,9 +72,7 @@ double CADVector::getZ() const
 
 void CADVector::setZ( double value )
 {
-    if( !bHasZ )
-        bHasZ = true;
-    Z         = value;
+    Z = value;
 }
 
 double CADVector::getY() const
@@ -118,7 +95,7 @@ void CADVector::setX( double value )
     X = value;
 }
 
-CADVector::CADVector() : X( .0 ), Y( .0 ), Z( .0 ), bHasZ( true )
+CADVector::CADVector() : X( .0 ), Y( .0 ), Z( .0 )
 {
 
 }
@@ -541,6 +518,16 @@ string getNameByType( CADObject::ObjectType eType )
 // CADObject
 //------------------------------------------------------------------------------
 
+void * CADObject::operator new( size_t nSize )
+{
+    return CADObjectPool::Allocate( nSize );
+}
+
+void CADObject::operator delete( void * pObject, size_t nSize )
+{
+    CADObjectPool::Free( pObject, nSize );
+}
+
 CADObject::ObjectType CADObject::getType() const
 {
     return type;
@@ -37,17 +37,18 @@
 using namespace std;
 
 /*
- * @brief Class which basically implements 3D vertex
+ * @brief Class which basically implements 3D vertex. It is trivially copyable
+ * and takes 24 bytes, so vertex arrays are copied as plain memory. Whether 2D
+ * vertexes have Z is kept by their container, see CADLWPolyline::getBHasZ().
  */
 class CADVector
 {
+    friend class Matrix;
 public:
     CADVector();
     CADVector( double dx, double dy );
     CADVector( double dx, double dy, double dz );
-    CADVector( const CADVector& other );
-    bool      operator==( const CADVector& second );
-    CADVector operator=( const CADVector& second );
+    bool      operator==( const CADVector& second ) const;
     double getX() const;
     void   setX( double value );
 
@@ -57,16 +58,12 @@ public:
     double getZ() const;
     void   setZ( double value );
 
-    bool getBHasZ() const;
-    void setBHasZ( bool value );
-
 protected:
-    inline bool fcmp( double x, double y );
+    static inline bool fcmp( double x, double y );
 protected:
     double X;
     double Y;
     double Z;
-    bool   bHasZ;
 };
 
 typedef struct _Eed
@@ -205,6 +202,15 @@ public:
         WIPEOUT              = 0x72                  // 114
     };
 
+    virtual ~CADObject(){}
+
+    /**
+     * Decoded objects are allocated from CADObjectPool, as they are created
+     * and freed in big numbers while reading.
+     */
+    static void * operator new( size_t nSize );
+    static void   operator delete( void * pObject, size_t nSize );
+
     ObjectType getType() const;
     long       getSize() const;
 
@@ -282,6 +288,20 @@ struct CADCommonEHD
     CADHandle hEdgeVisualStyle;
 };
 
+/**
+ * @brief The entity fields needed to walk entities lists and to attach
+ * entities to the layers. Handles are absolute.
+ */
+struct CADEntityProbe
+{
+    CADObject::ObjectType eType;
+    long                  nHandle;
+    long                  nOwner;      // 0 if owner is not stored (entmode isn't 0)
+    long                  nLayer;
+    long                  nNextEntity; // valid if bNoLinks is false
+    bool                  bNoLinks;
+};
+
 /*
  * @brief The abstract class, which contains data common to all entities
  */
@@ -0,0 +1,133 @@
+/*******************************************************************************
+ *  Project: libopencad
+ *  Purpose: OpenSource CAD formats support library
+ *  Author: Alexandr Borzykh, mush3d at gmail.com
+ *  Author: Dmitry Baryshnikov, bishop.dev@gmail.com
+ *  Language: C++
+ *******************************************************************************
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2016 Alexandr Borzykh
+ *  Copyright (c) 2016 NextGIS, <info@nextgis.com>
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ ******************************************************************************/
+#include "cadspatialindex.h"
+
+#include <algorithm>
+#include <cmath>
+
+const size_t CADSpatialIndex::NODE_CAPACITY;
+
+// Center of the node in one dimension, 0 for nodes infinite both ways
+static double GetCenter( double dfMin, double dfMax )
+{
+    double dfCenter = dfMin / 2 + dfMax / 2;
+    return std::isnan( dfCenter ) ? 0.0 : dfCenter;
+}
+
+CADSpatialIndex::CADSpatialIndex( const std::vector<CADBoundingBox>& aoBoxes )
+{
+    for( size_t i = 0; i < aoBoxes.size(); ++i )
+    {
+        if( aoBoxes[i].isEmpty() )
+            continue;
+        CADVector oMin = aoBoxes[i].getMin();
+        CADVector oMax = aoBoxes[i].getMax();
+        Node stLeaf = { oMin.getX(), oMin.getY(), oMax.getX(), oMax.getY(), i, 0 };
+        astNodes.push_back( stLeaf );
+    }
+
+    // Every level is sorted by X, cut into vertical slices which are sorted by
+    // Y and packed into parent nodes in runs of NODE_CAPACITY.
+    auto centerX = []( const Node& a ) { return GetCenter( a.minX, a.maxX ); };
+    auto centerY = []( const Node& a ) { return GetCenter( a.minY, a.maxY ); };
+    size_t nLevelBegin = 0;
+    size_t nLevelEnd   = astNodes.size();
+    while( nLevelEnd - nLevelBegin > 1 )
+    {
+        auto itBegin = astNodes.begin() + static_cast<std::ptrdiff_t>( nLevelBegin );
+        auto itEnd   = astNodes.begin() + static_cast<std::ptrdiff_t>( nLevelEnd );
+        std::sort( itBegin, itEnd, [&]( const Node& a, const Node& b ) { return centerX( a ) < centerX( b ); } );
+
+        size_t nCount      = nLevelEnd - nLevelBegin;
+        size_t nParents    = ( nCount + NODE_CAPACITY - 1 ) / NODE_CAPACITY;
+        size_t nSlices     = static_cast<size_t>( std::ceil( std::sqrt( static_cast<double>( nParents ) ) ) );
+        size_t nSliceCount = ( nCount + nSlices - 1 ) / nSlices;
+        nSliceCount        = ( nSliceCount + NODE_CAPACITY - 1 ) / NODE_CAPACITY * NODE_CAPACITY;
+
+        std::vector<Node> astParents;
+        for( size_t nSlice = nLevelBegin; nSlice < nLevelEnd; nSlice += nSliceCount )
+        {
+            size_t nSliceEnd = std::min( nSlice + nSliceCount, nLevelEnd );
+            std::sort( astNodes.begin() + static_cast<std::ptrdiff_t>( nSlice ),
+                       astNodes.begin() + static_cast<std::ptrdiff_t>( nSliceEnd ),
+                       [&]( const Node& a, const Node& b ) { return centerY( a ) < centerY( b ); } );
+
+            for( size_t nChild = nSlice; nChild < nSliceEnd; nChild += NODE_CAPACITY )
+            {
+                Node stParent = astNodes[nChild];
+                stParent.nFirst = nChild;
+                stParent.nCount = std::min( NODE_CAPACITY, nSliceEnd - nChild );
+                for( size_t i = nChild + 1; i < nChild + stParent.nCount; ++i )
+                {
+                    stParent.minX = std::min( stParent.minX, astNodes[i].minX );
+                    stParent.minY = std::min( stParent.minY, astNodes[i].minY );
+                    stParent.maxX = std::max( stParent.maxX, astNodes[i].maxX );
+                    stParent.maxY = std::max( stParent.maxY, astNodes[i].maxY );
+                }
+                astParents.push_back( stParent );
+            }
+        }
+
+        nLevelBegin = nLevelEnd;
+        astNodes.insert( astNodes.end(), astParents.begin(), astParents.end() );
+        nLevelEnd = astNodes.size();
+    }
+}
+
+std::vector<size_t> CADSpatialIndex::query( const CADBoundingBox& oBox ) const
+{
+    std::vector<size_t> anResult;
+    if( astNodes.empty() || oBox.isEmpty() )
+        return anResult;
+
+    CADVector oMin = oBox.getMin();
+    CADVector oMax = oBox.getMax();
+    std::vector<size_t> anStack( 1, astNodes.size() - 1 );
+    while( !anStack.empty() )
+    {
+        const Node& stNode = astNodes[anStack.back()];
+        anStack.pop_back();
+        if( stNode.minX > oMax.getX() || stNode.maxX < oMin.getX() ||
+            stNode.minY > oMax.getY() || stNode.maxY < oMin.getY() )
+            continue;
+
+        if( stNode.nCount == 0 )
+        {
+            anResult.push_back( stNode.nFirst );
+            continue;
+        }
+        for( size_t i = stNode.nFirst; i < stNode.nFirst + stNode.nCount; ++i )
+            anStack.push_back( i );
+    }
+
+    std::sort( anResult.begin(), anResult.end() );
+    return anResult;
+}
@@ -0,0 +1,72 @@
+/*******************************************************************************
+ *  Project: libopencad
+ *  Purpose: OpenSource CAD formats support library
+ *  Author: Alexandr Borzykh, mush3d at gmail.com
+ *  Author: Dmitry Baryshnikov, bishop.dev@gmail.com
+ *  Language: C++
+ *******************************************************************************
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2016 Alexandr Borzykh
+ *  Copyright (c) 2016 NextGIS, <info@nextgis.com>
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ ******************************************************************************/
+#ifndef CADSPATIALINDEX_H
+#define CADSPATIALINDEX_H
+
+#include "cadgeometry.h"
+
+#include <vector>
+
+/**
+ * @brief Static R-tree over bounding boxes in XY plane. The tree is bulk
+ * loaded with Sort-Tile-Recursive packing, so nodes are full and don't overlap
+ * much, and it can't be changed afterwards.
+ */
+class CADSpatialIndex
+{
+public:
+    /**
+     * @param aoBoxes Boxes of items, item index is the index in this vector.
+     * Empty boxes are not indexed.
+     */
+    explicit CADSpatialIndex( const std::vector<CADBoundingBox>& aoBoxes );
+
+    /**
+     * @brief Find items which boxes intersect oBox in XY plane
+     * @param oBox Box to search
+     * @return indexes of found items in ascending order
+     */
+    std::vector<size_t> query( const CADBoundingBox& oBox ) const;
+protected:
+    struct Node
+    {
+        double minX, minY, maxX, maxY;
+        size_t nFirst; // item index for leaves, first child node otherwise
+        size_t nCount; // 0 for leaves
+    };
+
+    static const size_t NODE_CAPACITY = 16;
+protected:
+    // Leaves first, then the upper levels one after another, root is the last.
+    std::vector<Node> astNodes;
+};
+
+#endif // CADSPATIALINDEX_H
@@ -37,7 +37,7 @@
 
 using namespace std;
 
-CADTables::CADTables()
+CADTables::CADTables() : dFirstModelSpaceEntity( 0 ), dLastModelSpaceEntity( 0 )
 {
 }
 
@@ -75,10 +75,12 @@ CADLayer& CADTables::GetLayer( size_t iIndex )
     return aLayers[iIndex];
 }
 
-CADHandle CADTables::GetTableHandle( enum TableType eType )
+CADHandle CADTables::GetTableHandle( enum TableType eType ) const
 {
-    // FIXME: need to add try/catch to prevent crashes on not found elem.
-    return mapTables[eType];
+    auto iter = mapTables.find( eType );
+    if( iter == mapTables.end() )
+        return CADHandle();
+    return iter->second;
 }
 
 int CADTables::ReadLayersTable( CADFile * const pCADFile, long dLayerControlHandle )
@@ -98,6 +100,8 @@ int CADTables::ReadLayersTable( CADFile * const pCADFile, long dLayerControlHand
             // Init CADLayer from CADLayerObject properties
             unique_ptr<CADLayerObject> oCADLayerObj(
                     static_cast<CADLayerObject *>(pCADFile->GetObject( spLayerControl->hLayers[i].getAsLong() )) );
+            if( oCADLayerObj == nullptr )
+                return CADErrorCodes::TABLE_READ_FAILED;
 
             oCADLayer.setName( oCADLayerObj->sLayerName );
             oCADLayer.setFrozen( oCADLayerObj->bFrozen );
@@ -119,51 +123,75 @@ int CADTables::ReadLayersTable( CADFile * const pCADFile, long dLayerControlHand
 
     unique_ptr<CADBlockHeaderObject> spModelSpace(
             static_cast<CADBlockHeaderObject *>(pCADFile->GetObject( iterBlockMS->second.getAsLong() )) );
+    if( spModelSpace == nullptr || spModelSpace->hEntities.size() < 2 )
+        return CADErrorCodes::TABLE_READ_FAILED;
+
+    // Entities are attached to the layers later, by FillLayers(), so opening
+    // a file to look at its header and layer names doesn't cost a walk over
+    // every entity.
+    dFirstModelSpaceEntity = spModelSpace->hEntities[0].getAsLong();
+    dLastModelSpaceEntity  = spModelSpace->hEntities[1].getAsLong();
+
+    DebugMsg( "Read aLayers using LayerControl object count: %zd\n", aLayers.size() );
+
+    return CADErrorCodes::SUCCESS;
+}
+
+void CADTables::FillLayers( CADFile * const pCADFile )
+{
+    call_once( oLayersFilled, &CADTables::WalkModelSpace, this, pCADFile );
+}
 
-    auto dCurrentEntHandle = spModelSpace->hEntities[0].getAsLong();
-    auto dLastEntHandle    = spModelSpace->hEntities[1].getAsLong();
+void CADTables::GetModelSpaceEntities( long& dFirst, long& dLast ) const
+{
+    dFirst = dFirstModelSpaceEntity;
+    dLast  = dLastModelSpaceEntity;
+}
+
+void CADTables::WalkModelSpace( CADFile * const pCADFile )
+{
+    auto dCurrentEntHandle = dFirstModelSpaceEntity;
+    auto dLastEntHandle    = dLastModelSpaceEntity;
     while( dCurrentEntHandle != 0 )
     {
-        unique_ptr<CADEntityObject> spEntityObj( static_cast<CADEntityObject *>( pCADFile->GetObject( dCurrentEntHandle, true ) ) );
-
-        if( spEntityObj == nullptr )
+        CADEntityProbe stEntity;
+        if( !pCADFile->ProbeEntity( dCurrentEntHandle, stEntity ) )
         {
         	DebugMsg("Entity object is null\n");
             break;
         }
         else if(dCurrentEntHandle == dLastEntHandle)
         {
-            FillLayer( spEntityObj.get() );
+            FillLayer( pCADFile, stEntity );
             break;
         }
 
-        FillLayer(spEntityObj.get());
+        FillLayer( pCADFile, stEntity );
 
-        if(spEntityObj->stCed.bNoLinks)
+        if(stEntity.bNoLinks)
         {
         	++dCurrentEntHandle;
         }
         else
         {
-        	dCurrentEntHandle = spEntityObj->stChed.hNextEntity.getAsLong(spEntityObj->stCed.hObjectHandle);
+        	dCurrentEntHandle = stEntity.nNextEntity;
         }
     }
-
-    DebugMsg( "Read aLayers using LayerControl object count: %zd\n", aLayers.size() );
-
-    return CADErrorCodes::SUCCESS;
 }
 
-void CADTables::FillLayer( const CADEntityObject * pEntityObject )
+void CADTables::FillLayer( CADFile * const pCADFile, const CADEntityProbe& stEntity )
 {
     for( CADLayer& oLayer : aLayers )
     {
-        if( pEntityObject->stChed.hLayer.getAsLong( pEntityObject->stCed.hObjectHandle ) == oLayer.getHandle() )
+        if( stEntity.nLayer == oLayer.getHandle() )
         {
+            if( !pCADFile->isLayerAccepted( oLayer.getName() ) )
+                break;
+
             DebugMsg( "Object with type: %s is attached to layer named: %s\n",
-                      getNameByType( pEntityObject->getType() ).c_str(), oLayer.getName().c_str() );
+                      getNameByType( stEntity.eType ).c_str(), oLayer.getName().c_str() );
 
-            oLayer.addHandle( pEntityObject->stCed.hObjectHandle.getAsLong(), pEntityObject->getType() );
+            oLayer.addHandle( stEntity.nHandle, stEntity.eType );
             break;
         }
     }
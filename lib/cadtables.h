@@ -34,6 +34,8 @@
 #include "cadheader.h"
 #include "cadlayer.h"
 
+#include <mutex>
+
 using namespace std;
 
 class CADFile;
@@ -72,17 +74,30 @@ public:
     CADTables();
 
     void      AddTable( enum TableType eType, CADHandle hHandle );
-    CADHandle GetTableHandle( enum TableType eType );
+    CADHandle GetTableHandle( enum TableType eType ) const;
     int       ReadTable( CADFile * const pCADFile, enum TableType eType );
     size_t    GetLayerCount() const;
     CADLayer& GetLayer( size_t iIndex );
+    /**
+     * @brief Walk model space entities and attach them to the layers. The walk
+     * is done only once, on the first access to layer geometries.
+     */
+    void      FillLayers( CADFile * const pCADFile );
+    /**
+     * @brief Handles of the first and the last model space entities
+     */
+    void      GetModelSpaceEntities( long& dFirst, long& dLast ) const;
 
 protected:
     int  ReadLayersTable( CADFile * const pCADFile, long dLayerControlHandle );
-    void FillLayer( const CADEntityObject * pEntityObject );
+    void FillLayer( CADFile * const pCADFile, const CADEntityProbe& stEntity );
+    void WalkModelSpace( CADFile * const pCADFile );
 protected:
     map<enum TableType, CADHandle> mapTables;
     vector<CADLayer>               aLayers;
+    long                           dFirstModelSpaceEntity;
+    long                           dLastModelSpaceEntity;
+    once_flag                      oLayersFilled;
 };
 
 #endif // CADTABLES_H
\ No newline at end of file
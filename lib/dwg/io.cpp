@@ -32,6 +32,7 @@
 
 #include <iostream>
 #include <cstring>
+#include <limits>
 
 unsigned short CalculateCRC8( unsigned short initialVal, const char * ptr, int num )
 {
@@ -47,492 +48,356 @@ unsigned short CalculateCRC8( unsigned short initialVal, const char * ptr, int n
     return static_cast<unsigned short>( initialVal );
 }
 
-unsigned char Read2B( const char * pabyInput, size_t& nBitOffsetFromStart )
-{
-    unsigned char result           = 0;
-    size_t        nByteOffset      = nBitOffsetFromStart / 8;
-    size_t        nBitOffsetInByte = nBitOffsetFromStart % 8;
+//------------------------------------------------------------------------------
+// DWGBitReader
+//------------------------------------------------------------------------------
 
-    const char * p2BByte = pabyInput + nByteOffset;
-    unsigned char a2BBytes[2];
-    memcpy( a2BBytes, p2BByte, 2 );
+// Compound values, decoded by the reader members and, inlined, by the bit
+// reading functions.
 
-    switch( nBitOffsetInByte )
+static inline short DecodeBITSHORT( DWGBitReader& oReader )
+{
+    switch( oReader.Read2B() )
     {
-        case 7:
-            result = ( a2BBytes[0] & binary(00000001) ) << 1;
-            result |= ( a2BBytes[1] & binary(10000000) ) >> 7;
-            break;
-        default:
-            result = ( a2BBytes[0] >> ( 6 - nBitOffsetInByte ) );
-            break;
+        case BITSHORT_NORMAL:
+            return oReader.ReadRAWSHORT();
+        case BITSHORT_UNSIGNED_CHAR:
+            return oReader.ReadCHAR();
+        case BITSHORT_ZERO_VALUE:
+            return 0;
+        case BITSHORT_256:
+            return 256;
     }
 
-    result &= binary(00000011);
-    nBitOffsetFromStart += 2;
-
-    return result;
+    return -1;
 }
 
-unsigned char Read3B( const char * pabyInput, size_t& nBitOffsetFromStart )
+static inline int DecodeBITLONG( DWGBitReader& oReader )
 {
-    unsigned char result           = 0;
-    size_t        nByteOffset      = nBitOffsetFromStart / 8;
-    size_t        nBitOffsetInByte = nBitOffsetFromStart % 8;
-
-    const char * p3BByte = pabyInput + nByteOffset;
-    unsigned char a3BBytes[2];
-    memcpy( a3BBytes, p3BByte, 2 );
-
-    switch( nBitOffsetInByte )
+    switch( oReader.Read2B() )
     {
-        case 6:
-            result = ( a3BBytes[0] & binary(00000011) ) << 1;
-            result |= ( a3BBytes[1] & binary(10000000) ) >> 7;
-            break;
-
-        case 7:
-            result = ( a3BBytes[0] & binary(00000001) ) << 2;
-            result |= ( a3BBytes[1] & binary(11000000) ) >> 6;
-            break;
-
-        default:
-            result = ( a3BBytes[0] >> ( 5 - nBitOffsetInByte ) );
-            break;
+        case BITLONG_NORMAL:
+            return oReader.ReadRAWLONG();
+        case BITLONG_UNSIGNED_CHAR:
+            return oReader.ReadCHAR();
+        case BITLONG_ZERO_VALUE:
+            return 0;
+        case BITLONG_NOT_USED:
+            std::cerr <<
+            "THAT SHOULD NEVER HAPPENED! BUG. (in file, or reader, or both.) ReadBITLONG(), case BITLONG_NOT_USED" <<
+            std::endl;
+            return 0;
     }
 
-    result &= binary(00000111);
-    nBitOffsetFromStart += 3;
-
-    return result;
+    return -1;
 }
 
-unsigned char Read4B( const char * pabyInput, size_t& nBitOffsetFromStart )
+static inline double DecodeBITDOUBLE( DWGBitReader& oReader )
 {
-    unsigned char result           = 0;
-    size_t        nByteOffset      = nBitOffsetFromStart / 8;
-    size_t        nBitOffsetInByte = nBitOffsetFromStart % 8;
-
-    const char * p4BByte = pabyInput + nByteOffset;
-    unsigned char a4BBytes[2];
-    memcpy( a4BBytes, p4BByte, 2 );
-
-    switch( nBitOffsetInByte )
+    switch( oReader.Read2B() )
     {
-        case 5:
-            result = ( a4BBytes[0] & binary(00000111) ) << 1;
-            result |= ( a4BBytes[1] & binary(10000000) ) >> 7;
-            break;
-        case 6:
-            result = ( a4BBytes[0] & binary(00000011) ) << 2;
-            result |= ( a4BBytes[1] & binary(11000000) ) >> 6;
-            break;
-
-        case 7:
-            result = ( a4BBytes[0] & binary(00000001) ) << 3;
-            result |= ( a4BBytes[1] & binary(11100000) ) >> 5;
-            break;
-
-        default:
-            result = ( a4BBytes[0] >> ( 4 - nBitOffsetInByte ) );
-            break;
+        case BITDOUBLE_NORMAL:
+            return oReader.ReadRAWDOUBLE();
+        case BITDOUBLE_ONE_VALUE:
+            return 1.0f;
+        case BITDOUBLE_ZERO_VALUE:
+        case BITDOUBLE_NOT_USED:
+            return 0.0f;
     }
 
-    result &= binary(00001111);
-    nBitOffsetFromStart += 4;
+    return 0.0f;
+}
 
+static inline CADHandle DecodeHANDLE( DWGBitReader& oReader )
+{
+    CADHandle     result( oReader.Read4B() );
+    unsigned char counter = oReader.Read4B();
+    for( unsigned char i = 0; i < counter; ++i )
+        result.addOffset( oReader.ReadCHAR() );
     return result;
 }
 
-short ReadRAWSHORT( const char * pabyInput, size_t& nBitOffsetFromStart )
+short DWGBitReader::ReadBITSHORT()
 {
-    size_t nByteOffset      = nBitOffsetFromStart / 8;
-    size_t nBitOffsetInByte = nBitOffsetFromStart % 8;
-
-    const char * pShortFirstByte = pabyInput + nByteOffset;
-    unsigned char aShortBytes[3];
-    memcpy( aShortBytes, pShortFirstByte, 3 );
-
-    switch( nBitOffsetInByte )
-    {
-        case 0:
-            break;
-
-        default:
-            aShortBytes[0] <<= nBitOffsetInByte;
-            aShortBytes[0] |= ( aShortBytes[1] >> ( 8 - nBitOffsetInByte ) );
-            aShortBytes[1] <<= nBitOffsetInByte;
-            aShortBytes[1] |= ( aShortBytes[2] >> ( 8 - nBitOffsetInByte ) );
-            break;
-    }
-
-    void  * ptr    = aShortBytes;
-    short * result = static_cast<short *>(ptr);
-
-    nBitOffsetFromStart += 16;
-
-    return * result;
+    return DecodeBITSHORT( * this );
 }
 
-double ReadRAWDOUBLE( const char * pabyInput, size_t& nBitOffsetFromStart )
+int DWGBitReader::ReadBITLONG()
 {
-    size_t nByteOffset      = nBitOffsetFromStart / 8;
-    size_t nBitOffsetInByte = nBitOffsetFromStart % 8;
-
-    const char * pDoubleFirstByte = pabyInput + nByteOffset;
-
-    unsigned char aDoubleBytes[9];
-    memcpy( aDoubleBytes, pDoubleFirstByte, 9 );
-
-    switch( nBitOffsetInByte )
-    {
-        case 0:
-            break;
-
-        default:
-            aDoubleBytes[0] <<= nBitOffsetInByte;
-            aDoubleBytes[0] |= ( aDoubleBytes[1] >> ( 8 - nBitOffsetInByte ) );
-            aDoubleBytes[1] <<= nBitOffsetInByte;
-            aDoubleBytes[1] |= ( aDoubleBytes[2] >> ( 8 - nBitOffsetInByte ) );
-            aDoubleBytes[2] <<= nBitOffsetInByte;
-            aDoubleBytes[2] |= ( aDoubleBytes[3] >> ( 8 - nBitOffsetInByte ) );
-            aDoubleBytes[3] <<= nBitOffsetInByte;
-            aDoubleBytes[3] |= ( aDoubleBytes[4] >> ( 8 - nBitOffsetInByte ) );
-            aDoubleBytes[4] <<= nBitOffsetInByte;
-            aDoubleBytes[4] |= ( aDoubleBytes[5] >> ( 8 - nBitOffsetInByte ) );
-            aDoubleBytes[5] <<= nBitOffsetInByte;
-            aDoubleBytes[5] |= ( aDoubleBytes[6] >> ( 8 - nBitOffsetInByte ) );
-            aDoubleBytes[6] <<= nBitOffsetInByte;
-            aDoubleBytes[6] |= ( aDoubleBytes[7] >> ( 8 - nBitOffsetInByte ) );
-            aDoubleBytes[7] <<= nBitOffsetInByte;
-            aDoubleBytes[7] |= ( aDoubleBytes[8] >> ( 8 - nBitOffsetInByte ) );
-            break;
-    }
-
-    void   * ptr    = aDoubleBytes;
-    double * result = static_cast<double *>(ptr);
-
-    nBitOffsetFromStart += 64;
-
-    return * result;
+    return DecodeBITLONG( * this );
 }
 
-int ReadRAWLONG( const char * pabyInput, size_t& nBitOffsetFromStart )
+double DWGBitReader::ReadBITDOUBLE()
 {
-    size_t nByteOffset      = nBitOffsetFromStart / 8;
-    size_t nBitOffsetInByte = nBitOffsetFromStart % 8;
-
-    const char * pLongFirstByte = pabyInput + nByteOffset;
-
-    unsigned char aLongBytes[5];
-    memcpy( aLongBytes, pLongFirstByte, 5 );
-
-    switch( nBitOffsetInByte )
-    {
-        case 0:
-            break;
-
-        default:
-            aLongBytes[0] <<= nBitOffsetInByte;
-            aLongBytes[0] |= ( aLongBytes[1] >> ( 8 - nBitOffsetInByte ) );
-            aLongBytes[1] <<= nBitOffsetInByte;
-            aLongBytes[1] |= ( aLongBytes[2] >> ( 8 - nBitOffsetInByte ) );
-            aLongBytes[2] <<= nBitOffsetInByte;
-            aLongBytes[2] |= ( aLongBytes[3] >> ( 8 - nBitOffsetInByte ) );
-            aLongBytes[3] <<= nBitOffsetInByte;
-            aLongBytes[3] |= ( aLongBytes[4] >> ( 8 - nBitOffsetInByte ) );
-            break;
-    }
-
-    void * ptr    = aLongBytes;
-    int  * result = static_cast<int *>(ptr);
-
-    nBitOffsetFromStart += 32;
-
-    return * result;
+    return DecodeBITDOUBLE( * this );
 }
 
-bool ReadBIT( const char * pabyInput, size_t& nBitOffsetFromStart )
+CADHandle DWGBitReader::ReadHANDLE()
 {
-    size_t nByteOffset      = nBitOffsetFromStart / 8;
-    size_t nBitOffsetInByte = nBitOffsetFromStart % 8;
-
-    const char * pBoolByte = pabyInput + nByteOffset;
-
-    unsigned char resultVal = ( pBoolByte[0] >> ( 7 - nBitOffsetInByte ) ) & binary(00000001);
-
-    ++nBitOffsetFromStart;
-
-    return resultVal == 0 ? false : true;
+    return DecodeHANDLE( * this );
 }
 
-short ReadBITSHORT( const char * pabyInput, size_t& nBitOffsetFromStart )
+void DWGBitReader::SkipHANDLE()
 {
-    unsigned char BITCODE = Read2B( pabyInput, nBitOffsetFromStart );
-
-    size_t nByteOffset      = nBitOffsetFromStart / 8;
-    size_t nBitOffsetInByte = nBitOffsetFromStart % 8;
-
-    const char * pShortFirstByte = pabyInput + nByteOffset;
-    unsigned char aShortBytes[4]; // maximum bytes a single short can take.
-    memcpy( aShortBytes, pShortFirstByte, 4 );
-
-    switch( BITCODE )
-    {
-        case BITSHORT_NORMAL:
-        {
-            aShortBytes[0] = ( aShortBytes[0] << nBitOffsetInByte );
-            aShortBytes[0] |= ( aShortBytes[1] >> ( 8 - nBitOffsetInByte ) );
-            aShortBytes[1] = ( aShortBytes[1] << nBitOffsetInByte );
-            aShortBytes[1] |= ( aShortBytes[2] >> ( 8 - nBitOffsetInByte ) );
-
-            nBitOffsetFromStart += 16;
-
-            void  * ptr    = aShortBytes;
-            short * result = static_cast < short * > ( ptr );
-
-            return * result;
-        }
+    Read4B();
+    unsigned char counter = Read4B();
+    SkipBits( counter * 8 );
+}
 
-        case BITSHORT_UNSIGNED_CHAR:
-        {
-            aShortBytes[0] = ( aShortBytes[0] << nBitOffsetInByte );
-            aShortBytes[0] |= ( aShortBytes[1] >> ( 8 - nBitOffsetInByte ) );
+//------------------------------------------------------------------------------
+// Bit reading functions
+//------------------------------------------------------------------------------
 
-            nBitOffsetFromStart += 8;
+static inline void FinishRead( const DWGBitReader& oReader, const DWGBuffer& oInput, size_t& nBitOffsetFromStart )
+{
+    nBitOffsetFromStart = oReader.GetBitOffset();
+    if( oReader.IsOverrun() )
+        oInput.SetOverrun();
+}
 
-            return static_cast<unsigned char>(aShortBytes[0]);
-        }
+/**
+ * @brief Read one value at the caller's offset
+ */
+template<class T, T ( DWGBitReader::*Read )()>
+static inline T ReadValue( const DWGBuffer& oInput, size_t& nBitOffsetFromStart )
+{
+    DWGBitReader oReader( oInput, nBitOffsetFromStart );
+    T result = ( oReader.*Read )();
+    FinishRead( oReader, oInput, nBitOffsetFromStart );
+    return result;
+}
 
-        case BITSHORT_ZERO_VALUE:
-        {
-            nBitOffsetFromStart += 0;
-            return 0;
-        }
+unsigned char Read2B( const DWGBuffer& oInput, size_t& nBitOffsetFromStart )
+{
+    return ReadValue<unsigned char, &DWGBitReader::Read2B>( oInput, nBitOffsetFromStart );
+}
 
-        case BITSHORT_256:
-        {
-            nBitOffsetFromStart += 0;
-            return 256;
-        }
-    }
+unsigned char Read3B( const DWGBuffer& oInput, size_t& nBitOffsetFromStart )
+{
+    return ReadValue<unsigned char, &DWGBitReader::Read3B>( oInput, nBitOffsetFromStart );
+}
 
-    return -1;
+unsigned char Read4B( const DWGBuffer& oInput, size_t& nBitOffsetFromStart )
+{
+    return ReadValue<unsigned char, &DWGBitReader::Read4B>( oInput, nBitOffsetFromStart );
 }
 
-unsigned char ReadCHAR( const char * pabyInput, size_t& nBitOffsetFromStart )
+short ReadRAWSHORT( const DWGBuffer& oInput, size_t& nBitOffsetFromStart )
 {
-    unsigned char result           = 0;
-    size_t        nByteOffset      = nBitOffsetFromStart / 8;
-    size_t        nBitOffsetInByte = nBitOffsetFromStart % 8;
+    return ReadValue<short, &DWGBitReader::ReadRAWSHORT>( oInput, nBitOffsetFromStart );
+}
 
-    const char * pCharFirstByte = pabyInput + nByteOffset;
-    unsigned char aCharBytes[2]; // maximum bytes a single char can take.
-    memcpy( aCharBytes, pCharFirstByte, 2 );
+double ReadRAWDOUBLE( const DWGBuffer& oInput, size_t& nBitOffsetFromStart )
+{
+    return ReadValue<double, &DWGBitReader::ReadRAWDOUBLE>( oInput, nBitOffsetFromStart );
+}
 
-    result = ( aCharBytes[0] << nBitOffsetInByte );
-    result |= ( aCharBytes[1] >> ( 8 - nBitOffsetInByte ) );
+int ReadRAWLONG( const DWGBuffer& oInput, size_t& nBitOffsetFromStart )
+{
+    return ReadValue<int, &DWGBitReader::ReadRAWLONG>( oInput, nBitOffsetFromStart );
+}
 
-    nBitOffsetFromStart += 8;
+bool ReadBIT( const DWGBuffer& oInput, size_t& nBitOffsetFromStart )
+{
+    return ReadValue<bool, &DWGBitReader::ReadBIT>( oInput, nBitOffsetFromStart );
+}
 
+short ReadBITSHORT( const DWGBuffer& oInput, size_t& nBitOffsetFromStart )
+{
+    DWGBitReader oReader( oInput, nBitOffsetFromStart );
+    short result = DecodeBITSHORT( oReader );
+    FinishRead( oReader, oInput, nBitOffsetFromStart );
     return result;
 }
 
-std::string ReadTV( const char * pabyInput, size_t& nBitOffsetFromStart )
+unsigned char ReadCHAR( const DWGBuffer& oInput, size_t& nBitOffsetFromStart )
+{
+    return ReadValue<unsigned char, &DWGBitReader::ReadCHAR>( oInput, nBitOffsetFromStart );
+}
+
+std::string ReadTV( const DWGBuffer& oInput, size_t& nBitOffsetFromStart )
 {
     // TODO: due to CLion issues with copying text from output window, all
     //       string read are now not zero-terminated. Will fix soon.
-    short stringLength = ReadBITSHORT( pabyInput, nBitOffsetFromStart );
+    DWGBitReader oReader( oInput, nBitOffsetFromStart );
+    short stringLength = oReader.ReadBITSHORT();
 
     std::string result;
+    if( stringLength > 0 )
+        result.reserve( static_cast<size_t>( stringLength ) );
 
     for( short i = 0; i < stringLength; ++i )
     {
-        result += static_cast<char>(ReadCHAR( pabyInput, nBitOffsetFromStart ));
+        result += static_cast<char>( oReader.ReadCHAR() );
     }
 
+    FinishRead( oReader, oInput, nBitOffsetFromStart );
     return result;
 }
 
-long ReadUMCHAR( const char * pabyInput, size_t& nBitOffsetFromStart )
-{
-    // TODO: bit offset is calculated, but function has nothing to do with it.
-    long long result      = 0;
-    /*bool   negative = false;*/
-    size_t    nByteOffset = nBitOffsetFromStart / 8;
-    /*size_t nBitOffsetInByte = nBitOffsetFromStart % 8;*/
+//------------------------------------------------------------------------------
+// MCHAR
+//------------------------------------------------------------------------------
+
+// MCHAR is a little endian sequence of 7 bit groups, high bit of a byte is set
+// if one more byte follows. Bit 0x40 of the last byte of a signed MCHAR is the
+// sign. 8 bytes is maximum.
 
-    const char * pMCharFirstByte = pabyInput + nByteOffset;
-    unsigned char aMCharBytes[8]; // 8 bytes is maximum.
-    memcpy( aMCharBytes, pMCharFirstByte, 8 );
+static const uint64_t MCHAR_CONTINUATION_BITS = 0x8080808080808080ULL;
 
-    size_t      MCharBytesCount = 0;
-    for( size_t i               = 0; i < 8; ++i )
+static inline unsigned int CountTrailingZeros( uint64_t nValue )
+{
+#if defined(__GNUC__)
+    return static_cast<unsigned int>( __builtin_ctzll( nValue ) );
+#else
+    unsigned int nCount = 0;
+    while( !( nValue & 1 ) )
     {
-        aMCharBytes[i] = ReadCHAR( pabyInput, nBitOffsetFromStart );
-        ++MCharBytesCount;
-        if( !( aMCharBytes[i] & binary(10000000) ) )
-        {
-            break;
-        }
+        nValue >>= 1;
+        ++nCount;
     }
+    return nCount;
+#endif
+}
+
+static inline uint64_t LoadLittleEndian64( const unsigned char * pabyData )
+{
+    uint64_t nWord;
+    memcpy( & nWord, pabyData, 8 );
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    nWord = __builtin_bswap64( nWord );
+#endif
+    return nWord;
+}
+
+/**
+ * @brief Length in bytes of MCHAR in the lowest bytes of nWord, 0 if it
+ * doesn't end there.
+ */
+static inline size_t MCHARLength( uint64_t nWord )
+{
+    uint64_t nLastBytes = ~nWord & MCHAR_CONTINUATION_BITS;
+    if( nLastBytes == 0 )
+        return 0;
+    return CountTrailingZeros( nLastBytes ) / 8 + 1;
+}
 
-    SwapEndianness( aMCharBytes, MCharBytesCount ); // LSB to MSB
+/**
+ * @brief Decode MCHAR of nBytes lowest bytes of nWord
+ */
+static inline long DecodeMCHAR( uint64_t nWord, size_t nBytes, bool bSigned )
+{
+    if( nBytes < 8 )
+        nWord &= ( uint64_t( 1 ) << ( nBytes * 8 ) ) - 1;
+    nWord &= ~MCHAR_CONTINUATION_BITS;
+
+    // pack 7 bit groups together: 8 x 7 -> 4 x 14 -> 2 x 28 -> 56 bits
+    nWord = ( ( nWord & 0x7F007F007F007F00ULL ) >> 1 ) | ( nWord & 0x007F007F007F007FULL );
+    nWord = ( ( nWord & 0x3FFF00003FFF0000ULL ) >> 2 ) | ( nWord & 0x00003FFF00003FFFULL );
+    nWord = ( ( nWord & 0x0FFFFFFF00000000ULL ) >> 4 ) | ( nWord & 0x000000000FFFFFFFULL );
+
+    if( !bSigned )
+        return static_cast<long>( nWord );
+
+    uint64_t nSignBit = uint64_t( 1 ) << ( nBytes * 7 - 1 );
+    if( nWord & nSignBit )
+        return -static_cast<long>( nWord & ~nSignBit );
+    return static_cast<long>( nWord );
+}
 
-    for( size_t i = 0; i < MCharBytesCount; ++i )
+static long ReadMCHARValue( const DWGBuffer& oInput, size_t& nBitOffsetFromStart, bool bSigned )
+{
+    DWGBitReader oReader( oInput, nBitOffsetFromStart );
+    uint64_t nWord  = 0;
+    size_t   nBytes = 0;
+    bool     bEnded = false;
+    while( nBytes < 8 && !bEnded )
     {
-        aMCharBytes[i] &= binary(01111111);
+        unsigned char nByte = oReader.ReadCHAR();
+        nWord |= uint64_t( nByte ) << ( nBytes * 8 );
+        ++nBytes;
+        bEnded = !( nByte & 0x80 );
     }
-
-    // TODO: this code doesn't cover case when char.bytescount > 3, but it's
-    //       possible on large files.
-    // I just can't write an algorithm that does this.
-    switch( MCharBytesCount )
+    FinishRead( oReader, oInput, nBitOffsetFromStart );
+    // values are at most 8 bytes long, longer one is damaged data
+    if( !bEnded )
     {
-        case 1:
-            break;
-        case 2:
-        {
-            char tmp = aMCharBytes[0] & binary(00000001);
-            aMCharBytes[0] = aMCharBytes[0] >> 1;
-            aMCharBytes[1] |= ( tmp << 7 );
-            break;
-        }
-        case 3:
-        {
-            unsigned char tmp1 = aMCharBytes[0] & binary(00000011);
-            unsigned char tmp2 = aMCharBytes[1] & binary(00000001);
-            aMCharBytes[0]     = aMCharBytes[0] >> 2;
-            aMCharBytes[1]     = aMCharBytes[1] >> 1;
-            aMCharBytes[1] |= ( tmp1 << 6 );
-            aMCharBytes[2] |= ( tmp2 << 7 );
-            break;
-        }
-        case 4:
-        {
-            unsigned char tmp1 = aMCharBytes[0] & binary(00000111);
-            unsigned char tmp2 = aMCharBytes[1] & binary(00000011);
-            unsigned char tmp3 = aMCharBytes[2] & binary(00000001);
-            aMCharBytes[0]     = aMCharBytes[0] >> 3;
-            aMCharBytes[1]     = aMCharBytes[1] >> 2;
-            aMCharBytes[2]     = aMCharBytes[2] >> 1;
-            aMCharBytes[1] |= ( tmp1 << 5 );
-            aMCharBytes[2] |= ( tmp2 << 6 );
-            aMCharBytes[3] |= ( tmp3 << 7 );
-            break;
-        }
+        oInput.SetOverrun();
+        return 0;
     }
-
-    SwapEndianness( aMCharBytes, MCharBytesCount ); // MSB to LSB
-
-    memcpy( & result, aMCharBytes, MCharBytesCount );
-
-    return result;
+    return DecodeMCHAR( nWord, nBytes, bSigned );
 }
 
-long ReadMCHAR( const char * pabyInput, size_t& nBitOffsetFromStart )
+long ReadUMCHAR( const DWGBuffer& oInput, size_t& nBitOffsetFromStart )
 {
-    long   result      = 0;
-    bool   negative    = false;
-    size_t nByteOffset = nBitOffsetFromStart / 8;
+    return ReadMCHARValue( oInput, nBitOffsetFromStart, false );
+}
 
-    // TODO: bit offset is calculated, but function has nothing to do with it.
-    /*size_t nBitOffsetInByte = nBitOffsetFromStart % 8;*/
+long ReadMCHAR( const DWGBuffer& oInput, size_t& nBitOffsetFromStart )
+{
+    return ReadMCHARValue( oInput, nBitOffsetFromStart, true );
+}
 
-    const char * pMCharFirstByte = pabyInput + nByteOffset;
-    unsigned char aMCharBytes[8]; // 8 bytes is maximum.
-    memcpy( aMCharBytes, pMCharFirstByte, 8 );
+bool ReadUMCHARMCHARPairs( const DWGBuffer& oInput, size_t nDataSize, std::vector<std::pair<long, long> >& aPairs )
+{
+    const unsigned char * pabyData = reinterpret_cast<const unsigned char *>( oInput.GetData() );
+    size_t nSize   = std::min( oInput.GetSize(), std::numeric_limits<size_t>::max() - 8 );
+    size_t nOffset = 0;
+    long   anValues[2];
+    size_t iValue  = 0;
 
-    size_t      MCharBytesCount = 0;
-    for( size_t i               = 0; i < 8; ++i )
+    while( nOffset < nDataSize || iValue == 1 )
     {
-        aMCharBytes[i] = ReadCHAR( pabyInput, nBitOffsetFromStart );
-        ++MCharBytesCount;
-        if( !( aMCharBytes[i] & binary(10000000) ) )
+        // Load next 8 bytes as a little endian word, zero padded near the end
+        uint64_t nWord = 0;
+        if( nOffset + 8 <= nSize )
         {
-            break;
+            nWord = LoadLittleEndian64( pabyData + nOffset );
         }
-    }
-
-    SwapEndianness( aMCharBytes, MCharBytesCount ); // LSB to MSB
-
-    if( ( aMCharBytes[0] & binary(01000000) ) == binary(01000000) )
-    {
-        aMCharBytes[0] &= binary(10111111);
-        negative = true;
-    }
-
-    for( size_t i = 0; i < MCharBytesCount; ++i )
-    {
-        aMCharBytes[i] &= binary(01111111);
-    }
-
-    // TODO: this code doesn't cover case when char.bytescount > 3, but it's
-    //       possible on large files.
-    // I just can't write an algorithm that does this.
-    switch( MCharBytesCount )
-    {
-        case 1:
-            break;
-        case 2:
+        else
         {
-            char tmp = aMCharBytes[0] & binary(00000001);
-            aMCharBytes[0] = aMCharBytes[0] >> 1;
-            aMCharBytes[1] |= ( tmp << 7 );
-            break;
+            if( nOffset >= nSize )
+            {
+                oInput.SetOverrun();
+                return false;
+            }
+            unsigned char abyTail[8] = { 0 };
+            memcpy( abyTail, pabyData + nOffset, nSize - nOffset );
+            nWord = LoadLittleEndian64( abyTail );
         }
-        case 3:
+
+        size_t nBytes = MCHARLength( nWord );
+        if( nBytes == 0 || nOffset + nBytes > nSize )
         {
-            unsigned char tmp1 = aMCharBytes[0] & binary(00000011);
-            unsigned char tmp2 = aMCharBytes[1] & binary(00000001);
-            aMCharBytes[0]     = aMCharBytes[0] >> 2;
-            aMCharBytes[1]     = aMCharBytes[1] >> 1;
-            aMCharBytes[1] |= ( tmp1 << 6 );
-            aMCharBytes[2] |= ( tmp2 << 7 );
-            break;
+            oInput.SetOverrun();
+            return false;
         }
-        case 4:
+
+        anValues[iValue] = DecodeMCHAR( nWord, nBytes, iValue == 1 );
+        nOffset += nBytes;
+        if( ++iValue == 2 )
         {
-            unsigned char tmp1 = aMCharBytes[0] & binary(00000111);
-            unsigned char tmp2 = aMCharBytes[1] & binary(00000011);
-            unsigned char tmp3 = aMCharBytes[2] & binary(00000001);
-            aMCharBytes[0]     = aMCharBytes[0] >> 3;
-            aMCharBytes[1]     = aMCharBytes[1] >> 2;
-            aMCharBytes[2]     = aMCharBytes[2] >> 1;
-            aMCharBytes[1] |= ( tmp1 << 5 );
-            aMCharBytes[2] |= ( tmp2 << 6 );
-            aMCharBytes[3] |= ( tmp3 << 7 );
-            break;
+            aPairs.push_back( std::make_pair( anValues[0], anValues[1] ) );
+            iValue = 0;
         }
     }
-
-    SwapEndianness( aMCharBytes, MCharBytesCount ); // MSB to LSB
-
-    memcpy( & result, aMCharBytes, MCharBytesCount );
-
-    if( negative ) result *= -1;
-
-    return result;
+    return true;
 }
 
-unsigned int ReadMSHORT( const char * pabyInput, size_t& nBitOffsetFromStart )
+unsigned int ReadMSHORT( const DWGBuffer& oInput, size_t& nBitOffsetFromStart )
 {
     unsigned int  result = 0;
-    /*size_t nByteOffset      = nBitOffsetFromStart / 8;
-    size_t nBitOffsetInByte = nBitOffsetFromStart % 8;
-
-    const char * pMShortFirstByte = pabyInput + nByteOffset;*/
     unsigned char aMShortBytes[8]; // 8 bytes is maximum.
 
     // TODO: this function doesn't support MSHORTS longer than 4 bytes. ODA says
     //       it's impossible, but not sure.
     size_t MShortBytesCount = 2;
-    aMShortBytes[0] = ReadCHAR( pabyInput, nBitOffsetFromStart );
-    aMShortBytes[1] = ReadCHAR( pabyInput, nBitOffsetFromStart );
+    aMShortBytes[0] = ReadCHAR( oInput, nBitOffsetFromStart );
+    aMShortBytes[1] = ReadCHAR( oInput, nBitOffsetFromStart );
     if( aMShortBytes[1] & binary(10000000) )
     {
-        aMShortBytes[2] = ReadCHAR( pabyInput, nBitOffsetFromStart );
-        aMShortBytes[3] = ReadCHAR( pabyInput, nBitOffsetFromStart );
+        aMShortBytes[2] = ReadCHAR( oInput, nBitOffsetFromStart );
+        aMShortBytes[3] = ReadCHAR( oInput, nBitOffsetFromStart );
         MShortBytesCount = 4;
     }
 
@@ -556,77 +421,20 @@ unsigned int ReadMSHORT( const char * pabyInput, size_t& nBitOffsetFromStart )
     return result;
 }
 
-double ReadBITDOUBLE( const char * pabyInput, size_t& nBitOffsetFromStart )
+double ReadBITDOUBLE( const DWGBuffer& oInput, size_t& nBitOffsetFromStart )
 {
-    unsigned char BITCODE = Read2B( pabyInput, nBitOffsetFromStart );
-
-    size_t nByteOffset      = nBitOffsetFromStart / 8;
-    size_t nBitOffsetInByte = nBitOffsetFromStart % 8;
-
-    const char * pDoubleFirstByte = pabyInput + nByteOffset;
-    unsigned char aDoubleBytes[9]; // maximum bytes a single double can take.
-    memcpy( aDoubleBytes, pDoubleFirstByte, 9 );
-
-    switch( BITCODE )
-    {
-        case BITDOUBLE_NORMAL:
-        {
-            aDoubleBytes[0] <<= nBitOffsetInByte;
-            aDoubleBytes[0] |= ( aDoubleBytes[1] >> ( 8 - nBitOffsetInByte ) );
-            aDoubleBytes[1] <<= nBitOffsetInByte;
-            aDoubleBytes[1] |= ( aDoubleBytes[2] >> ( 8 - nBitOffsetInByte ) );
-            aDoubleBytes[2] <<= nBitOffsetInByte;
-            aDoubleBytes[2] |= ( aDoubleBytes[3] >> ( 8 - nBitOffsetInByte ) );
-            aDoubleBytes[3] <<= nBitOffsetInByte;
-            aDoubleBytes[3] |= ( aDoubleBytes[4] >> ( 8 - nBitOffsetInByte ) );
-            aDoubleBytes[4] <<= nBitOffsetInByte;
-            aDoubleBytes[4] |= ( aDoubleBytes[5] >> ( 8 - nBitOffsetInByte ) );
-            aDoubleBytes[5] <<= nBitOffsetInByte;
-            aDoubleBytes[5] |= ( aDoubleBytes[6] >> ( 8 - nBitOffsetInByte ) );
-            aDoubleBytes[6] <<= nBitOffsetInByte;
-            aDoubleBytes[6] |= ( aDoubleBytes[7] >> ( 8 - nBitOffsetInByte ) );
-            aDoubleBytes[7] <<= nBitOffsetInByte;
-            aDoubleBytes[7] |= ( aDoubleBytes[8] >> ( 8 - nBitOffsetInByte ) );
-
-            nBitOffsetFromStart += 64;
-
-            void   * ptr    = aDoubleBytes;
-            double * result = static_cast< double *> ( ptr );
-
-            return * result;
-        }
-
-        case BITDOUBLE_ONE_VALUE:
-        {
-            nBitOffsetFromStart += 0;
-
-            return 1.0f;
-        }
-
-        case BITDOUBLE_ZERO_VALUE:
-        {
-            nBitOffsetFromStart += 0;
-
-            return 0.0f;
-        }
-
-        case BITDOUBLE_NOT_USED:
-        {
-            nBitOffsetFromStart += 0;
-
-            return 0.0f;
-        }
-    }
-
-    return 0.0f;
+    DWGBitReader oReader( oInput, nBitOffsetFromStart );
+    double result = DecodeBITDOUBLE( oReader );
+    FinishRead( oReader, oInput, nBitOffsetFromStart );
+    return result;
 }
 
-double ReadBITDOUBLEWD( const char * pabyInput, size_t& nBitOffsetFromStart, double defaultvalue )
+double ReadBITDOUBLEWD( const DWGBuffer& oInput, size_t& nBitOffsetFromStart, double defaultvalue )
 {
     unsigned char aDefaultValueBytes[8];
     memcpy( aDefaultValueBytes, & defaultvalue, 8 );
 
-    unsigned char BITCODE = Read2B( pabyInput, nBitOffsetFromStart );
+    unsigned char BITCODE = Read2B( oInput, nBitOffsetFromStart );
 
     switch( BITCODE )
     {
@@ -637,10 +445,10 @@ double ReadBITDOUBLEWD( const char * pabyInput, size_t& nBitOffsetFromStart, dou
 
         case BITDOUBLEWD_4BYTES_PATCHED:
         {
-            aDefaultValueBytes[0] = ReadCHAR( pabyInput, nBitOffsetFromStart );
-            aDefaultValueBytes[1] = ReadCHAR( pabyInput, nBitOffsetFromStart );
-            aDefaultValueBytes[2] = ReadCHAR( pabyInput, nBitOffsetFromStart );
-            aDefaultValueBytes[3] = ReadCHAR( pabyInput, nBitOffsetFromStart );
+            aDefaultValueBytes[0] = ReadCHAR( oInput, nBitOffsetFromStart );
+            aDefaultValueBytes[1] = ReadCHAR( oInput, nBitOffsetFromStart );
+            aDefaultValueBytes[2] = ReadCHAR( oInput, nBitOffsetFromStart );
+            aDefaultValueBytes[3] = ReadCHAR( oInput, nBitOffsetFromStart );
 
             void   * ptr    = aDefaultValueBytes;
             double * result = static_cast< double *> ( ptr );
@@ -650,12 +458,12 @@ double ReadBITDOUBLEWD( const char * pabyInput, size_t& nBitOffsetFromStart, dou
 
         case BITDOUBLEWD_6BYTES_PATCHED:
         {
-            aDefaultValueBytes[4] = ReadCHAR( pabyInput, nBitOffsetFromStart );
-            aDefaultValueBytes[5] = ReadCHAR( pabyInput, nBitOffsetFromStart );
-            aDefaultValueBytes[0] = ReadCHAR( pabyInput, nBitOffsetFromStart );
-            aDefaultValueBytes[1] = ReadCHAR( pabyInput, nBitOffsetFromStart );
-            aDefaultValueBytes[2] = ReadCHAR( pabyInput, nBitOffsetFromStart );
-            aDefaultValueBytes[3] = ReadCHAR( pabyInput, nBitOffsetFromStart );
+            aDefaultValueBytes[4] = ReadCHAR( oInput, nBitOffsetFromStart );
+            aDefaultValueBytes[5] = ReadCHAR( oInput, nBitOffsetFromStart );
+            aDefaultValueBytes[0] = ReadCHAR( oInput, nBitOffsetFromStart );
+            aDefaultValueBytes[1] = ReadCHAR( oInput, nBitOffsetFromStart );
+            aDefaultValueBytes[2] = ReadCHAR( oInput, nBitOffsetFromStart );
+            aDefaultValueBytes[3] = ReadCHAR( oInput, nBitOffsetFromStart );
 
             void   * ptr    = aDefaultValueBytes;
             double * result = static_cast< double *> ( ptr );
@@ -665,14 +473,14 @@ double ReadBITDOUBLEWD( const char * pabyInput, size_t& nBitOffsetFromStart, dou
 
         case BITDOUBLEWD_FULL_RD:
         {
-            aDefaultValueBytes[0] = ReadCHAR( pabyInput, nBitOffsetFromStart );
-            aDefaultValueBytes[1] = ReadCHAR( pabyInput, nBitOffsetFromStart );
-            aDefaultValueBytes[2] = ReadCHAR( pabyInput, nBitOffsetFromStart );
-            aDefaultValueBytes[3] = ReadCHAR( pabyInput, nBitOffsetFromStart );
-            aDefaultValueBytes[4] = ReadCHAR( pabyInput, nBitOffsetFromStart );
-            aDefaultValueBytes[5] = ReadCHAR( pabyInput, nBitOffsetFromStart );
-            aDefaultValueBytes[6] = ReadCHAR( pabyInput, nBitOffsetFromStart );
-            aDefaultValueBytes[7] = ReadCHAR( pabyInput, nBitOffsetFromStart );
+            aDefaultValueBytes[0] = ReadCHAR( oInput, nBitOffsetFromStart );
+            aDefaultValueBytes[1] = ReadCHAR( oInput, nBitOffsetFromStart );
+            aDefaultValueBytes[2] = ReadCHAR( oInput, nBitOffsetFromStart );
+            aDefaultValueBytes[3] = ReadCHAR( oInput, nBitOffsetFromStart );
+            aDefaultValueBytes[4] = ReadCHAR( oInput, nBitOffsetFromStart );
+            aDefaultValueBytes[5] = ReadCHAR( oInput, nBitOffsetFromStart );
+            aDefaultValueBytes[6] = ReadCHAR( oInput, nBitOffsetFromStart );
+            aDefaultValueBytes[7] = ReadCHAR( oInput, nBitOffsetFromStart );
 
             void   * ptr    = aDefaultValueBytes;
             double * result = static_cast< double *> ( ptr );
@@ -684,103 +492,46 @@ double ReadBITDOUBLEWD( const char * pabyInput, size_t& nBitOffsetFromStart, dou
     return 0.0f;
 }
 
-CADHandle ReadHANDLE( const char * pabyInput, size_t& nBitOffsetFromStart )
+CADHandle ReadHANDLE( const DWGBuffer& oInput, size_t& nBitOffsetFromStart )
 {
-    CADHandle          result( Read4B( pabyInput, nBitOffsetFromStart ) );
-    unsigned char      counter = Read4B( pabyInput, nBitOffsetFromStart );
-    for( unsigned char i       = 0; i < counter; ++i )
-    {
-        result.addOffset( ReadCHAR( pabyInput, nBitOffsetFromStart ) );
-    }
-
+    DWGBitReader oReader( oInput, nBitOffsetFromStart );
+    CADHandle result = DecodeHANDLE( oReader );
+    FinishRead( oReader, oInput, nBitOffsetFromStart );
     return result;
 }
 
-void SkipHANDLE( const char * pabyInput, size_t& nBitOffsetFromStart )
+void SkipHANDLE( const DWGBuffer& oInput, size_t& nBitOffsetFromStart )
 {
-    Read4B( pabyInput, nBitOffsetFromStart );
-    unsigned char counter = static_cast<unsigned char>(Read4B( pabyInput, nBitOffsetFromStart ));
+    Read4B( oInput, nBitOffsetFromStart );
+    unsigned char counter = static_cast<unsigned char>(Read4B( oInput, nBitOffsetFromStart ));
     nBitOffsetFromStart += counter * 8;
 }
 
-CADHandle ReadHANDLE8BLENGTH( const char * pabyInput, size_t& nBitOffsetFromStart )
+CADHandle ReadHANDLE8BLENGTH( const DWGBuffer& oInput, size_t& nBitOffsetFromStart )
 {
     CADHandle result;
 
-    unsigned char counter = ReadCHAR( pabyInput, nBitOffsetFromStart );
+    unsigned char counter = ReadCHAR( oInput, nBitOffsetFromStart );
 
     for( unsigned char i = 0; i < counter; ++i )
     {
-        result.addOffset( ReadCHAR( pabyInput, nBitOffsetFromStart ) );
+        result.addOffset( ReadCHAR( oInput, nBitOffsetFromStart ) );
     }
 
     return result;
 }
 
-int ReadBITLONG( const char * pabyInput, size_t& nBitOffsetFromStart )
+int ReadBITLONG( const DWGBuffer& oInput, size_t& nBitOffsetFromStart )
 {
-    unsigned char BITCODE = Read2B( pabyInput, nBitOffsetFromStart );
-
-    size_t nByteOffset      = nBitOffsetFromStart / 8;
-    size_t nBitOffsetInByte = nBitOffsetFromStart % 8;
-
-    const char * pLongFirstByte = pabyInput + nByteOffset;
-    unsigned char aLongBytes[5]; // maximum bytes a single short can take.
-    memcpy( aLongBytes, pLongFirstByte, 5 );
-
-    switch( BITCODE )
-    {
-        case BITLONG_NORMAL:
-        {
-            aLongBytes[0] <<= nBitOffsetInByte;
-            aLongBytes[0] |= ( aLongBytes[1] >> ( 8 - nBitOffsetInByte ) );
-            aLongBytes[1] <<= nBitOffsetInByte;
-            aLongBytes[1] |= ( aLongBytes[2] >> ( 8 - nBitOffsetInByte ) );
-            aLongBytes[2] <<= nBitOffsetInByte;
-            aLongBytes[2] |= ( aLongBytes[3] >> ( 8 - nBitOffsetInByte ) );
-            aLongBytes[3] <<= nBitOffsetInByte;
-            aLongBytes[3] |= ( aLongBytes[4] >> ( 8 - nBitOffsetInByte ) );
-
-            nBitOffsetFromStart += 32;
-
-            void * ptr    = aLongBytes;
-            int  * result = static_cast < int * > ( ptr );
-
-            return * result;
-        }
-
-        case BITLONG_UNSIGNED_CHAR:
-        {
-            aLongBytes[0] <<= nBitOffsetInByte;
-            aLongBytes[0] |= ( aLongBytes[1] >> ( 8 - nBitOffsetInByte ) );
-
-            nBitOffsetFromStart += 8;
-
-            return aLongBytes[0];
-        }
-
-        case BITLONG_ZERO_VALUE:
-        {
-            nBitOffsetFromStart += 0;
-            return 0;
-        }
-
-        case BITLONG_NOT_USED:
-        {
-            std::cerr <<
-            "THAT SHOULD NEVER HAPPENED! BUG. (in file, or reader, or both.) ReadBITLONG(), case BITLONG_NOT_USED" <<
-            std::endl;
-            nBitOffsetFromStart += 0;
-            return 0;
-        }
-    }
-
-    return -1;
+    DWGBitReader oReader( oInput, nBitOffsetFromStart );
+    int result = DecodeBITLONG( oReader );
+    FinishRead( oReader, oInput, nBitOffsetFromStart );
+    return result;
 }
 
-void SkipBITDOUBLE( const char * pabyInput, size_t& nBitOffsetFromStart )
+void SkipBITDOUBLE( const DWGBuffer& oInput, size_t& nBitOffsetFromStart )
 {
-    unsigned char BITCODE = Read2B( pabyInput, nBitOffsetFromStart );
+    unsigned char BITCODE = Read2B( oInput, nBitOffsetFromStart );
 
     switch( BITCODE )
     {
@@ -796,15 +547,15 @@ void SkipBITDOUBLE( const char * pabyInput, size_t& nBitOffsetFromStart )
     }
 }
 
-void SkipTV( const char * pabyInput, size_t& nBitOffsetFromStart )
+void SkipTV( const DWGBuffer& oInput, size_t& nBitOffsetFromStart )
 {
-    short stringLength = ReadBITSHORT( pabyInput, nBitOffsetFromStart );
+    short stringLength = ReadBITSHORT( oInput, nBitOffsetFromStart );
     nBitOffsetFromStart += size_t( stringLength * 8 );
 }
 
-void SkipBITLONG( const char * pabyInput, size_t& nBitOffsetFromStart )
+void SkipBITLONG( const DWGBuffer& oInput, size_t& nBitOffsetFromStart )
 {
-    unsigned char BITCODE = Read2B( pabyInput, nBitOffsetFromStart );
+    unsigned char BITCODE = Read2B( oInput, nBitOffsetFromStart );
     switch( BITCODE )
     {
         case BITLONG_NORMAL:
@@ -821,9 +572,9 @@ void SkipBITLONG( const char * pabyInput, size_t& nBitOffsetFromStart )
     }
 }
 
-void SkipBITSHORT( const char * pabyInput, size_t& nBitOffsetFromStart )
+void SkipBITSHORT( const DWGBuffer& oInput, size_t& nBitOffsetFromStart )
 {
-    unsigned char BITCODE = Read2B( pabyInput, nBitOffsetFromStart );
+    unsigned char BITCODE = Read2B( oInput, nBitOffsetFromStart );
     switch( BITCODE )
     {
         case BITSHORT_NORMAL:
@@ -840,26 +591,36 @@ void SkipBITSHORT( const char * pabyInput, size_t& nBitOffsetFromStart )
     }
 }
 
-void SkipBIT( const char * /*pabyInput*/, size_t& nBitOffsetFromStart )
+void SkipBIT( const DWGBuffer& /*oInput*/, size_t& nBitOffsetFromStart )
 {
     ++nBitOffsetFromStart;
 }
 
-CADVector ReadVector( const char * pabyInput, size_t& nBitOffsetFromStart )
+void AlignToByte( size_t& nBitOffsetFromStart )
+{
+    if( nBitOffsetFromStart % 8 != 0 )
+        nBitOffsetFromStart += 8 - ( nBitOffsetFromStart % 8 );
+}
+
+CADVector ReadVector( const DWGBuffer& oInput, size_t& nBitOffsetFromStart )
 {
+    DWGBitReader oReader( oInput, nBitOffsetFromStart );
     double x, y, z;
-    x = ReadBITDOUBLE( pabyInput, nBitOffsetFromStart );
-    y = ReadBITDOUBLE( pabyInput, nBitOffsetFromStart );
-    z = ReadBITDOUBLE( pabyInput, nBitOffsetFromStart );
+    x = DecodeBITDOUBLE( oReader );
+    y = DecodeBITDOUBLE( oReader );
+    z = DecodeBITDOUBLE( oReader );
+    FinishRead( oReader, oInput, nBitOffsetFromStart );
 
     return CADVector( x, y, z );
 }
 
-CADVector ReadRAWVector( const char * pabyInput, size_t& nBitOffsetFromStart )
+CADVector ReadRAWVector( const DWGBuffer& oInput, size_t& nBitOffsetFromStart )
 {
+    DWGBitReader oReader( oInput, nBitOffsetFromStart );
     double x, y;
-    x = ReadRAWDOUBLE( pabyInput, nBitOffsetFromStart );
-    y = ReadRAWDOUBLE( pabyInput, nBitOffsetFromStart );
+    x = oReader.ReadRAWDOUBLE();
+    y = oReader.ReadRAWDOUBLE();
+    FinishRead( oReader, oInput, nBitOffsetFromStart );
 
     return CADVector( x, y );
 }
@@ -34,8 +34,12 @@
 #include "cadheader.h"
 #include "cadobjects.h"
 
+#include <cstdint>
+#include <cstring>
 #include <string>
 #include <algorithm>
+#include <utility>
+#include <vector>
 
 /* DATA TYPES CONSTANTS */
 
@@ -128,33 +132,279 @@ static const int DWGCRC8Table[256] = {
 
 unsigned short CalculateCRC8( unsigned short initialVal, const char * ptr, int num );
 
-long          ReadRAWLONGLONG( const char * pabyInput, size_t& nBitOffsetFromStart );
-int           ReadRAWLONG( const char * pabyInput, size_t& nBitOffsetFromStart );
-short         ReadRAWSHORT( const char * pabyInput, size_t& nBitOffsetFromStart );
-double        ReadRAWDOUBLE( const char * pabyInput, size_t& nBitOffsetFromStart );
-unsigned char Read2B( const char * pabyInput, size_t& nBitOffsetFromStart );
-unsigned char Read3B( const char * pabyInput, size_t& nBitOffsetFromStart );
-unsigned char Read4B( const char * pabyInput, size_t& nBitOffsetFromStart );
-CADHandle     ReadHANDLE( const char * pabyInput, size_t& nBitOffsetFromStart );
-CADHandle     ReadHANDLE8BLENGTH( const char * pabyInput, size_t& nBitOffsetFromStart );
-void          SkipHANDLE( const char * pabyInput, size_t& nBitOffsetFromStart );
-bool          ReadBIT( const char * pabyInput, size_t& nBitOffsetFromStart );
-void          SkipBIT( const char * pabyInput, size_t& nBitOffsetFromStart );
-unsigned char ReadCHAR( const char * pabyInput, size_t& nBitOffsetFromStart );
-short         ReadBITSHORT( const char * pabyInput, size_t& nBitOffsetFromStart );
-int           ReadBITLONG( const char * pabyInput, size_t& nBitOffsetFromStart );
-double        ReadBITDOUBLE( const char * pabyInput, size_t& nBitOffsetFromStart );
-void          SkipBITDOUBLE( const char * pabyInput, size_t& nBitOffsetFromStart );
-double        ReadBITDOUBLEWD( const char * pabyInput, size_t& nBitOffsetFromStart, double defaultvalue );
-long          ReadMCHAR( const char * pabyInput, size_t& nBitOffsetFromStart );
-long          ReadUMCHAR( const char * pabyInput, size_t& nBitOffsetFromStart );
-unsigned int  ReadMSHORT( const char * pabyInput, size_t& nBitOffsetFromStart );
-std::string   ReadTV( const char * pabyInput, size_t& nBitOffsetFromStart );
-void          SkipTV( const char * pabyInput, size_t& nBitOffsetFromStart );
-void          SkipBITLONG( const char * pabyInput, size_t& nBitOffsetFromStart );
-void          SkipBITSHORT( const char * pabyInput, size_t& nBitOffsetFromStart );
-
-CADVector ReadVector( const char * pabyInput, size_t& nBitOffsetFromStart );
-CADVector ReadRAWVector( const char * pabyInput, size_t& nBitOffsetFromStart );
+/**
+ * @brief The DWGBuffer class is DWG bit coded input with known size. Reading
+ * past its end gives zero bits and marks the buffer as overrun instead of
+ * touching memory behind it.
+ */
+class DWGBuffer
+{
+public:
+    DWGBuffer( const char * pabyData, size_t nSize );
+
+    const char * GetData() const;
+    size_t       GetSize() const;
+
+    /**
+     * @brief returns true if any read went past the end of the buffer
+     */
+    bool IsOverrun() const;
+    void SetOverrun() const;
+
+protected:
+    const char * m_pabyData;
+    size_t       m_nSize;
+    mutable bool m_bOverrun;
+};
+
+/**
+ * @brief The DWGBitReader class reads DWG bit coded values sequentially. Every
+ * value is taken with a single shift of 8 bytes loaded at its offset, bytes
+ * are loaded one by one only near the end of the input. Reader keeps no data
+ * but the offset, so it costs nothing to construct, the bit reading functions
+ * below use it for every value too. Fixed size reads are inline, they are
+ * called for every value decoded.
+ */
+class DWGBitReader
+{
+public:
+    DWGBitReader( const DWGBuffer& oInput, size_t nBitOffsetFromStart = 0 );
+
+    size_t GetBitOffset() const;
+    void   SetBitOffset( size_t nBitOffsetFromStart );
+    void   SkipBits( size_t nBits );
+
+    /**
+     * @brief returns true if reader went past the end of the input
+     */
+    bool   IsOverrun() const;
+
+    bool          ReadBIT();
+    unsigned char Read2B();
+    unsigned char Read3B();
+    unsigned char Read4B();
+    unsigned char ReadCHAR();
+    short         ReadRAWSHORT();
+    int           ReadRAWLONG();
+    double        ReadRAWDOUBLE();
+    short         ReadBITSHORT();
+    int           ReadBITLONG();
+    double        ReadBITDOUBLE();
+    CADHandle     ReadHANDLE();
+    void          SkipHANDLE();
+
+protected:
+    /**
+     * @brief Read up to 32 bits, most significant bit first
+     */
+    uint32_t ReadBits( unsigned int nBits );
+
+protected:
+    const unsigned char * m_pabyInput;
+    size_t                m_nSize;
+    size_t                m_nBitOffset;
+    bool                  m_bOverrun;
+};
+
+inline DWGBuffer::DWGBuffer( const char * pabyData, size_t nSize ) :
+    m_pabyData( pabyData ),
+    m_nSize( nSize ),
+    m_bOverrun( false )
+{
+}
+
+inline const char * DWGBuffer::GetData() const
+{
+    return m_pabyData;
+}
+
+inline size_t DWGBuffer::GetSize() const
+{
+    return m_nSize;
+}
+
+inline bool DWGBuffer::IsOverrun() const
+{
+    return m_bOverrun;
+}
+
+inline void DWGBuffer::SetOverrun() const
+{
+    m_bOverrun = true;
+}
+
+// Values are stored little-endian, bits come most significant first, so
+// ReadBits() returns bytes in reversed order.
+static inline uint16_t SwapBytes16( uint32_t val )
+{
+    return static_cast<uint16_t>( ( ( val & 0xFF ) << 8 ) | ( ( val >> 8 ) & 0xFF ) );
+}
+
+static inline uint32_t SwapBytes32( uint32_t val )
+{
+    return ( val << 24 ) | ( ( val & 0xFF00 ) << 8 ) | ( ( val >> 8 ) & 0xFF00 ) | ( val >> 24 );
+}
+
+static inline uint64_t LoadBigEndian64( const unsigned char * pabyData )
+{
+#if defined(__GNUC__)
+    uint64_t nWord;
+    memcpy( & nWord, pabyData, 8 );
+#if !defined(__BYTE_ORDER__) || __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    nWord = __builtin_bswap64( nWord );
+#endif
+    return nWord;
+#else
+    uint64_t nWord = 0;
+    for( size_t i = 0; i < 8; ++i )
+        nWord = ( nWord << 8 ) | pabyData[i];
+    return nWord;
+#endif
+}
+
+inline DWGBitReader::DWGBitReader( const DWGBuffer& oInput, size_t nBitOffsetFromStart ) :
+    m_pabyInput( reinterpret_cast<const unsigned char *>( oInput.GetData() ) ),
+    m_nSize( oInput.GetSize() ),
+    m_nBitOffset( nBitOffsetFromStart ),
+    m_bOverrun( false )
+{
+}
+
+inline size_t DWGBitReader::GetBitOffset() const
+{
+    return m_nBitOffset;
+}
+
+inline void DWGBitReader::SetBitOffset( size_t nBitOffsetFromStart )
+{
+    m_nBitOffset = nBitOffsetFromStart;
+}
+
+inline void DWGBitReader::SkipBits( size_t nBits )
+{
+    m_nBitOffset += nBits;
+}
+
+inline bool DWGBitReader::IsOverrun() const
+{
+    return m_bOverrun;
+}
+
+inline uint32_t DWGBitReader::ReadBits( unsigned int nBits )
+{
+    size_t       nByte  = m_nBitOffset / 8;
+    unsigned int nShift = m_nBitOffset % 8;
+    uint64_t     nWord  = 0;
+    if( nByte < m_nSize && m_nSize - nByte >= 8 )
+    {
+        nWord = LoadBigEndian64( m_pabyInput + nByte );
+    }
+    else
+    {
+        // end of the input, missing bytes are zero
+        size_t nBytes = ( nShift + nBits + 7 ) / 8;
+        for( size_t i = 0; i < nBytes; ++i )
+        {
+            if( nByte + i < m_nSize )
+                nWord |= uint64_t( m_pabyInput[nByte + i] ) << ( 56 - 8 * i );
+            else
+                m_bOverrun = true;
+        }
+    }
+    m_nBitOffset += nBits;
+    return static_cast<uint32_t>( ( nWord << nShift ) >> ( 64 - nBits ) );
+}
+
+inline bool DWGBitReader::ReadBIT()
+{
+    return ReadBits( 1 ) != 0;
+}
+
+inline unsigned char DWGBitReader::Read2B()
+{
+    return static_cast<unsigned char>( ReadBits( 2 ) );
+}
+
+inline unsigned char DWGBitReader::Read3B()
+{
+    return static_cast<unsigned char>( ReadBits( 3 ) );
+}
+
+inline unsigned char DWGBitReader::Read4B()
+{
+    return static_cast<unsigned char>( ReadBits( 4 ) );
+}
+
+inline unsigned char DWGBitReader::ReadCHAR()
+{
+    return static_cast<unsigned char>( ReadBits( 8 ) );
+}
+
+inline short DWGBitReader::ReadRAWSHORT()
+{
+    return static_cast<short>( SwapBytes16( ReadBits( 16 ) ) );
+}
+
+inline int DWGBitReader::ReadRAWLONG()
+{
+    return static_cast<int>( SwapBytes32( ReadBits( 32 ) ) );
+}
+
+inline double DWGBitReader::ReadRAWDOUBLE()
+{
+    uint64_t nLow  = SwapBytes32( ReadBits( 32 ) );
+    uint64_t nHigh = SwapBytes32( ReadBits( 32 ) );
+    uint64_t nRaw  = ( nHigh << 32 ) | nLow;
+
+    double result;
+    memcpy( & result, & nRaw, 8 );
+    return result;
+}
+
+long          ReadRAWLONGLONG( const DWGBuffer& oInput, size_t& nBitOffsetFromStart );
+int           ReadRAWLONG( const DWGBuffer& oInput, size_t& nBitOffsetFromStart );
+short         ReadRAWSHORT( const DWGBuffer& oInput, size_t& nBitOffsetFromStart );
+double        ReadRAWDOUBLE( const DWGBuffer& oInput, size_t& nBitOffsetFromStart );
+unsigned char Read2B( const DWGBuffer& oInput, size_t& nBitOffsetFromStart );
+unsigned char Read3B( const DWGBuffer& oInput, size_t& nBitOffsetFromStart );
+unsigned char Read4B( const DWGBuffer& oInput, size_t& nBitOffsetFromStart );
+CADHandle     ReadHANDLE( const DWGBuffer& oInput, size_t& nBitOffsetFromStart );
+CADHandle     ReadHANDLE8BLENGTH( const DWGBuffer& oInput, size_t& nBitOffsetFromStart );
+void          SkipHANDLE( const DWGBuffer& oInput, size_t& nBitOffsetFromStart );
+bool          ReadBIT( const DWGBuffer& oInput, size_t& nBitOffsetFromStart );
+void          SkipBIT( const DWGBuffer& oInput, size_t& nBitOffsetFromStart );
+unsigned char ReadCHAR( const DWGBuffer& oInput, size_t& nBitOffsetFromStart );
+short         ReadBITSHORT( const DWGBuffer& oInput, size_t& nBitOffsetFromStart );
+int           ReadBITLONG( const DWGBuffer& oInput, size_t& nBitOffsetFromStart );
+double        ReadBITDOUBLE( const DWGBuffer& oInput, size_t& nBitOffsetFromStart );
+void          SkipBITDOUBLE( const DWGBuffer& oInput, size_t& nBitOffsetFromStart );
+double        ReadBITDOUBLEWD( const DWGBuffer& oInput, size_t& nBitOffsetFromStart, double defaultvalue );
+long          ReadMCHAR( const DWGBuffer& oInput, size_t& nBitOffsetFromStart );
+long          ReadUMCHAR( const DWGBuffer& oInput, size_t& nBitOffsetFromStart );
+unsigned int  ReadMSHORT( const DWGBuffer& oInput, size_t& nBitOffsetFromStart );
+std::string   ReadTV( const DWGBuffer& oInput, size_t& nBitOffsetFromStart );
+void          SkipTV( const DWGBuffer& oInput, size_t& nBitOffsetFromStart );
+void          SkipBITLONG( const DWGBuffer& oInput, size_t& nBitOffsetFromStart );
+void          SkipBITSHORT( const DWGBuffer& oInput, size_t& nBitOffsetFromStart );
+
+/**
+ * @brief Decode byte aligned sequence of (UMCHAR, MCHAR) pairs, the way object
+ * map sections are stored. Values are decoded 8 bytes at a time, without
+ * branching on their length.
+ * @param oInput Data, may be read past nDataSize up to its size
+ * @param nDataSize Decoding stops once this many bytes are consumed
+ * @param aPairs Receives decoded pairs
+ * @return false if a value runs out of the input or is longer than 8 bytes
+ */
+bool          ReadUMCHARMCHARPairs( const DWGBuffer& oInput, size_t nDataSize,
+                                    std::vector<std::pair<long, long> >& aPairs );
+
+/**
+ * @brief Move offset to the next byte boundary, unless it is on the boundary already
+ */
+void          AlignToByte( size_t& nBitOffsetFromStart );
+
+CADVector ReadVector( const DWGBuffer& oInput, size_t& nBitOffsetFromStart );
+CADVector ReadRAWVector( const DWGBuffer& oInput, size_t& nBitOffsetFromStart );
 
 #endif // DWG_IO_H
@@ -39,6 +39,8 @@
 #include <cassert>
 #include <memory>
 #include <cmath>
+#include <atomic>
+#include <thread>
 
 #ifdef __APPLE__
 
@@ -62,14 +64,139 @@
 #define UNKNOWN14 CADHeader::MAX_HEADER_CONSTANT + 14
 #define UNKNOWN15 CADHeader::MAX_HEADER_CONSTANT + 15
 
+// Types of header values kept raw by CADHeader until they are asked for.
+enum DWGHeaderValueType
+{
+    HV_BIT = 1,
+    HV_BITSHORT,
+    HV_BITLONG,
+    HV_BITDOUBLE,
+    HV_TV,
+    HV_HANDLE,
+    HV_HANDLE8BLENGTH,
+    HV_3BITDOUBLE,  // point of 3 BD
+    HV_2RAWDOUBLE,  // point of 2 RD
+    HV_TIMEBLL      // julian day and milliseconds, 2 BL
+};
+
+static CADVariant DecodeHeaderValue( const char * pabyData, size_t nSize, size_t nBitOffset, short nRawType )
+{
+    DWGBuffer oBuffer( pabyData, nSize );
+    switch( nRawType )
+    {
+        case HV_BIT:
+            return CADVariant( ReadBIT( oBuffer, nBitOffset ) ? 1 : 0 );
+        case HV_BITSHORT:
+            return CADVariant( ReadBITSHORT( oBuffer, nBitOffset ) );
+        case HV_BITLONG:
+            return CADVariant( ReadBITLONG( oBuffer, nBitOffset ) );
+        case HV_BITDOUBLE:
+            return CADVariant( ReadBITDOUBLE( oBuffer, nBitOffset ) );
+        case HV_TV:
+            return CADVariant( ReadTV( oBuffer, nBitOffset ) );
+        case HV_HANDLE:
+            return CADVariant( ReadHANDLE( oBuffer, nBitOffset ) );
+        case HV_HANDLE8BLENGTH:
+            return CADVariant( ReadHANDLE8BLENGTH( oBuffer, nBitOffset ) );
+        case HV_3BITDOUBLE:
+        {
+            double dX = ReadBITDOUBLE( oBuffer, nBitOffset );
+            double dY = ReadBITDOUBLE( oBuffer, nBitOffset );
+            double dZ = ReadBITDOUBLE( oBuffer, nBitOffset );
+            return CADVariant( dX, dY, dZ );
+        }
+        case HV_2RAWDOUBLE:
+        {
+            double dX = ReadRAWDOUBLE( oBuffer, nBitOffset );
+            double dY = ReadRAWDOUBLE( oBuffer, nBitOffset );
+            return CADVariant( dX, dY );
+        }
+        case HV_TIMEBLL:
+        {
+            long juliandate = ReadBITLONG( oBuffer, nBitOffset );
+            long millisec   = ReadBITLONG( oBuffer, nBitOffset );
+            return CADVariant( CADHeader::julianDayToTime( juliandate, millisec ) );
+        }
+        default:
+            return CADVariant();
+    }
+}
+
+/**
+ * @brief Add header value at the current offset to oHeader without decoding it
+ * and move the offset past the value.
+ */
+static void AddRawHeaderValue( CADHeader& oHeader, short nCode, DWGHeaderValueType eType,
+                               const DWGBuffer& oBuffer, size_t& nBitOffsetFromStart )
+{
+    oHeader.addRawValue( nCode, nBitOffsetFromStart, eType );
+    switch( eType )
+    {
+        case HV_BIT:
+            SkipBIT( oBuffer, nBitOffsetFromStart );
+            break;
+        case HV_BITSHORT:
+            SkipBITSHORT( oBuffer, nBitOffsetFromStart );
+            break;
+        case HV_BITLONG:
+            SkipBITLONG( oBuffer, nBitOffsetFromStart );
+            break;
+        case HV_BITDOUBLE:
+            SkipBITDOUBLE( oBuffer, nBitOffsetFromStart );
+            break;
+        case HV_TV:
+            SkipTV( oBuffer, nBitOffsetFromStart );
+            break;
+        case HV_HANDLE:
+            SkipHANDLE( oBuffer, nBitOffsetFromStart );
+            break;
+        case HV_HANDLE8BLENGTH:
+            ReadHANDLE8BLENGTH( oBuffer, nBitOffsetFromStart );
+            break;
+        case HV_3BITDOUBLE:
+            for( char i = 0; i < 3; ++i )
+                SkipBITDOUBLE( oBuffer, nBitOffsetFromStart );
+            break;
+        case HV_2RAWDOUBLE:
+            nBitOffsetFromStart += 2 * 64;
+            break;
+        case HV_TIMEBLL:
+            SkipBITLONG( oBuffer, nBitOffsetFromStart );
+            SkipBITLONG( oBuffer, nBitOffsetFromStart );
+            break;
+    }
+}
+
+/**
+ * @brief Read section of the size declared in the file. Buffer grows as the
+ * data is actually read, so a damaged size can't make a huge allocation.
+ * @return section data, shorter than nSize if file ends before
+ */
+static std::vector<char> ReadSection( CADFileIO * poFileIO, long nOffset, size_t nSize )
+{
+    const size_t nChunkSize = 1024 * 1024;
+    std::vector<char> abyData;
+    while( abyData.size() < nSize )
+    {
+        size_t nOldSize = abyData.size();
+        size_t nToRead  = std::min( nChunkSize, nSize - nOldSize );
+        abyData.resize( nOldSize + nToRead );
+        size_t nRead = poFileIO->ReadAt( nOffset + static_cast<long>( nOldSize ), abyData.data() + nOldSize,
+                                         nToRead );
+        abyData.resize( nOldSize + nRead );
+        if( nRead < nToRead )
+            break;
+    }
+    return abyData;
+}
+
 int DWGFileR2000::ReadHeader( OpenOptions eOptions )
 {
     char buffer[255];
-    char * pabyBuf;
     size_t dHeaderVarsSectionLength = 0;
 
-    pFileIO->Seek( sectionLocatorRecords[0].dSeeker, CADFileIO::SeekOrigin::BEG );
-    pFileIO->Read( buffer, DWGSentinelLength );
+    long nOffset = sectionLocatorRecords[0].dSeeker;
+    nOffset += pFileIO->ReadAt( nOffset, buffer, DWGSentinelLength );
     if( memcmp( buffer, DWGHeaderVariablesStart, DWGSentinelLength ) )
     {
         DebugMsg( "File is corrupted (wrong pointer to HEADER_VARS section,"
@@ -78,64 +205,66 @@ int DWGFileR2000::ReadHeader( OpenOptions eOptions )
         return CADErrorCodes::HEADER_SECTION_READ_FAILED;
     }
 
-    pFileIO->Read( & dHeaderVarsSectionLength, 4 );
+    nOffset += pFileIO->ReadAt( nOffset, & dHeaderVarsSectionLength, 4 );
     DebugMsg( "Header variables section length: %zd\n", dHeaderVarsSectionLength );
 
     size_t nBitOffsetFromStart = 0;
-    pabyBuf = new char[dHeaderVarsSectionLength + 4];
-    pFileIO->Read( pabyBuf, dHeaderVarsSectionLength + 2 );
+    // Header keeps the raw section to decode its values on access
+    std::vector<char> abyBuf = ReadSection( pFileIO, nOffset, dHeaderVarsSectionLength + 2 );
+    nOffset += abyBuf.size();
+    DWGBuffer oBuffer( abyBuf.data(), abyBuf.size() );
 
     if( eOptions == OpenOptions::READ_ALL )
     {
-        oHeader.addValue( UNKNOWN1, ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart ) );
-        oHeader.addValue( UNKNOWN2, ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart ) );
-        oHeader.addValue( UNKNOWN3, ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart ) );
-        oHeader.addValue( UNKNOWN4, ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart ) );
-        oHeader.addValue( UNKNOWN5, ReadTV( pabyBuf, nBitOffsetFromStart ) );
-        oHeader.addValue( UNKNOWN6, ReadTV( pabyBuf, nBitOffsetFromStart ) );
-        oHeader.addValue( UNKNOWN7, ReadTV( pabyBuf, nBitOffsetFromStart ) );
-        oHeader.addValue( UNKNOWN8, ReadTV( pabyBuf, nBitOffsetFromStart ) );
-        oHeader.addValue( UNKNOWN9, ReadBITLONG( pabyBuf, nBitOffsetFromStart ) );
-        oHeader.addValue( UNKNOWN10, ReadBITLONG( pabyBuf, nBitOffsetFromStart ) );
+        AddRawHeaderValue( oHeader, UNKNOWN1, HV_BITDOUBLE, oBuffer, nBitOffsetFromStart );
+        AddRawHeaderValue( oHeader, UNKNOWN2, HV_BITDOUBLE, oBuffer, nBitOffsetFromStart );
+        AddRawHeaderValue( oHeader, UNKNOWN3, HV_BITDOUBLE, oBuffer, nBitOffsetFromStart );
+        AddRawHeaderValue( oHeader, UNKNOWN4, HV_BITDOUBLE, oBuffer, nBitOffsetFromStart );
+        AddRawHeaderValue( oHeader, UNKNOWN5, HV_TV, oBuffer, nBitOffsetFromStart );
+        AddRawHeaderValue( oHeader, UNKNOWN6, HV_TV, oBuffer, nBitOffsetFromStart );
+        AddRawHeaderValue( oHeader, UNKNOWN7, HV_TV, oBuffer, nBitOffsetFromStart );
+        AddRawHeaderValue( oHeader, UNKNOWN8, HV_TV, oBuffer, nBitOffsetFromStart );
+        AddRawHeaderValue( oHeader, UNKNOWN9, HV_BITLONG, oBuffer, nBitOffsetFromStart );
+        AddRawHeaderValue( oHeader, UNKNOWN10, HV_BITLONG, oBuffer, nBitOffsetFromStart );
     } else
     {
-        SkipBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-        SkipBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-        SkipBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-        SkipBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-        SkipTV( pabyBuf, nBitOffsetFromStart );
-        SkipTV( pabyBuf, nBitOffsetFromStart );
-        SkipTV( pabyBuf, nBitOffsetFromStart );
-        SkipTV( pabyBuf, nBitOffsetFromStart );
-        SkipBITLONG( pabyBuf, nBitOffsetFromStart );
-        SkipBITLONG( pabyBuf, nBitOffsetFromStart );
+        SkipBITDOUBLE( oBuffer, nBitOffsetFromStart );
+        SkipBITDOUBLE( oBuffer, nBitOffsetFromStart );
+        SkipBITDOUBLE( oBuffer, nBitOffsetFromStart );
+        SkipBITDOUBLE( oBuffer, nBitOffsetFromStart );
+        SkipTV( oBuffer, nBitOffsetFromStart );
+        SkipTV( oBuffer, nBitOffsetFromStart );
+        SkipTV( oBuffer, nBitOffsetFromStart );
+        SkipTV( oBuffer, nBitOffsetFromStart );
+        SkipBITLONG( oBuffer, nBitOffsetFromStart );
+        SkipBITLONG( oBuffer, nBitOffsetFromStart );
     }
 
-    CADHandle stCurrentViewportTable = ReadHANDLE( pabyBuf, nBitOffsetFromStart );
+    CADHandle stCurrentViewportTable = ReadHANDLE( oBuffer, nBitOffsetFromStart );
     oTables.AddTable( CADTables::CurrentViewportTable, stCurrentViewportTable );
 
     if( eOptions == OpenOptions::READ_ALL )
     {
-        oHeader.addValue( CADHeader::DIMASO, ReadBIT( pabyBuf, nBitOffsetFromStart ) );     // 1
-        oHeader.addValue( CADHeader::DIMSHO, ReadBIT( pabyBuf, nBitOffsetFromStart ) );     // 2
-        oHeader.addValue( CADHeader::PLINEGEN, ReadBIT( pabyBuf, nBitOffsetFromStart ) );   // 3
-        oHeader.addValue( CADHeader::ORTHOMODE, ReadBIT( pabyBuf, nBitOffsetFromStart ) );  // 4
-        oHeader.addValue( CADHeader::REGENMODE, ReadBIT( pabyBuf, nBitOffsetFromStart ) );  // 5
-        oHeader.addValue( CADHeader::FILLMODE, ReadBIT( pabyBuf, nBitOffsetFromStart ) );   // 6
-        oHeader.addValue( CADHeader::QTEXTMODE, ReadBIT( pabyBuf, nBitOffsetFromStart ) );  // 7
-        oHeader.addValue( CADHeader::PSLTSCALE, ReadBIT( pabyBuf, nBitOffsetFromStart ) );  // 8
-        oHeader.addValue( CADHeader::LIMCHECK, ReadBIT( pabyBuf, nBitOffsetFromStart ) );   // 9
-        oHeader.addValue( CADHeader::USRTIMER, ReadBIT( pabyBuf, nBitOffsetFromStart ) );   // 10
-        oHeader.addValue( CADHeader::SKPOLY, ReadBIT( pabyBuf, nBitOffsetFromStart ) );     // 11
-        oHeader.addValue( CADHeader::ANGDIR, ReadBIT( pabyBuf, nBitOffsetFromStart ) );     // 12
-        oHeader.addValue( CADHeader::SPLFRAME, ReadBIT( pabyBuf, nBitOffsetFromStart ) );   // 13
-        oHeader.addValue( CADHeader::MIRRTEXT, ReadBIT( pabyBuf, nBitOffsetFromStart ) );   // 14
-        oHeader.addValue( CADHeader::WORDLVIEW, ReadBIT( pabyBuf, nBitOffsetFromStart ) );  // 15
-        oHeader.addValue( CADHeader::TILEMODE, ReadBIT( pabyBuf, nBitOffsetFromStart ) );   // 16
-        oHeader.addValue( CADHeader::PLIMCHECK, ReadBIT( pabyBuf, nBitOffsetFromStart ) );  // 17
-        oHeader.addValue( CADHeader::VISRETAIN, ReadBIT( pabyBuf, nBitOffsetFromStart ) );  // 18
-        oHeader.addValue( CADHeader::DISPSILH, ReadBIT( pabyBuf, nBitOffsetFromStart ) );   // 19
-        oHeader.addValue( CADHeader::PELLIPSE, ReadBIT( pabyBuf, nBitOffsetFromStart ) );   // 20
+        AddRawHeaderValue( oHeader, CADHeader::DIMASO, HV_BIT, oBuffer, nBitOffsetFromStart );    // 1
+        AddRawHeaderValue( oHeader, CADHeader::DIMSHO, HV_BIT, oBuffer, nBitOffsetFromStart );    // 2
+        AddRawHeaderValue( oHeader, CADHeader::PLINEGEN, HV_BIT, oBuffer, nBitOffsetFromStart );  // 3
+        AddRawHeaderValue( oHeader, CADHeader::ORTHOMODE, HV_BIT, oBuffer, nBitOffsetFromStart ); // 4
+        AddRawHeaderValue( oHeader, CADHeader::REGENMODE, HV_BIT, oBuffer, nBitOffsetFromStart ); // 5
+        AddRawHeaderValue( oHeader, CADHeader::FILLMODE, HV_BIT, oBuffer, nBitOffsetFromStart );  // 6
+        AddRawHeaderValue( oHeader, CADHeader::QTEXTMODE, HV_BIT, oBuffer, nBitOffsetFromStart ); // 7
+        AddRawHeaderValue( oHeader, CADHeader::PSLTSCALE, HV_BIT, oBuffer, nBitOffsetFromStart ); // 8
+        AddRawHeaderValue( oHeader, CADHeader::LIMCHECK, HV_BIT, oBuffer, nBitOffsetFromStart );  // 9
+        AddRawHeaderValue( oHeader, CADHeader::USRTIMER, HV_BIT, oBuffer, nBitOffsetFromStart );  // 10
+        AddRawHeaderValue( oHeader, CADHeader::SKPOLY, HV_BIT, oBuffer, nBitOffsetFromStart );    // 11
+        AddRawHeaderValue( oHeader, CADHeader::ANGDIR, HV_BIT, oBuffer, nBitOffsetFromStart );    // 12
+        AddRawHeaderValue( oHeader, CADHeader::SPLFRAME, HV_BIT, oBuffer, nBitOffsetFromStart );  // 13
+        AddRawHeaderValue( oHeader, CADHeader::MIRRTEXT, HV_BIT, oBuffer, nBitOffsetFromStart );  // 14
+        AddRawHeaderValue( oHeader, CADHeader::WORDLVIEW, HV_BIT, oBuffer, nBitOffsetFromStart ); // 15
+        AddRawHeaderValue( oHeader, CADHeader::TILEMODE, HV_BIT, oBuffer, nBitOffsetFromStart );  // 16
+        AddRawHeaderValue( oHeader, CADHeader::PLIMCHECK, HV_BIT, oBuffer, nBitOffsetFromStart ); // 17
+        AddRawHeaderValue( oHeader, CADHeader::VISRETAIN, HV_BIT, oBuffer, nBitOffsetFromStart ); // 18
+        AddRawHeaderValue( oHeader, CADHeader::DISPSILH, HV_BIT, oBuffer, nBitOffsetFromStart );  // 19
+        AddRawHeaderValue( oHeader, CADHeader::PELLIPSE, HV_BIT, oBuffer, nBitOffsetFromStart );  // 20
     } else
     {
         nBitOffsetFromStart += 20;
@@ -143,427 +272,337 @@ int DWGFileR2000::ReadHeader( OpenOptions eOptions )
 
     if( eOptions == OpenOptions::READ_ALL )
     {
-        oHeader.addValue( CADHeader::PROXYGRAPHICS, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) ); // 1
-        oHeader.addValue( CADHeader::TREEDEPTH, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );     // 2
-        oHeader.addValue( CADHeader::LUNITS, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );        // 3
-        oHeader.addValue( CADHeader::LUPREC, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );        // 4
-        oHeader.addValue( CADHeader::AUNITS, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );        // 5
-        oHeader.addValue( CADHeader::AUPREC, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );        // 6
+        AddRawHeaderValue( oHeader, CADHeader::PROXYGRAPHICS, HV_BITSHORT, oBuffer, nBitOffsetFromStart ); // 1
+        AddRawHeaderValue( oHeader, CADHeader::TREEDEPTH, HV_BITSHORT, oBuffer, nBitOffsetFromStart );     // 2
+        AddRawHeaderValue( oHeader, CADHeader::LUNITS, HV_BITSHORT, oBuffer, nBitOffsetFromStart );        // 3
+        AddRawHeaderValue( oHeader, CADHeader::LUPREC, HV_BITSHORT, oBuffer, nBitOffsetFromStart );        // 4
+        AddRawHeaderValue( oHeader, CADHeader::AUNITS, HV_BITSHORT, oBuffer, nBitOffsetFromStart );        // 5
+        AddRawHeaderValue( oHeader, CADHeader::AUPREC, HV_BITSHORT, oBuffer, nBitOffsetFromStart );        // 6
     } else
     {
         for( char i = 0; i < 6; ++i )
-            SkipBITSHORT( pabyBuf, nBitOffsetFromStart );
+            SkipBITSHORT( oBuffer, nBitOffsetFromStart );
     }
 
-    oHeader.addValue( CADHeader::ATTMODE, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );
-    oHeader.addValue( CADHeader::PDMODE, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );
+    AddRawHeaderValue( oHeader, CADHeader::ATTMODE, HV_BITSHORT, oBuffer, nBitOffsetFromStart );
+    AddRawHeaderValue( oHeader, CADHeader::PDMODE, HV_BITSHORT, oBuffer, nBitOffsetFromStart );
 
     if( eOptions == OpenOptions::READ_ALL )
     {
-        oHeader.addValue( CADHeader::USERI1, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );    // 1
-        oHeader.addValue( CADHeader::USERI2, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );    // 2
-        oHeader.addValue( CADHeader::USERI3, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );    // 3
-        oHeader.addValue( CADHeader::USERI4, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );    // 4
-        oHeader.addValue( CADHeader::USERI5, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );    // 5
-        oHeader.addValue( CADHeader::SPLINESEGS, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );// 6
-        oHeader.addValue( CADHeader::SURFU, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );     // 7
-        oHeader.addValue( CADHeader::SURFV, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );     // 8
-        oHeader.addValue( CADHeader::SURFTYPE, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );  // 9
-        oHeader.addValue( CADHeader::SURFTAB1, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );  // 10
-        oHeader.addValue( CADHeader::SURFTAB2, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );  // 11
-        oHeader.addValue( CADHeader::SPLINETYPE, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );// 12
-        oHeader.addValue( CADHeader::SHADEDGE, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );  // 13
-        oHeader.addValue( CADHeader::SHADEDIF, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );  // 14
-        oHeader.addValue( CADHeader::UNITMODE, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );  // 15
-        oHeader.addValue( CADHeader::MAXACTVP, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );  // 16
-        oHeader.addValue( CADHeader::ISOLINES, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );  // 17
-        oHeader.addValue( CADHeader::CMLJUST, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );   // 18
-        oHeader.addValue( CADHeader::TEXTQLTY, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );  // 19
+        AddRawHeaderValue( oHeader, CADHeader::USERI1, HV_BITSHORT, oBuffer, nBitOffsetFromStart );     // 1
+        AddRawHeaderValue( oHeader, CADHeader::USERI2, HV_BITSHORT, oBuffer, nBitOffsetFromStart );     // 2
+        AddRawHeaderValue( oHeader, CADHeader::USERI3, HV_BITSHORT, oBuffer, nBitOffsetFromStart );     // 3
+        AddRawHeaderValue( oHeader, CADHeader::USERI4, HV_BITSHORT, oBuffer, nBitOffsetFromStart );     // 4
+        AddRawHeaderValue( oHeader, CADHeader::USERI5, HV_BITSHORT, oBuffer, nBitOffsetFromStart );     // 5
+        AddRawHeaderValue( oHeader, CADHeader::SPLINESEGS, HV_BITSHORT, oBuffer, nBitOffsetFromStart ); // 6
+        AddRawHeaderValue( oHeader, CADHeader::SURFU, HV_BITSHORT, oBuffer, nBitOffsetFromStart );      // 7
+        AddRawHeaderValue( oHeader, CADHeader::SURFV, HV_BITSHORT, oBuffer, nBitOffsetFromStart );      // 8
+        AddRawHeaderValue( oHeader, CADHeader::SURFTYPE, HV_BITSHORT, oBuffer, nBitOffsetFromStart );   // 9
+        AddRawHeaderValue( oHeader, CADHeader::SURFTAB1, HV_BITSHORT, oBuffer, nBitOffsetFromStart );   // 10
+        AddRawHeaderValue( oHeader, CADHeader::SURFTAB2, HV_BITSHORT, oBuffer, nBitOffsetFromStart );   // 11
+        AddRawHeaderValue( oHeader, CADHeader::SPLINETYPE, HV_BITSHORT, oBuffer, nBitOffsetFromStart ); // 12
+        AddRawHeaderValue( oHeader, CADHeader::SHADEDGE, HV_BITSHORT, oBuffer, nBitOffsetFromStart );   // 13
+        AddRawHeaderValue( oHeader, CADHeader::SHADEDIF, HV_BITSHORT, oBuffer, nBitOffsetFromStart );   // 14
+        AddRawHeaderValue( oHeader, CADHeader::UNITMODE, HV_BITSHORT, oBuffer, nBitOffsetFromStart );   // 15
+        AddRawHeaderValue( oHeader, CADHeader::MAXACTVP, HV_BITSHORT, oBuffer, nBitOffsetFromStart );   // 16
+        AddRawHeaderValue( oHeader, CADHeader::ISOLINES, HV_BITSHORT, oBuffer, nBitOffsetFromStart );   // 17
+        AddRawHeaderValue( oHeader, CADHeader::CMLJUST, HV_BITSHORT, oBuffer, nBitOffsetFromStart );    // 18
+        AddRawHeaderValue( oHeader, CADHeader::TEXTQLTY, HV_BITSHORT, oBuffer, nBitOffsetFromStart );   // 19
     } else
     {
         for( char i = 0; i < 19; ++i )
-            SkipBITSHORT( pabyBuf, nBitOffsetFromStart );
+            SkipBITSHORT( oBuffer, nBitOffsetFromStart );
     }
 
-    oHeader.addValue( CADHeader::LTSCALE, ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart ) );
-    oHeader.addValue( CADHeader::TEXTSIZE, ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart ) );
-    oHeader.addValue( CADHeader::TRACEWID, ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart ) );
-    oHeader.addValue( CADHeader::SKETCHINC, ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart ) );
-    oHeader.addValue( CADHeader::FILLETRAD, ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart ) );
-    oHeader.addValue( CADHeader::THICKNESS, ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart ) );
-    oHeader.addValue( CADHeader::ANGBASE, ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart ) );
-    oHeader.addValue( CADHeader::PDSIZE, ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart ) );
-    oHeader.addValue( CADHeader::PLINEWID, ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart ) );
+    AddRawHeaderValue( oHeader, CADHeader::LTSCALE, HV_BITDOUBLE, oBuffer, nBitOffsetFromStart );
+    AddRawHeaderValue( oHeader, CADHeader::TEXTSIZE, HV_BITDOUBLE, oBuffer, nBitOffsetFromStart );
+    AddRawHeaderValue( oHeader, CADHeader::TRACEWID, HV_BITDOUBLE, oBuffer, nBitOffsetFromStart );
+    AddRawHeaderValue( oHeader, CADHeader::SKETCHINC, HV_BITDOUBLE, oBuffer, nBitOffsetFromStart );
+    AddRawHeaderValue( oHeader, CADHeader::FILLETRAD, HV_BITDOUBLE, oBuffer, nBitOffsetFromStart );
+    AddRawHeaderValue( oHeader, CADHeader::THICKNESS, HV_BITDOUBLE, oBuffer, nBitOffsetFromStart );
+    AddRawHeaderValue( oHeader, CADHeader::ANGBASE, HV_BITDOUBLE, oBuffer, nBitOffsetFromStart );
+    AddRawHeaderValue( oHeader, CADHeader::PDSIZE, HV_BITDOUBLE, oBuffer, nBitOffsetFromStart );
+    AddRawHeaderValue( oHeader, CADHeader::PLINEWID, HV_BITDOUBLE, oBuffer, nBitOffsetFromStart );
 
     if( eOptions == OpenOptions::READ_ALL )
     {
-        oHeader.addValue( CADHeader::USERR1, ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart ) );   // 1
-        oHeader.addValue( CADHeader::USERR2, ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart ) );   // 2
-        oHeader.addValue( CADHeader::USERR3, ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart ) );   // 3
-        oHeader.addValue( CADHeader::USERR4, ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart ) );   // 4
-        oHeader.addValue( CADHeader::USERR5, ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart ) );   // 5
-        oHeader.addValue( CADHeader::CHAMFERA, ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart ) ); // 6
-        oHeader.addValue( CADHeader::CHAMFERB, ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart ) ); // 7
-        oHeader.addValue( CADHeader::CHAMFERC, ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart ) ); // 8
-        oHeader.addValue( CADHeader::CHAMFERD, ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart ) ); // 9
-        oHeader.addValue( CADHeader::FACETRES, ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart ) ); // 10
-        oHeader.addValue( CADHeader::CMLSCALE, ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart ) ); // 11
-        oHeader.addValue( CADHeader::CELTSCALE, ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart ) );// 12
-
-        oHeader.addValue( CADHeader::MENU, ReadTV( pabyBuf, nBitOffsetFromStart ) );
+        AddRawHeaderValue( oHeader, CADHeader::USERR1, HV_BITDOUBLE, oBuffer, nBitOffsetFromStart );    // 1
+        AddRawHeaderValue( oHeader, CADHeader::USERR2, HV_BITDOUBLE, oBuffer, nBitOffsetFromStart );    // 2
+        AddRawHeaderValue( oHeader, CADHeader::USERR3, HV_BITDOUBLE, oBuffer, nBitOffsetFromStart );    // 3
+        AddRawHeaderValue( oHeader, CADHeader::USERR4, HV_BITDOUBLE, oBuffer, nBitOffsetFromStart );    // 4
+        AddRawHeaderValue( oHeader, CADHeader::USERR5, HV_BITDOUBLE, oBuffer, nBitOffsetFromStart );    // 5
+        AddRawHeaderValue( oHeader, CADHeader::CHAMFERA, HV_BITDOUBLE, oBuffer, nBitOffsetFromStart );  // 6
+        AddRawHeaderValue( oHeader, CADHeader::CHAMFERB, HV_BITDOUBLE, oBuffer, nBitOffsetFromStart );  // 7
+        AddRawHeaderValue( oHeader, CADHeader::CHAMFERC, HV_BITDOUBLE, oBuffer, nBitOffsetFromStart );  // 8
+        AddRawHeaderValue( oHeader, CADHeader::CHAMFERD, HV_BITDOUBLE, oBuffer, nBitOffsetFromStart );  // 9
+        AddRawHeaderValue( oHeader, CADHeader::FACETRES, HV_BITDOUBLE, oBuffer, nBitOffsetFromStart );  // 10
+        AddRawHeaderValue( oHeader, CADHeader::CMLSCALE, HV_BITDOUBLE, oBuffer, nBitOffsetFromStart );  // 11
+        AddRawHeaderValue( oHeader, CADHeader::CELTSCALE, HV_BITDOUBLE, oBuffer, nBitOffsetFromStart ); // 12
+
+        AddRawHeaderValue( oHeader, CADHeader::MENU, HV_TV, oBuffer, nBitOffsetFromStart );
     } else
     {
         for( char i = 0; i < 12; ++i )
-            SkipBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-        SkipTV( pabyBuf, nBitOffsetFromStart );
-    }
-
-    long juliandate, millisec;
-    juliandate = ReadBITLONG( pabyBuf, nBitOffsetFromStart );
-    millisec   = ReadBITLONG( pabyBuf, nBitOffsetFromStart );
-    oHeader.addValue( CADHeader::TDCREATE, juliandate, millisec );
-    juliandate = ReadBITLONG( pabyBuf, nBitOffsetFromStart );
-    millisec   = ReadBITLONG( pabyBuf, nBitOffsetFromStart );
-    oHeader.addValue( CADHeader::TDUPDATE, juliandate, millisec );
-    juliandate = ReadBITLONG( pabyBuf, nBitOffsetFromStart );
-    millisec   = ReadBITLONG( pabyBuf, nBitOffsetFromStart );
-    oHeader.addValue( CADHeader::TDINDWG, juliandate, millisec );
-    juliandate = ReadBITLONG( pabyBuf, nBitOffsetFromStart );
-    millisec   = ReadBITLONG( pabyBuf, nBitOffsetFromStart );
-    oHeader.addValue( CADHeader::TDUSRTIMER, juliandate, millisec );
-
-    oHeader.addValue( CADHeader::CECOLOR, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );
-
-    oHeader.addValue( CADHeader::HANDSEED, ReadHANDLE8BLENGTH( pabyBuf, nBitOffsetFromStart ) ); // CHECK THIS CASE.
-
-    oHeader.addValue( CADHeader::CLAYER, ReadHANDLE( pabyBuf, nBitOffsetFromStart ) );
-    oHeader.addValue( CADHeader::TEXTSTYLE, ReadHANDLE( pabyBuf, nBitOffsetFromStart ) );
-    oHeader.addValue( CADHeader::CELTYPE, ReadHANDLE( pabyBuf, nBitOffsetFromStart ) );
-    oHeader.addValue( CADHeader::DIMSTYLE, ReadHANDLE( pabyBuf, nBitOffsetFromStart ) );
-    oHeader.addValue( CADHeader::CMLSTYLE, ReadHANDLE( pabyBuf, nBitOffsetFromStart ) );
-
-    oHeader.addValue( CADHeader::PSVPSCALE, ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart ) );
-    double dX, dY, dZ;
-    dX = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    dY = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    dZ = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    oHeader.addValue( CADHeader::PINSBASE, dX, dY, dZ );
-
-    dX = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    dY = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    dZ = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    oHeader.addValue( CADHeader::PEXTMIN, dX, dY, dZ );
-    dX = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    dY = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    dZ = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    oHeader.addValue( CADHeader::PEXTMAX, dX, dY, dZ );
-    dX = ReadRAWDOUBLE( pabyBuf, nBitOffsetFromStart );
-    dY = ReadRAWDOUBLE( pabyBuf, nBitOffsetFromStart );
-    oHeader.addValue( CADHeader::PLIMMIN, dX, dY );
-    dX = ReadRAWDOUBLE( pabyBuf, nBitOffsetFromStart );
-    dY = ReadRAWDOUBLE( pabyBuf, nBitOffsetFromStart );
-    oHeader.addValue( CADHeader::PLIMMAX, dX, dY );
-
-    oHeader.addValue( CADHeader::PELEVATION, ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart ) );
-
-    dX = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    dY = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    dZ = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    oHeader.addValue( CADHeader::PUCSORG, dX, dY, dZ );
-    dX = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    dY = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    dZ = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    oHeader.addValue( CADHeader::PUCSXDIR, dX, dY, dZ );
-    dX = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    dY = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    dZ = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    oHeader.addValue( CADHeader::PUCSYDIR, dX, dY, dZ );
-
-    oHeader.addValue( CADHeader::PUCSNAME, ReadHANDLE( pabyBuf, nBitOffsetFromStart ) );
-    oHeader.addValue( CADHeader::PUCSORTHOREF, ReadHANDLE( pabyBuf, nBitOffsetFromStart ) );
-
-    oHeader.addValue( CADHeader::PUCSORTHOVIEW, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );
-    oHeader.addValue( CADHeader::PUCSBASE, ReadHANDLE( pabyBuf, nBitOffsetFromStart ) );
-
-    dX = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    dY = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    dZ = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    oHeader.addValue( CADHeader::PUCSORGTOP, dX, dY, dZ );
-    dX = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    dY = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    dZ = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    oHeader.addValue( CADHeader::PUCSORGBOTTOM, dX, dY, dZ );
-    dX = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    dY = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    dZ = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    oHeader.addValue( CADHeader::PUCSORGLEFT, dX, dY, dZ );
-    dX = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    dY = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    dZ = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    oHeader.addValue( CADHeader::PUCSORGRIGHT, dX, dY, dZ );
-    dX = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    dY = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    dZ = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    oHeader.addValue( CADHeader::PUCSORGFRONT, dX, dY, dZ );
-    dX = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    dY = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    dZ = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    oHeader.addValue( CADHeader::PUCSORGBACK, dX, dY, dZ );
-
-    dX = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    dY = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    dZ = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    oHeader.addValue( CADHeader::INSBASE, dX, dY, dZ );
-    dX = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    dY = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    dZ = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    oHeader.addValue( CADHeader::EXTMIN, dX, dY, dZ );
-    dX = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    dY = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    dZ = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    oHeader.addValue( CADHeader::EXTMAX, dX, dY, dZ );
-    dX = ReadRAWDOUBLE( pabyBuf, nBitOffsetFromStart );
-    dY = ReadRAWDOUBLE( pabyBuf, nBitOffsetFromStart );
-    oHeader.addValue( CADHeader::LIMMIN, dX, dY );
-    dX = ReadRAWDOUBLE( pabyBuf, nBitOffsetFromStart );
-    dY = ReadRAWDOUBLE( pabyBuf, nBitOffsetFromStart );
-    oHeader.addValue( CADHeader::LIMMAX, dX, dY );
-
-    oHeader.addValue( CADHeader::ELEVATION, ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart ) );
-    dX = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    dY = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    dZ = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    oHeader.addValue( CADHeader::UCSORG, dX, dY, dZ );
-    dX = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    dY = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    dZ = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    oHeader.addValue( CADHeader::UCSXDIR, dX, dY, dZ );
-    dX = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    dY = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    dZ = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    oHeader.addValue( CADHeader::UCSYDIR, dX, dY, dZ );
-
-    oHeader.addValue( CADHeader::UCSNAME, ReadHANDLE( pabyBuf, nBitOffsetFromStart ) );
-    oHeader.addValue( CADHeader::UCSORTHOREF, ReadHANDLE( pabyBuf, nBitOffsetFromStart ) );
-
-    oHeader.addValue( CADHeader::UCSORTHOVIEW, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );
-
-    oHeader.addValue( CADHeader::UCSBASE, ReadHANDLE( pabyBuf, nBitOffsetFromStart ) );
-
-    dX = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    dY = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    dZ = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    oHeader.addValue( CADHeader::UCSORGTOP, dX, dY, dZ );
-    dX = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    dY = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    dZ = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    oHeader.addValue( CADHeader::UCSORGBOTTOM, dX, dY, dZ );
-    dX = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    dY = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    dZ = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    oHeader.addValue( CADHeader::UCSORGLEFT, dX, dY, dZ );
-    dX = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    dY = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    dZ = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    oHeader.addValue( CADHeader::UCSORGRIGHT, dX, dY, dZ );
-    dX = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    dY = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    dZ = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    oHeader.addValue( CADHeader::UCSORGFRONT, dX, dY, dZ );
-    dX = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    dY = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    dZ = ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart );
-    oHeader.addValue( CADHeader::UCSORGBACK, dX, dY, dZ );
+            SkipBITDOUBLE( oBuffer, nBitOffsetFromStart );
+        SkipTV( oBuffer, nBitOffsetFromStart );
+    }
+
+    AddRawHeaderValue( oHeader, CADHeader::TDCREATE, HV_TIMEBLL, oBuffer, nBitOffsetFromStart );
+    AddRawHeaderValue( oHeader, CADHeader::TDUPDATE, HV_TIMEBLL, oBuffer, nBitOffsetFromStart );
+    AddRawHeaderValue( oHeader, CADHeader::TDINDWG, HV_TIMEBLL, oBuffer, nBitOffsetFromStart );
+    AddRawHeaderValue( oHeader, CADHeader::TDUSRTIMER, HV_TIMEBLL, oBuffer, nBitOffsetFromStart );
+
+    AddRawHeaderValue( oHeader, CADHeader::CECOLOR, HV_BITSHORT, oBuffer, nBitOffsetFromStart );
+
+    AddRawHeaderValue( oHeader, CADHeader::HANDSEED, HV_HANDLE8BLENGTH, oBuffer, nBitOffsetFromStart ); // CHECK THIS CASE.
+
+    AddRawHeaderValue( oHeader, CADHeader::CLAYER, HV_HANDLE, oBuffer, nBitOffsetFromStart );
+    AddRawHeaderValue( oHeader, CADHeader::TEXTSTYLE, HV_HANDLE, oBuffer, nBitOffsetFromStart );
+    AddRawHeaderValue( oHeader, CADHeader::CELTYPE, HV_HANDLE, oBuffer, nBitOffsetFromStart );
+    AddRawHeaderValue( oHeader, CADHeader::DIMSTYLE, HV_HANDLE, oBuffer, nBitOffsetFromStart );
+    AddRawHeaderValue( oHeader, CADHeader::CMLSTYLE, HV_HANDLE, oBuffer, nBitOffsetFromStart );
+
+    AddRawHeaderValue( oHeader, CADHeader::PSVPSCALE, HV_BITDOUBLE, oBuffer, nBitOffsetFromStart );
+    AddRawHeaderValue( oHeader, CADHeader::PINSBASE, HV_3BITDOUBLE, oBuffer, nBitOffsetFromStart );
+
+    AddRawHeaderValue( oHeader, CADHeader::PEXTMIN, HV_3BITDOUBLE, oBuffer, nBitOffsetFromStart );
+    AddRawHeaderValue( oHeader, CADHeader::PEXTMAX, HV_3BITDOUBLE, oBuffer, nBitOffsetFromStart );
+    AddRawHeaderValue( oHeader, CADHeader::PLIMMIN, HV_2RAWDOUBLE, oBuffer, nBitOffsetFromStart );
+    AddRawHeaderValue( oHeader, CADHeader::PLIMMAX, HV_2RAWDOUBLE, oBuffer, nBitOffsetFromStart );
+
+    AddRawHeaderValue( oHeader, CADHeader::PELEVATION, HV_BITDOUBLE, oBuffer, nBitOffsetFromStart );
+
+    AddRawHeaderValue( oHeader, CADHeader::PUCSORG, HV_3BITDOUBLE, oBuffer, nBitOffsetFromStart );
+    AddRawHeaderValue( oHeader, CADHeader::PUCSXDIR, HV_3BITDOUBLE, oBuffer, nBitOffsetFromStart );
+    AddRawHeaderValue( oHeader, CADHeader::PUCSYDIR, HV_3BITDOUBLE, oBuffer, nBitOffsetFromStart );
+
+    AddRawHeaderValue( oHeader, CADHeader::PUCSNAME, HV_HANDLE, oBuffer, nBitOffsetFromStart );
+    AddRawHeaderValue( oHeader, CADHeader::PUCSORTHOREF, HV_HANDLE, oBuffer, nBitOffsetFromStart );
+
+    AddRawHeaderValue( oHeader, CADHeader::PUCSORTHOVIEW, HV_BITSHORT, oBuffer, nBitOffsetFromStart );
+    AddRawHeaderValue( oHeader, CADHeader::PUCSBASE, HV_HANDLE, oBuffer, nBitOffsetFromStart );
+
+    AddRawHeaderValue( oHeader, CADHeader::PUCSORGTOP, HV_3BITDOUBLE, oBuffer, nBitOffsetFromStart );
+    AddRawHeaderValue( oHeader, CADHeader::PUCSORGBOTTOM, HV_3BITDOUBLE, oBuffer, nBitOffsetFromStart );
+    AddRawHeaderValue( oHeader, CADHeader::PUCSORGLEFT, HV_3BITDOUBLE, oBuffer, nBitOffsetFromStart );
+    AddRawHeaderValue( oHeader, CADHeader::PUCSORGRIGHT, HV_3BITDOUBLE, oBuffer, nBitOffsetFromStart );
+    AddRawHeaderValue( oHeader, CADHeader::PUCSORGFRONT, HV_3BITDOUBLE, oBuffer, nBitOffsetFromStart );
+    AddRawHeaderValue( oHeader, CADHeader::PUCSORGBACK, HV_3BITDOUBLE, oBuffer, nBitOffsetFromStart );
+
+    AddRawHeaderValue( oHeader, CADHeader::INSBASE, HV_3BITDOUBLE, oBuffer, nBitOffsetFromStart );
+    AddRawHeaderValue( oHeader, CADHeader::EXTMIN, HV_3BITDOUBLE, oBuffer, nBitOffsetFromStart );
+    AddRawHeaderValue( oHeader, CADHeader::EXTMAX, HV_3BITDOUBLE, oBuffer, nBitOffsetFromStart );
+    AddRawHeaderValue( oHeader, CADHeader::LIMMIN, HV_2RAWDOUBLE, oBuffer, nBitOffsetFromStart );
+    AddRawHeaderValue( oHeader, CADHeader::LIMMAX, HV_2RAWDOUBLE, oBuffer, nBitOffsetFromStart );
+
+    AddRawHeaderValue( oHeader, CADHeader::ELEVATION, HV_BITDOUBLE, oBuffer, nBitOffsetFromStart );
+    AddRawHeaderValue( oHeader, CADHeader::UCSORG, HV_3BITDOUBLE, oBuffer, nBitOffsetFromStart );
+    AddRawHeaderValue( oHeader, CADHeader::UCSXDIR, HV_3BITDOUBLE, oBuffer, nBitOffsetFromStart );
+    AddRawHeaderValue( oHeader, CADHeader::UCSYDIR, HV_3BITDOUBLE, oBuffer, nBitOffsetFromStart );
+
+    AddRawHeaderValue( oHeader, CADHeader::UCSNAME, HV_HANDLE, oBuffer, nBitOffsetFromStart );
+    AddRawHeaderValue( oHeader, CADHeader::UCSORTHOREF, HV_HANDLE, oBuffer, nBitOffsetFromStart );
+
+    AddRawHeaderValue( oHeader, CADHeader::UCSORTHOVIEW, HV_BITSHORT, oBuffer, nBitOffsetFromStart );
+
+    AddRawHeaderValue( oHeader, CADHeader::UCSBASE, HV_HANDLE, oBuffer, nBitOffsetFromStart );
+
+    AddRawHeaderValue( oHeader, CADHeader::UCSORGTOP, HV_3BITDOUBLE, oBuffer, nBitOffsetFromStart );
+    AddRawHeaderValue( oHeader, CADHeader::UCSORGBOTTOM, HV_3BITDOUBLE, oBuffer, nBitOffsetFromStart );
+    AddRawHeaderValue( oHeader, CADHeader::UCSORGLEFT, HV_3BITDOUBLE, oBuffer, nBitOffsetFromStart );
+    AddRawHeaderValue( oHeader, CADHeader::UCSORGRIGHT, HV_3BITDOUBLE, oBuffer, nBitOffsetFromStart );
+    AddRawHeaderValue( oHeader, CADHeader::UCSORGFRONT, HV_3BITDOUBLE, oBuffer, nBitOffsetFromStart );
+    AddRawHeaderValue( oHeader, CADHeader::UCSORGBACK, HV_3BITDOUBLE, oBuffer, nBitOffsetFromStart );
 
     if( eOptions == OpenOptions::READ_ALL )
     {
-        oHeader.addValue( CADHeader::DIMPOST, ReadTV( pabyBuf, nBitOffsetFromStart ) );
-        oHeader.addValue( CADHeader::DIMAPOST, ReadTV( pabyBuf, nBitOffsetFromStart ) );
-
-        oHeader.addValue( CADHeader::DIMSCALE, ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart ) ); // 1
-        oHeader.addValue( CADHeader::DIMASZ, ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart ) );   // 2
-        oHeader.addValue( CADHeader::DIMEXO, ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart ) );   // 3
-        oHeader.addValue( CADHeader::DIMDLI, ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart ) );   // 4
-        oHeader.addValue( CADHeader::DIMEXE, ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart ) );   // 5
-        oHeader.addValue( CADHeader::DIMRND, ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart ) );   // 6
-        oHeader.addValue( CADHeader::DIMDLE, ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart ) );   // 7
-        oHeader.addValue( CADHeader::DIMTP, ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart ) );    // 8
-        oHeader.addValue( CADHeader::DIMTM, ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart ) );    // 9
-
-        oHeader.addValue( CADHeader::DIMTOL, ReadBIT( pabyBuf, nBitOffsetFromStart ) );
-        oHeader.addValue( CADHeader::DIMLIM, ReadBIT( pabyBuf, nBitOffsetFromStart ) );
-        oHeader.addValue( CADHeader::DIMTIH, ReadBIT( pabyBuf, nBitOffsetFromStart ) );
-        oHeader.addValue( CADHeader::DIMTOH, ReadBIT( pabyBuf, nBitOffsetFromStart ) );
-        oHeader.addValue( CADHeader::DIMSE1, ReadBIT( pabyBuf, nBitOffsetFromStart ) );
-        oHeader.addValue( CADHeader::DIMSE2, ReadBIT( pabyBuf, nBitOffsetFromStart ) );
-
-        oHeader.addValue( CADHeader::DIMTAD, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );
-        oHeader.addValue( CADHeader::DIMZIN, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );
-        oHeader.addValue( CADHeader::DIMAZIN, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );
-
-        oHeader.addValue( CADHeader::DIMTXT, ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart ) );   // 1
-        oHeader.addValue( CADHeader::DIMCEN, ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart ) );   // 2
-        oHeader.addValue( CADHeader::DIMTSZ, ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart ) );   // 3
-        oHeader.addValue( CADHeader::DIMALTF, ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart ) );  // 4
-        oHeader.addValue( CADHeader::DIMLFAC, ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart ) );  // 5
-        oHeader.addValue( CADHeader::DIMTVP, ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart ) );   // 6
-        oHeader.addValue( CADHeader::DIMTFAC, ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart ) );  // 7
-        oHeader.addValue( CADHeader::DIMGAP, ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart ) );   // 8
-        oHeader.addValue( CADHeader::DIMALTRND, ReadBITDOUBLE( pabyBuf, nBitOffsetFromStart ) );// 9
-
-        oHeader.addValue( CADHeader::DIMALT, ReadBIT( pabyBuf, nBitOffsetFromStart ) );
-
-        oHeader.addValue( CADHeader::DIMALTD, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );
-
-        oHeader.addValue( CADHeader::DIMTOFL, ReadBIT( pabyBuf, nBitOffsetFromStart ) );
-        oHeader.addValue( CADHeader::DIMSAH, ReadBIT( pabyBuf, nBitOffsetFromStart ) );
-        oHeader.addValue( CADHeader::DIMTIX, ReadBIT( pabyBuf, nBitOffsetFromStart ) );
-        oHeader.addValue( CADHeader::DIMSOXD, ReadBIT( pabyBuf, nBitOffsetFromStart ) );
-
-        oHeader.addValue( CADHeader::DIMCLRD, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );   // 1
-        oHeader.addValue( CADHeader::DIMCLRE, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );   // 2
-        oHeader.addValue( CADHeader::DIMCLRT, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );   // 3
-        oHeader.addValue( CADHeader::DIMADEC, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );   // 4
-        oHeader.addValue( CADHeader::DIMDEC, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );    // 5
-        oHeader.addValue( CADHeader::DIMTDEC, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );   // 6
-        oHeader.addValue( CADHeader::DIMALTU, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );   // 7
-        oHeader.addValue( CADHeader::DIMALTTD, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );  // 8
-        oHeader.addValue( CADHeader::DIMAUNIT, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );  // 9
-        oHeader.addValue( CADHeader::DIMFRAC, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );   // 10
-        oHeader.addValue( CADHeader::DIMLUNIT, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );  // 11
-        oHeader.addValue( CADHeader::DIMDSEP, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );   // 12
-        oHeader.addValue( CADHeader::DIMTMOVE, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );  // 13
-        oHeader.addValue( CADHeader::DIMJUST, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );   // 14
-
-        oHeader.addValue( CADHeader::DIMSD1, ReadBIT( pabyBuf, nBitOffsetFromStart ) );
-        oHeader.addValue( CADHeader::DIMSD2, ReadBIT( pabyBuf, nBitOffsetFromStart ) );
-
-        oHeader.addValue( CADHeader::DIMTOLJ, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );
-        oHeader.addValue( CADHeader::DIMTZIN, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );
-        oHeader.addValue( CADHeader::DIMALTZ, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );
-        oHeader.addValue( CADHeader::DIMALTTZ, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );
-
-        oHeader.addValue( CADHeader::DIMUPT, ReadBIT( pabyBuf, nBitOffsetFromStart ) );
-
-        oHeader.addValue( CADHeader::DIMATFIT, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );
-
-        oHeader.addValue( CADHeader::DIMTXSTY, ReadHANDLE( pabyBuf, nBitOffsetFromStart ) );
-        oHeader.addValue( CADHeader::DIMLDRBLK, ReadHANDLE( pabyBuf, nBitOffsetFromStart ) );
-        oHeader.addValue( CADHeader::DIMBLK, ReadHANDLE( pabyBuf, nBitOffsetFromStart ) );
-        oHeader.addValue( CADHeader::DIMBLK1, ReadHANDLE( pabyBuf, nBitOffsetFromStart ) );
-        oHeader.addValue( CADHeader::DIMBLK2, ReadHANDLE( pabyBuf, nBitOffsetFromStart ) );
-
-        oHeader.addValue( CADHeader::DIMLWD, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );
-        oHeader.addValue( CADHeader::DIMLWE, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );
+        AddRawHeaderValue( oHeader, CADHeader::DIMPOST, HV_TV, oBuffer, nBitOffsetFromStart );
+        AddRawHeaderValue( oHeader, CADHeader::DIMAPOST, HV_TV, oBuffer, nBitOffsetFromStart );
+
+        AddRawHeaderValue( oHeader, CADHeader::DIMSCALE, HV_BITDOUBLE, oBuffer, nBitOffsetFromStart ); // 1
+        AddRawHeaderValue( oHeader, CADHeader::DIMASZ, HV_BITDOUBLE, oBuffer, nBitOffsetFromStart );   // 2
+        AddRawHeaderValue( oHeader, CADHeader::DIMEXO, HV_BITDOUBLE, oBuffer, nBitOffsetFromStart );   // 3
+        AddRawHeaderValue( oHeader, CADHeader::DIMDLI, HV_BITDOUBLE, oBuffer, nBitOffsetFromStart );   // 4
+        AddRawHeaderValue( oHeader, CADHeader::DIMEXE, HV_BITDOUBLE, oBuffer, nBitOffsetFromStart );   // 5
+        AddRawHeaderValue( oHeader, CADHeader::DIMRND, HV_BITDOUBLE, oBuffer, nBitOffsetFromStart );   // 6
+        AddRawHeaderValue( oHeader, CADHeader::DIMDLE, HV_BITDOUBLE, oBuffer, nBitOffsetFromStart );   // 7
+        AddRawHeaderValue( oHeader, CADHeader::DIMTP, HV_BITDOUBLE, oBuffer, nBitOffsetFromStart );    // 8
+        AddRawHeaderValue( oHeader, CADHeader::DIMTM, HV_BITDOUBLE, oBuffer, nBitOffsetFromStart );    // 9
+
+        AddRawHeaderValue( oHeader, CADHeader::DIMTOL, HV_BIT, oBuffer, nBitOffsetFromStart );
+        AddRawHeaderValue( oHeader, CADHeader::DIMLIM, HV_BIT, oBuffer, nBitOffsetFromStart );
+        AddRawHeaderValue( oHeader, CADHeader::DIMTIH, HV_BIT, oBuffer, nBitOffsetFromStart );
+        AddRawHeaderValue( oHeader, CADHeader::DIMTOH, HV_BIT, oBuffer, nBitOffsetFromStart );
+        AddRawHeaderValue( oHeader, CADHeader::DIMSE1, HV_BIT, oBuffer, nBitOffsetFromStart );
+        AddRawHeaderValue( oHeader, CADHeader::DIMSE2, HV_BIT, oBuffer, nBitOffsetFromStart );
+
+        AddRawHeaderValue( oHeader, CADHeader::DIMTAD, HV_BITSHORT, oBuffer, nBitOffsetFromStart );
+        AddRawHeaderValue( oHeader, CADHeader::DIMZIN, HV_BITSHORT, oBuffer, nBitOffsetFromStart );
+        AddRawHeaderValue( oHeader, CADHeader::DIMAZIN, HV_BITSHORT, oBuffer, nBitOffsetFromStart );
+
+        AddRawHeaderValue( oHeader, CADHeader::DIMTXT, HV_BITDOUBLE, oBuffer, nBitOffsetFromStart );    // 1
+        AddRawHeaderValue( oHeader, CADHeader::DIMCEN, HV_BITDOUBLE, oBuffer, nBitOffsetFromStart );    // 2
+        AddRawHeaderValue( oHeader, CADHeader::DIMTSZ, HV_BITDOUBLE, oBuffer, nBitOffsetFromStart );    // 3
+        AddRawHeaderValue( oHeader, CADHeader::DIMALTF, HV_BITDOUBLE, oBuffer, nBitOffsetFromStart );   // 4
+        AddRawHeaderValue( oHeader, CADHeader::DIMLFAC, HV_BITDOUBLE, oBuffer, nBitOffsetFromStart );   // 5
+        AddRawHeaderValue( oHeader, CADHeader::DIMTVP, HV_BITDOUBLE, oBuffer, nBitOffsetFromStart );    // 6
+        AddRawHeaderValue( oHeader, CADHeader::DIMTFAC, HV_BITDOUBLE, oBuffer, nBitOffsetFromStart );   // 7
+        AddRawHeaderValue( oHeader, CADHeader::DIMGAP, HV_BITDOUBLE, oBuffer, nBitOffsetFromStart );    // 8
+        AddRawHeaderValue( oHeader, CADHeader::DIMALTRND, HV_BITDOUBLE, oBuffer, nBitOffsetFromStart ); // 9
+
+        AddRawHeaderValue( oHeader, CADHeader::DIMALT, HV_BIT, oBuffer, nBitOffsetFromStart );
+
+        AddRawHeaderValue( oHeader, CADHeader::DIMALTD, HV_BITSHORT, oBuffer, nBitOffsetFromStart );
+
+        AddRawHeaderValue( oHeader, CADHeader::DIMTOFL, HV_BIT, oBuffer, nBitOffsetFromStart );
+        AddRawHeaderValue( oHeader, CADHeader::DIMSAH, HV_BIT, oBuffer, nBitOffsetFromStart );
+        AddRawHeaderValue( oHeader, CADHeader::DIMTIX, HV_BIT, oBuffer, nBitOffsetFromStart );
+        AddRawHeaderValue( oHeader, CADHeader::DIMSOXD, HV_BIT, oBuffer, nBitOffsetFromStart );
+
+        AddRawHeaderValue( oHeader, CADHeader::DIMCLRD, HV_BITSHORT, oBuffer, nBitOffsetFromStart );  // 1
+        AddRawHeaderValue( oHeader, CADHeader::DIMCLRE, HV_BITSHORT, oBuffer, nBitOffsetFromStart );  // 2
+        AddRawHeaderValue( oHeader, CADHeader::DIMCLRT, HV_BITSHORT, oBuffer, nBitOffsetFromStart );  // 3
+        AddRawHeaderValue( oHeader, CADHeader::DIMADEC, HV_BITSHORT, oBuffer, nBitOffsetFromStart );  // 4
+        AddRawHeaderValue( oHeader, CADHeader::DIMDEC, HV_BITSHORT, oBuffer, nBitOffsetFromStart );   // 5
+        AddRawHeaderValue( oHeader, CADHeader::DIMTDEC, HV_BITSHORT, oBuffer, nBitOffsetFromStart );  // 6
+        AddRawHeaderValue( oHeader, CADHeader::DIMALTU, HV_BITSHORT, oBuffer, nBitOffsetFromStart );  // 7
+        AddRawHeaderValue( oHeader, CADHeader::DIMALTTD, HV_BITSHORT, oBuffer, nBitOffsetFromStart ); // 8
+        AddRawHeaderValue( oHeader, CADHeader::DIMAUNIT, HV_BITSHORT, oBuffer, nBitOffsetFromStart ); // 9
+        AddRawHeaderValue( oHeader, CADHeader::DIMFRAC, HV_BITSHORT, oBuffer, nBitOffsetFromStart );  // 10
+        AddRawHeaderValue( oHeader, CADHeader::DIMLUNIT, HV_BITSHORT, oBuffer, nBitOffsetFromStart ); // 11
+        AddRawHeaderValue( oHeader, CADHeader::DIMDSEP, HV_BITSHORT, oBuffer, nBitOffsetFromStart );  // 12
+        AddRawHeaderValue( oHeader, CADHeader::DIMTMOVE, HV_BITSHORT, oBuffer, nBitOffsetFromStart ); // 13
+        AddRawHeaderValue( oHeader, CADHeader::DIMJUST, HV_BITSHORT, oBuffer, nBitOffsetFromStart );  // 14
+
+        AddRawHeaderValue( oHeader, CADHeader::DIMSD1, HV_BIT, oBuffer, nBitOffsetFromStart );
+        AddRawHeaderValue( oHeader, CADHeader::DIMSD2, HV_BIT, oBuffer, nBitOffsetFromStart );
+
+        AddRawHeaderValue( oHeader, CADHeader::DIMTOLJ, HV_BITSHORT, oBuffer, nBitOffsetFromStart );
+        AddRawHeaderValue( oHeader, CADHeader::DIMTZIN, HV_BITSHORT, oBuffer, nBitOffsetFromStart );
+        AddRawHeaderValue( oHeader, CADHeader::DIMALTZ, HV_BITSHORT, oBuffer, nBitOffsetFromStart );
+        AddRawHeaderValue( oHeader, CADHeader::DIMALTTZ, HV_BITSHORT, oBuffer, nBitOffsetFromStart );
+
+        AddRawHeaderValue( oHeader, CADHeader::DIMUPT, HV_BIT, oBuffer, nBitOffsetFromStart );
+
+        AddRawHeaderValue( oHeader, CADHeader::DIMATFIT, HV_BITSHORT, oBuffer, nBitOffsetFromStart );
+
+        AddRawHeaderValue( oHeader, CADHeader::DIMTXSTY, HV_HANDLE, oBuffer, nBitOffsetFromStart );
+        AddRawHeaderValue( oHeader, CADHeader::DIMLDRBLK, HV_HANDLE, oBuffer, nBitOffsetFromStart );
+        AddRawHeaderValue( oHeader, CADHeader::DIMBLK, HV_HANDLE, oBuffer, nBitOffsetFromStart );
+        AddRawHeaderValue( oHeader, CADHeader::DIMBLK1, HV_HANDLE, oBuffer, nBitOffsetFromStart );
+        AddRawHeaderValue( oHeader, CADHeader::DIMBLK2, HV_HANDLE, oBuffer, nBitOffsetFromStart );
+
+        AddRawHeaderValue( oHeader, CADHeader::DIMLWD, HV_BITSHORT, oBuffer, nBitOffsetFromStart );
+        AddRawHeaderValue( oHeader, CADHeader::DIMLWE, HV_BITSHORT, oBuffer, nBitOffsetFromStart );
     } else
     {
-        SkipTV( pabyBuf, nBitOffsetFromStart );
-        SkipTV( pabyBuf, nBitOffsetFromStart );
+        SkipTV( oBuffer, nBitOffsetFromStart );
+        SkipTV( oBuffer, nBitOffsetFromStart );
 
         for( char i = 0; i < 9; ++i )
-            SkipBITDOUBLE( pabyBuf, nBitOffsetFromStart );
+            SkipBITDOUBLE( oBuffer, nBitOffsetFromStart );
 
         nBitOffsetFromStart += 6;
 
         for( char i = 0; i < 3; ++i )
-            SkipBITSHORT( pabyBuf, nBitOffsetFromStart );
+            SkipBITSHORT( oBuffer, nBitOffsetFromStart );
 
         for( char i = 0; i < 9; ++i )
-            SkipBITDOUBLE( pabyBuf, nBitOffsetFromStart );
+            SkipBITDOUBLE( oBuffer, nBitOffsetFromStart );
 
         nBitOffsetFromStart++;
 
-        SkipBITSHORT( pabyBuf, nBitOffsetFromStart );
+        SkipBITSHORT( oBuffer, nBitOffsetFromStart );
 
         nBitOffsetFromStart += 4;
 
         for( char i = 0; i < 14; ++i )
-            SkipBITSHORT( pabyBuf, nBitOffsetFromStart );
+            SkipBITSHORT( oBuffer, nBitOffsetFromStart );
 
         nBitOffsetFromStart += 2;
 
         for( char i = 0; i < 4; ++i )
-            SkipBITSHORT( pabyBuf, nBitOffsetFromStart );
+            SkipBITSHORT( oBuffer, nBitOffsetFromStart );
 
         nBitOffsetFromStart++;
-        SkipBITSHORT( pabyBuf, nBitOffsetFromStart );
+        SkipBITSHORT( oBuffer, nBitOffsetFromStart );
 
         for( char i = 0; i < 5; ++i )
-            SkipHANDLE( pabyBuf, nBitOffsetFromStart );
+            SkipHANDLE( oBuffer, nBitOffsetFromStart );
 
-        SkipBITSHORT( pabyBuf, nBitOffsetFromStart );
-        SkipBITSHORT( pabyBuf, nBitOffsetFromStart );
+        SkipBITSHORT( oBuffer, nBitOffsetFromStart );
+        SkipBITSHORT( oBuffer, nBitOffsetFromStart );
     }
 
-    CADHandle stBlocksTable = ReadHANDLE( pabyBuf, nBitOffsetFromStart );
+    CADHandle stBlocksTable = ReadHANDLE( oBuffer, nBitOffsetFromStart );
     oTables.AddTable( CADTables::BlocksTable, stBlocksTable );
 
-    CADHandle stLayersTable = ReadHANDLE( pabyBuf, nBitOffsetFromStart );
+    CADHandle stLayersTable = ReadHANDLE( oBuffer, nBitOffsetFromStart );
     oTables.AddTable( CADTables::LayersTable, stLayersTable );
 
-    CADHandle stStyleTable = ReadHANDLE( pabyBuf, nBitOffsetFromStart );
+    CADHandle stStyleTable = ReadHANDLE( oBuffer, nBitOffsetFromStart );
     oTables.AddTable( CADTables::StyleTable, stStyleTable );
 
-    CADHandle stLineTypesTable = ReadHANDLE( pabyBuf, nBitOffsetFromStart );
+    CADHandle stLineTypesTable = ReadHANDLE( oBuffer, nBitOffsetFromStart );
     oTables.AddTable( CADTables::LineTypesTable, stLineTypesTable );
 
-    CADHandle stViewTable = ReadHANDLE( pabyBuf, nBitOffsetFromStart );
+    CADHandle stViewTable = ReadHANDLE( oBuffer, nBitOffsetFromStart );
     oTables.AddTable( CADTables::ViewTable, stViewTable );
 
-    CADHandle stUCSTable = ReadHANDLE( pabyBuf, nBitOffsetFromStart );
+    CADHandle stUCSTable = ReadHANDLE( oBuffer, nBitOffsetFromStart );
     oTables.AddTable( CADTables::UCSTable, stUCSTable );
 
-    CADHandle stViewportTable = ReadHANDLE( pabyBuf, nBitOffsetFromStart );
+    CADHandle stViewportTable = ReadHANDLE( oBuffer, nBitOffsetFromStart );
     oTables.AddTable( CADTables::ViewportTable, stViewportTable );
 
-    CADHandle stAPPIDTable = ReadHANDLE( pabyBuf, nBitOffsetFromStart );
+    CADHandle stAPPIDTable = ReadHANDLE( oBuffer, nBitOffsetFromStart );
     oTables.AddTable( CADTables::APPIDTable, stAPPIDTable );
 
     if( eOptions == OpenOptions::READ_ALL )
     {
-        oHeader.addValue( CADHeader::DIMSTYLE, ReadHANDLE( pabyBuf, nBitOffsetFromStart ) );
+        AddRawHeaderValue( oHeader, CADHeader::DIMSTYLE, HV_HANDLE, oBuffer, nBitOffsetFromStart );
     } else
     {
-        SkipHANDLE( pabyBuf, nBitOffsetFromStart );
+        SkipHANDLE( oBuffer, nBitOffsetFromStart );
     }
 
-    CADHandle stEntityTable = ReadHANDLE( pabyBuf, nBitOffsetFromStart );
+    CADHandle stEntityTable = ReadHANDLE( oBuffer, nBitOffsetFromStart );
     oTables.AddTable( CADTables::EntityTable, stEntityTable );
 
-    CADHandle stACADGroupDict = ReadHANDLE( pabyBuf, nBitOffsetFromStart );
+    CADHandle stACADGroupDict = ReadHANDLE( oBuffer, nBitOffsetFromStart );
     oTables.AddTable( CADTables::ACADGroupDict, stACADGroupDict );
 
-    CADHandle stACADMLineStyleDict = ReadHANDLE( pabyBuf, nBitOffsetFromStart );
+    CADHandle stACADMLineStyleDict = ReadHANDLE( oBuffer, nBitOffsetFromStart );
     oTables.AddTable( CADTables::ACADMLineStyleDict, stACADMLineStyleDict );
 
-    CADHandle stNamedObjectsDict = ReadHANDLE( pabyBuf, nBitOffsetFromStart );
+    CADHandle stNamedObjectsDict = ReadHANDLE( oBuffer, nBitOffsetFromStart );
     oTables.AddTable( CADTables::NamedObjectsDict, stNamedObjectsDict );
 
     if( eOptions == OpenOptions::READ_ALL )
     {
-        oHeader.addValue( CADHeader::TSTACKALIGN, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );
-        oHeader.addValue( CADHeader::TSTACKSIZE, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );
+        AddRawHeaderValue( oHeader, CADHeader::TSTACKALIGN, HV_BITSHORT, oBuffer, nBitOffsetFromStart );
+        AddRawHeaderValue( oHeader, CADHeader::TSTACKSIZE, HV_BITSHORT, oBuffer, nBitOffsetFromStart );
     } else
     {
-        SkipBITSHORT( pabyBuf, nBitOffsetFromStart );
-        SkipBITSHORT( pabyBuf, nBitOffsetFromStart );
+        SkipBITSHORT( oBuffer, nBitOffsetFromStart );
+        SkipBITSHORT( oBuffer, nBitOffsetFromStart );
     }
 
-    oHeader.addValue( CADHeader::HYPERLINKBASE, ReadTV( pabyBuf, nBitOffsetFromStart ) );
-    oHeader.addValue( CADHeader::STYLESHEET, ReadTV( pabyBuf, nBitOffsetFromStart ) );
+    AddRawHeaderValue( oHeader, CADHeader::HYPERLINKBASE, HV_TV, oBuffer, nBitOffsetFromStart );
+    AddRawHeaderValue( oHeader, CADHeader::STYLESHEET, HV_TV, oBuffer, nBitOffsetFromStart );
 
-    CADHandle stLayoutsDict = ReadHANDLE( pabyBuf, nBitOffsetFromStart );
+    CADHandle stLayoutsDict = ReadHANDLE( oBuffer, nBitOffsetFromStart );
     oTables.AddTable( CADTables::LayoutsDict, stLayoutsDict );
 
-    CADHandle stPlotSettingsDict = ReadHANDLE( pabyBuf, nBitOffsetFromStart );
+    CADHandle stPlotSettingsDict = ReadHANDLE( oBuffer, nBitOffsetFromStart );
     oTables.AddTable( CADTables::PlotSettingsDict, stPlotSettingsDict );
 
-    CADHandle stPlotStylesDict = ReadHANDLE( pabyBuf, nBitOffsetFromStart );
+    CADHandle stPlotStylesDict = ReadHANDLE( oBuffer, nBitOffsetFromStart );
     oTables.AddTable( CADTables::PlotStylesDict, stPlotStylesDict );
 
     if( eOptions == OpenOptions::READ_ALL )
     {
-        int Flags = ReadBITLONG( pabyBuf, nBitOffsetFromStart );
+        int Flags = ReadBITLONG( oBuffer, nBitOffsetFromStart );
         oHeader.addValue( CADHeader::CELWEIGHT, Flags & 0x001F );
         oHeader.addValue( CADHeader::ENDCAPS, static_cast<bool>(Flags & 0x0060) );
         oHeader.addValue( CADHeader::JOINSTYLE, static_cast<bool>(Flags & 0x0180) );
@@ -574,25 +613,25 @@ int DWGFileR2000::ReadHeader( OpenOptions eOptions )
         oHeader.addValue( CADHeader::OLESTARTUP, static_cast<bool>(Flags & 0x4000) );
     } else
     {
-        SkipBITLONG( pabyBuf, nBitOffsetFromStart );
+        SkipBITLONG( oBuffer, nBitOffsetFromStart );
     }
 
-    oHeader.addValue( CADHeader::INSUNITS, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );
-    short nCEPSNTYPE = ReadBITSHORT( pabyBuf, nBitOffsetFromStart );
+    AddRawHeaderValue( oHeader, CADHeader::INSUNITS, HV_BITSHORT, oBuffer, nBitOffsetFromStart );
+    short nCEPSNTYPE = ReadBITSHORT( oBuffer, nBitOffsetFromStart );
     oHeader.addValue( CADHeader::CEPSNTYPE, nCEPSNTYPE );
 
     if( nCEPSNTYPE == 3 )
-        oHeader.addValue( CADHeader::CEPSNID, ReadHANDLE( pabyBuf, nBitOffsetFromStart ) );
+        AddRawHeaderValue( oHeader, CADHeader::CEPSNID, HV_HANDLE, oBuffer, nBitOffsetFromStart );
 
-    oHeader.addValue( CADHeader::FINGERPRINTGUID, ReadTV( pabyBuf, nBitOffsetFromStart ) );
-    oHeader.addValue( CADHeader::VERSIONGUID, ReadTV( pabyBuf, nBitOffsetFromStart ) );
+    AddRawHeaderValue( oHeader, CADHeader::FINGERPRINTGUID, HV_TV, oBuffer, nBitOffsetFromStart );
+    AddRawHeaderValue( oHeader, CADHeader::VERSIONGUID, HV_TV, oBuffer, nBitOffsetFromStart );
 
 
 
-    CADHandle stBlockRecordPaperSpace = ReadHANDLE( pabyBuf, nBitOffsetFromStart );
+    CADHandle stBlockRecordPaperSpace = ReadHANDLE( oBuffer, nBitOffsetFromStart );
     oTables.AddTable( CADTables::BlockRecordPaperSpace, stBlockRecordPaperSpace );
     // TODO: is this part of the header?
-    CADHandle stBlockRecordModelSpace = ReadHANDLE( pabyBuf, nBitOffsetFromStart );
+    CADHandle stBlockRecordModelSpace = ReadHANDLE( oBuffer, nBitOffsetFromStart );
     oTables.AddTable( CADTables::BlockRecordModelSpace, stBlockRecordModelSpace );
 
     if( eOptions == OpenOptions::READ_ALL )
@@ -600,34 +639,41 @@ int DWGFileR2000::ReadHeader( OpenOptions eOptions )
         // Is this part of the header?
 
         /*CADHandle LTYPE_
-		= */ReadHANDLE( pabyBuf, nBitOffsetFromStart );
-        /*CADHandle LTYPE_BYBLOCK = */ReadHANDLE( pabyBuf, nBitOffsetFromStart );
-        /*CADHandle LTYPE_CONTINUOUS = */ReadHANDLE( pabyBuf, nBitOffsetFromStart );
-
-        oHeader.addValue( UNKNOWN11, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );
-        oHeader.addValue( UNKNOWN12, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );
-        oHeader.addValue( UNKNOWN13, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );
-        oHeader.addValue( UNKNOWN14, ReadBITSHORT( pabyBuf, nBitOffsetFromStart ) );
+		= */ReadHANDLE( oBuffer, nBitOffsetFromStart );
+        /*CADHandle LTYPE_BYBLOCK = */ReadHANDLE( oBuffer, nBitOffsetFromStart );
+        /*CADHandle LTYPE_CONTINUOUS = */ReadHANDLE( oBuffer, nBitOffsetFromStart );
+
+        AddRawHeaderValue( oHeader, UNKNOWN11, HV_BITSHORT, oBuffer, nBitOffsetFromStart );
+        AddRawHeaderValue( oHeader, UNKNOWN12, HV_BITSHORT, oBuffer, nBitOffsetFromStart );
+        AddRawHeaderValue( oHeader, UNKNOWN13, HV_BITSHORT, oBuffer, nBitOffsetFromStart );
+        AddRawHeaderValue( oHeader, UNKNOWN14, HV_BITSHORT, oBuffer, nBitOffsetFromStart );
     } else
     {
-        SkipHANDLE( pabyBuf, nBitOffsetFromStart );
-        SkipHANDLE( pabyBuf, nBitOffsetFromStart );
-        SkipHANDLE( pabyBuf, nBitOffsetFromStart );
-        SkipBITSHORT( pabyBuf, nBitOffsetFromStart );
-        SkipBITSHORT( pabyBuf, nBitOffsetFromStart );
-        SkipBITSHORT( pabyBuf, nBitOffsetFromStart );
-        SkipBITSHORT( pabyBuf, nBitOffsetFromStart );
+        SkipHANDLE( oBuffer, nBitOffsetFromStart );
+        SkipHANDLE( oBuffer, nBitOffsetFromStart );
+        SkipHANDLE( oBuffer, nBitOffsetFromStart );
+        SkipBITSHORT( oBuffer, nBitOffsetFromStart );
+        SkipBITSHORT( oBuffer, nBitOffsetFromStart );
+        SkipBITSHORT( oBuffer, nBitOffsetFromStart );
+        SkipBITSHORT( oBuffer, nBitOffsetFromStart );
     }
 
-    /*short nCRC =*/ ReadRAWSHORT( pabyBuf, nBitOffsetFromStart );
+    nHeaderCRC = ReadRAWSHORT( oBuffer, nBitOffsetFromStart );
     unsigned short initial = 0xC0C1;
-    /*short calculated_crc = */ CalculateCRC8( initial, pabyBuf,
-                                               static_cast<int>(dHeaderVarsSectionLength) ); // TODO: CRC is calculated wrong every time.
+    /*short calculated_crc = */ CalculateCRC8( initial, abyBuf.data(),
+                                               static_cast<int>( std::min( dHeaderVarsSectionLength, abyBuf.size() ) ) ); // TODO: CRC is calculated wrong every time.
 
 
     int returnCode = CADErrorCodes::SUCCESS;
-    pFileIO->Read( pabyBuf, DWGSentinelLength );
-    if( memcmp( pabyBuf, DWGHeaderVariablesEnd, DWGSentinelLength ) )
+    if( oBuffer.IsOverrun() )
+    {
+        DebugMsg( "File is corrupted (HEADERVARS section is truncated.)" );
+
+        returnCode = CADErrorCodes::HEADER_SECTION_READ_FAILED;
+    }
+
+    pFileIO->ReadAt( nOffset, buffer, DWGSentinelLength );
+    if( memcmp( buffer, DWGHeaderVariablesEnd, DWGSentinelLength ) )
     {
         DebugMsg( "File is corrupted (HEADERVARS section ending sentinel "
                           "does not match.)" );
@@ -635,7 +681,7 @@ int DWGFileR2000::ReadHeader( OpenOptions eOptions )
         returnCode = CADErrorCodes::HEADER_SECTION_READ_FAILED;
     }
 
-    delete[] pabyBuf;
+    oHeader.setRawData( std::move( abyBuf ), DecodeHeaderValue );
     return returnCode;
 }
 
@@ -643,14 +689,12 @@ int DWGFileR2000::ReadClasses( enum OpenOptions eOptions )
 {
     if( eOptions == OpenOptions::READ_ALL || eOptions == OpenOptions::READ_FAST )
     {
-        char * pabySectionContent;
         char   buffer[255];
         size_t dSectionSize        = 0;
         size_t nBitOffsetFromStart = 0;
 
-        pFileIO->Seek( sectionLocatorRecords[1].dSeeker, CADFileIO::SeekOrigin::BEG );
-
-        pFileIO->Read( buffer, DWGSentinelLength );
+        long nOffset = sectionLocatorRecords[1].dSeeker;
+        nOffset += pFileIO->ReadAt( nOffset, buffer, DWGSentinelLength );
         if( memcmp( buffer, DWGDSClassesStart, DWGSentinelLength ) )
         {
             cerr << "File is corrupted (wrong pointer to CLASSES section,"
@@ -659,31 +703,38 @@ int DWGFileR2000::ReadClasses( enum OpenOptions eOptions )
             return CADErrorCodes::CLASSES_SECTION_READ_FAILED;
         }
 
-        pFileIO->Read( & dSectionSize, 4 );
+        nOffset += pFileIO->ReadAt( nOffset, & dSectionSize, 4 );
         DebugMsg( "Classes section length: %zd\n", dSectionSize );
 
-        pabySectionContent = new char[dSectionSize + 4];
-        pFileIO->Read( pabySectionContent, dSectionSize );
+        std::vector<char> abySectionContent = ReadSection( pFileIO, nOffset, dSectionSize );
+        DWGBuffer oSectionContent( abySectionContent.data(), abySectionContent.size() );
+        nOffset += oSectionContent.GetSize();
 
-        while( ( nBitOffsetFromStart / 8 + 1 ) < dSectionSize )
+        while( ( nBitOffsetFromStart / 8 + 1 ) < oSectionContent.GetSize() )
         {
             CADClass stClass;
-            stClass.dClassNum        = ReadBITSHORT( pabySectionContent, nBitOffsetFromStart );
-            stClass.dProxyCapFlag    = ReadBITSHORT( pabySectionContent, nBitOffsetFromStart );
-            stClass.sApplicationName = ReadTV( pabySectionContent, nBitOffsetFromStart );
-            stClass.sCppClassName    = ReadTV( pabySectionContent, nBitOffsetFromStart );
-            stClass.sDXFRecordName   = ReadTV( pabySectionContent, nBitOffsetFromStart );
-            stClass.bWasZombie       = ReadBIT( pabySectionContent, nBitOffsetFromStart );
-            stClass.bIsEntity        = ReadBITSHORT( pabySectionContent, nBitOffsetFromStart ) == 0x1F2 ? true : false;
-
+            stClass.dClassNum        = ReadBITSHORT( oSectionContent, nBitOffsetFromStart );
+            stClass.dProxyCapFlag    = ReadBITSHORT( oSectionContent, nBitOffsetFromStart );
+            stClass.sApplicationName = ReadTV( oSectionContent, nBitOffsetFromStart );
+            stClass.sCppClassName    = ReadTV( oSectionContent, nBitOffsetFromStart );
+            stClass.sDXFRecordName   = ReadTV( oSectionContent, nBitOffsetFromStart );
+            stClass.bWasZombie       = ReadBIT( oSectionContent, nBitOffsetFromStart );
+            stClass.bIsEntity        = ReadBITSHORT( oSectionContent, nBitOffsetFromStart ) == 0x1F2 ? true : false;
+
+            if( oSectionContent.IsOverrun() )
+                break;
             oClasses.addClass( stClass );
         }
 
-        delete[] pabySectionContent;
+        if( oSectionContent.IsOverrun() || oSectionContent.GetSize() < dSectionSize )
+        {
+            cerr << "File is corrupted (CLASSES section is truncated.)\n";
+            return CADErrorCodes::CLASSES_SECTION_READ_FAILED;
+        }
 
-        pFileIO->Read( buffer, 2 ); // CLASSES CRC!. TODO: add CRC computing & checking feature.
+        nOffset += 2; // CLASSES CRC!. TODO: add CRC computing & checking feature.
 
-        pFileIO->Read( buffer, DWGSentinelLength );
+        pFileIO->ReadAt( nOffset, buffer, DWGSentinelLength );
         if( memcmp( buffer, DWGDSClassesEnd, DWGSentinelLength ) )
         {
             cerr << "File is corrupted (CLASSES section ending sentinel "
@@ -694,98 +745,139 @@ int DWGFileR2000::ReadClasses( enum OpenOptions eOptions )
     return CADErrorCodes::SUCCESS;
 }
 
+/**
+ * @brief Object map section location in the buffer of all sections
+ */
+struct ObjectMapSection
+{
+    size_t nOffset;
+    size_t nSize; // without the CRC
+};
+
+/**
+ * @brief Decode handle/offset pairs of one object map section. Every section
+ * starts the delta accumulation anew, so sections can be decoded independently.
+ * @return false if section is truncated
+ */
+static bool DecodeObjectMapSection( const char * pabySection, size_t nSectionSize,
+                                    vector<CADObjectIndex::Entry>& aEntries )
+{
+    // the CRC follows the section data
+    DWGBuffer oSectionContent( pabySection, nSectionSize + 2 );
+    vector<pair<long, long> > aDeltas;
+    aDeltas.reserve( nSectionSize / 2 );
+    if( !ReadUMCHARMCHARPairs( oSectionContent, nSectionSize, aDeltas ) )
+        return false;
+
+    CADObjectIndex::Entry stPrevious = { 0, 0 };
+    aEntries.reserve( aDeltas.size() );
+    for( const pair<long, long>& stDelta : aDeltas )
+    {
+        stPrevious.nHandle += stDelta.first;
+        stPrevious.nOffset += stDelta.second;
+        aEntries.push_back( stPrevious );
+    }
+    return true;
+}
+
 int DWGFileR2000::CreateFileMap()
 {
     // Seems like ODA specification is completely awful. CRC is included in section size.
-    // section size
-    char * pabySectionContent;
-    unsigned short dSectionSize;
-    size_t         nRecordsInSection;
-    size_t         nSection = 0;
-    size_t         nBitOffsetFromStart;
-
-    typedef pair<long, long> ObjHandleOffset;
-    ObjHandleOffset          previousObjHandleOffset;
-    ObjHandleOffset          tmpOffset;
+    oObjectIndex.Clear();
 
-    mapObjects.clear();
+    if( sectionLocatorRecords.size() < 3 )
+        return CADErrorCodes::OBJECTS_SECTION_READ_FAILED;
 
-    // seek to the beginning of the objects map
-    pFileIO->Seek( sectionLocatorRecords[2].dSeeker, CADFileIO::SeekOrigin::BEG );
+    // the beginning of the objects map
+    long nOffset = sectionLocatorRecords[2].dSeeker;
 
+    // Read all sections first, the sizes chain them together so this can't
+    // be parallel.
+    vector<char>             abySections;
+    vector<ObjectMapSection> astSections;
     while( true )
     {
-        dSectionSize = 0;
+        unsigned short dSectionSize = 0;
 
         // read section size
-        pFileIO->Read( & dSectionSize, 2 );
+        nOffset += pFileIO->ReadAt( nOffset, & dSectionSize, 2 );
         SwapEndianness( dSectionSize, sizeof( dSectionSize ) );
 
-        DebugMsg( "Object map section #%zd size: %hu\n", ++nSection, dSectionSize );
+        DebugMsg( "Object map section #%zd size: %hu\n", astSections.size() + 1, dSectionSize );
 
         if( dSectionSize == 2 )
             break; // last section is empty.
 
-        pabySectionContent  = new char[dSectionSize + 4];
-        nBitOffsetFromStart = 0;
-        nRecordsInSection   = 0;
-
-        // read section data
-        pFileIO->Read( pabySectionContent, dSectionSize );
-
-        while( ( nBitOffsetFromStart / 8 ) < ( ( size_t ) dSectionSize - 2 ) )
+        if( dSectionSize < 2 )
         {
-            tmpOffset.first  = ReadUMCHAR( pabySectionContent, nBitOffsetFromStart );
-            tmpOffset.second = ReadMCHAR( pabySectionContent, nBitOffsetFromStart );
+            DebugMsg( "File is corrupted (object map section #%zd is truncated.)\n", astSections.size() + 1 );
+            return CADErrorCodes::OBJECTS_SECTION_READ_FAILED;
+        }
 
-            if( 0 == nRecordsInSection )
-            {
-                previousObjHandleOffset = tmpOffset;
-            } else
-            {
-                previousObjHandleOffset.first += tmpOffset.first;
-                previousObjHandleOffset.second += tmpOffset.second;
-            }
-#ifdef _DEBUG
-            assert( mapObjects.find( previousObjHandleOffset.first ) == mapObjects.end() );
-#endif //_DEBUG
-            mapObjects.insert( previousObjHandleOffset );
-            ++nRecordsInSection;
+        // read section data, section CRC is unused
+        ObjectMapSection stSection = { abySections.size(), static_cast<size_t>( dSectionSize - 2 ) };
+        abySections.resize( abySections.size() + dSectionSize );
+        if( pFileIO->ReadAt( nOffset, abySections.data() + stSection.nOffset, dSectionSize ) != dSectionSize )
+        {
+            DebugMsg( "File is corrupted (object map section #%zd is truncated.)\n", astSections.size() + 1 );
+            return CADErrorCodes::OBJECTS_SECTION_READ_FAILED;
         }
+        nOffset += dSectionSize;
+        astSections.push_back( stSection );
+    }
 
-        /* Unused
-        dSectionCRC = */ReadRAWSHORT( pabySectionContent, nBitOffsetFromStart );/*
-        SwapEndianness (dSectionCRC, sizeof (dSectionCRC));
-        */
+    // Decode sections concurrently, each into its own vector
+    vector<vector<CADObjectIndex::Entry> > aaSectionEntries( astSections.size() );
+    vector<char>                           abSectionFailed( astSections.size(), 0 );
+    atomic<size_t>                         nNextSection( 0 );
+    auto oDecodeSections = [&]()
+    {
+        size_t iSection;
+        while( ( iSection = nNextSection++ ) < astSections.size() )
+        {
+            const ObjectMapSection& stSection = astSections[iSection];
+            if( !DecodeObjectMapSection( abySections.data() + stSection.nOffset, stSection.nSize,
+                                         aaSectionEntries[iSection] ) )
+                abSectionFailed[iSection] = 1;
+        }
+    };
+
+    // A section holds ~2 KB, threads are worth it on big maps only.
+    const size_t nSectionsPerThread = 64;
+    size_t nThreads = min<size_t>( max( 1u, thread::hardware_concurrency() ),
+                                   astSections.size() / nSectionsPerThread );
+    vector<thread> aoThreads;
+    for( size_t i = 1; i < nThreads; ++i )
+        aoThreads.emplace_back( oDecodeSections );
+    oDecodeSections();
+    for( thread& oThread : aoThreads )
+        oThread.join();
+
+    size_t nEntries = 0;
+    for( size_t i = 0; i < astSections.size(); ++i )
+    {
+        if( abSectionFailed[i] )
+        {
+            DebugMsg( "File is corrupted (object map section #%zd is truncated.)\n", i + 1 );
+            return CADErrorCodes::OBJECTS_SECTION_READ_FAILED;
+        }
+        nEntries += aaSectionEntries[i].size();
+    }
 
-        delete[] pabySectionContent;
+    oObjectIndex.Reserve( nEntries );
+    for( const vector<CADObjectIndex::Entry>& aEntries : aaSectionEntries )
+    {
+        for( const CADObjectIndex::Entry& stEntry : aEntries )
+            oObjectIndex.Add( stEntry.nHandle, stEntry.nOffset );
     }
+    oObjectIndex.Finalize();
+    DebugMsg( "Objects in the file map: %zd\n", oObjectIndex.GetCount() );
 
     return CADErrorCodes::SUCCESS;
 }
 
-CADObject * DWGFileR2000::GetObject( long dHandle, bool bHandlesOnly )
+short DWGFileR2000::resolveObjectType( short dObjectType ) const
 {
-    CADObject * readed_object  = nullptr;
-
-    char   pabyObjectSize[8];
-    size_t nBitOffsetFromStart = 0;
-    pFileIO->Seek( mapObjects[dHandle], CADFileIO::SeekOrigin::BEG );
-    pFileIO->Read( pabyObjectSize, 8 );
-    unsigned int dObjectSize = ReadMSHORT( pabyObjectSize, nBitOffsetFromStart );
-
-    // And read whole data chunk into memory for future parsing.
-    // + nBitOffsetFromStart/8 + 2 is because dObjectSize doesn't cover CRC and itself.
-    size_t             nSectionSize = dObjectSize + nBitOffsetFromStart / 8 + 2;
-    unique_ptr<char[]> sectionContentPtr( new char[nSectionSize + 4] );
-    char * pabySectionContent = sectionContentPtr.get();
-    pFileIO->Seek( mapObjects[dHandle], CADFileIO::SeekOrigin::BEG );
-    pFileIO->Read( pabySectionContent, nSectionSize );
-
-    nBitOffsetFromStart = 0;
-    dObjectSize         = ReadMSHORT( pabySectionContent, nBitOffsetFromStart );
-    short dObjectType = ReadBITSHORT( pabySectionContent, nBitOffsetFromStart );
-
     if( dObjectType >= 500 )
     {
         CADClass cadClass = oClasses.getClassByNum( dObjectType );
@@ -804,194 +896,395 @@ CADObject * DWGFileR2000::GetObject( long dHandle, bool bHandlesOnly )
             dObjectType = CADObject::WIPEOUT;
         }
     }
+    return dObjectType;
+}
+
+bool DWGFileR2000::ProbeEntity( long dHandle, CADEntityProbe& stProbe )
+{
+    long nObjectOffset = 0;
+    if( !oObjectIndex.Find( dHandle, nObjectOffset ) )
+    {
+        DebugMsg( "Object %ld is not in the file map\n", dHandle );
+        return false;
+    }
+
+    CADFileIO  * poFileIO      = GetFileIO();
+    char         pabyObjectSize[8] = { 0 };
+    const char * pabyObjectSizeData = poFileIO->GetView( nObjectOffset, 8 );
+    size_t       nBitOffsetFromStart = 0;
+    if( pabyObjectSizeData == nullptr )
+    {
+        poFileIO->ReadAt( nObjectOffset, pabyObjectSize, 8 );
+        pabyObjectSizeData = pabyObjectSize;
+    }
+    unsigned int dObjectSize = ReadMSHORT( DWGBuffer( pabyObjectSizeData, 8 ), nBitOffsetFromStart );
+    size_t       nObjectSizeBits = nBitOffsetFromStart;
+
+    // Most of entities fit the stack buffer, only ones with big EED or
+    // graphics data need the heap.
+    size_t       nSectionSize = dObjectSize + nBitOffsetFromStart / 8;
+    char         abyStackBuffer[512];
+    vector<char> abyHeapBuffer;
+    const char * pabySectionContent = poFileIO->GetView( nObjectOffset, nSectionSize );
+    if( pabySectionContent == nullptr )
+    {
+        char * pabyBuffer = abyStackBuffer;
+        if( nSectionSize > sizeof( abyStackBuffer ) )
+        {
+            abyHeapBuffer.resize( nSectionSize );
+            pabyBuffer = abyHeapBuffer.data();
+        }
+        if( poFileIO->ReadAt( nObjectOffset, pabyBuffer, nSectionSize ) != nSectionSize )
+        {
+            DebugMsg( "Object %ld is out of the file\n", dHandle );
+            return false;
+        }
+        pabySectionContent = pabyBuffer;
+    }
+    DWGBuffer    oSectionContent( pabySectionContent, nSectionSize );
+    DWGBitReader oReader( oSectionContent, nBitOffsetFromStart );
+
+    short dObjectType = resolveObjectType( oReader.ReadBITSHORT() );
+    if( !isCommonEntityType( dObjectType ) )
+        return false;
+
+    long      nObjectSizeInBits = oReader.ReadRAWLONG();
+    CADHandle hObjectHandle     = oReader.ReadHANDLE();
+
+    // EED and graphics are skipped, not read
+    short dEEDSize;
+    while( ( dEEDSize = oReader.ReadBITSHORT() ) != 0 && !oReader.IsOverrun() )
+    {
+        oReader.SkipHANDLE();
+        oReader.SkipBits( static_cast<unsigned short>( dEEDSize ) * 8 );
+    }
+
+    if( oReader.ReadBIT() )
+    {
+        size_t nGraphicsDataSize = static_cast<size_t>( oReader.ReadRAWLONG() );
+        oReader.SkipBits( nGraphicsDataSize * 8 );
+    }
+    unsigned char bbEntMode    = oReader.Read2B();
+    long          nNumReactors = oReader.ReadBITLONG();
+    bool          bNoLinks     = oReader.ReadBIT();
+
+    // Handles stream starts right after the object data
+    oReader.SetBitOffset( nObjectSizeBits + static_cast<size_t>( nObjectSizeInBits ) );
+
+    long nOwner = 0;
+    if( bbEntMode == 0 )
+        nOwner = oReader.ReadHANDLE().getAsLong( hObjectHandle );
+
+    for( long i = 0; i < nNumReactors && !oReader.IsOverrun(); ++i )
+        oReader.SkipHANDLE();
+
+    oReader.SkipHANDLE(); // xdictionary
+
+    CADHandle hNextEntity;
+    if( !bNoLinks )
+    {
+        oReader.SkipHANDLE(); // previous entity
+        hNextEntity = oReader.ReadHANDLE();
+    }
+
+    CADHandle hLayer = oReader.ReadHANDLE();
+    if( oReader.IsOverrun() )
+    {
+        DebugMsg( "Object %ld is truncated\n", dHandle );
+        return false;
+    }
+
+    stProbe.eType       = static_cast<CADObject::ObjectType>( dObjectType );
+    stProbe.nHandle     = hObjectHandle.getAsLong();
+    stProbe.nOwner      = nOwner;
+    stProbe.nLayer      = hLayer.getAsLong( hObjectHandle );
+    stProbe.nNextEntity = hNextEntity.getAsLong( hObjectHandle );
+    stProbe.bNoLinks    = bNoLinks;
+
+    return true;
+}
+
+CADObject * DWGFileR2000::GetObject( long dHandle, bool bHandlesOnly )
+{
+    CADObject * readed_object  = nullptr;
+
+    long nObjectOffset = 0;
+    if( !oObjectIndex.Find( dHandle, nObjectOffset ) )
+    {
+        DebugMsg( "Object %ld is not in the file map\n", dHandle );
+        return nullptr;
+    }
+
+    CADFileIO  * poFileIO      = GetFileIO();
+    char         pabyObjectSize[8] = { 0 };
+    const char * pabyObjectSizeData = poFileIO->GetView( nObjectOffset, 8 );
+    size_t       nBitOffsetFromStart = 0;
+    if( pabyObjectSizeData == nullptr )
+    {
+        poFileIO->ReadAt( nObjectOffset, pabyObjectSize, 8 );
+        pabyObjectSizeData = pabyObjectSize;
+    }
+    unsigned int dObjectSize = ReadMSHORT( DWGBuffer( pabyObjectSizeData, 8 ), nBitOffsetFromStart );
+
+    // And read whole data chunk into memory for future parsing, unless the file
+    // io gives direct access to its data.
+    // + nBitOffsetFromStart/8 + 2 is because dObjectSize doesn't cover CRC and itself.
+    size_t             nSectionSize = dObjectSize + nBitOffsetFromStart / 8 + 2;
+    std::vector<char> abySectionContent;
+    const char * pabySectionContent = poFileIO->GetView( nObjectOffset, nSectionSize );
+    if( pabySectionContent == nullptr )
+    {
+        abySectionContent = ReadSection( poFileIO, nObjectOffset, nSectionSize );
+        if( abySectionContent.size() != nSectionSize )
+        {
+            DebugMsg( "Object %ld is out of the file\n", dHandle );
+            return nullptr;
+        }
+        pabySectionContent = abySectionContent.data();
+    }
+    DWGBuffer oSectionContent( pabySectionContent, nSectionSize );
+
+    nBitOffsetFromStart = 0;
+    dObjectSize         = ReadMSHORT( oSectionContent, nBitOffsetFromStart );
+    short dObjectType = resolveObjectType( ReadBITSHORT( oSectionContent, nBitOffsetFromStart ) );
 
     // Entities handling
     if( isCommonEntityType( dObjectType ) )
     {
         struct CADCommonED stCommonEntityData; // common for all entities
 
-        stCommonEntityData.nObjectSizeInBits = ReadRAWLONG( pabySectionContent, nBitOffsetFromStart );
-        stCommonEntityData.hObjectHandle     = ReadHANDLE( pabySectionContent, nBitOffsetFromStart );
+        stCommonEntityData.nObjectSizeInBits = ReadRAWLONG( oSectionContent, nBitOffsetFromStart );
+        stCommonEntityData.hObjectHandle     = ReadHANDLE( oSectionContent, nBitOffsetFromStart );
 
         short  dEEDSize;
         CADEed dwgEed;
-        while( ( dEEDSize = ReadBITSHORT( pabySectionContent, nBitOffsetFromStart ) ) != 0 )
+        while( ( dEEDSize = ReadBITSHORT( oSectionContent, nBitOffsetFromStart ) ) != 0 )
         {
             dwgEed.dLength      = dEEDSize;
-            dwgEed.hApplication = ReadHANDLE( pabySectionContent, nBitOffsetFromStart );
+            dwgEed.hApplication = ReadHANDLE( oSectionContent, nBitOffsetFromStart );
 
             for( short i = 0; i < dEEDSize; ++i )
             {
-                dwgEed.acData.push_back( ReadCHAR( pabySectionContent, nBitOffsetFromStart ) );
+                dwgEed.acData.push_back( ReadCHAR( oSectionContent, nBitOffsetFromStart ) );
             }
 
             stCommonEntityData.aEED.push_back( dwgEed );
         }
 
-        stCommonEntityData.bGraphicsPresented = ReadBIT( pabySectionContent, nBitOffsetFromStart );
+        stCommonEntityData.bGraphicsPresented = ReadBIT( oSectionContent, nBitOffsetFromStart );
         if( stCommonEntityData.bGraphicsPresented )
         {
-            size_t nGraphicsDataSize = static_cast<size_t>(ReadRAWLONG( pabySectionContent, nBitOffsetFromStart ));
+            size_t nGraphicsDataSize = static_cast<size_t>(ReadRAWLONG( oSectionContent, nBitOffsetFromStart ));
             // skip read graphics data
             nBitOffsetFromStart += nGraphicsDataSize * 8;
         }
-        stCommonEntityData.bbEntMode        = Read2B( pabySectionContent, nBitOffsetFromStart );
-        stCommonEntityData.nNumReactors     = ReadBITLONG( pabySectionContent, nBitOffsetFromStart );
-        stCommonEntityData.bNoLinks         = ReadBIT( pabySectionContent, nBitOffsetFromStart );
-        stCommonEntityData.nCMColor         = ReadBITSHORT( pabySectionContent, nBitOffsetFromStart );
-        stCommonEntityData.dfLTypeScale     = ReadBITDOUBLE( pabySectionContent, nBitOffsetFromStart );
-        stCommonEntityData.bbLTypeFlags     = Read2B( pabySectionContent, nBitOffsetFromStart );
-        stCommonEntityData.bbPlotStyleFlags = Read2B( pabySectionContent, nBitOffsetFromStart );
-        stCommonEntityData.nInvisibility    = ReadBITSHORT( pabySectionContent, nBitOffsetFromStart );
-        stCommonEntityData.nLineWeight      = ReadCHAR( pabySectionContent, nBitOffsetFromStart );
+        stCommonEntityData.bbEntMode        = Read2B( oSectionContent, nBitOffsetFromStart );
+        stCommonEntityData.nNumReactors     = ReadBITLONG( oSectionContent, nBitOffsetFromStart );
+        stCommonEntityData.bNoLinks         = ReadBIT( oSectionContent, nBitOffsetFromStart );
+        stCommonEntityData.nCMColor         = ReadBITSHORT( oSectionContent, nBitOffsetFromStart );
+        stCommonEntityData.dfLTypeScale     = ReadBITDOUBLE( oSectionContent, nBitOffsetFromStart );
+        stCommonEntityData.bbLTypeFlags     = Read2B( oSectionContent, nBitOffsetFromStart );
+        stCommonEntityData.bbPlotStyleFlags = Read2B( oSectionContent, nBitOffsetFromStart );
+        stCommonEntityData.nInvisibility    = ReadBITSHORT( oSectionContent, nBitOffsetFromStart );
+        stCommonEntityData.nLineWeight      = ReadCHAR( oSectionContent, nBitOffsetFromStart );
 
         // Skip entitity-specific data, we don't need it if bHandlesOnly == true
         if( bHandlesOnly == true )
         {
-            return getEntity( dObjectType, dObjectSize, stCommonEntityData, pabySectionContent, nBitOffsetFromStart );
-        }
-
-        switch( dObjectType )
+            readed_object = getEntity( dObjectType, dObjectSize, stCommonEntityData, oSectionContent,
+                                       nBitOffsetFromStart );
+        } else
         {
-            case CADObject::BLOCK:
-                return getBlock( dObjectSize, stCommonEntityData, pabySectionContent, nBitOffsetFromStart );
+            switch( dObjectType )
+            {
+                case CADObject::BLOCK:
+                    readed_object = getBlock( dObjectSize, stCommonEntityData, oSectionContent, nBitOffsetFromStart );
+                    break;
 
-            case CADObject::ELLIPSE:
-                return getEllipse( dObjectSize, stCommonEntityData, pabySectionContent, nBitOffsetFromStart );
+                case CADObject::ELLIPSE:
+                    readed_object = getEllipse( dObjectSize, stCommonEntityData, oSectionContent, nBitOffsetFromStart );
+                    break;
 
-            case CADObject::MLINE:
-                return getMLine( dObjectSize, stCommonEntityData, pabySectionContent, nBitOffsetFromStart );
+                case CADObject::MLINE:
+                    readed_object = getMLine( dObjectSize, stCommonEntityData, oSectionContent, nBitOffsetFromStart );
+                    break;
 
-            case CADObject::SOLID:
-                return getSolid( dObjectSize, stCommonEntityData, pabySectionContent, nBitOffsetFromStart );
+                case CADObject::SOLID:
+                    readed_object = getSolid( dObjectSize, stCommonEntityData, oSectionContent, nBitOffsetFromStart );
+                    break;
 
-            case CADObject::POINT:
-                return getPoint( dObjectSize, stCommonEntityData, pabySectionContent, nBitOffsetFromStart );
+                case CADObject::POINT:
+                    readed_object = getPoint( dObjectSize, stCommonEntityData, oSectionContent, nBitOffsetFromStart );
+                    break;
 
-            case CADObject::POLYLINE3D:
-                return getPolyLine3D( dObjectSize, stCommonEntityData, pabySectionContent, nBitOffsetFromStart );
+                case CADObject::POLYLINE3D:
+                    readed_object = getPolyLine3D( dObjectSize, stCommonEntityData, oSectionContent, nBitOffsetFromStart );
+                    break;
 
-            case CADObject::RAY:
-                return getRay( dObjectSize, stCommonEntityData, pabySectionContent, nBitOffsetFromStart );
+                case CADObject::RAY:
+                    readed_object = getRay( dObjectSize, stCommonEntityData, oSectionContent, nBitOffsetFromStart );
+                    break;
 
-            case CADObject::XLINE:
-                return getXLine( dObjectSize, stCommonEntityData, pabySectionContent, nBitOffsetFromStart );
+                case CADObject::XLINE:
+                    readed_object = getXLine( dObjectSize, stCommonEntityData, oSectionContent, nBitOffsetFromStart );
+                    break;
 
-            case CADObject::LINE:
-                return getLine( dObjectSize, stCommonEntityData, pabySectionContent, nBitOffsetFromStart );
+                case CADObject::LINE:
+                    readed_object = getLine( dObjectSize, stCommonEntityData, oSectionContent, nBitOffsetFromStart );
+                    break;
 
-            case CADObject::TEXT:
-                return getText( dObjectSize, stCommonEntityData, pabySectionContent, nBitOffsetFromStart );
+                case CADObject::TEXT:
+                    readed_object = getText( dObjectSize, stCommonEntityData, oSectionContent, nBitOffsetFromStart );
+                    break;
 
-			case CADObject::VERTEX2D:
-				return getVertex2D(dObjectSize, stCommonEntityData, pabySectionContent, nBitOffsetFromStart);
+                case CADObject::VERTEX2D:
+                    readed_object = getVertex2D( dObjectSize, stCommonEntityData, oSectionContent, nBitOffsetFromStart );
+                    break;
 
-            case CADObject::VERTEX3D:
-                return getVertex3D( dObjectSize, stCommonEntityData, pabySectionContent, nBitOffsetFromStart );
+                case CADObject::VERTEX3D:
+                    readed_object = getVertex3D( dObjectSize, stCommonEntityData, oSectionContent, nBitOffsetFromStart );
+                    break;
 
-            case CADObject::CIRCLE:
-                return getCircle( dObjectSize, stCommonEntityData, pabySectionContent, nBitOffsetFromStart );
+                case CADObject::CIRCLE:
+                    readed_object = getCircle( dObjectSize, stCommonEntityData, oSectionContent, nBitOffsetFromStart );
+                    break;
 
-            case CADObject::ENDBLK:
-                return getEndBlock( dObjectSize, stCommonEntityData, pabySectionContent, nBitOffsetFromStart );
+                case CADObject::ENDBLK:
+                    readed_object = getEndBlock( dObjectSize, stCommonEntityData, oSectionContent, nBitOffsetFromStart );
+                    break;
 
-            case CADObject::POLYLINE2D:
-                return getPolyline2D( dObjectSize, stCommonEntityData, pabySectionContent, nBitOffsetFromStart );
+                case CADObject::POLYLINE2D:
+                    readed_object = getPolyline2D( dObjectSize, stCommonEntityData, oSectionContent, nBitOffsetFromStart );
+                    break;
 
-            case CADObject::ATTRIB:
-                return getAttributes( dObjectSize, stCommonEntityData, pabySectionContent, nBitOffsetFromStart );
+                case CADObject::ATTRIB:
+                    readed_object = getAttributes( dObjectSize, stCommonEntityData, oSectionContent, nBitOffsetFromStart );
+                    break;
 
-            case CADObject::ATTDEF:
-                return getAttributesDefn( dObjectSize, stCommonEntityData, pabySectionContent, nBitOffsetFromStart );
+                case CADObject::ATTDEF:
+                    readed_object = getAttributesDefn( dObjectSize, stCommonEntityData, oSectionContent, nBitOffsetFromStart );
+                    break;
 
-            case CADObject::LWPOLYLINE:
-                return getLWPolyLine( dObjectSize, stCommonEntityData, pabySectionContent, nBitOffsetFromStart );
+                case CADObject::LWPOLYLINE:
+                    readed_object = getLWPolyLine( dObjectSize, stCommonEntityData, oSectionContent, nBitOffsetFromStart );
+                    break;
 
-            case CADObject::ARC:
-                return getArc( dObjectSize, stCommonEntityData, pabySectionContent, nBitOffsetFromStart );
+                case CADObject::ARC:
+                    readed_object = getArc( dObjectSize, stCommonEntityData, oSectionContent, nBitOffsetFromStart );
+                    break;
 
-            case CADObject::SPLINE:
-                return getSpline( dObjectSize, stCommonEntityData, pabySectionContent, nBitOffsetFromStart );
+                case CADObject::SPLINE:
+                    readed_object = getSpline( dObjectSize, stCommonEntityData, oSectionContent, nBitOffsetFromStart );
+                    break;
 
-            case CADObject::POLYLINE_PFACE:
-                return getPolylinePFace( dObjectSize, stCommonEntityData, pabySectionContent, nBitOffsetFromStart );
+                case CADObject::POLYLINE_PFACE:
+                    readed_object = getPolylinePFace( dObjectSize, stCommonEntityData, oSectionContent, nBitOffsetFromStart );
+                    break;
 
-            case CADObject::IMAGE:
-                return getImage( dObjectSize, stCommonEntityData, pabySectionContent, nBitOffsetFromStart );
+                case CADObject::IMAGE:
+                    readed_object = getImage( dObjectSize, stCommonEntityData, oSectionContent, nBitOffsetFromStart );
+                    break;
 
-            case CADObject::FACE3D:
-                return get3DFace( dObjectSize, stCommonEntityData, pabySectionContent, nBitOffsetFromStart );
+                case CADObject::FACE3D:
+                    readed_object = get3DFace( dObjectSize, stCommonEntityData, oSectionContent, nBitOffsetFromStart );
+                    break;
 
-            case CADObject::VERTEX_MESH:
-                return getVertexMesh( dObjectSize, stCommonEntityData, pabySectionContent, nBitOffsetFromStart );
+                case CADObject::VERTEX_MESH:
+                    readed_object = getVertexMesh( dObjectSize, stCommonEntityData, oSectionContent, nBitOffsetFromStart );
+                    break;
 
-            case CADObject::VERTEX_PFACE:
-                return getVertexPFace( dObjectSize, stCommonEntityData, pabySectionContent, nBitOffsetFromStart );
+                case CADObject::VERTEX_PFACE:
+                    readed_object = getVertexPFace( dObjectSize, stCommonEntityData, oSectionContent, nBitOffsetFromStart );
+                    break;
 
-            case CADObject::MTEXT:
-                return getMText( dObjectSize, stCommonEntityData, pabySectionContent, nBitOffsetFromStart );
+                case CADObject::MTEXT:
+                    readed_object = getMText( dObjectSize, stCommonEntityData, oSectionContent, nBitOffsetFromStart );
+                    break;
 
-            case CADObject::DIMENSION_RADIUS:
-            case CADObject::DIMENSION_DIAMETER:
-            case CADObject::DIMENSION_ALIGNED:
-            case CADObject::DIMENSION_ANG_3PT:
-            case CADObject::DIMENSION_ANG_2LN:
-            case CADObject::DIMENSION_ORDINATE:
-            case CADObject::DIMENSION_LINEAR:
-                return getDimension( dObjectType, dObjectSize, stCommonEntityData, pabySectionContent,
-                                     nBitOffsetFromStart );
+                case CADObject::DIMENSION_RADIUS:
+                case CADObject::DIMENSION_DIAMETER:
+                case CADObject::DIMENSION_ALIGNED:
+                case CADObject::DIMENSION_ANG_3PT:
+                case CADObject::DIMENSION_ANG_2LN:
+                case CADObject::DIMENSION_ORDINATE:
+                case CADObject::DIMENSION_LINEAR:
+                    readed_object = getDimension( dObjectType, dObjectSize, stCommonEntityData, oSectionContent,
+                                                  nBitOffsetFromStart );
+                    break;
 
-            case CADObject::INSERT:
-                return getInsert( dObjectType, dObjectSize, stCommonEntityData, pabySectionContent,
-                                  nBitOffsetFromStart );
+                case CADObject::INSERT:
+                    readed_object = getInsert( dObjectType, dObjectSize, stCommonEntityData, oSectionContent,
+                                               nBitOffsetFromStart );
+                    break;
 
-            default:
-                return getEntity( dObjectType, dObjectSize, stCommonEntityData, pabySectionContent,
-                                  nBitOffsetFromStart );
+                default:
+                    readed_object = getEntity( dObjectType, dObjectSize, stCommonEntityData, oSectionContent,
+                                               nBitOffsetFromStart );
+                    break;
+            }
         }
     } else
     {
         switch( dObjectType )
         {
             case CADObject::DICTIONARY:
-                return getDictionary( dObjectSize, pabySectionContent, nBitOffsetFromStart );
+                readed_object = getDictionary( dObjectSize, oSectionContent, nBitOffsetFromStart );
+                break;
 
             case CADObject::LAYER:
-                return getLayerObject( dObjectSize, pabySectionContent, nBitOffsetFromStart );
+                readed_object = getLayerObject( dObjectSize, oSectionContent, nBitOffsetFromStart );
+                break;
 
             case CADObject::LAYER_CONTROL_OBJ:
-                return getLayerControl( dObjectSize, pabySectionContent, nBitOffsetFromStart );
+                readed_object = getLayerControl( dObjectSize, oSectionContent, nBitOffsetFromStart );
+                break;
 
             case CADObject::BLOCK_CONTROL_OBJ:
-                return getBlockControl( dObjectSize, pabySectionContent, nBitOffsetFromStart );
+                readed_object = getBlockControl( dObjectSize, oSectionContent, nBitOffsetFromStart );
+                break;
 
             case CADObject::BLOCK_HEADER:
-                return getBlockHeader( dObjectSize, pabySectionContent, nBitOffsetFromStart );
+                readed_object = getBlockHeader( dObjectSize, oSectionContent, nBitOffsetFromStart );
+                break;
 
             case CADObject::LTYPE_CONTROL_OBJ:
-                return getLineTypeControl( dObjectSize, pabySectionContent, nBitOffsetFromStart );
+                readed_object = getLineTypeControl( dObjectSize, oSectionContent, nBitOffsetFromStart );
+                break;
 
             case CADObject::LTYPE1:
-                return getLineType1( dObjectSize, pabySectionContent, nBitOffsetFromStart );
+                readed_object = getLineType1( dObjectSize, oSectionContent, nBitOffsetFromStart );
+                break;
 
             case CADObject::IMAGEDEF:
-                return getImageDef( dObjectSize, pabySectionContent, nBitOffsetFromStart );
+                readed_object = getImageDef( dObjectSize, oSectionContent, nBitOffsetFromStart );
+                break;
 
             case CADObject::IMAGEDEFREACTOR:
-                return getImageDefReactor( dObjectSize, pabySectionContent, nBitOffsetFromStart );
+                readed_object = getImageDefReactor( dObjectSize, oSectionContent, nBitOffsetFromStart );
+                break;
 
             case CADObject::XRECORD:
-                return getXRecord( dObjectSize, pabySectionContent, nBitOffsetFromStart );
+                readed_object = getXRecord( dObjectSize, oSectionContent, nBitOffsetFromStart );
+                break;
         }
     }
 
+    // Truncated or corrupted object, don't return garbage.
+    if( oSectionContent.IsOverrun() )
+    {
+        DebugMsg( "Object %ld is truncated or corrupted\n", dHandle );
+        delete readed_object;
+        return nullptr;
+    }
+
     return readed_object;
 }
 
 CADGeometry * DWGFileR2000::GetGeometry( size_t iLayerIndex, long dHandle, long dBlockRefHandle )
 {
     CADGeometry * poGeometry = nullptr;
-    unique_ptr<CADEntityObject> readedObject( static_cast<CADEntityObject *>(GetObject( dHandle )) );
+    shared_ptr<const CADEntityObject> readedObject =
+            static_pointer_cast<const CADEntityObject>( GetCachedObject( dHandle ) );
 
     if( nullptr == readedObject )
         return nullptr;
@@ -1000,8 +1293,8 @@ CADGeometry * DWGFileR2000::GetGeometry( size_t iLayerIndex, long dHandle, long
     {
         case CADObject::ARC:
         {
-            CADArc       * arc    = new CADArc();
-            CADArcObject * cadArc = static_cast<CADArcObject *>(
+            CADArc             * arc    = new CADArc();
+            const CADArcObject * cadArc = static_cast<const CADArcObject *>(
                     readedObject.get());
 
             arc->setPosition( cadArc->vertPosition );
@@ -1017,8 +1310,8 @@ CADGeometry * DWGFileR2000::GetGeometry( size_t iLayerIndex, long dHandle, long
 
         case CADObject::POINT:
         {
-            CADPoint3D     * point    = new CADPoint3D();
-            CADPointObject * cadPoint = static_cast<CADPointObject *>(
+            CADPoint3D           * point    = new CADPoint3D();
+            const CADPointObject * cadPoint = static_cast<const CADPointObject *>(
                     readedObject.get());
 
             point->setPosition( cadPoint->vertPosition );
@@ -1032,8 +1325,8 @@ CADGeometry * DWGFileR2000::GetGeometry( size_t iLayerIndex, long dHandle, long
 
         case CADObject::POLYLINE3D:
         {
-            CADPolyline3D       * polyline               = new CADPolyline3D();
-            CADPolyline3DObject * cadPolyline3D          = static_cast<CADPolyline3DObject *>(
+            CADPolyline3D             * polyline               = new CADPolyline3D();
+            const CADPolyline3DObject * cadPolyline3D          = static_cast<const CADPolyline3DObject *>(
                     readedObject.get());
 
 			polyline->setClosed(cadPolyline3D->bClosed);
@@ -1041,12 +1334,11 @@ CADGeometry * DWGFileR2000::GetGeometry( size_t iLayerIndex, long dHandle, long
 
             // TODO: code can be much simplified if CADHandle will be used.
             // to do so, == and ++ operators should be implemented.
-            unique_ptr<CADVertex3DObject> vertex;
+            shared_ptr<const CADVertex3DObject> vertex;
             long                          currentVertexH = cadPolyline3D->hVertexes[0].getAsLong();
             while( currentVertexH != 0 )
             {
-                vertex.reset( static_cast<CADVertex3DObject *>(
-                                      GetObject( currentVertexH )) );
+                vertex = static_pointer_cast<const CADVertex3DObject>( GetCachedObject( currentVertexH ) );
 
                 if( vertex == nullptr )
                     break;
@@ -1065,9 +1357,8 @@ CADGeometry * DWGFileR2000::GetGeometry( size_t iLayerIndex, long dHandle, long
                 // Last vertex is reached. read it and break reading.
                 if( currentVertexH == cadPolyline3D->hVertexes[1].getAsLong() )
                 {
-                    vertex.reset( static_cast<CADVertex3DObject *>(
-                                          GetObject( currentVertexH )) );
-					if (!( vertex->vFlags & 2 || vertex->vFlags & 16 )) // ignore tangent / spline frame pts
+                    vertex = static_pointer_cast<const CADVertex3DObject>( GetCachedObject( currentVertexH ) );
+					if ( vertex != nullptr && !( vertex->vFlags & 2 || vertex->vFlags & 16 )) // ignore tangent / spline frame pts
 						polyline->addVertex( vertex->vertPosition );
                     break;
                 }
@@ -1079,16 +1370,15 @@ CADGeometry * DWGFileR2000::GetGeometry( size_t iLayerIndex, long dHandle, long
 
         case CADObject::LWPOLYLINE:
         {
-            CADLWPolyline       * lwPolyline    = new CADLWPolyline();
-            CADLWPolylineObject * cadlwPolyline = static_cast<CADLWPolylineObject *>(
+            CADLWPolyline             * lwPolyline    = new CADLWPolyline();
+            const CADLWPolylineObject * cadlwPolyline = static_cast<const CADLWPolylineObject *>(
                     readedObject.get());
 
 			lwPolyline->setBulges(cadlwPolyline->adfBulges);
             lwPolyline->setClosed(cadlwPolyline->bClosed );
             lwPolyline->setConstWidth(cadlwPolyline->dfConstWidth );
             lwPolyline->setElevation(cadlwPolyline->dfElevation );
-            for( const CADVector& vertex : cadlwPolyline->avertVertexes )
-                lwPolyline->addVertex(vertex );
+            lwPolyline->setVertexes( cadlwPolyline->avertVertexes );
             lwPolyline->setVectExtrusion(cadlwPolyline->vectExtrusion );
             lwPolyline->setWidths( cadlwPolyline->astWidths );
 
@@ -1098,8 +1388,8 @@ CADGeometry * DWGFileR2000::GetGeometry( size_t iLayerIndex, long dHandle, long
 
 		case CADObject::POLYLINE2D:
 		{
-			CADPolyline2D       * polyline2D = new CADPolyline2D();
-			CADPolyline2DObject * cadPolyline2D = static_cast<CADPolyline2DObject *>(
+			CADPolyline2D             * polyline2D = new CADPolyline2D();
+			const CADPolyline2DObject * cadPolyline2D = static_cast<const CADPolyline2DObject *>(
                     readedObject.get());
 
 			polyline2D->setClosed(cadPolyline2D->bClosed);
@@ -1114,12 +1404,11 @@ CADGeometry * DWGFileR2000::GetGeometry( size_t iLayerIndex, long dHandle, long
 
 			// TODO: code can be much simplified if CADHandle will be used.
 			// to do so, == and ++ operators should be implemented.
-			unique_ptr<CADVertex2DObject> vertex;
+			shared_ptr<const CADVertex2DObject> vertex;
 			long                          currentVertexH = cadPolyline2D->hVertexes[0].getAsLong();
 			while (currentVertexH != 0)
 			{
-				vertex.reset(static_cast<CADVertex2DObject *>(
-					GetObject(currentVertexH)));
+				vertex = static_pointer_cast<const CADVertex2DObject>( GetCachedObject( currentVertexH ) );
 
 				if (vertex == nullptr)
 					break;
@@ -1143,9 +1432,8 @@ CADGeometry * DWGFileR2000::GetGeometry( size_t iLayerIndex, long dHandle, long
 				// Last vertex is reached. read it and break reading.
 				if (currentVertexH == cadPolyline2D->hVertexes[1].getAsLong())
 				{
-					vertex.reset(static_cast<CADVertex2DObject *>(
-						GetObject(currentVertexH)));
-					if (!( vertex->vFlags & 2 || vertex->vFlags & 16 )) // ignore tangent / spline frame pts
+					vertex = static_pointer_cast<const CADVertex2DObject>( GetCachedObject( currentVertexH ) );
+					if ( vertex != nullptr && !( vertex->vFlags & 2 || vertex->vFlags & 16 )) // ignore tangent / spline frame pts
 					{
 						polyline2D->addVertex( CADVector( vertex->vertPosition ));
 						widths.push_back( make_pair( vertex->dfStartWidth, vertex->dfEndWidth ));
@@ -1154,8 +1442,8 @@ CADGeometry * DWGFileR2000::GetGeometry( size_t iLayerIndex, long dHandle, long
 				}
 			}
 
-			polyline2D->setBulges(bulges);
-			polyline2D->setWidths(widths);
+			polyline2D->setBulges( std::move( bulges ) );
+			polyline2D->setWidths( std::move( widths ) );
 
 			poGeometry = polyline2D;
             break;
@@ -1163,8 +1451,8 @@ CADGeometry * DWGFileR2000::GetGeometry( size_t iLayerIndex, long dHandle, long
 
         case CADObject::CIRCLE:
         {
-            CADCircle       * circle    = new CADCircle();
-            CADCircleObject * cadCircle = static_cast<CADCircleObject *>(
+            CADCircle             * circle    = new CADCircle();
+            const CADCircleObject * cadCircle = static_cast<const CADCircleObject *>(
                     readedObject.get());
 
             circle->setPosition( cadCircle->vertPosition );
@@ -1178,8 +1466,8 @@ CADGeometry * DWGFileR2000::GetGeometry( size_t iLayerIndex, long dHandle, long
 
         case CADObject::ATTRIB:
         {
-            CADAttrib       * attrib    = new CADAttrib();
-            CADAttribObject * cadAttrib = static_cast<CADAttribObject *>(
+            CADAttrib             * attrib    = new CADAttrib();
+            const CADAttribObject * cadAttrib = static_cast<const CADAttribObject *>(
                     readedObject.get() );
 
             attrib->setPosition( cadAttrib->vertInsetionPoint );
@@ -1200,8 +1488,8 @@ CADGeometry * DWGFileR2000::GetGeometry( size_t iLayerIndex, long dHandle, long
 
         case CADObject::ATTDEF:
         {
-            CADAttdef       * attdef    = new CADAttdef();
-            CADAttdefObject * cadAttrib = static_cast<CADAttdefObject *>(
+            CADAttdef             * attdef    = new CADAttdef();
+            const CADAttdefObject * cadAttrib = static_cast<const CADAttdefObject *>(
                     readedObject.get() );
 
             attdef->setPosition( cadAttrib->vertInsetionPoint );
@@ -1223,8 +1511,8 @@ CADGeometry * DWGFileR2000::GetGeometry( size_t iLayerIndex, long dHandle, long
 
         case CADObject::ELLIPSE:
         {
-            CADEllipse       * ellipse    = new CADEllipse();
-            CADEllipseObject * cadEllipse = static_cast<CADEllipseObject *>(
+            CADEllipse             * ellipse    = new CADEllipse();
+            const CADEllipseObject * cadEllipse = static_cast<const CADEllipseObject *>(
                     readedObject.get());
 
             ellipse->setPosition( cadEllipse->vertPosition );
@@ -1239,7 +1527,7 @@ CADGeometry * DWGFileR2000::GetGeometry( size_t iLayerIndex, long dHandle, long
 
         case CADObject::LINE:
         {
-            CADLineObject * cadLine = static_cast<CADLineObject *>(
+            const CADLineObject * cadLine = static_cast<const CADLineObject *>(
                     readedObject.get());
 
             CADPoint3D ptBeg( cadLine->vertStart, cadLine->dfThickness );
@@ -1253,8 +1541,8 @@ CADGeometry * DWGFileR2000::GetGeometry( size_t iLayerIndex, long dHandle, long
 
         case CADObject::RAY:
         {
-            CADRay       * ray    = new CADRay();
-            CADRayObject * cadRay = static_cast<CADRayObject *>(
+            CADRay             * ray    = new CADRay();
+            const CADRayObject * cadRay = static_cast<const CADRayObject *>(
                     readedObject.get());
 
             ray->setVectVector( cadRay->vectVector );
@@ -1266,8 +1554,8 @@ CADGeometry * DWGFileR2000::GetGeometry( size_t iLayerIndex, long dHandle, long
 
         case CADObject::SPLINE:
         {
-            CADSpline       * spline    = new CADSpline();
-            CADSplineObject * cadSpline = static_cast<CADSplineObject *>(
+            CADSpline             * spline    = new CADSpline();
+            const CADSplineObject * cadSpline = static_cast<const CADSplineObject *>(
                     readedObject.get());
 
             spline->setScenario( cadSpline->dScenario );
@@ -1281,14 +1569,9 @@ CADGeometry * DWGFileR2000::GetGeometry( size_t iLayerIndex, long dHandle, long
                 spline->setClosed( cadSpline->bClosed );
                 spline->setWeight( cadSpline->bWeight );
             }
-            for( double weight : cadSpline->adfCtrlPointsWeight )
-                spline->addControlPointsWeight( weight );
-
-            for( const CADVector& pt : cadSpline->averFitPoints )
-                spline->addFitPoint( pt );
-
-            for( const CADVector& pt : cadSpline->avertCtrlPoints )
-                spline->addControlPoint( pt );
+            spline->setControlPointsWeights( cadSpline->adfCtrlPointsWeight );
+            spline->setFitPoints( cadSpline->averFitPoints );
+            spline->setControlPoints( cadSpline->avertCtrlPoints );
 
             poGeometry = spline;
             break;
@@ -1296,8 +1579,8 @@ CADGeometry * DWGFileR2000::GetGeometry( size_t iLayerIndex, long dHandle, long
 
         case CADObject::TEXT:
         {
-            CADText       * text    = new CADText();
-            CADTextObject * cadText = static_cast<CADTextObject *>(
+            CADText             * text    = new CADText();
+            const CADTextObject * cadText = static_cast<const CADTextObject *>(
                     readedObject.get());
 
             text->setPosition( cadText->vertInsetionPoint );
@@ -1313,8 +1596,8 @@ CADGeometry * DWGFileR2000::GetGeometry( size_t iLayerIndex, long dHandle, long
 
         case CADObject::SOLID:
         {
-            CADSolid       * solid    = new CADSolid();
-            CADSolidObject * cadSolid = static_cast<CADSolidObject *>(
+            CADSolid             * solid    = new CADSolid();
+            const CADSolidObject * cadSolid = static_cast<const CADSolidObject *>(
                     readedObject.get());
 
             solid->setElevation( cadSolid->dfElevation );
@@ -1329,13 +1612,15 @@ CADGeometry * DWGFileR2000::GetGeometry( size_t iLayerIndex, long dHandle, long
 
         case CADObject::IMAGE:
         {
-            CADImage       * image    = new CADImage();
-            CADImageObject * cadImage = static_cast<CADImageObject *>(
+            const CADImageObject * cadImage = static_cast<const CADImageObject *>(
                     readedObject.get());
 
             unique_ptr<CADImageDefObject> cadImageDef( static_cast<CADImageDefObject *>(
                                                                GetObject( cadImage->hImageDef.getAsLong() ) ) );
+            if( cadImageDef == nullptr )
+                return nullptr;
 
+            CADImage * image = new CADImage();
 
             image->setClippingBoundaryType( cadImage->dClipBoundaryType );
             image->setFilePath( cadImageDef->sFilePath );
@@ -1360,8 +1645,8 @@ CADGeometry * DWGFileR2000::GetGeometry( size_t iLayerIndex, long dHandle, long
 
         case CADObject::MLINE:
         {
-            CADMLine       * mline    = new CADMLine();
-            CADMLineObject * cadmLine = static_cast<CADMLineObject *>(
+            CADMLine             * mline    = new CADMLine();
+            const CADMLineObject * cadmLine = static_cast<const CADMLineObject *>(
                     readedObject.get());
 
             mline->setScale( cadmLine->dfScale );
@@ -1375,8 +1660,8 @@ CADGeometry * DWGFileR2000::GetGeometry( size_t iLayerIndex, long dHandle, long
 
         case CADObject::MTEXT:
         {
-            CADMText       * mtext    = new CADMText();
-            CADMTextObject * cadmText = static_cast<CADMTextObject *>(
+            CADMText             * mtext    = new CADMText();
+            const CADMTextObject * cadmText = static_cast<const CADMTextObject *>(
                     readedObject.get());
 
             mtext->setTextValue( cadmText->sTextValue );
@@ -1396,23 +1681,22 @@ CADGeometry * DWGFileR2000::GetGeometry( size_t iLayerIndex, long dHandle, long
 
         case CADObject::POLYLINE_PFACE:
         {
-            CADPolylinePFace       * polyline                  = new CADPolylinePFace();
-            CADPolylinePFaceObject * cadpolyPface              = static_cast<CADPolylinePFaceObject *>(
+            CADPolylinePFace             * polyline                  = new CADPolylinePFace();
+            const CADPolylinePFaceObject * cadpolyPface              = static_cast<const CADPolylinePFaceObject *>(
                     readedObject.get());
 
             // TODO: code can be much simplified if CADHandle will be used.
             // to do so, == and ++ operators should be implemented.
-            unique_ptr<CADVertexPFaceObject> vertex;
+            shared_ptr<const CADVertexPFaceObject> vertex;
             auto                             dCurrentEntHandle = cadpolyPface->hVertexes[0].getAsLong();
             auto                             dLastEntHandle    = cadpolyPface->hVertexes[1].getAsLong();
             while( true )
             {
-                vertex.reset( static_cast<CADVertexPFaceObject *>(
-                                      GetObject( dCurrentEntHandle )) );
+                vertex = static_pointer_cast<const CADVertexPFaceObject>( GetCachedObject( dCurrentEntHandle ) );
                 /* TODO: this check is excessive, but if something goes wrong way -
              * some part of geometries will be parsed. */
                 if( vertex == nullptr )
-                    continue;
+                    break;
 
                 polyline->addVertex( vertex->vertPosition );
 
@@ -1432,9 +1716,9 @@ CADGeometry * DWGFileR2000::GetGeometry( size_t iLayerIndex, long dHandle, long
 
                 if( dCurrentEntHandle == dLastEntHandle )
                 {
-                    vertex.reset( static_cast<CADVertexPFaceObject *>(
-                                          GetObject( dCurrentEntHandle )) );
-                    polyline->addVertex( vertex->vertPosition );
+                    vertex = static_pointer_cast<const CADVertexPFaceObject>( GetCachedObject( dCurrentEntHandle ) );
+                    if( vertex != nullptr )
+                        polyline->addVertex( vertex->vertPosition );
                     break;
                 }
             }
@@ -1445,8 +1729,8 @@ CADGeometry * DWGFileR2000::GetGeometry( size_t iLayerIndex, long dHandle, long
 
         case CADObject::XLINE:
         {
-            CADXLine       * xline    = new CADXLine();
-            CADXLineObject * cadxLine = static_cast<CADXLineObject *>(
+            CADXLine             * xline    = new CADXLine();
+            const CADXLineObject * cadxLine = static_cast<const CADXLineObject *>(
                     readedObject.get());
 
             xline->setVectVector( cadxLine->vectVector );
@@ -1458,8 +1742,8 @@ CADGeometry * DWGFileR2000::GetGeometry( size_t iLayerIndex, long dHandle, long
 
         case CADObject::FACE3D:
         {
-            CADFace3D       * face      = new CADFace3D();
-            CAD3DFaceObject * cad3DFace = static_cast<CAD3DFaceObject *>(
+            CADFace3D             * face      = new CADFace3D();
+            const CAD3DFaceObject * cad3DFace = static_cast<const CAD3DFaceObject *>(
                     readedObject.get());
 
             for( const CADVector& corner : cad3DFace->avertCorners )
@@ -1485,8 +1769,9 @@ CADGeometry * DWGFileR2000::GetGeometry( size_t iLayerIndex, long dHandle, long
     // Applying color
     if( readedObject->stCed.nCMColor == 256 ) // BYLAYER CASE
     {
-        CADLayer& oCurrentLayer = this->GetLayer( iLayerIndex );
-        poGeometry->setColor( CADACIColors[oCurrentLayer.getColor()] );
+        // no color when the entity layer is not in the table
+        if( iLayerIndex < GetLayersCount() )
+            poGeometry->setColor( CADACIColors[GetLayer( iLayerIndex ).getColor()] );
     }
     else if( readedObject->stCed.nCMColor <= 255 &&
              readedObject->stCed.nCMColor >= 0 ) // Excessive check until BYBLOCK case will not be implemented
@@ -1497,6 +1782,7 @@ CADGeometry * DWGFileR2000::GetGeometry( size_t iLayerIndex, long dHandle, long
     // Applying EED
     // Casting object's EED to a vector of strings
     vector<string> asEED;
+    asEED.reserve( readedObject->stCed.aEED.size() );
     for( auto      citer     = readedObject->stCed.aEED.cbegin(); citer != readedObject->stCed.aEED.cend(); ++citer )
     {
         string sEED = "";
@@ -1602,97 +1888,106 @@ CADGeometry * DWGFileR2000::GetGeometry( size_t iLayerIndex, long dHandle, long
                 DebugMsg( "Error in parsing geometry EED: undefined typecode: %d", ( int ) citer->acData[0] );
             }
         }
-        asEED.emplace_back( sEED );
+        asEED.emplace_back( std::move( sEED ) );
     }
 
     // Getting block reference attributes.
     if( dBlockRefHandle != 0 )
     {
-        vector<CADAttrib>           blockRefAttributes;
-        unique_ptr<CADInsertObject> spoBlockRef( static_cast<CADInsertObject *>( GetObject( dBlockRefHandle ) ) );
+        vector<CADAttrib> blockRefAttributes = GetBlockReferenceAttributes( iLayerIndex, dBlockRefHandle );
+        if( !blockRefAttributes.empty() )
+            poGeometry->setBlockAttributes( std::move( blockRefAttributes ) );
+    }
+
+    poGeometry->setEED( std::move( asEED ) );
+    return poGeometry;
+}
 
-        if( spoBlockRef->hAttribs.size() != 0 )
+vector<CADAttrib> DWGFileR2000::GetBlockReferenceAttributes( size_t iLayerIndex, long dBlockRefHandle )
+{
+    vector<CADAttrib>           blockRefAttributes;
+    shared_ptr<const CADInsertObject> spoBlockRef =
+            static_pointer_cast<const CADInsertObject>( GetCachedObject( dBlockRefHandle ) );
+
+    if( spoBlockRef == nullptr || spoBlockRef->getType() != CADObject::INSERT )
+        return blockRefAttributes;
+
+    if( spoBlockRef->hAttribs.size() != 0 )
+    {
+        long dCurrentEntHandle = spoBlockRef->hAttribs[0].getAsLong();
+        long dLastEntHandle    = spoBlockRef->hAttribs[0].getAsLong();
+
+        while( spoBlockRef->bHasAttribs )
         {
-            long dCurrentEntHandle = spoBlockRef->hAttribs[0].getAsLong();
-            long dLastEntHandle    = spoBlockRef->hAttribs[0].getAsLong();
+            CADEntityProbe stAttDef;
+            bool bAttDefRead = ProbeEntity( dCurrentEntHandle, stAttDef );
 
-            while( spoBlockRef->bHasAttribs )
+            if( dCurrentEntHandle == dLastEntHandle )
             {
-                // FIXME: memory leak, somewhere in CAD* destructor is a bug
-                CADEntityObject * attDefObj = static_cast<CADEntityObject *>(
-                        GetObject( dCurrentEntHandle, true ) );
+                if( !bAttDefRead )
+                    break;
 
-                if( dCurrentEntHandle == dLastEntHandle )
+                CADAttrib * attrib = static_cast<CADAttrib *>(
+                        GetGeometry( iLayerIndex, dCurrentEntHandle ) );
+
+                if( attrib )
                 {
-                    if( attDefObj == nullptr )
-                        break;
-
-                    CADAttrib * attrib = static_cast<CADAttrib *>(
-                            GetGeometry( iLayerIndex, dCurrentEntHandle ) );
-
-                    if( attrib )
-                    {
-                        blockRefAttributes.push_back( CADAttrib( * attrib ) );
-                        delete attrib;
-                    }
-                    delete attDefObj;
-                    break;
+                    blockRefAttributes.push_back( CADAttrib( * attrib ) );
+                    delete attrib;
                 }
+                break;
+            }
 
-                if( attDefObj != nullptr )
-                {
-                    if( attDefObj->stCed.bNoLinks )
-                        ++dCurrentEntHandle;
-                    else
-                        dCurrentEntHandle = attDefObj->stChed.hNextEntity.getAsLong( attDefObj->stCed.hObjectHandle );
-
-                    CADAttrib * attrib = static_cast<CADAttrib *>(
-                            GetGeometry( iLayerIndex, dCurrentEntHandle ) );
-
-                    if( attrib )
-                    {
-                        blockRefAttributes.push_back( CADAttrib( * attrib ) );
-                        delete attrib;
-                    }
-                    delete attDefObj;
-                } else
+            if( bAttDefRead )
+            {
+                if( stAttDef.bNoLinks )
+                    ++dCurrentEntHandle;
+                else
+                    dCurrentEntHandle = stAttDef.nNextEntity;
+
+                CADAttrib * attrib = static_cast<CADAttrib *>(
+                        GetGeometry( iLayerIndex, dCurrentEntHandle ) );
+
+                if( attrib )
                 {
-                    assert ( 0 );
+                    blockRefAttributes.push_back( CADAttrib( * attrib ) );
+                    delete attrib;
                 }
+            } else
+            {
+                assert ( 0 );
+                break;
             }
-            poGeometry->setBlockAttributes( blockRefAttributes );
         }
     }
-
-    poGeometry->setEED( asEED );
-    return poGeometry;
+    return blockRefAttributes;
 }
 
 CADBlockObject * DWGFileR2000::getBlock( long dObjectSize, struct CADCommonED stCommonEntityData,
-                                         const char * pabyInput, size_t& nBitOffsetFromStart )
+                                         const DWGBuffer& oInput, size_t& nBitOffsetFromStart )
 {
     CADBlockObject * pBlock = new CADBlockObject();
 
     pBlock->setSize( dObjectSize );
     pBlock->stCed = stCommonEntityData;
 
-    pBlock->sBlockName = ReadTV( pabyInput, nBitOffsetFromStart );
+    pBlock->sBlockName = ReadTV( oInput, nBitOffsetFromStart );
 
-    fillCommonEntityHandleData( pBlock, pabyInput, nBitOffsetFromStart );
+    fillCommonEntityHandleData( pBlock, oInput, nBitOffsetFromStart );
 
-    nBitOffsetFromStart += 8 - ( nBitOffsetFromStart % 8 );
-    pBlock->setCRC( ReadRAWSHORT( pabyInput, nBitOffsetFromStart ) );
+    AlignToByte( nBitOffsetFromStart );
+    pBlock->setCRC( ReadRAWSHORT( oInput, nBitOffsetFromStart ) );
 
 #ifdef _DEBUG
-    if( ( nBitOffsetFromStart / 8 ) != ( dObjectSize + 4 ) )
+    if( ( nBitOffsetFromStart / 8 ) != oInput.GetSize() )
         DebugMsg( "Assertion failed at %d in %s\nSize difference: %d\n", __LINE__, __FILE__,
-                  ( nBitOffsetFromStart / 8 - dObjectSize - 4 ) );
+                  static_cast<int>( nBitOffsetFromStart / 8 - oInput.GetSize() ) );
 #endif // _DEBUG
 
     return pBlock;
 }
 
-CADEllipseObject * DWGFileR2000::getEllipse( long dObjectSize, CADCommonED stCommonEntityData, const char * pabyInput,
+CADEllipseObject * DWGFileR2000::getEllipse( long dObjectSize, CADCommonED stCommonEntityData, const DWGBuffer& oInput,
                                              size_t& nBitOffsetFromStart )
 {
     CADEllipseObject * ellipse = new CADEllipseObject();
@@ -1700,37 +1995,37 @@ CADEllipseObject * DWGFileR2000::getEllipse( long dObjectSize, CADCommonED stCom
     ellipse->setSize( dObjectSize );
     ellipse->stCed = stCommonEntityData;
 
-    CADVector vertPosition = ReadVector( pabyInput, nBitOffsetFromStart );
+    CADVector vertPosition = ReadVector( oInput, nBitOffsetFromStart );
 
     ellipse->vertPosition = vertPosition;
 
-    CADVector vectSMAxis = ReadVector( pabyInput, nBitOffsetFromStart );
+    CADVector vectSMAxis = ReadVector( oInput, nBitOffsetFromStart );
 
     ellipse->vectSMAxis = vectSMAxis;
 
-    CADVector vectExtrusion = ReadVector( pabyInput, nBitOffsetFromStart );
+    CADVector vectExtrusion = ReadVector( oInput, nBitOffsetFromStart );
 
     ellipse->vectExtrusion = vectExtrusion;
 
-    ellipse->dfAxisRatio = ReadBITDOUBLE( pabyInput, nBitOffsetFromStart );
-    ellipse->dfBegAngle  = ReadBITDOUBLE( pabyInput, nBitOffsetFromStart );
-    ellipse->dfEndAngle  = ReadBITDOUBLE( pabyInput, nBitOffsetFromStart );
+    ellipse->dfAxisRatio = ReadBITDOUBLE( oInput, nBitOffsetFromStart );
+    ellipse->dfBegAngle  = ReadBITDOUBLE( oInput, nBitOffsetFromStart );
+    ellipse->dfEndAngle  = ReadBITDOUBLE( oInput, nBitOffsetFromStart );
 
-    fillCommonEntityHandleData( ellipse, pabyInput, nBitOffsetFromStart );
+    fillCommonEntityHandleData( ellipse, oInput, nBitOffsetFromStart );
 
-    nBitOffsetFromStart += 8 - ( nBitOffsetFromStart % 8 );
-    ellipse->setCRC( ReadRAWSHORT( pabyInput, nBitOffsetFromStart ) );
+    AlignToByte( nBitOffsetFromStart );
+    ellipse->setCRC( ReadRAWSHORT( oInput, nBitOffsetFromStart ) );
 
 #ifdef _DEBUG
-    if( ( nBitOffsetFromStart / 8 ) != ( dObjectSize + 4 ) )
+    if( ( nBitOffsetFromStart / 8 ) != oInput.GetSize() )
         DebugMsg( "Assertion failed at %d in %s\nSize difference: %d\n", __LINE__, __FILE__,
-                  ( nBitOffsetFromStart / 8 - dObjectSize - 4 ) );
+                  static_cast<int>( nBitOffsetFromStart / 8 - oInput.GetSize() ) );
 #endif // _DEBUG
 
     return ellipse;
 }
 
-CADSolidObject * DWGFileR2000::getSolid( long dObjectSize, CADCommonED stCommonEntityData, const char * pabyInput,
+CADSolidObject * DWGFileR2000::getSolid( long dObjectSize, CADCommonED stCommonEntityData, const DWGBuffer& oInput,
                                          size_t& nBitOffsetFromStart )
 {
     CADSolidObject * solid = new CADSolidObject();
@@ -1738,44 +2033,44 @@ CADSolidObject * DWGFileR2000::getSolid( long dObjectSize, CADCommonED stCommonE
     solid->setSize( dObjectSize );
     solid->stCed = stCommonEntityData;
 
-    solid->dfThickness = ReadBIT( pabyInput, nBitOffsetFromStart ) ? 0.0f : ReadBITDOUBLE( pabyInput,
+    solid->dfThickness = ReadBIT( oInput, nBitOffsetFromStart ) ? 0.0f : ReadBITDOUBLE( oInput,
                                                                                            nBitOffsetFromStart );
 
-    solid->dfElevation = ReadBITDOUBLE( pabyInput, nBitOffsetFromStart );
+    solid->dfElevation = ReadBITDOUBLE( oInput, nBitOffsetFromStart );
 
     CADVector   oCorner;
     for( size_t i      = 0; i < 4; ++i )
     {
-        oCorner.setX( ReadRAWDOUBLE( pabyInput, nBitOffsetFromStart ) );
-        oCorner.setY( ReadRAWDOUBLE( pabyInput, nBitOffsetFromStart ) );
+        oCorner.setX( ReadRAWDOUBLE( oInput, nBitOffsetFromStart ) );
+        oCorner.setY( ReadRAWDOUBLE( oInput, nBitOffsetFromStart ) );
         solid->avertCorners.push_back( oCorner );
     }
 
-    if( ReadBIT( pabyInput, nBitOffsetFromStart ) )
+    if( ReadBIT( oInput, nBitOffsetFromStart ) )
     {
         solid->vectExtrusion = CADVector( 0.0f, 0.0f, 1.0f );
     } else
     {
-        CADVector vectExtrusion = ReadVector( pabyInput, nBitOffsetFromStart );
+        CADVector vectExtrusion = ReadVector( oInput, nBitOffsetFromStart );
         solid->vectExtrusion = vectExtrusion;
     }
 
 
-    fillCommonEntityHandleData( solid, pabyInput, nBitOffsetFromStart );
+    fillCommonEntityHandleData( solid, oInput, nBitOffsetFromStart );
 
-    nBitOffsetFromStart += 8 - ( nBitOffsetFromStart % 8 );
-    solid->setCRC( ReadRAWSHORT( pabyInput, nBitOffsetFromStart ) );
+    AlignToByte( nBitOffsetFromStart );
+    solid->setCRC( ReadRAWSHORT( oInput, nBitOffsetFromStart ) );
 
 #ifdef _DEBUG
-    if( ( nBitOffsetFromStart / 8 ) != ( dObjectSize + 4 ) )
+    if( ( nBitOffsetFromStart / 8 ) != oInput.GetSize() )
         DebugMsg( "Assertion failed at %d in %s\nSize difference: %d\n", __LINE__, __FILE__,
-                  ( nBitOffsetFromStart / 8 - dObjectSize - 4 ) );
+                  static_cast<int>( nBitOffsetFromStart / 8 - oInput.GetSize() ) );
 #endif //_DEBUG
 
     return solid;
 }
 
-CADPointObject * DWGFileR2000::getPoint( long dObjectSize, CADCommonED stCommonEntityData, const char * pabyInput,
+CADPointObject * DWGFileR2000::getPoint( long dObjectSize, CADCommonED stCommonEntityData, const DWGBuffer& oInput,
                                          size_t& nBitOffsetFromStart )
 {
     CADPointObject * point = new CADPointObject();
@@ -1783,78 +2078,78 @@ CADPointObject * DWGFileR2000::getPoint( long dObjectSize, CADCommonED stCommonE
     point->setSize( dObjectSize );
     point->stCed = stCommonEntityData;
 
-    CADVector vertPosition = ReadVector( pabyInput, nBitOffsetFromStart );
+    CADVector vertPosition = ReadVector( oInput, nBitOffsetFromStart );
 
     point->vertPosition = vertPosition;
 
-    point->dfThickness = ReadBIT( pabyInput, nBitOffsetFromStart ) ? 0.0f : ReadBITDOUBLE( pabyInput,
+    point->dfThickness = ReadBIT( oInput, nBitOffsetFromStart ) ? 0.0f : ReadBITDOUBLE( oInput,
                                                                                            nBitOffsetFromStart );
 
-    if( ReadBIT( pabyInput, nBitOffsetFromStart ) )
+    if( ReadBIT( oInput, nBitOffsetFromStart ) )
     {
         point->vectExtrusion = CADVector( 0.0f, 0.0f, 1.0f );
     } else
     {
-        CADVector vectExtrusion = ReadVector( pabyInput, nBitOffsetFromStart );
+        CADVector vectExtrusion = ReadVector( oInput, nBitOffsetFromStart );
         point->vectExtrusion = vectExtrusion;
     }
 
-    point->dfXAxisAng = ReadBITDOUBLE( pabyInput, nBitOffsetFromStart );
+    point->dfXAxisAng = ReadBITDOUBLE( oInput, nBitOffsetFromStart );
 
-    fillCommonEntityHandleData( point, pabyInput, nBitOffsetFromStart );
+    fillCommonEntityHandleData( point, oInput, nBitOffsetFromStart );
 
-    nBitOffsetFromStart += 8 - ( nBitOffsetFromStart % 8 );
-    point->setCRC( ReadRAWSHORT( pabyInput, nBitOffsetFromStart ) );
+    AlignToByte( nBitOffsetFromStart );
+    point->setCRC( ReadRAWSHORT( oInput, nBitOffsetFromStart ) );
 
 #ifdef _DEBUG
-    if( ( nBitOffsetFromStart / 8 ) != ( dObjectSize + 4 ) )
+    if( ( nBitOffsetFromStart / 8 ) != oInput.GetSize() )
         DebugMsg( "Assertion failed at %d in %s\nSize difference: %d\n", __LINE__, __FILE__,
-                  ( nBitOffsetFromStart / 8 - dObjectSize - 4 ) );
+                  static_cast<int>( nBitOffsetFromStart / 8 - oInput.GetSize() ) );
 #endif // _DEBUG
 
     return point;
 }
 
 CADPolyline3DObject * DWGFileR2000::getPolyLine3D( long dObjectSize, CADCommonED stCommonEntityData,
-                                                   const char * pabyInput, size_t& nBitOffsetFromStart )
+                                                   const DWGBuffer& oInput, size_t& nBitOffsetFromStart )
 {
     CADPolyline3DObject * polyline = new CADPolyline3DObject();
 
     polyline->setSize( dObjectSize );
     polyline->stCed = stCommonEntityData;
 
-	polyline->SplinedFlags = ReadCHAR(pabyInput, nBitOffsetFromStart);
+	polyline->SplinedFlags = ReadCHAR(oInput, nBitOffsetFromStart);
 	if ( polyline->SplinedFlags & 0x1 || polyline->SplinedFlags & 0x2 ) // quadratic or cubic spline fit
 		polyline->bSplined = true;
 	else
 		polyline->bSplined = false;
 
-	polyline->ClosedFlags = ReadCHAR( pabyInput, nBitOffsetFromStart );
+	polyline->ClosedFlags = ReadCHAR( oInput, nBitOffsetFromStart );
 	if ( polyline->ClosedFlags & 0x1 )
 		polyline->bClosed = true;
 	else
 		polyline->bClosed = false;
 
-    fillCommonEntityHandleData( polyline, pabyInput, nBitOffsetFromStart );
+    fillCommonEntityHandleData( polyline, oInput, nBitOffsetFromStart );
 
-    polyline->hVertexes.push_back( ReadHANDLE( pabyInput, nBitOffsetFromStart ) ); // 1st vertex
-    polyline->hVertexes.push_back( ReadHANDLE( pabyInput, nBitOffsetFromStart ) ); // last vertex
+    polyline->hVertexes.push_back( ReadHANDLE( oInput, nBitOffsetFromStart ) ); // 1st vertex
+    polyline->hVertexes.push_back( ReadHANDLE( oInput, nBitOffsetFromStart ) ); // last vertex
 
-    polyline->hSeqend = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+    polyline->hSeqend = ReadHANDLE( oInput, nBitOffsetFromStart );
 
-    nBitOffsetFromStart += 8 - ( nBitOffsetFromStart % 8 ); // padding bits to next byte boundary
-    polyline->setCRC( ReadRAWSHORT( pabyInput, nBitOffsetFromStart ) );
+    AlignToByte( nBitOffsetFromStart ); // padding bits to next byte boundary
+    polyline->setCRC( ReadRAWSHORT( oInput, nBitOffsetFromStart ) );
 
 #ifdef _DEBUG
-    if( ( nBitOffsetFromStart / 8 ) != ( dObjectSize + 4 ) )
+    if( ( nBitOffsetFromStart / 8 ) != oInput.GetSize() )
         DebugMsg( "Assertion failed at %d in %s\nSize difference: %d\n", __LINE__, __FILE__,
-                  ( nBitOffsetFromStart / 8 - dObjectSize - 4 ) );
+                  static_cast<int>( nBitOffsetFromStart / 8 - oInput.GetSize() ) );
 #endif // _DEBUG
 
     return polyline;
 }
 
-CADRayObject * DWGFileR2000::getRay( long dObjectSize, CADCommonED stCommonEntityData, const char * pabyInput,
+CADRayObject * DWGFileR2000::getRay( long dObjectSize, CADCommonED stCommonEntityData, const DWGBuffer& oInput,
                                      size_t& nBitOffsetFromStart )
 {
     CADRayObject * ray = new CADRayObject();
@@ -1862,28 +2157,28 @@ CADRayObject * DWGFileR2000::getRay( long dObjectSize, CADCommonED stCommonEntit
     ray->setSize( dObjectSize );
     ray->stCed = stCommonEntityData;
 
-    CADVector vertPosition = ReadVector( pabyInput, nBitOffsetFromStart );
+    CADVector vertPosition = ReadVector( oInput, nBitOffsetFromStart );
 
     ray->vertPosition = vertPosition;
 
-    CADVector vectVector = ReadVector( pabyInput, nBitOffsetFromStart );
+    CADVector vectVector = ReadVector( oInput, nBitOffsetFromStart );
     ray->vectVector = vectVector;
 
-    fillCommonEntityHandleData( ray, pabyInput, nBitOffsetFromStart );
+    fillCommonEntityHandleData( ray, oInput, nBitOffsetFromStart );
 
-    nBitOffsetFromStart += 8 - ( nBitOffsetFromStart % 8 ); // padding bits to next byte boundary
-    ray->setCRC( ReadRAWSHORT( pabyInput, nBitOffsetFromStart ) );
+    AlignToByte( nBitOffsetFromStart ); // padding bits to next byte boundary
+    ray->setCRC( ReadRAWSHORT( oInput, nBitOffsetFromStart ) );
 
 #ifdef _DEBUG
-    if( ( nBitOffsetFromStart / 8 ) != ( dObjectSize + 4 ) )
+    if( ( nBitOffsetFromStart / 8 ) != oInput.GetSize() )
         DebugMsg( "Assertion failed at %d in %s\nSize difference: %d\n", __LINE__, __FILE__,
-                  ( nBitOffsetFromStart / 8 - dObjectSize - 4 ) );
+                  static_cast<int>( nBitOffsetFromStart / 8 - oInput.GetSize() ) );
 #endif //_DEBUG
 
     return ray;
 }
 
-CADXLineObject * DWGFileR2000::getXLine( long dObjectSize, CADCommonED stCommonEntityData, const char * pabyInput,
+CADXLineObject * DWGFileR2000::getXLine( long dObjectSize, CADCommonED stCommonEntityData, const DWGBuffer& oInput,
                                          size_t& nBitOffsetFromStart )
 {
     CADXLineObject * xline = new CADXLineObject();
@@ -1891,28 +2186,28 @@ CADXLineObject * DWGFileR2000::getXLine( long dObjectSize, CADCommonED stCommonE
     xline->setSize( dObjectSize );
     xline->stCed = stCommonEntityData;
 
-    CADVector vertPosition = ReadVector( pabyInput, nBitOffsetFromStart );
+    CADVector vertPosition = ReadVector( oInput, nBitOffsetFromStart );
 
     xline->vertPosition = vertPosition;
 
-    CADVector vectVector = ReadVector( pabyInput, nBitOffsetFromStart );
+    CADVector vectVector = ReadVector( oInput, nBitOffsetFromStart );
     xline->vectVector = vectVector;
 
-    fillCommonEntityHandleData( xline, pabyInput, nBitOffsetFromStart );
+    fillCommonEntityHandleData( xline, oInput, nBitOffsetFromStart );
 
-    nBitOffsetFromStart += 8 - ( nBitOffsetFromStart % 8 ); // padding bits to next byte boundary
-    xline->setCRC( ReadRAWSHORT( pabyInput, nBitOffsetFromStart ) );
+    AlignToByte( nBitOffsetFromStart ); // padding bits to next byte boundary
+    xline->setCRC( ReadRAWSHORT( oInput, nBitOffsetFromStart ) );
 
 #ifdef _DEBUG
-    if( ( nBitOffsetFromStart / 8 ) != ( dObjectSize + 4 ) )
+    if( ( nBitOffsetFromStart / 8 ) != oInput.GetSize() )
         DebugMsg( "Assertion failed at %d in %s\nSize difference: %d\n", __LINE__, __FILE__,
-                  ( nBitOffsetFromStart / 8 - dObjectSize - 4 ) );
+                  static_cast<int>( nBitOffsetFromStart / 8 - oInput.GetSize() ) );
 #endif // _DEBUG
 
     return xline;
 }
 
-CADLineObject * DWGFileR2000::getLine( long dObjectSize, CADCommonED stCommonEntityData, const char * pabyInput,
+CADLineObject * DWGFileR2000::getLine( long dObjectSize, CADCommonED stCommonEntityData, const DWGBuffer& oInput,
                                        size_t& nBitOffsetFromStart )
 {
     CADLineObject * line = new CADLineObject();
@@ -1920,49 +2215,49 @@ CADLineObject * DWGFileR2000::getLine( long dObjectSize, CADCommonED stCommonEnt
     line->setSize( dObjectSize );
     line->stCed = stCommonEntityData;
 
-    bool bZsAreZeros = ReadBIT( pabyInput, nBitOffsetFromStart );
+    bool bZsAreZeros = ReadBIT( oInput, nBitOffsetFromStart );
 
     CADVector vertStart, vertEnd;
-    vertStart.setX( ReadRAWDOUBLE( pabyInput, nBitOffsetFromStart ) );
-    vertEnd.setX( ReadBITDOUBLEWD( pabyInput, nBitOffsetFromStart, vertStart.getX() ) );
-    vertStart.setY( ReadRAWDOUBLE( pabyInput, nBitOffsetFromStart ) );
-    vertEnd.setY( ReadBITDOUBLEWD( pabyInput, nBitOffsetFromStart, vertStart.getY() ) );
+    vertStart.setX( ReadRAWDOUBLE( oInput, nBitOffsetFromStart ) );
+    vertEnd.setX( ReadBITDOUBLEWD( oInput, nBitOffsetFromStart, vertStart.getX() ) );
+    vertStart.setY( ReadRAWDOUBLE( oInput, nBitOffsetFromStart ) );
+    vertEnd.setY( ReadBITDOUBLEWD( oInput, nBitOffsetFromStart, vertStart.getY() ) );
 
     if( !bZsAreZeros )
     {
-        vertStart.setZ( ReadBITDOUBLE( pabyInput, nBitOffsetFromStart ) );
-        vertEnd.setZ( ReadBITDOUBLEWD( pabyInput, nBitOffsetFromStart, vertStart.getZ() ) );
+        vertStart.setZ( ReadBITDOUBLE( oInput, nBitOffsetFromStart ) );
+        vertEnd.setZ( ReadBITDOUBLEWD( oInput, nBitOffsetFromStart, vertStart.getZ() ) );
     }
 
     line->vertStart = vertStart;
     line->vertEnd   = vertEnd;
 
-    line->dfThickness = ReadBIT( pabyInput, nBitOffsetFromStart ) ? 0.0f : ReadBITDOUBLE( pabyInput,
+    line->dfThickness = ReadBIT( oInput, nBitOffsetFromStart ) ? 0.0f : ReadBITDOUBLE( oInput,
                                                                                           nBitOffsetFromStart );
 
-    if( ReadBIT( pabyInput, nBitOffsetFromStart ) )
+    if( ReadBIT( oInput, nBitOffsetFromStart ) )
     {
         line->vectExtrusion = CADVector( 0.0f, 0.0f, 1.0f );
     } else
     {
-        CADVector vectExtrusion = ReadVector( pabyInput, nBitOffsetFromStart );
+        CADVector vectExtrusion = ReadVector( oInput, nBitOffsetFromStart );
         line->vectExtrusion = vectExtrusion;
     }
 
-    fillCommonEntityHandleData( line, pabyInput, nBitOffsetFromStart );
+    fillCommonEntityHandleData( line, oInput, nBitOffsetFromStart );
 
-    nBitOffsetFromStart += 8 - ( nBitOffsetFromStart % 8 ); // padding bits to next byte boundary
-    line->setCRC( ReadRAWSHORT( pabyInput, nBitOffsetFromStart ) );
+    AlignToByte( nBitOffsetFromStart ); // padding bits to next byte boundary
+    line->setCRC( ReadRAWSHORT( oInput, nBitOffsetFromStart ) );
 
 #ifdef _DEBUG
-    if( ( nBitOffsetFromStart / 8 ) != ( dObjectSize + 4 ) )
+    if( ( nBitOffsetFromStart / 8 ) != oInput.GetSize() )
         DebugMsg( "Assertion failed at %d in %s\nSize difference: %d\n", __LINE__, __FILE__,
-                  ( nBitOffsetFromStart / 8 - dObjectSize - 4 ) );
+                  static_cast<int>( nBitOffsetFromStart / 8 - oInput.GetSize() ) );
 #endif // _DEBUG
     return line;
 }
 
-CADTextObject * DWGFileR2000::getText( long dObjectSize, CADCommonED stCommonEntityData, const char * pabyInput,
+CADTextObject * DWGFileR2000::getText( long dObjectSize, CADCommonED stCommonEntityData, const DWGBuffer& oInput,
                                        size_t& nBitOffsetFromStart )
 {
     CADTextObject * text = new CADTextObject();
@@ -1970,72 +2265,72 @@ CADTextObject * DWGFileR2000::getText( long dObjectSize, CADCommonED stCommonEnt
     text->setSize( dObjectSize );
     text->stCed = stCommonEntityData;
 
-    text->DataFlags = ReadCHAR( pabyInput, nBitOffsetFromStart );
+    text->DataFlags = ReadCHAR( oInput, nBitOffsetFromStart );
 
     if( !( text->DataFlags & 0x01 ) )
-        text->dfElevation = ReadRAWDOUBLE( pabyInput, nBitOffsetFromStart );
+        text->dfElevation = ReadRAWDOUBLE( oInput, nBitOffsetFromStart );
 
-    CADVector vertInsetionPoint = ReadRAWVector( pabyInput, nBitOffsetFromStart );
+    CADVector vertInsetionPoint = ReadRAWVector( oInput, nBitOffsetFromStart );
 
     text->vertInsetionPoint = vertInsetionPoint;
 
     if( !( text->DataFlags & 0x02 ) )
     {
         double x, y;
-        x = ReadBITDOUBLEWD( pabyInput, nBitOffsetFromStart, vertInsetionPoint.getX() );
-        y = ReadBITDOUBLEWD( pabyInput, nBitOffsetFromStart, vertInsetionPoint.getY() );
+        x = ReadBITDOUBLEWD( oInput, nBitOffsetFromStart, vertInsetionPoint.getX() );
+        y = ReadBITDOUBLEWD( oInput, nBitOffsetFromStart, vertInsetionPoint.getY() );
         CADVector vertAlignmentPoint( x, y );
         text->vertAlignmentPoint = vertAlignmentPoint;
     }
 
-    if( ReadBIT( pabyInput, nBitOffsetFromStart ) )
+    if( ReadBIT( oInput, nBitOffsetFromStart ) )
     {
         text->vectExtrusion = CADVector( 0.0f, 0.0f, 1.0f );
     } else
     {
-        CADVector vectExtrusion = ReadVector( pabyInput, nBitOffsetFromStart );
+        CADVector vectExtrusion = ReadVector( oInput, nBitOffsetFromStart );
         text->vectExtrusion = vectExtrusion;
     }
 
-    text->dfThickness = ReadBIT( pabyInput, nBitOffsetFromStart ) ? 0.0f : ReadBITDOUBLE( pabyInput,
+    text->dfThickness = ReadBIT( oInput, nBitOffsetFromStart ) ? 0.0f : ReadBITDOUBLE( oInput,
                                                                                           nBitOffsetFromStart );
 
     if( !( text->DataFlags & 0x04 ) )
-        text->dfObliqueAng  = ReadRAWDOUBLE( pabyInput, nBitOffsetFromStart );
+        text->dfObliqueAng  = ReadRAWDOUBLE( oInput, nBitOffsetFromStart );
     if( !( text->DataFlags & 0x08 ) )
-        text->dfRotationAng = ReadRAWDOUBLE( pabyInput, nBitOffsetFromStart );
+        text->dfRotationAng = ReadRAWDOUBLE( oInput, nBitOffsetFromStart );
 
-    text->dfHeight = ReadRAWDOUBLE( pabyInput, nBitOffsetFromStart );
+    text->dfHeight = ReadRAWDOUBLE( oInput, nBitOffsetFromStart );
 
     if( !( text->DataFlags & 0x10 ) )
-        text->dfWidthFactor = ReadRAWDOUBLE( pabyInput, nBitOffsetFromStart );
+        text->dfWidthFactor = ReadRAWDOUBLE( oInput, nBitOffsetFromStart );
 
-    text->sTextValue = ReadTV( pabyInput, nBitOffsetFromStart );
+    text->sTextValue = ReadTV( oInput, nBitOffsetFromStart );
 
     if( !( text->DataFlags & 0x20 ) )
-        text->dGeneration = ReadBITSHORT( pabyInput, nBitOffsetFromStart );
+        text->dGeneration = ReadBITSHORT( oInput, nBitOffsetFromStart );
     if( !( text->DataFlags & 0x40 ) )
-        text->dHorizAlign = ReadBITSHORT( pabyInput, nBitOffsetFromStart );
+        text->dHorizAlign = ReadBITSHORT( oInput, nBitOffsetFromStart );
     if( !( text->DataFlags & 0x80 ) )
-        text->dVertAlign  = ReadBITSHORT( pabyInput, nBitOffsetFromStart );
+        text->dVertAlign  = ReadBITSHORT( oInput, nBitOffsetFromStart );
 
-    fillCommonEntityHandleData( text, pabyInput, nBitOffsetFromStart );
+    fillCommonEntityHandleData( text, oInput, nBitOffsetFromStart );
 
-    text->hStyle = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+    text->hStyle = ReadHANDLE( oInput, nBitOffsetFromStart );
 
-    nBitOffsetFromStart += 8 - ( nBitOffsetFromStart % 8 ); // padding bits to next byte boundary
-    text->setCRC( ReadRAWSHORT( pabyInput, nBitOffsetFromStart ) );
+    AlignToByte( nBitOffsetFromStart ); // padding bits to next byte boundary
+    text->setCRC( ReadRAWSHORT( oInput, nBitOffsetFromStart ) );
 
 #ifdef _DEBUG
-    if( ( nBitOffsetFromStart / 8 ) != ( dObjectSize + 4 ) )
+    if( ( nBitOffsetFromStart / 8 ) != oInput.GetSize() )
         DebugMsg( "Assertion failed at %d in %s\nSize difference: %d\n", __LINE__, __FILE__,
-                  ( nBitOffsetFromStart / 8 - dObjectSize - 4 ) );
+                  static_cast<int>( nBitOffsetFromStart / 8 - oInput.GetSize() ) );
 #endif // _DEBUG
 
     return text;
 }
 
-CADVertex2DObject * DWGFileR2000::getVertex2D( long dObjectSize, CADCommonED stCommonEntityData, const char * pabyInput,
+CADVertex2DObject * DWGFileR2000::getVertex2D( long dObjectSize, CADCommonED stCommonEntityData, const DWGBuffer& oInput,
 	size_t& nBitOffsetFromStart )
 {
 	CADVertex2DObject * vertex = new CADVertex2DObject();
@@ -2043,39 +2338,39 @@ CADVertex2DObject * DWGFileR2000::getVertex2D( long dObjectSize, CADCommonED stC
 	vertex->setSize( dObjectSize );
 	vertex->stCed = stCommonEntityData;
 
-	vertex->vFlags = ReadCHAR( pabyInput, nBitOffsetFromStart );
+	vertex->vFlags = ReadCHAR( oInput, nBitOffsetFromStart );
 
-	CADVector vertPosition = ReadVector( pabyInput, nBitOffsetFromStart );
+	CADVector vertPosition = ReadVector( oInput, nBitOffsetFromStart );
 	vertex->vertPosition = vertPosition; // z must be taken from polyline elevation
 
-	vertex->dfStartWidth = ReadBITDOUBLE( pabyInput, nBitOffsetFromStart );
+	vertex->dfStartWidth = ReadBITDOUBLE( oInput, nBitOffsetFromStart );
 	if (vertex->dfStartWidth < 0) // if negative, abs start value is applicable for both start and end
 	{
 		vertex->dfStartWidth = std::fabs( vertex->dfStartWidth );
 		vertex->dfEndWidth = std::fabs(vertex->dfStartWidth);
 	}
 	else
-		vertex->dfEndWidth = ReadBITDOUBLE(pabyInput, nBitOffsetFromStart);
+		vertex->dfEndWidth = ReadBITDOUBLE(oInput, nBitOffsetFromStart);
 
-	vertex->dfBulge = ReadBITDOUBLE(pabyInput, nBitOffsetFromStart);
+	vertex->dfBulge = ReadBITDOUBLE(oInput, nBitOffsetFromStart);
 
-	vertex->dfTangentDir = ReadBITDOUBLE(pabyInput, nBitOffsetFromStart);
+	vertex->dfTangentDir = ReadBITDOUBLE(oInput, nBitOffsetFromStart);
 
 
-	fillCommonEntityHandleData(vertex, pabyInput, nBitOffsetFromStart);
+	fillCommonEntityHandleData(vertex, oInput, nBitOffsetFromStart);
 
-	nBitOffsetFromStart += 8 - (nBitOffsetFromStart % 8); // padding bits to next byte boundary
-	vertex->setCRC(ReadRAWSHORT(pabyInput, nBitOffsetFromStart));
+	AlignToByte( nBitOffsetFromStart ); // padding bits to next byte boundary
+	vertex->setCRC(ReadRAWSHORT(oInput, nBitOffsetFromStart));
 
 #ifdef _DEBUG
-	if ((nBitOffsetFromStart / 8) != (dObjectSize + 4))
+	if ((nBitOffsetFromStart / 8) != oInput.GetSize())
 		DebugMsg("Assertion failed at %d in %s\nSize difference: %d\n", __LINE__, __FILE__,
-		(nBitOffsetFromStart / 8 - dObjectSize - 4));
+		static_cast<int>(nBitOffsetFromStart / 8 - oInput.GetSize()));
 #endif // _DEBUG
 	return vertex;
 }
 
-CADVertex3DObject * DWGFileR2000::getVertex3D( long dObjectSize, CADCommonED stCommonEntityData, const char * pabyInput,
+CADVertex3DObject * DWGFileR2000::getVertex3D( long dObjectSize, CADCommonED stCommonEntityData, const DWGBuffer& oInput,
                                                size_t& nBitOffsetFromStart )
 {
     CADVertex3DObject * vertex = new CADVertex3DObject();
@@ -2083,25 +2378,25 @@ CADVertex3DObject * DWGFileR2000::getVertex3D( long dObjectSize, CADCommonED stC
     vertex->setSize( dObjectSize );
     vertex->stCed = stCommonEntityData;
 
-	vertex->vFlags = ReadCHAR(pabyInput, nBitOffsetFromStart);
+	vertex->vFlags = ReadCHAR(oInput, nBitOffsetFromStart);
 
-    CADVector vertPosition = ReadVector( pabyInput, nBitOffsetFromStart );;
+    CADVector vertPosition = ReadVector( oInput, nBitOffsetFromStart );;
     vertex->vertPosition = vertPosition;
 
-    fillCommonEntityHandleData( vertex, pabyInput, nBitOffsetFromStart );
+    fillCommonEntityHandleData( vertex, oInput, nBitOffsetFromStart );
 
-    nBitOffsetFromStart += 8 - ( nBitOffsetFromStart % 8 ); // padding bits to next byte boundary
-    vertex->setCRC( ReadRAWSHORT( pabyInput, nBitOffsetFromStart ) );
+    AlignToByte( nBitOffsetFromStart ); // padding bits to next byte boundary
+    vertex->setCRC( ReadRAWSHORT( oInput, nBitOffsetFromStart ) );
 
 #ifdef _DEBUG
-    if( ( nBitOffsetFromStart / 8 ) != ( dObjectSize + 4 ) )
+    if( ( nBitOffsetFromStart / 8 ) != oInput.GetSize() )
         DebugMsg( "Assertion failed at %d in %s\nSize difference: %d\n", __LINE__, __FILE__,
-                  ( nBitOffsetFromStart / 8 - dObjectSize - 4 ) );
+                  static_cast<int>( nBitOffsetFromStart / 8 - oInput.GetSize() ) );
 #endif // _DEBUG
     return vertex;
 }
 
-CADCircleObject * DWGFileR2000::getCircle( long dObjectSize, CADCommonED stCommonEntityData, const char * pabyInput,
+CADCircleObject * DWGFileR2000::getCircle( long dObjectSize, CADCommonED stCommonEntityData, const DWGBuffer& oInput,
                                            size_t& nBitOffsetFromStart )
 {
     CADCircleObject * circle = new CADCircleObject();
@@ -2109,35 +2404,35 @@ CADCircleObject * DWGFileR2000::getCircle( long dObjectSize, CADCommonED stCommo
     circle->setSize( dObjectSize );
     circle->stCed = stCommonEntityData;
 
-    CADVector vertPosition = ReadVector( pabyInput, nBitOffsetFromStart );
+    CADVector vertPosition = ReadVector( oInput, nBitOffsetFromStart );
     circle->vertPosition = vertPosition;
-    circle->dfRadius     = ReadBITDOUBLE( pabyInput, nBitOffsetFromStart );
-    circle->dfThickness  = ReadBIT( pabyInput, nBitOffsetFromStart ) ? 0.0f : ReadBITDOUBLE( pabyInput,
+    circle->dfRadius     = ReadBITDOUBLE( oInput, nBitOffsetFromStart );
+    circle->dfThickness  = ReadBIT( oInput, nBitOffsetFromStart ) ? 0.0f : ReadBITDOUBLE( oInput,
                                                                                              nBitOffsetFromStart );
 
-    if( ReadBIT( pabyInput, nBitOffsetFromStart ) )
+    if( ReadBIT( oInput, nBitOffsetFromStart ) )
     {
         circle->vectExtrusion = CADVector( 0.0f, 0.0f, 1.0f );
     } else
     {
-        CADVector vectExtrusion = ReadVector( pabyInput, nBitOffsetFromStart );
+        CADVector vectExtrusion = ReadVector( oInput, nBitOffsetFromStart );
         circle->vectExtrusion = vectExtrusion;
     }
 
-    fillCommonEntityHandleData( circle, pabyInput, nBitOffsetFromStart );
+    fillCommonEntityHandleData( circle, oInput, nBitOffsetFromStart );
 
-    nBitOffsetFromStart += 8 - ( nBitOffsetFromStart % 8 ); // padding bits to next byte boundary
-    circle->setCRC( ReadRAWSHORT( pabyInput, nBitOffsetFromStart ) );
+    AlignToByte( nBitOffsetFromStart ); // padding bits to next byte boundary
+    circle->setCRC( ReadRAWSHORT( oInput, nBitOffsetFromStart ) );
 
 #ifdef _DEBUG
-    if( ( nBitOffsetFromStart / 8 ) != ( dObjectSize + 4 ) )
+    if( ( nBitOffsetFromStart / 8 ) != oInput.GetSize() )
         DebugMsg( "Assertion failed at %d in %s\nSize difference: %d\n", __LINE__, __FILE__,
-                  ( nBitOffsetFromStart / 8 - dObjectSize - 4 ) );
+                  static_cast<int>( nBitOffsetFromStart / 8 - oInput.GetSize() ) );
 #endif // _DEBUG
     return circle;
 }
 
-CADEndblkObject * DWGFileR2000::getEndBlock( long dObjectSize, CADCommonED stCommonEntityData, const char * pabyInput,
+CADEndblkObject * DWGFileR2000::getEndBlock( long dObjectSize, CADCommonED stCommonEntityData, const DWGBuffer& oInput,
                                              size_t& nBitOffsetFromStart )
 {
     CADEndblkObject * endblk = new CADEndblkObject();
@@ -2145,29 +2440,29 @@ CADEndblkObject * DWGFileR2000::getEndBlock( long dObjectSize, CADCommonED stCom
     endblk->setSize( dObjectSize );
     endblk->stCed = stCommonEntityData;
 
-    fillCommonEntityHandleData( endblk, pabyInput, nBitOffsetFromStart );
+    fillCommonEntityHandleData( endblk, oInput, nBitOffsetFromStart );
 
-    nBitOffsetFromStart += 8 - ( nBitOffsetFromStart % 8 );
-    endblk->setCRC( ReadRAWSHORT( pabyInput, nBitOffsetFromStart ) );
+    AlignToByte( nBitOffsetFromStart );
+    endblk->setCRC( ReadRAWSHORT( oInput, nBitOffsetFromStart ) );
 
 #ifdef _DEBUG
-    if( ( nBitOffsetFromStart / 8 ) != ( dObjectSize + 4 ) )
+    if( ( nBitOffsetFromStart / 8 ) != oInput.GetSize() )
         DebugMsg( "Assertion failed at %d in %s\nSize difference: %d\n", __LINE__, __FILE__,
-                  ( nBitOffsetFromStart / 8 - dObjectSize - 4 ) );
+                  static_cast<int>( nBitOffsetFromStart / 8 - oInput.GetSize() ) );
 #endif //_DEBUG
     return endblk;
 }
 
 CADPolyline2DObject * DWGFileR2000::getPolyline2D( long dObjectSize, CADCommonED stCommonEntityData,
-                                                   const char * pabyInput, size_t& nBitOffsetFromStart )
+                                                   const DWGBuffer& oInput, size_t& nBitOffsetFromStart )
 {
     CADPolyline2DObject * polyline = new CADPolyline2DObject();
 
     polyline->setSize( dObjectSize );
     polyline->stCed = stCommonEntityData;
 
-    polyline->dFlags                = ReadBITSHORT( pabyInput, nBitOffsetFromStart );
-    polyline->dCurveNSmoothSurfType = ReadBITSHORT( pabyInput, nBitOffsetFromStart );
+    polyline->dFlags                = ReadBITSHORT( oInput, nBitOffsetFromStart );
+    polyline->dCurveNSmoothSurfType = ReadBITSHORT( oInput, nBitOffsetFromStart );
 
 	if ( polyline->dFlags & 0x1 )
 		polyline->bClosed = true;
@@ -2180,185 +2475,202 @@ CADPolyline2DObject * DWGFileR2000::getPolyline2D( long dObjectSize, CADCommonED
 		polyline->bSplined = false;
 
 
-    polyline->dfStartWidth = ReadBITDOUBLE( pabyInput, nBitOffsetFromStart );
-    polyline->dfEndWidth   = ReadBITDOUBLE( pabyInput, nBitOffsetFromStart );
+    polyline->dfStartWidth = ReadBITDOUBLE( oInput, nBitOffsetFromStart );
+    polyline->dfEndWidth   = ReadBITDOUBLE( oInput, nBitOffsetFromStart );
 
-    polyline->dfThickness = ReadBIT( pabyInput, nBitOffsetFromStart ) ? 0.0f : ReadBITDOUBLE( pabyInput,
+    polyline->dfThickness = ReadBIT( oInput, nBitOffsetFromStart ) ? 0.0f : ReadBITDOUBLE( oInput,
                                                                                               nBitOffsetFromStart );
 
-    polyline->dfElevation = ReadBITDOUBLE( pabyInput, nBitOffsetFromStart );
+    polyline->dfElevation = ReadBITDOUBLE( oInput, nBitOffsetFromStart );
 
-    if( ReadBIT( pabyInput, nBitOffsetFromStart ) )
+    if( ReadBIT( oInput, nBitOffsetFromStart ) )
     {
         polyline->vectExtrusion = CADVector( 0.0f, 0.0f, 1.0f );
     } else
     {
-        CADVector vectExtrusion = ReadVector( pabyInput, nBitOffsetFromStart );
+        CADVector vectExtrusion = ReadVector( oInput, nBitOffsetFromStart );
         polyline->vectExtrusion = vectExtrusion;
     }
 
-    fillCommonEntityHandleData( polyline, pabyInput, nBitOffsetFromStart );
+    fillCommonEntityHandleData( polyline, oInput, nBitOffsetFromStart );
 
-    polyline->hVertexes.push_back( ReadHANDLE( pabyInput, nBitOffsetFromStart ) ); // 1st vertex
-    polyline->hVertexes.push_back( ReadHANDLE( pabyInput, nBitOffsetFromStart ) ); // last vertex
+    polyline->hVertexes.push_back( ReadHANDLE( oInput, nBitOffsetFromStart ) ); // 1st vertex
+    polyline->hVertexes.push_back( ReadHANDLE( oInput, nBitOffsetFromStart ) ); // last vertex
 
-    polyline->hSeqend = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+    polyline->hSeqend = ReadHANDLE( oInput, nBitOffsetFromStart );
 
-    nBitOffsetFromStart += 8 - ( nBitOffsetFromStart % 8 ); // padding bits to next byte boundary
-    polyline->setCRC( ReadRAWSHORT( pabyInput, nBitOffsetFromStart ) );
+    AlignToByte( nBitOffsetFromStart ); // padding bits to next byte boundary
+    polyline->setCRC( ReadRAWSHORT( oInput, nBitOffsetFromStart ) );
 
 #ifdef _DEBUG
-    if( ( nBitOffsetFromStart / 8 ) != ( dObjectSize + 4 ) )
+    if( ( nBitOffsetFromStart / 8 ) != oInput.GetSize() )
         DebugMsg( "Assertion failed at %d in %s\nSize difference: %d\n", __LINE__, __FILE__,
-                  ( nBitOffsetFromStart / 8 - dObjectSize - 4 ) );
+                  static_cast<int>( nBitOffsetFromStart / 8 - oInput.GetSize() ) );
 #endif // _DEBUG
     return polyline;
 }
 
-CADAttribObject * DWGFileR2000::getAttributes( long dObjectSize, CADCommonED stCommonEntityData, const char * pabyInput,
+CADAttribObject * DWGFileR2000::getAttributes( long dObjectSize, CADCommonED stCommonEntityData, const DWGBuffer& oInput,
                                                size_t& nBitOffsetFromStart )
 {
     CADAttribObject * attrib = new CADAttribObject();
 
     attrib->setSize( dObjectSize );
     attrib->stCed     = stCommonEntityData;
-    attrib->DataFlags = ReadCHAR( pabyInput, nBitOffsetFromStart );
+    attrib->DataFlags = ReadCHAR( oInput, nBitOffsetFromStart );
 
     if( !( attrib->DataFlags & 0x01 ) )
-        attrib->dfElevation = ReadRAWDOUBLE( pabyInput, nBitOffsetFromStart );
+        attrib->dfElevation = ReadRAWDOUBLE( oInput, nBitOffsetFromStart );
 
     double x, y;
 
-    CADVector vertInsetionPoint = ReadRAWVector( pabyInput, nBitOffsetFromStart );
+    CADVector vertInsetionPoint = ReadRAWVector( oInput, nBitOffsetFromStart );
     attrib->vertInsetionPoint = vertInsetionPoint;
 
     if( !( attrib->DataFlags & 0x02 ) )
     {
-        x = ReadBITDOUBLEWD( pabyInput, nBitOffsetFromStart, vertInsetionPoint.getX() );
-        y = ReadBITDOUBLEWD( pabyInput, nBitOffsetFromStart, vertInsetionPoint.getY() );
+        x = ReadBITDOUBLEWD( oInput, nBitOffsetFromStart, vertInsetionPoint.getX() );
+        y = ReadBITDOUBLEWD( oInput, nBitOffsetFromStart, vertInsetionPoint.getY() );
         CADVector vertAlignmentPoint( x, y );
         attrib->vertAlignmentPoint = vertAlignmentPoint;
     }
 
-    if( ReadBIT( pabyInput, nBitOffsetFromStart ) )
+    if( ReadBIT( oInput, nBitOffsetFromStart ) )
     {
         attrib->vectExtrusion = CADVector( 0.0f, 0.0f, 1.0f );
     } else
     {
-        CADVector vectExtrusion = ReadVector( pabyInput, nBitOffsetFromStart );
+        CADVector vectExtrusion = ReadVector( oInput, nBitOffsetFromStart );
         attrib->vectExtrusion = vectExtrusion;
     }
 
-    attrib->dfThickness = ReadBIT( pabyInput, nBitOffsetFromStart ) ? 0.0f : ReadBITDOUBLE( pabyInput,
+    attrib->dfThickness = ReadBIT( oInput, nBitOffsetFromStart ) ? 0.0f : ReadBITDOUBLE( oInput,
                                                                                             nBitOffsetFromStart );
 
     if( !( attrib->DataFlags & 0x04 ) )
-        attrib->dfObliqueAng  = ReadRAWDOUBLE( pabyInput, nBitOffsetFromStart );
+        attrib->dfObliqueAng  = ReadRAWDOUBLE( oInput, nBitOffsetFromStart );
     if( !( attrib->DataFlags & 0x08 ) )
-        attrib->dfRotationAng = ReadRAWDOUBLE( pabyInput, nBitOffsetFromStart );
-    attrib->dfHeight          = ReadRAWDOUBLE( pabyInput, nBitOffsetFromStart );
+        attrib->dfRotationAng = ReadRAWDOUBLE( oInput, nBitOffsetFromStart );
+    attrib->dfHeight          = ReadRAWDOUBLE( oInput, nBitOffsetFromStart );
     if( !( attrib->DataFlags & 0x10 ) )
-        attrib->dfWidthFactor = ReadRAWDOUBLE( pabyInput, nBitOffsetFromStart );
-    attrib->sTextValue        = ReadTV( pabyInput, nBitOffsetFromStart );
+        attrib->dfWidthFactor = ReadRAWDOUBLE( oInput, nBitOffsetFromStart );
+    attrib->sTextValue        = ReadTV( oInput, nBitOffsetFromStart );
     if( !( attrib->DataFlags & 0x20 ) )
-        attrib->dGeneration   = ReadBITSHORT( pabyInput, nBitOffsetFromStart );
+        attrib->dGeneration   = ReadBITSHORT( oInput, nBitOffsetFromStart );
     if( !( attrib->DataFlags & 0x40 ) )
-        attrib->dHorizAlign   = ReadBITSHORT( pabyInput, nBitOffsetFromStart );
+        attrib->dHorizAlign   = ReadBITSHORT( oInput, nBitOffsetFromStart );
     if( !( attrib->DataFlags & 0x80 ) )
-        attrib->dVertAlign    = ReadBITSHORT( pabyInput, nBitOffsetFromStart );
+        attrib->dVertAlign    = ReadBITSHORT( oInput, nBitOffsetFromStart );
 
-    attrib->sTag         = ReadTV( pabyInput, nBitOffsetFromStart );
-    attrib->nFieldLength = ReadBITSHORT( pabyInput, nBitOffsetFromStart );
-    attrib->nFlags       = ReadCHAR( pabyInput, nBitOffsetFromStart );
+    attrib->sTag         = ReadTV( oInput, nBitOffsetFromStart );
+    attrib->nFieldLength = ReadBITSHORT( oInput, nBitOffsetFromStart );
+    attrib->nFlags       = ReadCHAR( oInput, nBitOffsetFromStart );
 
-    fillCommonEntityHandleData( attrib, pabyInput, nBitOffsetFromStart );
+    fillCommonEntityHandleData( attrib, oInput, nBitOffsetFromStart );
 
-    attrib->hStyle = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+    attrib->hStyle = ReadHANDLE( oInput, nBitOffsetFromStart );
 
-    nBitOffsetFromStart += 8 - ( nBitOffsetFromStart % 8 );
-    attrib->setCRC( ReadRAWSHORT( pabyInput, nBitOffsetFromStart ) );
+    AlignToByte( nBitOffsetFromStart );
+    attrib->setCRC( ReadRAWSHORT( oInput, nBitOffsetFromStart ) );
 
 #ifdef _DEBUG
-    if( ( nBitOffsetFromStart / 8 ) != ( dObjectSize + 4 ) )
+    if( ( nBitOffsetFromStart / 8 ) != oInput.GetSize() )
         DebugMsg( "Assertion failed at %d in %s\nSize difference: %d\n", __LINE__, __FILE__,
-                  ( nBitOffsetFromStart / 8 - dObjectSize - 4 ) );
+                  static_cast<int>( nBitOffsetFromStart / 8 - oInput.GetSize() ) );
 #endif //_DEBUG
     return attrib;
 }
 
 CADAttdefObject * DWGFileR2000::getAttributesDefn( long dObjectSize, CADCommonED stCommonEntityData,
-                                                   const char * pabyInput, size_t& nBitOffsetFromStart )
+                                                   const DWGBuffer& oInput, size_t& nBitOffsetFromStart )
 {
     CADAttdefObject * attdef = new CADAttdefObject();
 
     attdef->setSize( dObjectSize );
     attdef->stCed     = stCommonEntityData;
-    attdef->DataFlags = ReadCHAR( pabyInput, nBitOffsetFromStart );
+    attdef->DataFlags = ReadCHAR( oInput, nBitOffsetFromStart );
 
     if( !( attdef->DataFlags & 0x01 ) )
-        attdef->dfElevation = ReadRAWDOUBLE( pabyInput, nBitOffsetFromStart );
+        attdef->dfElevation = ReadRAWDOUBLE( oInput, nBitOffsetFromStart );
 
-    CADVector vertInsetionPoint = ReadRAWVector( pabyInput, nBitOffsetFromStart );
+    CADVector vertInsetionPoint = ReadRAWVector( oInput, nBitOffsetFromStart );
     attdef->vertInsetionPoint = vertInsetionPoint;
 
     if( !( attdef->DataFlags & 0x02 ) )
     {
-        double    x = ReadBITDOUBLEWD( pabyInput, nBitOffsetFromStart, vertInsetionPoint.getX() );
-        double    y = ReadBITDOUBLEWD( pabyInput, nBitOffsetFromStart, vertInsetionPoint.getY() );
+        double    x = ReadBITDOUBLEWD( oInput, nBitOffsetFromStart, vertInsetionPoint.getX() );
+        double    y = ReadBITDOUBLEWD( oInput, nBitOffsetFromStart, vertInsetionPoint.getY() );
         CADVector vertAlignmentPoint( x, y );
         attdef->vertAlignmentPoint = vertAlignmentPoint;
     }
 
-    if( ReadBIT( pabyInput, nBitOffsetFromStart ) )
+    if( ReadBIT( oInput, nBitOffsetFromStart ) )
     {
         attdef->vectExtrusion = CADVector( 0.0f, 0.0f, 1.0f );
     } else
     {
-        CADVector vectExtrusion = ReadVector( pabyInput, nBitOffsetFromStart );
+        CADVector vectExtrusion = ReadVector( oInput, nBitOffsetFromStart );
         attdef->vectExtrusion = vectExtrusion;
     }
 
-    attdef->dfThickness = ReadBIT( pabyInput, nBitOffsetFromStart ) ? 0.0f : ReadBITDOUBLE( pabyInput,
+    attdef->dfThickness = ReadBIT( oInput, nBitOffsetFromStart ) ? 0.0f : ReadBITDOUBLE( oInput,
                                                                                             nBitOffsetFromStart );
 
     if( !( attdef->DataFlags & 0x04 ) )
-        attdef->dfObliqueAng  = ReadRAWDOUBLE( pabyInput, nBitOffsetFromStart );
+        attdef->dfObliqueAng  = ReadRAWDOUBLE( oInput, nBitOffsetFromStart );
     if( !( attdef->DataFlags & 0x08 ) )
-        attdef->dfRotationAng = ReadRAWDOUBLE( pabyInput, nBitOffsetFromStart );
-    attdef->dfHeight          = ReadRAWDOUBLE( pabyInput, nBitOffsetFromStart );
+        attdef->dfRotationAng = ReadRAWDOUBLE( oInput, nBitOffsetFromStart );
+    attdef->dfHeight          = ReadRAWDOUBLE( oInput, nBitOffsetFromStart );
     if( !( attdef->DataFlags & 0x10 ) )
-        attdef->dfWidthFactor = ReadRAWDOUBLE( pabyInput, nBitOffsetFromStart );
-    attdef->sTextValue        = ReadTV( pabyInput, nBitOffsetFromStart );
+        attdef->dfWidthFactor = ReadRAWDOUBLE( oInput, nBitOffsetFromStart );
+    attdef->sTextValue        = ReadTV( oInput, nBitOffsetFromStart );
     if( !( attdef->DataFlags & 0x20 ) )
-        attdef->dGeneration   = ReadBITSHORT( pabyInput, nBitOffsetFromStart );
+        attdef->dGeneration   = ReadBITSHORT( oInput, nBitOffsetFromStart );
     if( !( attdef->DataFlags & 0x40 ) )
-        attdef->dHorizAlign   = ReadBITSHORT( pabyInput, nBitOffsetFromStart );
+        attdef->dHorizAlign   = ReadBITSHORT( oInput, nBitOffsetFromStart );
     if( !( attdef->DataFlags & 0x80 ) )
-        attdef->dVertAlign    = ReadBITSHORT( pabyInput, nBitOffsetFromStart );
+        attdef->dVertAlign    = ReadBITSHORT( oInput, nBitOffsetFromStart );
 
-    attdef->sTag         = ReadTV( pabyInput, nBitOffsetFromStart );
-    attdef->nFieldLength = ReadBITSHORT( pabyInput, nBitOffsetFromStart );
-    attdef->nFlags       = ReadCHAR( pabyInput, nBitOffsetFromStart );
+    attdef->sTag         = ReadTV( oInput, nBitOffsetFromStart );
+    attdef->nFieldLength = ReadBITSHORT( oInput, nBitOffsetFromStart );
+    attdef->nFlags       = ReadCHAR( oInput, nBitOffsetFromStart );
 
-    attdef->sPrompt = ReadTV( pabyInput, nBitOffsetFromStart );
+    attdef->sPrompt = ReadTV( oInput, nBitOffsetFromStart );
 
-    fillCommonEntityHandleData( attdef, pabyInput, nBitOffsetFromStart );
+    fillCommonEntityHandleData( attdef, oInput, nBitOffsetFromStart );
 
-    attdef->hStyle = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+    attdef->hStyle = ReadHANDLE( oInput, nBitOffsetFromStart );
 
-    nBitOffsetFromStart += 8 - ( nBitOffsetFromStart % 8 );
-    attdef->setCRC( ReadRAWSHORT( pabyInput, nBitOffsetFromStart ) );
+    AlignToByte( nBitOffsetFromStart );
+    attdef->setCRC( ReadRAWSHORT( oInput, nBitOffsetFromStart ) );
 
 #ifdef _DEBUG
-    if( ( nBitOffsetFromStart / 8 ) != ( dObjectSize + 4 ) )
+    if( ( nBitOffsetFromStart / 8 ) != oInput.GetSize() )
         DebugMsg( "Assertion failed at %d in %s\nSize difference: %d\n", __LINE__, __FILE__,
-                  ( nBitOffsetFromStart / 8 - dObjectSize - 4 ) );
+                  static_cast<int>( nBitOffsetFromStart / 8 - oInput.GetSize() ) );
 #endif //_DEBUG
     return attdef;
 }
 
+/**
+ * @brief Limit count of elements read from file to the number of elements the
+ * rest of the input can hold, so a corrupted count can't request a huge
+ * allocation
+ * @param nMinBits Size of the smallest possible element in bits
+ * @return 0 for negative count
+ */
+static size_t GetReservableCount( long nCount, const DWGBuffer& oInput, size_t nBitOffsetFromStart,
+                                  size_t nMinBits )
+{
+    if( nCount <= 0 )
+        return 0;
+    size_t nBitsLeft = oInput.GetSize() * 8 > nBitOffsetFromStart ?
+                       oInput.GetSize() * 8 - nBitOffsetFromStart : 0;
+    return std::min( static_cast<size_t>( nCount ), nBitsLeft / nMinBits );
+}
+
 CADLWPolylineObject * DWGFileR2000::getLWPolyLine( long dObjectSize, CADCommonED stCommonEntityData,
-                                                   const char * pabyInput, size_t& nBitOffsetFromStart )
+                                                   const DWGBuffer& oInput, size_t& nBitOffsetFromStart )
 {
     CADLWPolylineObject * polyline = new CADLWPolylineObject();
     polyline->setSize( dObjectSize );
@@ -2366,33 +2678,34 @@ CADLWPolylineObject * DWGFileR2000::getLWPolyLine( long dObjectSize, CADCommonED
 
     double x             = 0.0, y = 0.0;
     int    vertixesCount = 0, nBulges = 0, nNumWidths = 0;
-    short  dataFlag      = ReadBITSHORT( pabyInput, nBitOffsetFromStart );
+    short  dataFlag      = ReadBITSHORT( oInput, nBitOffsetFromStart );
     if( dataFlag & 4 )
-        polyline->dfConstWidth = ReadBITDOUBLE( pabyInput, nBitOffsetFromStart );
+        polyline->dfConstWidth = ReadBITDOUBLE( oInput, nBitOffsetFromStart );
     if( dataFlag & 8 )
-        polyline->dfElevation  = ReadBITDOUBLE( pabyInput, nBitOffsetFromStart );
+        polyline->dfElevation  = ReadBITDOUBLE( oInput, nBitOffsetFromStart );
     if( dataFlag & 2 )
-        polyline->dfThickness  = ReadBITDOUBLE( pabyInput, nBitOffsetFromStart );
+        polyline->dfThickness  = ReadBITDOUBLE( oInput, nBitOffsetFromStart );
     if( dataFlag & 1 )
     {
-        CADVector vectExtrusion = ReadVector( pabyInput, nBitOffsetFromStart );
+        CADVector vectExtrusion = ReadVector( oInput, nBitOffsetFromStart );
         polyline->vectExtrusion = vectExtrusion;
     }
 
-    vertixesCount = ReadBITLONG( pabyInput, nBitOffsetFromStart );
-    polyline->avertVertexes.reserve( vertixesCount );
+    vertixesCount = ReadBITLONG( oInput, nBitOffsetFromStart );
+    // vertexes after the first one are two bit doubles with default
+    polyline->avertVertexes.reserve( GetReservableCount( vertixesCount, oInput, nBitOffsetFromStart, 4 ) );
 
     if( dataFlag & 16 )
     {
-        nBulges = ReadBITLONG( pabyInput, nBitOffsetFromStart );
-        polyline->adfBulges.reserve( nBulges );
+        nBulges = ReadBITLONG( oInput, nBitOffsetFromStart );
+        polyline->adfBulges.reserve( GetReservableCount( nBulges, oInput, nBitOffsetFromStart, 2 ) );
     }
 
     // TODO: tell ODA that R2000 contains nNumWidths flag
     if( dataFlag & 32 )
     {
-        nNumWidths = ReadBITLONG( pabyInput, nBitOffsetFromStart );
-        polyline->astWidths.reserve( nNumWidths );
+        nNumWidths = ReadBITLONG( oInput, nBitOffsetFromStart );
+        polyline->astWidths.reserve( GetReservableCount( nNumWidths, oInput, nBitOffsetFromStart, 4 ) );
     }
 
     if( dataFlag & 512 )
@@ -2402,49 +2715,49 @@ CADLWPolylineObject * DWGFileR2000::getLWPolyLine( long dObjectSize, CADCommonED
         polyline->bClosed = false;
 
     // First of all, read first vertex.
-    CADVector vertex = ReadRAWVector( pabyInput, nBitOffsetFromStart );
+    CADVector vertex = ReadRAWVector( oInput, nBitOffsetFromStart );
     polyline->avertVertexes.push_back( vertex );
 
     // All the others are not raw doubles; bitdoubles with default instead,
     // where default is previous point coords.
     size_t   prev;
-    for( int i       = 1; i < vertixesCount; ++i )
+    for( int i       = 1; i < vertixesCount && !oInput.IsOverrun(); ++i )
     {
         prev = size_t( i - 1 );
-        x    = ReadBITDOUBLEWD( pabyInput, nBitOffsetFromStart, polyline->avertVertexes[prev].getX() );
-        y    = ReadBITDOUBLEWD( pabyInput, nBitOffsetFromStart, polyline->avertVertexes[prev].getY() );
+        x    = ReadBITDOUBLEWD( oInput, nBitOffsetFromStart, polyline->avertVertexes[prev].getX() );
+        y    = ReadBITDOUBLEWD( oInput, nBitOffsetFromStart, polyline->avertVertexes[prev].getY() );
         vertex.setX( x );
         vertex.setY( y );
         polyline->avertVertexes.push_back( vertex );
     }
 
-    for( int i = 0; i < nBulges; ++i )
+    for( int i = 0; i < nBulges && !oInput.IsOverrun(); ++i )
     {
-        double dfBulgeValue = ReadBITDOUBLE( pabyInput, nBitOffsetFromStart );
+        double dfBulgeValue = ReadBITDOUBLE( oInput, nBitOffsetFromStart );
         polyline->adfBulges.push_back( dfBulgeValue );
     }
 
-    for( int i = 0; i < nNumWidths; ++i )
+    for( int i = 0; i < nNumWidths && !oInput.IsOverrun(); ++i )
     {
-        double dfStartWidth = ReadBITDOUBLE( pabyInput, nBitOffsetFromStart );
-        double dfEndWidth   = ReadBITDOUBLE( pabyInput, nBitOffsetFromStart );
+        double dfStartWidth = ReadBITDOUBLE( oInput, nBitOffsetFromStart );
+        double dfEndWidth   = ReadBITDOUBLE( oInput, nBitOffsetFromStart );
         polyline->astWidths.push_back( make_pair( dfStartWidth, dfEndWidth ) );
     }
 
-    fillCommonEntityHandleData( polyline, pabyInput, nBitOffsetFromStart );
+    fillCommonEntityHandleData( polyline, oInput, nBitOffsetFromStart );
 
-    nBitOffsetFromStart += 8 - ( nBitOffsetFromStart % 8 );
-    polyline->setCRC( ReadRAWSHORT( pabyInput, nBitOffsetFromStart ) );
+    AlignToByte( nBitOffsetFromStart );
+    polyline->setCRC( ReadRAWSHORT( oInput, nBitOffsetFromStart ) );
 
 #ifdef _DEBUG
-    if( ( nBitOffsetFromStart / 8 ) != ( dObjectSize + 4 ) )
+    if( ( nBitOffsetFromStart / 8 ) != oInput.GetSize() )
         DebugMsg( "Assertion failed at %d in %s\nSize difference: %d\n", __LINE__, __FILE__,
-                  ( nBitOffsetFromStart / 8 - dObjectSize - 4 ) );
+                  static_cast<int>( nBitOffsetFromStart / 8 - oInput.GetSize() ) );
 #endif //_DEBUG
     return polyline;
 }
 
-CADArcObject * DWGFileR2000::getArc( long dObjectSize, CADCommonED stCommonEntityData, const char * pabyInput,
+CADArcObject * DWGFileR2000::getArc( long dObjectSize, CADCommonED stCommonEntityData, const DWGBuffer& oInput,
                                      size_t& nBitOffsetFromStart )
 {
     CADArcObject * arc = new CADArcObject();
@@ -2452,71 +2765,74 @@ CADArcObject * DWGFileR2000::getArc( long dObjectSize, CADCommonED stCommonEntit
     arc->setSize( dObjectSize );
     arc->stCed = stCommonEntityData;
 
-    CADVector vertPosition = ReadVector( pabyInput, nBitOffsetFromStart );
+    CADVector vertPosition = ReadVector( oInput, nBitOffsetFromStart );
     arc->vertPosition = vertPosition;
-    arc->dfRadius     = ReadBITDOUBLE( pabyInput, nBitOffsetFromStart );
-    arc->dfThickness  = ReadBIT( pabyInput, nBitOffsetFromStart ) ? 0.0f : ReadBITDOUBLE( pabyInput,
+    arc->dfRadius     = ReadBITDOUBLE( oInput, nBitOffsetFromStart );
+    arc->dfThickness  = ReadBIT( oInput, nBitOffsetFromStart ) ? 0.0f : ReadBITDOUBLE( oInput,
                                                                                           nBitOffsetFromStart );
 
-    if( ReadBIT( pabyInput, nBitOffsetFromStart ) )
+    if( ReadBIT( oInput, nBitOffsetFromStart ) )
     {
         arc->vectExtrusion = CADVector( 0.0f, 0.0f, 1.0f );
     } else
     {
-        CADVector vectExtrusion = ReadVector( pabyInput, nBitOffsetFromStart );
+        CADVector vectExtrusion = ReadVector( oInput, nBitOffsetFromStart );
         arc->vectExtrusion = vectExtrusion;
     }
 
-    arc->dfStartAngle = ReadBITDOUBLE( pabyInput, nBitOffsetFromStart );
-    arc->dfEndAngle   = ReadBITDOUBLE( pabyInput, nBitOffsetFromStart );
+    arc->dfStartAngle = ReadBITDOUBLE( oInput, nBitOffsetFromStart );
+    arc->dfEndAngle   = ReadBITDOUBLE( oInput, nBitOffsetFromStart );
 
-    fillCommonEntityHandleData( arc, pabyInput, nBitOffsetFromStart );
+    fillCommonEntityHandleData( arc, oInput, nBitOffsetFromStart );
 
-    nBitOffsetFromStart += 8 - ( nBitOffsetFromStart % 8 );
-    arc->setCRC( ReadRAWSHORT( pabyInput, nBitOffsetFromStart ) );
+    AlignToByte( nBitOffsetFromStart );
+    arc->setCRC( ReadRAWSHORT( oInput, nBitOffsetFromStart ) );
 #ifdef _DEBUG
-    if( ( nBitOffsetFromStart / 8 ) != ( dObjectSize + 4 ) )
+    if( ( nBitOffsetFromStart / 8 ) != oInput.GetSize() )
         DebugMsg( "Assertion failed at %d in %s\nSize difference: %d\n", __LINE__, __FILE__,
-                  ( nBitOffsetFromStart / 8 - dObjectSize - 4 ) );
+                  static_cast<int>( nBitOffsetFromStart / 8 - oInput.GetSize() ) );
 #endif // _DEBUG
     return arc;
 }
 
-CADSplineObject * DWGFileR2000::getSpline( long dObjectSize, CADCommonED stCommonEntityData, const char * pabyInput,
+CADSplineObject * DWGFileR2000::getSpline( long dObjectSize, CADCommonED stCommonEntityData, const DWGBuffer& oInput,
                                            size_t& nBitOffsetFromStart )
 {
     CADSplineObject * spline = new CADSplineObject();
     spline->setSize( dObjectSize );
     spline->stCed     = stCommonEntityData;
-    spline->dScenario = ReadBITLONG( pabyInput, nBitOffsetFromStart );
-    spline->dDegree   = ReadBITLONG( pabyInput, nBitOffsetFromStart );
+    spline->dScenario = ReadBITLONG( oInput, nBitOffsetFromStart );
+    spline->dDegree   = ReadBITLONG( oInput, nBitOffsetFromStart );
 
     if( spline->dScenario == 2 )
     {
-        spline->dfFitTol = ReadBITDOUBLE( pabyInput, nBitOffsetFromStart );
-        CADVector vectBegTangDir = ReadVector( pabyInput, nBitOffsetFromStart );
+        spline->dfFitTol = ReadBITDOUBLE( oInput, nBitOffsetFromStart );
+        CADVector vectBegTangDir = ReadVector( oInput, nBitOffsetFromStart );
         spline->vectBegTangDir = vectBegTangDir;
-        CADVector vectEndTangDir = ReadVector( pabyInput, nBitOffsetFromStart );
+        CADVector vectEndTangDir = ReadVector( oInput, nBitOffsetFromStart );
         spline->vectEndTangDir = vectEndTangDir;
 
-        spline->nNumFitPts = ReadBITLONG( pabyInput, nBitOffsetFromStart );
-        spline->averFitPoints.reserve( spline->nNumFitPts );
+        spline->nNumFitPts = ReadBITLONG( oInput, nBitOffsetFromStart );
+        spline->averFitPoints.reserve( GetReservableCount( spline->nNumFitPts, oInput,
+                                                           nBitOffsetFromStart, 6 ) );
     } else if( spline->dScenario == 1 )
     {
-        spline->bRational = ReadBIT( pabyInput, nBitOffsetFromStart );
-        spline->bClosed   = ReadBIT( pabyInput, nBitOffsetFromStart );
-        spline->bPeriodic = ReadBIT( pabyInput, nBitOffsetFromStart );
-        spline->dfKnotTol = ReadBITDOUBLE( pabyInput, nBitOffsetFromStart );
-        spline->dfCtrlTol = ReadBITDOUBLE( pabyInput, nBitOffsetFromStart );
-
-        spline->nNumKnots = ReadBITLONG( pabyInput, nBitOffsetFromStart );
-        spline->adfKnots.reserve( spline->nNumKnots );
-
-        spline->nNumCtrlPts = ReadBITLONG( pabyInput, nBitOffsetFromStart );
-        spline->avertCtrlPoints.reserve( spline->nNumCtrlPts );
-        if( spline->bWeight ) spline->adfCtrlPointsWeight.reserve( spline->nNumCtrlPts );
-
-        spline->bWeight = ReadBIT( pabyInput, nBitOffsetFromStart );
+        spline->bRational = ReadBIT( oInput, nBitOffsetFromStart );
+        spline->bClosed   = ReadBIT( oInput, nBitOffsetFromStart );
+        spline->bPeriodic = ReadBIT( oInput, nBitOffsetFromStart );
+        spline->dfKnotTol = ReadBITDOUBLE( oInput, nBitOffsetFromStart );
+        spline->dfCtrlTol = ReadBITDOUBLE( oInput, nBitOffsetFromStart );
+
+        spline->nNumKnots = ReadBITLONG( oInput, nBitOffsetFromStart );
+        spline->adfKnots.reserve( GetReservableCount( spline->nNumKnots, oInput, nBitOffsetFromStart, 2 ) );
+
+        spline->nNumCtrlPts = ReadBITLONG( oInput, nBitOffsetFromStart );
+        spline->bWeight     = ReadBIT( oInput, nBitOffsetFromStart );
+
+        size_t nCtrlPts = GetReservableCount( spline->nNumCtrlPts, oInput, nBitOffsetFromStart,
+                                              spline->bWeight ? 8 : 6 );
+        spline->avertCtrlPoints.reserve( nCtrlPts );
+        if( spline->bWeight ) spline->adfCtrlPointsWeight.reserve( nCtrlPts );
     }
 #ifdef _DEBUG
     else
@@ -2524,36 +2840,36 @@ CADSplineObject * DWGFileR2000::getSpline( long dObjectSize, CADCommonED stCommo
         DebugMsg( "Spline scenario != {1,2} read: error." );
     }
 #endif
-    for( long i = 0; i < spline->nNumKnots; ++i )
-        spline->adfKnots.push_back( ReadBITDOUBLE( pabyInput, nBitOffsetFromStart ) );
-    for( long i = 0; i < spline->nNumCtrlPts; ++i )
+    for( long i = 0; i < spline->nNumKnots && !oInput.IsOverrun(); ++i )
+        spline->adfKnots.push_back( ReadBITDOUBLE( oInput, nBitOffsetFromStart ) );
+    for( long i = 0; i < spline->nNumCtrlPts && !oInput.IsOverrun(); ++i )
     {
-        CADVector vertex = ReadVector( pabyInput, nBitOffsetFromStart );
+        CADVector vertex = ReadVector( oInput, nBitOffsetFromStart );
         spline->avertCtrlPoints.push_back( vertex );
         if( spline->bWeight )
-            spline->adfCtrlPointsWeight.push_back( ReadBITDOUBLE( pabyInput, nBitOffsetFromStart ) );
+            spline->adfCtrlPointsWeight.push_back( ReadBITDOUBLE( oInput, nBitOffsetFromStart ) );
     }
-    for( long i = 0; i < spline->nNumFitPts; ++i )
+    for( long i = 0; i < spline->nNumFitPts && !oInput.IsOverrun(); ++i )
     {
-        CADVector vertex = ReadVector( pabyInput, nBitOffsetFromStart );
+        CADVector vertex = ReadVector( oInput, nBitOffsetFromStart );
         spline->averFitPoints.push_back( vertex );
     }
 
-    fillCommonEntityHandleData( spline, pabyInput, nBitOffsetFromStart );
+    fillCommonEntityHandleData( spline, oInput, nBitOffsetFromStart );
 
-    nBitOffsetFromStart += 8 - ( nBitOffsetFromStart % 8 );
-    spline->setCRC( ReadRAWSHORT( pabyInput, nBitOffsetFromStart ) );
+    AlignToByte( nBitOffsetFromStart );
+    spline->setCRC( ReadRAWSHORT( oInput, nBitOffsetFromStart ) );
 
 #ifdef _DEBUG
-    if( ( nBitOffsetFromStart / 8 ) != ( dObjectSize + 4 ) )
+    if( ( nBitOffsetFromStart / 8 ) != oInput.GetSize() )
         DebugMsg( "Assertion failed at %d in %s\nSize difference: %d\n", __LINE__, __FILE__,
-                  ( nBitOffsetFromStart / 8 - dObjectSize - 4 ) );
+                  static_cast<int>( nBitOffsetFromStart / 8 - oInput.GetSize() ) );
 #endif //_DEBUG
     return spline;
 }
 
 CADEntityObject * DWGFileR2000::getEntity( int dObjectType, long dObjectSize, CADCommonED stCommonEntityData,
-                                           const char * pabyInput, size_t& nBitOffsetFromStart )
+                                           const DWGBuffer& oInput, size_t& nBitOffsetFromStart )
 {
     CADEntityObject * entity = new CADEntityObject();
 
@@ -2564,20 +2880,20 @@ CADEntityObject * DWGFileR2000::getEntity( int dObjectType, long dObjectSize, CA
     nBitOffsetFromStart = static_cast<size_t>(
             entity->stCed.nObjectSizeInBits + 16);
 
-    fillCommonEntityHandleData( entity, pabyInput, nBitOffsetFromStart );
+    fillCommonEntityHandleData( entity, oInput, nBitOffsetFromStart );
 
-    nBitOffsetFromStart += 8 - ( nBitOffsetFromStart % 8 );
-    entity->setCRC( ReadRAWSHORT( pabyInput, nBitOffsetFromStart ) );
+    AlignToByte( nBitOffsetFromStart );
+    entity->setCRC( ReadRAWSHORT( oInput, nBitOffsetFromStart ) );
 #ifdef _DEBUG
-    if( ( nBitOffsetFromStart / 8 ) != ( dObjectSize + 4 ) )
+    if( ( nBitOffsetFromStart / 8 ) != oInput.GetSize() )
         DebugMsg( "Assertion failed at %d in %s\nSize difference: %d\n", __LINE__, __FILE__,
-                  ( nBitOffsetFromStart / 8 - dObjectSize - 4 ) );
+                  static_cast<int>( nBitOffsetFromStart / 8 - oInput.GetSize() ) );
 #endif //_DEBUG
     return entity;
 }
 
 CADInsertObject * DWGFileR2000::getInsert( int dObjectType, long dObjectSize, CADCommonED stCommonEntityData,
-                                           const char * pabyInput, size_t& nBitOffsetFromStart )
+                                           const DWGBuffer& oInput, size_t& nBitOffsetFromStart )
 {
     CADInsertObject * insert = new CADInsertObject();
 
@@ -2585,54 +2901,54 @@ CADInsertObject * DWGFileR2000::getInsert( int dObjectType, long dObjectSize, CA
     insert->setSize( dObjectSize );
     insert->stCed = stCommonEntityData;
 
-    insert->vertInsertionPoint = ReadVector( pabyInput, nBitOffsetFromStart );
-    unsigned char dataFlags = Read2B( pabyInput, nBitOffsetFromStart );
+    insert->vertInsertionPoint = ReadVector( oInput, nBitOffsetFromStart );
+    unsigned char dataFlags = Read2B( oInput, nBitOffsetFromStart );
     double        val41     = 1.0;
     double        val42     = 1.0;
     double        val43     = 1.0;
     if( dataFlags == 0 )
     {
-        val41 = ReadRAWDOUBLE( pabyInput, nBitOffsetFromStart );
-        val42 = ReadBITDOUBLEWD( pabyInput, nBitOffsetFromStart, val41 );
-        val43 = ReadBITDOUBLEWD( pabyInput, nBitOffsetFromStart, val41 );
+        val41 = ReadRAWDOUBLE( oInput, nBitOffsetFromStart );
+        val42 = ReadBITDOUBLEWD( oInput, nBitOffsetFromStart, val41 );
+        val43 = ReadBITDOUBLEWD( oInput, nBitOffsetFromStart, val41 );
     } else if( dataFlags == 1 )
     {
         val41 = 1.0;
-        val42 = ReadBITDOUBLEWD( pabyInput, nBitOffsetFromStart, val41 );
-        val43 = ReadBITDOUBLEWD( pabyInput, nBitOffsetFromStart, val41 );
+        val42 = ReadBITDOUBLEWD( oInput, nBitOffsetFromStart, val41 );
+        val43 = ReadBITDOUBLEWD( oInput, nBitOffsetFromStart, val41 );
     } else if( dataFlags == 2 )
     {
-        val41 = ReadRAWDOUBLE( pabyInput, nBitOffsetFromStart );
+        val41 = ReadRAWDOUBLE( oInput, nBitOffsetFromStart );
         val42 = val41;
         val43 = val41;
     }
     insert->vertScales    = CADVector( val41, val42, val43 );
-    insert->dfRotation    = ReadBITDOUBLE( pabyInput, nBitOffsetFromStart );
-    insert->vectExtrusion = ReadVector( pabyInput, nBitOffsetFromStart );
-    insert->bHasAttribs   = ReadBIT( pabyInput, nBitOffsetFromStart );
+    insert->dfRotation    = ReadBITDOUBLE( oInput, nBitOffsetFromStart );
+    insert->vectExtrusion = ReadVector( oInput, nBitOffsetFromStart );
+    insert->bHasAttribs   = ReadBIT( oInput, nBitOffsetFromStart );
 
-    fillCommonEntityHandleData( insert, pabyInput, nBitOffsetFromStart );
+    fillCommonEntityHandleData( insert, oInput, nBitOffsetFromStart );
 
-    insert->hBlockHeader = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+    insert->hBlockHeader = ReadHANDLE( oInput, nBitOffsetFromStart );
     if( insert->bHasAttribs )
     {
-        insert->hAttribs.push_back( ReadHANDLE( pabyInput, nBitOffsetFromStart ) );
-        insert->hAttribs.push_back( ReadHANDLE( pabyInput, nBitOffsetFromStart ) );
-        insert->hSeqend = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+        insert->hAttribs.push_back( ReadHANDLE( oInput, nBitOffsetFromStart ) );
+        insert->hAttribs.push_back( ReadHANDLE( oInput, nBitOffsetFromStart ) );
+        insert->hSeqend = ReadHANDLE( oInput, nBitOffsetFromStart );
     }
 
-    nBitOffsetFromStart += 8 - ( nBitOffsetFromStart % 8 );
-    insert->setCRC( ReadRAWSHORT( pabyInput, nBitOffsetFromStart ) );
+    AlignToByte( nBitOffsetFromStart );
+    insert->setCRC( ReadRAWSHORT( oInput, nBitOffsetFromStart ) );
 #ifdef _DEBUG
-    if( ( nBitOffsetFromStart / 8 ) != ( dObjectSize + 4 ) )
+    if( ( nBitOffsetFromStart / 8 ) != oInput.GetSize() )
         DebugMsg( "Assertion failed at %d in %s\nSize difference: %d\n", __LINE__, __FILE__,
-                  ( nBitOffsetFromStart / 8 - dObjectSize - 4 ) );
+                  static_cast<int>( nBitOffsetFromStart / 8 - oInput.GetSize() ) );
 #endif //_DEBUG
 
     return insert;
 }
 
-CADDictionaryObject * DWGFileR2000::getDictionary( long dObjectSize, const char * pabyInput,
+CADDictionaryObject * DWGFileR2000::getDictionary( long dObjectSize, const DWGBuffer& oInput,
                                                    size_t& nBitOffsetFromStart )
 {
     /*
@@ -2644,95 +2960,95 @@ CADDictionaryObject * DWGFileR2000::getDictionary( long dObjectSize, const char
     CADDictionaryObject * dictionary = new CADDictionaryObject();
 
     dictionary->setSize( dObjectSize );
-    dictionary->nObjectSizeInBits = ReadRAWLONG( pabyInput, nBitOffsetFromStart );
-    dictionary->hObjectHandle     = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+    dictionary->nObjectSizeInBits = ReadRAWLONG( oInput, nBitOffsetFromStart );
+    dictionary->hObjectHandle     = ReadHANDLE( oInput, nBitOffsetFromStart );
 
     short  dEEDSize = 0;
     CADEed dwgEed;
-    while( ( dEEDSize = ReadBITSHORT( pabyInput, nBitOffsetFromStart ) ) != 0 )
+    while( ( dEEDSize = ReadBITSHORT( oInput, nBitOffsetFromStart ) ) != 0 )
     {
         dwgEed.dLength      = dEEDSize;
-        dwgEed.hApplication = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+        dwgEed.hApplication = ReadHANDLE( oInput, nBitOffsetFromStart );
 
         for( short i = 0; i < dEEDSize; ++i )
         {
-            dwgEed.acData.push_back( ReadCHAR( pabyInput, nBitOffsetFromStart ) );
+            dwgEed.acData.push_back( ReadCHAR( oInput, nBitOffsetFromStart ) );
         }
 
         dictionary->aEED.push_back( dwgEed );
     }
 
-    dictionary->nNumReactors   = ReadBITSHORT( pabyInput, nBitOffsetFromStart );
-    dictionary->nNumItems      = ReadBITLONG( pabyInput, nBitOffsetFromStart );
-    dictionary->dCloningFlag   = ReadBITSHORT( pabyInput, nBitOffsetFromStart );
-    dictionary->dHardOwnerFlag = ReadCHAR( pabyInput, nBitOffsetFromStart );
+    dictionary->nNumReactors   = ReadBITSHORT( oInput, nBitOffsetFromStart );
+    dictionary->nNumItems      = ReadBITLONG( oInput, nBitOffsetFromStart );
+    dictionary->dCloningFlag   = ReadBITSHORT( oInput, nBitOffsetFromStart );
+    dictionary->dHardOwnerFlag = ReadCHAR( oInput, nBitOffsetFromStart );
 
-    for( long i = 0; i < dictionary->nNumItems; ++i )
-        dictionary->sItemNames.push_back( ReadTV( pabyInput, nBitOffsetFromStart ) );
+    for( long i = 0; i < dictionary->nNumItems && !oInput.IsOverrun(); ++i )
+        dictionary->sItemNames.push_back( ReadTV( oInput, nBitOffsetFromStart ) );
 
-    dictionary->hParentHandle = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+    dictionary->hParentHandle = ReadHANDLE( oInput, nBitOffsetFromStart );
 
-    for( long i = 0; i < dictionary->nNumReactors; ++i )
-        dictionary->hReactors.push_back( ReadHANDLE( pabyInput, nBitOffsetFromStart ) );
-    dictionary->hXDictionary = ReadHANDLE( pabyInput, nBitOffsetFromStart );
-    for( long i = 0; i < dictionary->nNumItems; ++i )
-        dictionary->hItemHandles.push_back( ReadHANDLE( pabyInput, nBitOffsetFromStart ) );
+    for( long i = 0; i < dictionary->nNumReactors && !oInput.IsOverrun(); ++i )
+        dictionary->hReactors.push_back( ReadHANDLE( oInput, nBitOffsetFromStart ) );
+    dictionary->hXDictionary = ReadHANDLE( oInput, nBitOffsetFromStart );
+    for( long i = 0; i < dictionary->nNumItems && !oInput.IsOverrun(); ++i )
+        dictionary->hItemHandles.push_back( ReadHANDLE( oInput, nBitOffsetFromStart ) );
 
-    nBitOffsetFromStart += 8 - ( nBitOffsetFromStart % 8 );
-    dictionary->setCRC( ReadRAWSHORT( pabyInput, nBitOffsetFromStart ) );
+    AlignToByte( nBitOffsetFromStart );
+    dictionary->setCRC( ReadRAWSHORT( oInput, nBitOffsetFromStart ) );
 
 #ifdef _DEBUG
-    if( ( nBitOffsetFromStart / 8 ) != ( dObjectSize + 4 ) )
+    if( ( nBitOffsetFromStart / 8 ) != oInput.GetSize() )
         DebugMsg( "Assertion failed at %d in %s\nSize difference: %d\n", __LINE__, __FILE__,
-                  ( nBitOffsetFromStart / 8 - dObjectSize - 4 ) );
+                  static_cast<int>( nBitOffsetFromStart / 8 - oInput.GetSize() ) );
 #endif // _DEBUG
     return dictionary;
 }
 
-CADLayerObject * DWGFileR2000::getLayerObject( long dObjectSize, const char * pabyInput, size_t& nBitOffsetFromStart )
+CADLayerObject * DWGFileR2000::getLayerObject( long dObjectSize, const DWGBuffer& oInput, size_t& nBitOffsetFromStart )
 {
     CADLayerObject * layer = new CADLayerObject();
 
     layer->setSize( dObjectSize );
-    layer->nObjectSizeInBits = ReadRAWLONG( pabyInput, nBitOffsetFromStart );
-    layer->hObjectHandle     = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+    layer->nObjectSizeInBits = ReadRAWLONG( oInput, nBitOffsetFromStart );
+    layer->hObjectHandle     = ReadHANDLE( oInput, nBitOffsetFromStart );
 
     short  dEEDSize = 0;
     CADEed dwgEed;
-    while( ( dEEDSize = ReadBITSHORT( pabyInput, nBitOffsetFromStart ) ) != 0 )
+    while( ( dEEDSize = ReadBITSHORT( oInput, nBitOffsetFromStart ) ) != 0 )
     {
         dwgEed.dLength      = dEEDSize;
-        dwgEed.hApplication = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+        dwgEed.hApplication = ReadHANDLE( oInput, nBitOffsetFromStart );
 
         for( short i = 0; i < dEEDSize; ++i )
         {
-            dwgEed.acData.push_back( ReadCHAR( pabyInput, nBitOffsetFromStart ) );
+            dwgEed.acData.push_back( ReadCHAR( oInput, nBitOffsetFromStart ) );
         }
 
         layer->aEED.push_back( dwgEed );
     }
 
-    layer->nNumReactors = ReadBITLONG( pabyInput, nBitOffsetFromStart );
-    layer->sLayerName   = ReadTV( pabyInput, nBitOffsetFromStart );
-    layer->b64Flag      = ReadBIT( pabyInput, nBitOffsetFromStart );
-    layer->dXRefIndex   = ReadBITSHORT( pabyInput, nBitOffsetFromStart );
-    layer->bXDep        = ReadBIT( pabyInput, nBitOffsetFromStart );
+    layer->nNumReactors = ReadBITLONG( oInput, nBitOffsetFromStart );
+    layer->sLayerName   = ReadTV( oInput, nBitOffsetFromStart );
+    layer->b64Flag      = ReadBIT( oInput, nBitOffsetFromStart );
+    layer->dXRefIndex   = ReadBITSHORT( oInput, nBitOffsetFromStart );
+    layer->bXDep        = ReadBIT( oInput, nBitOffsetFromStart );
 
-    short dFlags = ReadBITSHORT( pabyInput, nBitOffsetFromStart );
+    short dFlags = ReadBITSHORT( oInput, nBitOffsetFromStart );
     layer->bFrozen           = dFlags & 0x01;
     layer->bOn               = !(dFlags & 0x02); // bit seems to indicate off, rather than on (as in ODA spec)
     layer->bFrozenInNewVPORT = dFlags & 0x04;
     layer->bLocked           = dFlags & 0x08;
     layer->bPlottingFlag     = dFlags & 0x10;
     layer->dLineWeight       = dFlags & 0x03E0; //
-    layer->dCMColor          = ReadBITSHORT( pabyInput, nBitOffsetFromStart );
-    layer->hLayerControl     = ReadHANDLE( pabyInput, nBitOffsetFromStart );
-    for( long i = 0; i < layer->nNumReactors; ++i )
-        layer->hReactors.push_back( ReadHANDLE( pabyInput, nBitOffsetFromStart ) );
-    layer->hXDictionary            = ReadHANDLE( pabyInput, nBitOffsetFromStart );
-    layer->hExternalRefBlockHandle = ReadHANDLE( pabyInput, nBitOffsetFromStart );
-    layer->hPlotStyle              = ReadHANDLE( pabyInput, nBitOffsetFromStart );
-    layer->hLType                  = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+    layer->dCMColor          = ReadBITSHORT( oInput, nBitOffsetFromStart );
+    layer->hLayerControl     = ReadHANDLE( oInput, nBitOffsetFromStart );
+    for( long i = 0; i < layer->nNumReactors && !oInput.IsOverrun(); ++i )
+        layer->hReactors.push_back( ReadHANDLE( oInput, nBitOffsetFromStart ) );
+    layer->hXDictionary            = ReadHANDLE( oInput, nBitOffsetFromStart );
+    layer->hExternalRefBlockHandle = ReadHANDLE( oInput, nBitOffsetFromStart );
+    layer->hPlotStyle              = ReadHANDLE( oInput, nBitOffsetFromStart );
+    layer->hLType                  = ReadHANDLE( oInput, nBitOffsetFromStart );
 
     /*
      * FIXME: ODA says that this handle should be null hard pointer. It is not.
@@ -2742,296 +3058,296 @@ CADLayerObject * DWGFileR2000::getLayerObject( long dObjectSize, const char * pa
      */
 // layer->hUnknownHandle = ReadHANDLE (pabySectionContent, nBitOffsetFromStart);
 
-    nBitOffsetFromStart += 8 - ( nBitOffsetFromStart % 8 );
-    layer->setCRC( ReadRAWSHORT( pabyInput, nBitOffsetFromStart ) );
+    AlignToByte( nBitOffsetFromStart );
+    layer->setCRC( ReadRAWSHORT( oInput, nBitOffsetFromStart ) );
 
 #ifdef _DEBUG
-    if( ( nBitOffsetFromStart / 8 ) != ( dObjectSize + 4 ) )
+    if( ( nBitOffsetFromStart / 8 ) != oInput.GetSize() )
         DebugMsg( "Assertion failed at %d in %s\nSize difference: %d\n", __LINE__, __FILE__,
-                  ( nBitOffsetFromStart / 8 - dObjectSize - 4 ) );
+                  static_cast<int>( nBitOffsetFromStart / 8 - oInput.GetSize() ) );
 #endif //_DEBUG
     return layer;
 }
 
-CADLayerControlObject * DWGFileR2000::getLayerControl( long dObjectSize, const char * pabyInput,
+CADLayerControlObject * DWGFileR2000::getLayerControl( long dObjectSize, const DWGBuffer& oInput,
                                                        size_t& nBitOffsetFromStart )
 {
     CADLayerControlObject * layerControl = new CADLayerControlObject();
 
     layerControl->setSize( dObjectSize );
-    layerControl->nObjectSizeInBits = ReadRAWLONG( pabyInput, nBitOffsetFromStart );
-    layerControl->hObjectHandle     = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+    layerControl->nObjectSizeInBits = ReadRAWLONG( oInput, nBitOffsetFromStart );
+    layerControl->hObjectHandle     = ReadHANDLE( oInput, nBitOffsetFromStart );
 
     short  dEEDSize = 0;
     CADEed dwgEed;
-    while( ( dEEDSize = ReadBITSHORT( pabyInput, nBitOffsetFromStart ) ) != 0 )
+    while( ( dEEDSize = ReadBITSHORT( oInput, nBitOffsetFromStart ) ) != 0 )
     {
 
         dwgEed.dLength      = dEEDSize;
-        dwgEed.hApplication = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+        dwgEed.hApplication = ReadHANDLE( oInput, nBitOffsetFromStart );
 
         for( short i = 0; i < dEEDSize; ++i )
         {
-            dwgEed.acData.push_back( ReadCHAR( pabyInput, nBitOffsetFromStart ) );
+            dwgEed.acData.push_back( ReadCHAR( oInput, nBitOffsetFromStart ) );
         }
 
         layerControl->aEED.push_back( dwgEed );
     }
 
-    layerControl->nNumReactors = ReadBITLONG( pabyInput, nBitOffsetFromStart );
-    layerControl->nNumEntries  = ReadBITLONG( pabyInput, nBitOffsetFromStart );
-    layerControl->hNull        = ReadHANDLE( pabyInput, nBitOffsetFromStart );
-    layerControl->hXDictionary = ReadHANDLE( pabyInput, nBitOffsetFromStart );
-    for( long i = 0; i < layerControl->nNumEntries; ++i )
-        layerControl->hLayers.push_back( ReadHANDLE( pabyInput, nBitOffsetFromStart ) );
+    layerControl->nNumReactors = ReadBITLONG( oInput, nBitOffsetFromStart );
+    layerControl->nNumEntries  = ReadBITLONG( oInput, nBitOffsetFromStart );
+    layerControl->hNull        = ReadHANDLE( oInput, nBitOffsetFromStart );
+    layerControl->hXDictionary = ReadHANDLE( oInput, nBitOffsetFromStart );
+    for( long i = 0; i < layerControl->nNumEntries && !oInput.IsOverrun(); ++i )
+        layerControl->hLayers.push_back( ReadHANDLE( oInput, nBitOffsetFromStart ) );
 
-    nBitOffsetFromStart += 8 - ( nBitOffsetFromStart % 8 );
-    layerControl->setCRC( ReadRAWSHORT( pabyInput, nBitOffsetFromStart ) );
+    AlignToByte( nBitOffsetFromStart );
+    layerControl->setCRC( ReadRAWSHORT( oInput, nBitOffsetFromStart ) );
 #ifdef _DEBUG
-    if( ( nBitOffsetFromStart / 8 ) != ( dObjectSize + 4 ) )
+    if( ( nBitOffsetFromStart / 8 ) != oInput.GetSize() )
         DebugMsg( "Assertion failed at %d in %s\nSize difference: %d\n", __LINE__, __FILE__,
-                  ( nBitOffsetFromStart / 8 - dObjectSize - 4 ) );
+                  static_cast<int>( nBitOffsetFromStart / 8 - oInput.GetSize() ) );
 #endif
     return layerControl;
 }
 
-CADBlockControlObject * DWGFileR2000::getBlockControl( long dObjectSize, const char * pabyInput,
+CADBlockControlObject * DWGFileR2000::getBlockControl( long dObjectSize, const DWGBuffer& oInput,
                                                        size_t& nBitOffsetFromStart )
 {
     CADBlockControlObject * blockControl = new CADBlockControlObject();
 
     blockControl->setSize( dObjectSize );
-    blockControl->nObjectSizeInBits = ReadRAWLONG( pabyInput, nBitOffsetFromStart );
-    blockControl->hObjectHandle     = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+    blockControl->nObjectSizeInBits = ReadRAWLONG( oInput, nBitOffsetFromStart );
+    blockControl->hObjectHandle     = ReadHANDLE( oInput, nBitOffsetFromStart );
 
     short  dEEDSize = 0;
     CADEed dwgEed;
-    while( ( dEEDSize = ReadBITSHORT( pabyInput, nBitOffsetFromStart ) ) != 0 )
+    while( ( dEEDSize = ReadBITSHORT( oInput, nBitOffsetFromStart ) ) != 0 )
     {
         dwgEed.dLength      = dEEDSize;
-        dwgEed.hApplication = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+        dwgEed.hApplication = ReadHANDLE( oInput, nBitOffsetFromStart );
 
         for( short i = 0; i < dEEDSize; ++i )
         {
-            dwgEed.acData.push_back( ReadCHAR( pabyInput, nBitOffsetFromStart ) );
+            dwgEed.acData.push_back( ReadCHAR( oInput, nBitOffsetFromStart ) );
         }
 
         blockControl->aEED.push_back( dwgEed );
     }
 
-    blockControl->nNumReactors = ReadBITLONG( pabyInput, nBitOffsetFromStart );
-    blockControl->nNumEntries  = ReadBITLONG( pabyInput, nBitOffsetFromStart );
+    blockControl->nNumReactors = ReadBITLONG( oInput, nBitOffsetFromStart );
+    blockControl->nNumEntries  = ReadBITLONG( oInput, nBitOffsetFromStart );
 
-    blockControl->hNull        = ReadHANDLE( pabyInput, nBitOffsetFromStart );
-    blockControl->hXDictionary = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+    blockControl->hNull        = ReadHANDLE( oInput, nBitOffsetFromStart );
+    blockControl->hXDictionary = ReadHANDLE( oInput, nBitOffsetFromStart );
 
-    for( long i = 0; i < blockControl->nNumEntries + 2; ++i )
+    for( long i = 0; i < blockControl->nNumEntries + 2 && !oInput.IsOverrun(); ++i )
     {
-        blockControl->hBlocks.push_back( ReadHANDLE( pabyInput, nBitOffsetFromStart ) );
+        blockControl->hBlocks.push_back( ReadHANDLE( oInput, nBitOffsetFromStart ) );
     }
 
-    nBitOffsetFromStart += 8 - ( nBitOffsetFromStart % 8 );
-    blockControl->setCRC( ReadRAWSHORT( pabyInput, nBitOffsetFromStart ) );
+    AlignToByte( nBitOffsetFromStart );
+    blockControl->setCRC( ReadRAWSHORT( oInput, nBitOffsetFromStart ) );
 #ifdef _DEBUG
-    if( ( nBitOffsetFromStart / 8 ) != ( dObjectSize + 4 ) )
+    if( ( nBitOffsetFromStart / 8 ) != oInput.GetSize() )
         DebugMsg( "Assertion failed at %d in %s\nSize difference: %d\n", __LINE__, __FILE__,
-                  ( nBitOffsetFromStart / 8 - dObjectSize - 4 ) );
+                  static_cast<int>( nBitOffsetFromStart / 8 - oInput.GetSize() ) );
 #endif //_DEBUG
     return blockControl;
 }
 
-CADBlockHeaderObject * DWGFileR2000::getBlockHeader( long dObjectSize, const char * pabyInput,
+CADBlockHeaderObject * DWGFileR2000::getBlockHeader( long dObjectSize, const DWGBuffer& oInput,
                                                      size_t& nBitOffsetFromStart )
 {
     CADBlockHeaderObject * blockHeader = new CADBlockHeaderObject();
 
     blockHeader->setSize( dObjectSize );
-    blockHeader->nObjectSizeInBits = ReadRAWLONG( pabyInput, nBitOffsetFromStart );
-    blockHeader->hObjectHandle     = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+    blockHeader->nObjectSizeInBits = ReadRAWLONG( oInput, nBitOffsetFromStart );
+    blockHeader->hObjectHandle     = ReadHANDLE( oInput, nBitOffsetFromStart );
 
     short  dEEDSize;
     CADEed dwgEed;
-    while( ( dEEDSize = ReadBITSHORT( pabyInput, nBitOffsetFromStart ) ) != 0 )
+    while( ( dEEDSize = ReadBITSHORT( oInput, nBitOffsetFromStart ) ) != 0 )
     {
         dwgEed.dLength      = dEEDSize;
-        dwgEed.hApplication = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+        dwgEed.hApplication = ReadHANDLE( oInput, nBitOffsetFromStart );
 
         for( short i = 0; i < dEEDSize; ++i )
         {
-            dwgEed.acData.push_back( ReadCHAR( pabyInput, nBitOffsetFromStart ) );
+            dwgEed.acData.push_back( ReadCHAR( oInput, nBitOffsetFromStart ) );
         }
 
         blockHeader->aEED.push_back( dwgEed );
     }
 
-    blockHeader->nNumReactors  = ReadBITLONG( pabyInput, nBitOffsetFromStart );
-    blockHeader->sEntryName    = ReadTV( pabyInput, nBitOffsetFromStart );
-    blockHeader->b64Flag       = ReadBIT( pabyInput, nBitOffsetFromStart );
-    blockHeader->dXRefIndex    = ReadBITSHORT( pabyInput, nBitOffsetFromStart );
-    blockHeader->bXDep         = ReadBIT( pabyInput, nBitOffsetFromStart );
-    blockHeader->bAnonymous    = ReadBIT( pabyInput, nBitOffsetFromStart );
-    blockHeader->bHasAtts      = ReadBIT( pabyInput, nBitOffsetFromStart );
-    blockHeader->bBlkisXRef    = ReadBIT( pabyInput, nBitOffsetFromStart );
-    blockHeader->bXRefOverlaid = ReadBIT( pabyInput, nBitOffsetFromStart );
-    blockHeader->bLoadedBit    = ReadBIT( pabyInput, nBitOffsetFromStart );
-
-    CADVector vertBasePoint = ReadVector( pabyInput, nBitOffsetFromStart );
+    blockHeader->nNumReactors  = ReadBITLONG( oInput, nBitOffsetFromStart );
+    blockHeader->sEntryName    = ReadTV( oInput, nBitOffsetFromStart );
+    blockHeader->b64Flag       = ReadBIT( oInput, nBitOffsetFromStart );
+    blockHeader->dXRefIndex    = ReadBITSHORT( oInput, nBitOffsetFromStart );
+    blockHeader->bXDep         = ReadBIT( oInput, nBitOffsetFromStart );
+    blockHeader->bAnonymous    = ReadBIT( oInput, nBitOffsetFromStart );
+    blockHeader->bHasAtts      = ReadBIT( oInput, nBitOffsetFromStart );
+    blockHeader->bBlkisXRef    = ReadBIT( oInput, nBitOffsetFromStart );
+    blockHeader->bXRefOverlaid = ReadBIT( oInput, nBitOffsetFromStart );
+    blockHeader->bLoadedBit    = ReadBIT( oInput, nBitOffsetFromStart );
+
+    CADVector vertBasePoint = ReadVector( oInput, nBitOffsetFromStart );
     blockHeader->vertBasePoint = vertBasePoint;
-    blockHeader->sXRefPName    = ReadTV( pabyInput, nBitOffsetFromStart );
+    blockHeader->sXRefPName    = ReadTV( oInput, nBitOffsetFromStart );
     unsigned char Tmp;
     do
     {
-        Tmp = ReadCHAR( pabyInput, nBitOffsetFromStart );
+        Tmp = ReadCHAR( oInput, nBitOffsetFromStart );
         blockHeader->adInsertCount.push_back( Tmp );
     } while( Tmp != 0 );
 
-    blockHeader->sBlockDescription  = ReadTV( pabyInput, nBitOffsetFromStart );
-    blockHeader->nSizeOfPreviewData = ReadBITLONG( pabyInput, nBitOffsetFromStart );
-    for( long i = 0; i < blockHeader->nSizeOfPreviewData; ++i )
-        blockHeader->abyBinaryPreviewData.push_back( ReadCHAR( pabyInput, nBitOffsetFromStart ) );
-
-    blockHeader->hBlockControl = ReadHANDLE( pabyInput, nBitOffsetFromStart );
-    for( long i = 0; i < blockHeader->nNumReactors; ++i )
-        blockHeader->hReactors.push_back( ReadHANDLE( pabyInput, nBitOffsetFromStart ) );
-    blockHeader->hXDictionary = ReadHANDLE( pabyInput, nBitOffsetFromStart );
-    blockHeader->hNull        = ReadHANDLE( pabyInput, nBitOffsetFromStart );
-    blockHeader->hBlockEntity = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+    blockHeader->sBlockDescription  = ReadTV( oInput, nBitOffsetFromStart );
+    blockHeader->nSizeOfPreviewData = ReadBITLONG( oInput, nBitOffsetFromStart );
+    for( long i = 0; i < blockHeader->nSizeOfPreviewData && !oInput.IsOverrun(); ++i )
+        blockHeader->abyBinaryPreviewData.push_back( ReadCHAR( oInput, nBitOffsetFromStart ) );
+
+    blockHeader->hBlockControl = ReadHANDLE( oInput, nBitOffsetFromStart );
+    for( long i = 0; i < blockHeader->nNumReactors && !oInput.IsOverrun(); ++i )
+        blockHeader->hReactors.push_back( ReadHANDLE( oInput, nBitOffsetFromStart ) );
+    blockHeader->hXDictionary = ReadHANDLE( oInput, nBitOffsetFromStart );
+    blockHeader->hNull        = ReadHANDLE( oInput, nBitOffsetFromStart );
+    blockHeader->hBlockEntity = ReadHANDLE( oInput, nBitOffsetFromStart );
     if( !blockHeader->bBlkisXRef && !blockHeader->bXRefOverlaid )
     {
-        blockHeader->hEntities.push_back( ReadHANDLE( pabyInput, nBitOffsetFromStart ) ); // first
-        blockHeader->hEntities.push_back( ReadHANDLE( pabyInput, nBitOffsetFromStart ) ); // last
+        blockHeader->hEntities.push_back( ReadHANDLE( oInput, nBitOffsetFromStart ) ); // first
+        blockHeader->hEntities.push_back( ReadHANDLE( oInput, nBitOffsetFromStart ) ); // last
     }
 
-    blockHeader->hEndBlk = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+    blockHeader->hEndBlk = ReadHANDLE( oInput, nBitOffsetFromStart );
     for( size_t i = 0; i < blockHeader->adInsertCount.size() - 1; ++i )
-        blockHeader->hInsertHandles.push_back( ReadHANDLE( pabyInput, nBitOffsetFromStart ) );
-    blockHeader->hLayout = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+        blockHeader->hInsertHandles.push_back( ReadHANDLE( oInput, nBitOffsetFromStart ) );
+    blockHeader->hLayout = ReadHANDLE( oInput, nBitOffsetFromStart );
 
-    nBitOffsetFromStart += 8 - ( nBitOffsetFromStart % 8 );
-    blockHeader->setCRC( ReadRAWSHORT( pabyInput, nBitOffsetFromStart ) );
+    AlignToByte( nBitOffsetFromStart );
+    blockHeader->setCRC( ReadRAWSHORT( oInput, nBitOffsetFromStart ) );
 #ifdef _DEBUG
-    if( ( nBitOffsetFromStart / 8 ) != ( dObjectSize + 4 ) )
+    if( ( nBitOffsetFromStart / 8 ) != oInput.GetSize() )
         DebugMsg( "Assertion failed at %d in %s\nSize difference: %d\n", __LINE__, __FILE__,
-                  ( nBitOffsetFromStart / 8 - dObjectSize - 4 ) );
+                  static_cast<int>( nBitOffsetFromStart / 8 - oInput.GetSize() ) );
 #endif //_DEBUG
     return blockHeader;
 }
 
-CADLineTypeControlObject * DWGFileR2000::getLineTypeControl( long dObjectSize, const char * pabyInput,
+CADLineTypeControlObject * DWGFileR2000::getLineTypeControl( long dObjectSize, const DWGBuffer& oInput,
                                                              size_t& nBitOffsetFromStart )
 {
     CADLineTypeControlObject * ltypeControl = new CADLineTypeControlObject();
     ltypeControl->setSize( dObjectSize );
-    ltypeControl->nObjectSizeInBits = ReadRAWLONG( pabyInput, nBitOffsetFromStart );
-    ltypeControl->hObjectHandle     = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+    ltypeControl->nObjectSizeInBits = ReadRAWLONG( oInput, nBitOffsetFromStart );
+    ltypeControl->hObjectHandle     = ReadHANDLE( oInput, nBitOffsetFromStart );
 
     short  dEEDSize = 0;
     CADEed dwgEed;
-    while( ( dEEDSize = ReadBITSHORT( pabyInput, nBitOffsetFromStart ) ) != 0 )
+    while( ( dEEDSize = ReadBITSHORT( oInput, nBitOffsetFromStart ) ) != 0 )
     {
         dwgEed.dLength      = dEEDSize;
-        dwgEed.hApplication = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+        dwgEed.hApplication = ReadHANDLE( oInput, nBitOffsetFromStart );
 
         for( short i = 0; i < dEEDSize; ++i )
         {
-            dwgEed.acData.push_back( ReadCHAR( pabyInput, nBitOffsetFromStart ) );
+            dwgEed.acData.push_back( ReadCHAR( oInput, nBitOffsetFromStart ) );
         }
 
         ltypeControl->aEED.push_back( dwgEed );
     }
 
-    ltypeControl->nNumReactors = ReadBITLONG( pabyInput, nBitOffsetFromStart );
-    ltypeControl->nNumEntries  = ReadBITLONG( pabyInput, nBitOffsetFromStart );
+    ltypeControl->nNumReactors = ReadBITLONG( oInput, nBitOffsetFromStart );
+    ltypeControl->nNumEntries  = ReadBITLONG( oInput, nBitOffsetFromStart );
 
-    ltypeControl->hNull        = ReadHANDLE( pabyInput, nBitOffsetFromStart );
-    ltypeControl->hXDictionary = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+    ltypeControl->hNull        = ReadHANDLE( oInput, nBitOffsetFromStart );
+    ltypeControl->hXDictionary = ReadHANDLE( oInput, nBitOffsetFromStart );
 
     // hLTypes ends with BYLAYER and BYBLOCK
-    for( long i = 0; i < ltypeControl->nNumEntries + 2; ++i )
-        ltypeControl->hLTypes.push_back( ReadHANDLE( pabyInput, nBitOffsetFromStart ) );
+    for( long i = 0; i < ltypeControl->nNumEntries + 2 && !oInput.IsOverrun(); ++i )
+        ltypeControl->hLTypes.push_back( ReadHANDLE( oInput, nBitOffsetFromStart ) );
 
-    nBitOffsetFromStart += 8 - ( nBitOffsetFromStart % 8 );
-    ltypeControl->setCRC( ReadRAWSHORT( pabyInput, nBitOffsetFromStart ) );
+    AlignToByte( nBitOffsetFromStart );
+    ltypeControl->setCRC( ReadRAWSHORT( oInput, nBitOffsetFromStart ) );
 
 #ifdef _DEBUG
-    if( ( nBitOffsetFromStart / 8 ) != ( dObjectSize + 4 ) )
+    if( ( nBitOffsetFromStart / 8 ) != oInput.GetSize() )
         DebugMsg( "Assertion failed at %d in %s\nSize difference: %d\n", __LINE__, __FILE__,
-                  ( nBitOffsetFromStart / 8 - dObjectSize - 4 ) );
+                  static_cast<int>( nBitOffsetFromStart / 8 - oInput.GetSize() ) );
 #endif //_DEBUG
     return ltypeControl;
 }
 
-CADLineTypeObject * DWGFileR2000::getLineType1( long dObjectSize, const char * pabyInput, size_t& nBitOffsetFromStart )
+CADLineTypeObject * DWGFileR2000::getLineType1( long dObjectSize, const DWGBuffer& oInput, size_t& nBitOffsetFromStart )
 {
     CADLineTypeObject * ltype = new CADLineTypeObject();
 
     ltype->setSize( dObjectSize );
-    ltype->nObjectSizeInBits = ReadRAWLONG( pabyInput, nBitOffsetFromStart );
-    ltype->hObjectHandle     = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+    ltype->nObjectSizeInBits = ReadRAWLONG( oInput, nBitOffsetFromStart );
+    ltype->hObjectHandle     = ReadHANDLE( oInput, nBitOffsetFromStart );
     short  dEEDSize = 0;
     CADEed dwgEed;
-    while( ( dEEDSize = ReadBITSHORT( pabyInput, nBitOffsetFromStart ) ) != 0 )
+    while( ( dEEDSize = ReadBITSHORT( oInput, nBitOffsetFromStart ) ) != 0 )
     {
         dwgEed.dLength      = dEEDSize;
-        dwgEed.hApplication = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+        dwgEed.hApplication = ReadHANDLE( oInput, nBitOffsetFromStart );
 
         for( short i = 0; i < dEEDSize; ++i )
         {
-            dwgEed.acData.push_back( ReadCHAR( pabyInput, nBitOffsetFromStart ) );
+            dwgEed.acData.push_back( ReadCHAR( oInput, nBitOffsetFromStart ) );
         }
 
         ltype->aEED.push_back( dwgEed );
     }
 
-    ltype->nNumReactors = ReadBITLONG( pabyInput, nBitOffsetFromStart );
-    ltype->sEntryName   = ReadTV( pabyInput, nBitOffsetFromStart );
-    ltype->b64Flag      = ReadBIT( pabyInput, nBitOffsetFromStart );
-    ltype->dXRefIndex   = ReadBITSHORT( pabyInput, nBitOffsetFromStart );
-    ltype->bXDep        = ReadBIT( pabyInput, nBitOffsetFromStart );
-    ltype->sDescription = ReadTV( pabyInput, nBitOffsetFromStart );
-    ltype->dfPatternLen = ReadBITDOUBLE( pabyInput, nBitOffsetFromStart );
-    ltype->dAlignment   = ReadCHAR( pabyInput, nBitOffsetFromStart );
-    ltype->nNumDashes   = ReadCHAR( pabyInput, nBitOffsetFromStart );
+    ltype->nNumReactors = ReadBITLONG( oInput, nBitOffsetFromStart );
+    ltype->sEntryName   = ReadTV( oInput, nBitOffsetFromStart );
+    ltype->b64Flag      = ReadBIT( oInput, nBitOffsetFromStart );
+    ltype->dXRefIndex   = ReadBITSHORT( oInput, nBitOffsetFromStart );
+    ltype->bXDep        = ReadBIT( oInput, nBitOffsetFromStart );
+    ltype->sDescription = ReadTV( oInput, nBitOffsetFromStart );
+    ltype->dfPatternLen = ReadBITDOUBLE( oInput, nBitOffsetFromStart );
+    ltype->dAlignment   = ReadCHAR( oInput, nBitOffsetFromStart );
+    ltype->nNumDashes   = ReadCHAR( oInput, nBitOffsetFromStart );
 
     CADDash     dash;
-    for( size_t i       = 0; i < ltype->nNumDashes; ++i )
+    for( size_t i       = 0; i < ltype->nNumDashes && !oInput.IsOverrun(); ++i )
     {
-        dash.dfLength          = ReadBITDOUBLE( pabyInput, nBitOffsetFromStart );
-        dash.dComplexShapecode = ReadBITSHORT( pabyInput, nBitOffsetFromStart );
-        dash.dfXOffset         = ReadRAWDOUBLE( pabyInput, nBitOffsetFromStart );
-        dash.dfYOffset         = ReadRAWDOUBLE( pabyInput, nBitOffsetFromStart );
-        dash.dfScale           = ReadBITDOUBLE( pabyInput, nBitOffsetFromStart );
-        dash.dfRotation        = ReadBITDOUBLE( pabyInput, nBitOffsetFromStart );
-        dash.dShapeflag        = ReadBITSHORT( pabyInput, nBitOffsetFromStart ); // TODO: what to do with it?
+        dash.dfLength          = ReadBITDOUBLE( oInput, nBitOffsetFromStart );
+        dash.dComplexShapecode = ReadBITSHORT( oInput, nBitOffsetFromStart );
+        dash.dfXOffset         = ReadRAWDOUBLE( oInput, nBitOffsetFromStart );
+        dash.dfYOffset         = ReadRAWDOUBLE( oInput, nBitOffsetFromStart );
+        dash.dfScale           = ReadBITDOUBLE( oInput, nBitOffsetFromStart );
+        dash.dfRotation        = ReadBITDOUBLE( oInput, nBitOffsetFromStart );
+        dash.dShapeflag        = ReadBITSHORT( oInput, nBitOffsetFromStart ); // TODO: what to do with it?
 
         ltype->astDashes.push_back( dash );
     }
 
     for( short i = 0; i < 256; ++i )
-        ltype->abyTextArea.push_back( ReadCHAR( pabyInput, nBitOffsetFromStart ) );
+        ltype->abyTextArea.push_back( ReadCHAR( oInput, nBitOffsetFromStart ) );
 
-    ltype->hLTControl = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+    ltype->hLTControl = ReadHANDLE( oInput, nBitOffsetFromStart );
 
-    for( long i = 0; i < ltype->nNumReactors; ++i )
-        ltype->hReactors.push_back( ReadHANDLE( pabyInput, nBitOffsetFromStart ) );
+    for( long i = 0; i < ltype->nNumReactors && !oInput.IsOverrun(); ++i )
+        ltype->hReactors.push_back( ReadHANDLE( oInput, nBitOffsetFromStart ) );
 
-    ltype->hXDictionary = ReadHANDLE( pabyInput, nBitOffsetFromStart );
-    ltype->hXRefBlock   = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+    ltype->hXDictionary = ReadHANDLE( oInput, nBitOffsetFromStart );
+    ltype->hXRefBlock   = ReadHANDLE( oInput, nBitOffsetFromStart );
 
     // TODO: shapefile for dash/shape (1 each). Does it mean that we have nNumDashes * 2 handles, or what?
 
-    nBitOffsetFromStart += 8 - ( nBitOffsetFromStart % 8 );
-    ltype->setCRC( ReadRAWSHORT( pabyInput, nBitOffsetFromStart ) );
+    AlignToByte( nBitOffsetFromStart );
+    ltype->setCRC( ReadRAWSHORT( oInput, nBitOffsetFromStart ) );
 #ifdef _DEBUG
-    if( ( nBitOffsetFromStart / 8 ) != ( dObjectSize + 4 ) )
+    if( ( nBitOffsetFromStart / 8 ) != oInput.GetSize() )
         DebugMsg( "[NOT IMPORTANT, CAUSE NOT IMPLEMENTATION NOT COMPLETED] "
                           "Assertion failed at %d in %s\nSize difference: %d\n", __LINE__, __FILE__,
-                  ( nBitOffsetFromStart / 8 - dObjectSize - 4 ) );
+                  static_cast<int>( nBitOffsetFromStart / 8 - oInput.GetSize() ) );
 #endif //_DEBUG
     return ltype;
 }
 
-CADMLineObject * DWGFileR2000::getMLine( long dObjectSize, CADCommonED stCommonEntityData, const char * pabyInput,
+CADMLineObject * DWGFileR2000::getMLine( long dObjectSize, CADCommonED stCommonEntityData, const DWGBuffer& oInput,
                                          size_t& nBitOffsetFromStart )
 {
     CADMLineObject * mline = new CADMLineObject();
@@ -3039,38 +3355,38 @@ CADMLineObject * DWGFileR2000::getMLine( long dObjectSize, CADCommonED stCommonE
     mline->setSize( dObjectSize );
     mline->stCed = stCommonEntityData;
 
-    mline->dfScale = ReadBITDOUBLE( pabyInput, nBitOffsetFromStart );
-    mline->dJust   = ReadCHAR( pabyInput, nBitOffsetFromStart );
+    mline->dfScale = ReadBITDOUBLE( oInput, nBitOffsetFromStart );
+    mline->dJust   = ReadCHAR( oInput, nBitOffsetFromStart );
 
-    CADVector vertBasePoint = ReadVector( pabyInput, nBitOffsetFromStart );
+    CADVector vertBasePoint = ReadVector( oInput, nBitOffsetFromStart );
     mline->vertBasePoint = vertBasePoint;
 
-    CADVector vectExtrusion = ReadVector( pabyInput, nBitOffsetFromStart );
+    CADVector vectExtrusion = ReadVector( oInput, nBitOffsetFromStart );
     mline->vectExtrusion = vectExtrusion;
-    mline->dOpenClosed   = ReadBITSHORT( pabyInput, nBitOffsetFromStart );
-    mline->nLinesInStyle = ReadCHAR( pabyInput, nBitOffsetFromStart );
-    mline->nNumVertexes  = ReadBITSHORT( pabyInput, nBitOffsetFromStart );
+    mline->dOpenClosed   = ReadBITSHORT( oInput, nBitOffsetFromStart );
+    mline->nLinesInStyle = ReadCHAR( oInput, nBitOffsetFromStart );
+    mline->nNumVertexes  = ReadBITSHORT( oInput, nBitOffsetFromStart );
 
     CADMLineVertex stVertex;
     CADLineStyle   stLStyle;
-    for( long      i     = 0; i < mline->nNumVertexes; ++i )
+    for( long      i     = 0; i < mline->nNumVertexes && !oInput.IsOverrun(); ++i )
     {
-        CADVector vertPosition = ReadVector( pabyInput, nBitOffsetFromStart );
+        CADVector vertPosition = ReadVector( oInput, nBitOffsetFromStart );
         stVertex.vertPosition = vertPosition;
 
-        CADVector vectDirection = ReadVector( pabyInput, nBitOffsetFromStart );
+        CADVector vectDirection = ReadVector( oInput, nBitOffsetFromStart );
         stVertex.vectDirection = vectDirection;
 
-        CADVector vectMIterDirection = ReadVector( pabyInput, nBitOffsetFromStart );
+        CADVector vectMIterDirection = ReadVector( oInput, nBitOffsetFromStart );
         stVertex.vectMIterDirection = vectMIterDirection;
-        for( size_t j = 0; j < mline->nLinesInStyle; ++j )
+        for( size_t j = 0; j < mline->nLinesInStyle && !oInput.IsOverrun(); ++j )
         {
-            stLStyle.nNumSegParms = ReadBITSHORT( pabyInput, nBitOffsetFromStart );
+            stLStyle.nNumSegParms = ReadBITSHORT( oInput, nBitOffsetFromStart );
             for( short k = 0; k < stLStyle.nNumSegParms; ++k )
-                stLStyle.adfSegparms.push_back( ReadBITDOUBLE( pabyInput, nBitOffsetFromStart ) );
-            stLStyle.nAreaFillParms = ReadBITSHORT( pabyInput, nBitOffsetFromStart );
+                stLStyle.adfSegparms.push_back( ReadBITDOUBLE( oInput, nBitOffsetFromStart ) );
+            stLStyle.nAreaFillParms = ReadBITSHORT( oInput, nBitOffsetFromStart );
             for( short k = 0; k < stLStyle.nAreaFillParms; ++k )
-                stLStyle.adfAreaFillParameters.push_back( ReadBITDOUBLE( pabyInput, nBitOffsetFromStart ) );
+                stLStyle.adfAreaFillParameters.push_back( ReadBITDOUBLE( oInput, nBitOffsetFromStart ) );
 
             stVertex.astLStyles.push_back( stLStyle );
         }
@@ -3078,68 +3394,68 @@ CADMLineObject * DWGFileR2000::getMLine( long dObjectSize, CADCommonED stCommonE
     }
 
     if( mline->stCed.bbEntMode == 0 )
-        mline->stChed.hOwner = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+        mline->stChed.hOwner = ReadHANDLE( oInput, nBitOffsetFromStart );
 
-    for( long i = 0; i < mline->stCed.nNumReactors; ++i )
-        mline->stChed.hReactors.push_back( ReadHANDLE( pabyInput, nBitOffsetFromStart ) );
+    for( long i = 0; i < mline->stCed.nNumReactors && !oInput.IsOverrun(); ++i )
+        mline->stChed.hReactors.push_back( ReadHANDLE( oInput, nBitOffsetFromStart ) );
 
-    mline->stChed.hXDictionary = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+    mline->stChed.hXDictionary = ReadHANDLE( oInput, nBitOffsetFromStart );
 
     if( !mline->stCed.bNoLinks )
     {
-        mline->stChed.hPrevEntity = ReadHANDLE( pabyInput, nBitOffsetFromStart );
-        mline->stChed.hNextEntity = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+        mline->stChed.hPrevEntity = ReadHANDLE( oInput, nBitOffsetFromStart );
+        mline->stChed.hNextEntity = ReadHANDLE( oInput, nBitOffsetFromStart );
     }
 
-    mline->stChed.hLayer = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+    mline->stChed.hLayer = ReadHANDLE( oInput, nBitOffsetFromStart );
 
     if( mline->stCed.bbLTypeFlags == 0x03 )
-        mline->stChed.hLType = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+        mline->stChed.hLType = ReadHANDLE( oInput, nBitOffsetFromStart );
 
     if( mline->stCed.bbPlotStyleFlags == 0x03 )
-        mline->stChed.hPlotStyle = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+        mline->stChed.hPlotStyle = ReadHANDLE( oInput, nBitOffsetFromStart );
 
-    nBitOffsetFromStart += 8 - ( nBitOffsetFromStart % 8 );
-    mline->setCRC( ReadRAWSHORT( pabyInput, nBitOffsetFromStart ) );
+    AlignToByte( nBitOffsetFromStart );
+    mline->setCRC( ReadRAWSHORT( oInput, nBitOffsetFromStart ) );
 
 #ifdef _DEBUG
-    if( ( nBitOffsetFromStart / 8 ) != ( dObjectSize + 4 ) )
+    if( ( nBitOffsetFromStart / 8 ) != oInput.GetSize() )
         DebugMsg( "Assertion failed at %d in %s\nSize difference: %d\n", __LINE__, __FILE__,
-                  ( nBitOffsetFromStart / 8 - dObjectSize - 4 ) );
+                  static_cast<int>( nBitOffsetFromStart / 8 - oInput.GetSize() ) );
 #endif //_DEBUG
     return mline;
 }
 
 CADPolylinePFaceObject * DWGFileR2000::getPolylinePFace( long dObjectSize, CADCommonED stCommonEntityData,
-                                                         const char * pabyInput, size_t& nBitOffsetFromStart )
+                                                         const DWGBuffer& oInput, size_t& nBitOffsetFromStart )
 {
     CADPolylinePFaceObject * polyline = new CADPolylinePFaceObject();
 
     polyline->setSize( dObjectSize );
     polyline->stCed = stCommonEntityData;
 
-    polyline->nNumVertexes = ReadBITSHORT( pabyInput, nBitOffsetFromStart );
-    polyline->nNumFaces    = ReadBITSHORT( pabyInput, nBitOffsetFromStart );
+    polyline->nNumVertexes = ReadBITSHORT( oInput, nBitOffsetFromStart );
+    polyline->nNumFaces    = ReadBITSHORT( oInput, nBitOffsetFromStart );
 
-    fillCommonEntityHandleData( polyline, pabyInput, nBitOffsetFromStart );
+    fillCommonEntityHandleData( polyline, oInput, nBitOffsetFromStart );
 
-    polyline->hVertexes.push_back( ReadHANDLE( pabyInput, nBitOffsetFromStart ) ); // 1st vertex
-    polyline->hVertexes.push_back( ReadHANDLE( pabyInput, nBitOffsetFromStart ) ); // last vertex
+    polyline->hVertexes.push_back( ReadHANDLE( oInput, nBitOffsetFromStart ) ); // 1st vertex
+    polyline->hVertexes.push_back( ReadHANDLE( oInput, nBitOffsetFromStart ) ); // last vertex
 
-    polyline->hSeqend = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+    polyline->hSeqend = ReadHANDLE( oInput, nBitOffsetFromStart );
 
-    nBitOffsetFromStart += 8 - ( nBitOffsetFromStart % 8 ); // padding bits to next byte boundary
-    polyline->setCRC( ReadRAWSHORT( pabyInput, nBitOffsetFromStart ) );
+    AlignToByte( nBitOffsetFromStart ); // padding bits to next byte boundary
+    polyline->setCRC( ReadRAWSHORT( oInput, nBitOffsetFromStart ) );
 
 #ifdef _DEBUG
-    if( ( nBitOffsetFromStart / 8 ) != ( dObjectSize + 4 ) )
+    if( ( nBitOffsetFromStart / 8 ) != oInput.GetSize() )
         DebugMsg( "Assertion failed at %d in %s\nSize difference: %d\n", __LINE__, __FILE__,
-                  ( nBitOffsetFromStart / 8 - dObjectSize - 4 ) );
+                  static_cast<int>( nBitOffsetFromStart / 8 - oInput.GetSize() ) );
 #endif //_DEBUG
     return polyline;
 }
 
-CADImageObject * DWGFileR2000::getImage( long dObjectSize, CADCommonED stCommonEntityData, const char * pabyInput,
+CADImageObject * DWGFileR2000::getImage( long dObjectSize, CADCommonED stCommonEntityData, const DWGBuffer& oInput,
                                          size_t& nBitOffsetFromStart )
 {
     CADImageObject * image = new CADImageObject();
@@ -3147,63 +3463,63 @@ CADImageObject * DWGFileR2000::getImage( long dObjectSize, CADCommonED stCommonE
     image->setSize( dObjectSize );
     image->stCed = stCommonEntityData;
 
-    image->dClassVersion = ReadBITLONG( pabyInput, nBitOffsetFromStart );
+    image->dClassVersion = ReadBITLONG( oInput, nBitOffsetFromStart );
 
-    CADVector vertInsertion = ReadVector( pabyInput, nBitOffsetFromStart );
+    CADVector vertInsertion = ReadVector( oInput, nBitOffsetFromStart );
     image->vertInsertion = vertInsertion;
 
-    CADVector vectUDirection = ReadVector( pabyInput, nBitOffsetFromStart );
+    CADVector vectUDirection = ReadVector( oInput, nBitOffsetFromStart );
     image->vectUDirection = vectUDirection;
 
-    CADVector vectVDirection = ReadVector( pabyInput, nBitOffsetFromStart );
+    CADVector vectVDirection = ReadVector( oInput, nBitOffsetFromStart );
     image->vectVDirection = vectVDirection;
 
-    image->dfSizeX       = ReadRAWDOUBLE( pabyInput, nBitOffsetFromStart );
-    image->dfSizeY       = ReadRAWDOUBLE( pabyInput, nBitOffsetFromStart );
-    image->dDisplayProps = ReadBITSHORT( pabyInput, nBitOffsetFromStart );
+    image->dfSizeX       = ReadRAWDOUBLE( oInput, nBitOffsetFromStart );
+    image->dfSizeY       = ReadRAWDOUBLE( oInput, nBitOffsetFromStart );
+    image->dDisplayProps = ReadBITSHORT( oInput, nBitOffsetFromStart );
 
-    image->bClipping         = ReadBIT( pabyInput, nBitOffsetFromStart );
-    image->dBrightness       = ReadCHAR( pabyInput, nBitOffsetFromStart );
-    image->dContrast         = ReadCHAR( pabyInput, nBitOffsetFromStart );
-    image->dFade             = ReadCHAR( pabyInput, nBitOffsetFromStart );
-    image->dClipBoundaryType = ReadBITSHORT( pabyInput, nBitOffsetFromStart );
+    image->bClipping         = ReadBIT( oInput, nBitOffsetFromStart );
+    image->dBrightness       = ReadCHAR( oInput, nBitOffsetFromStart );
+    image->dContrast         = ReadCHAR( oInput, nBitOffsetFromStart );
+    image->dFade             = ReadCHAR( oInput, nBitOffsetFromStart );
+    image->dClipBoundaryType = ReadBITSHORT( oInput, nBitOffsetFromStart );
 
     if( image->dClipBoundaryType == 1 )
     {
-        CADVector vertPoint1 = ReadRAWVector( pabyInput, nBitOffsetFromStart );
+        CADVector vertPoint1 = ReadRAWVector( oInput, nBitOffsetFromStart );
         image->avertClippingPolygonVertexes.push_back( vertPoint1 );
 
-        CADVector vertPoint2 = ReadRAWVector( pabyInput, nBitOffsetFromStart );
+        CADVector vertPoint2 = ReadRAWVector( oInput, nBitOffsetFromStart );
         image->avertClippingPolygonVertexes.push_back( vertPoint2 );
     } else
     {
-        image->nNumberVertexesInClipPolygon = ReadBITLONG( pabyInput, nBitOffsetFromStart );
+        image->nNumberVertexesInClipPolygon = ReadBITLONG( oInput, nBitOffsetFromStart );
 
-        for( long i = 0; i < image->nNumberVertexesInClipPolygon; ++i )
+        for( long i = 0; i < image->nNumberVertexesInClipPolygon && !oInput.IsOverrun(); ++i )
         {
-            CADVector vertPoint = ReadRAWVector( pabyInput, nBitOffsetFromStart );
+            CADVector vertPoint = ReadRAWVector( oInput, nBitOffsetFromStart );
             image->avertClippingPolygonVertexes.push_back( vertPoint );
         }
     }
 
-    fillCommonEntityHandleData( image, pabyInput, nBitOffsetFromStart );
+    fillCommonEntityHandleData( image, oInput, nBitOffsetFromStart );
 
-    image->hImageDef        = ReadHANDLE( pabyInput, nBitOffsetFromStart );
-    image->hImageDefReactor = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+    image->hImageDef        = ReadHANDLE( oInput, nBitOffsetFromStart );
+    image->hImageDefReactor = ReadHANDLE( oInput, nBitOffsetFromStart );
 
-    nBitOffsetFromStart += 8 - ( nBitOffsetFromStart % 8 ); // padding bits to next byte boundary
-    image->setCRC( ReadRAWSHORT( pabyInput, nBitOffsetFromStart ) );
+    AlignToByte( nBitOffsetFromStart ); // padding bits to next byte boundary
+    image->setCRC( ReadRAWSHORT( oInput, nBitOffsetFromStart ) );
 
 #ifdef _DEBUG
-    if( ( nBitOffsetFromStart / 8 ) != ( dObjectSize + 4 ) )
+    if( ( nBitOffsetFromStart / 8 ) != oInput.GetSize() )
         DebugMsg( "Assertion failed at %d in %s\nSize difference: %d\n", __LINE__, __FILE__,
-                  ( nBitOffsetFromStart / 8 - dObjectSize - 4 ) );
+                  static_cast<int>( nBitOffsetFromStart / 8 - oInput.GetSize() ) );
 #endif //_DEBUG
 
     return image;
 }
 
-CAD3DFaceObject * DWGFileR2000::get3DFace( long dObjectSize, CADCommonED stCommonEntityData, const char * pabyInput,
+CAD3DFaceObject * DWGFileR2000::get3DFace( long dObjectSize, CADCommonED stCommonEntityData, const DWGBuffer& oInput,
                                            size_t& nBitOffsetFromStart )
 {
     CAD3DFaceObject * face = new CAD3DFaceObject();
@@ -3211,94 +3527,94 @@ CAD3DFaceObject * DWGFileR2000::get3DFace( long dObjectSize, CADCommonED stCommo
     face->setSize( dObjectSize );
     face->stCed = stCommonEntityData;
 
-    face->bHasNoFlagInd = ReadBIT( pabyInput, nBitOffsetFromStart );
-    face->bZZero        = ReadBIT( pabyInput, nBitOffsetFromStart );
+    face->bHasNoFlagInd = ReadBIT( oInput, nBitOffsetFromStart );
+    face->bZZero        = ReadBIT( oInput, nBitOffsetFromStart );
 
     double x, y, z;
 
-    CADVector vertex = ReadRAWVector( pabyInput, nBitOffsetFromStart );
+    CADVector vertex = ReadRAWVector( oInput, nBitOffsetFromStart );
     if( !face->bZZero )
     {
-        z = ReadRAWDOUBLE( pabyInput, nBitOffsetFromStart );
+        z = ReadRAWDOUBLE( oInput, nBitOffsetFromStart );
         vertex.setZ( z );
     }
     face->avertCorners.push_back( vertex );
     for( size_t i = 1; i < 4; ++i )
     {
-        x = ReadBITDOUBLEWD( pabyInput, nBitOffsetFromStart, face->avertCorners[i - 1].getX() );
-        y = ReadBITDOUBLEWD( pabyInput, nBitOffsetFromStart, face->avertCorners[i - 1].getY() );
-        z = ReadBITDOUBLEWD( pabyInput, nBitOffsetFromStart, face->avertCorners[i - 1].getZ() );
+        x = ReadBITDOUBLEWD( oInput, nBitOffsetFromStart, face->avertCorners[i - 1].getX() );
+        y = ReadBITDOUBLEWD( oInput, nBitOffsetFromStart, face->avertCorners[i - 1].getY() );
+        z = ReadBITDOUBLEWD( oInput, nBitOffsetFromStart, face->avertCorners[i - 1].getZ() );
 
         CADVector corner( x, y, z );
         face->avertCorners.push_back( corner );
     }
 
     if( !face->bHasNoFlagInd )
-        face->dInvisFlags = ReadBITSHORT( pabyInput, nBitOffsetFromStart );
+        face->dInvisFlags = ReadBITSHORT( oInput, nBitOffsetFromStart );
 
-    fillCommonEntityHandleData( face, pabyInput, nBitOffsetFromStart );
+    fillCommonEntityHandleData( face, oInput, nBitOffsetFromStart );
 
-    nBitOffsetFromStart += 8 - ( nBitOffsetFromStart % 8 ); // padding bits to next byte boundary
-    face->setCRC( ReadRAWSHORT( pabyInput, nBitOffsetFromStart ) );
+    AlignToByte( nBitOffsetFromStart ); // padding bits to next byte boundary
+    face->setCRC( ReadRAWSHORT( oInput, nBitOffsetFromStart ) );
 
 #ifdef _DEBUG
-    if( ( nBitOffsetFromStart / 8 ) != ( dObjectSize + 4 ) )
+    if( ( nBitOffsetFromStart / 8 ) != oInput.GetSize() )
         DebugMsg( "Assertion failed at %d in %s\nSize difference: %d\n", __LINE__, __FILE__,
-                  ( nBitOffsetFromStart / 8 - dObjectSize - 4 ) );
+                  static_cast<int>( nBitOffsetFromStart / 8 - oInput.GetSize() ) );
 #endif //_DEBUG
     return face;
 }
 
 CADVertexMeshObject * DWGFileR2000::getVertexMesh( long dObjectSize, CADCommonED stCommonEntityData,
-                                                   const char * pabyInput, size_t& nBitOffsetFromStart )
+                                                   const DWGBuffer& oInput, size_t& nBitOffsetFromStart )
 {
     CADVertexMeshObject * vertex = new CADVertexMeshObject();
 
     vertex->setSize( dObjectSize );
     vertex->stCed = stCommonEntityData;
 
-    /*unsigned char Flags = */ReadCHAR( pabyInput, nBitOffsetFromStart );
-    CADVector vertPosition = ReadVector( pabyInput, nBitOffsetFromStart );
+    /*unsigned char Flags = */ReadCHAR( oInput, nBitOffsetFromStart );
+    CADVector vertPosition = ReadVector( oInput, nBitOffsetFromStart );
     vertex->vertPosition = vertPosition;
 
-    fillCommonEntityHandleData( vertex, pabyInput, nBitOffsetFromStart );
+    fillCommonEntityHandleData( vertex, oInput, nBitOffsetFromStart );
 
-    nBitOffsetFromStart += 8 - ( nBitOffsetFromStart % 8 ); // padding bits to next byte boundary
-    vertex->setCRC( ReadRAWSHORT( pabyInput, nBitOffsetFromStart ) );
+    AlignToByte( nBitOffsetFromStart ); // padding bits to next byte boundary
+    vertex->setCRC( ReadRAWSHORT( oInput, nBitOffsetFromStart ) );
 
 #ifdef _DEBUG
-    if( ( nBitOffsetFromStart / 8 ) != ( dObjectSize + 4 ) )
+    if( ( nBitOffsetFromStart / 8 ) != oInput.GetSize() )
         DebugMsg( "Assertion failed at %d in %s\nSize difference: %d\n", __LINE__, __FILE__,
-                  ( nBitOffsetFromStart / 8 - dObjectSize - 4 ) );
+                  static_cast<int>( nBitOffsetFromStart / 8 - oInput.GetSize() ) );
 #endif
     return vertex;
 }
 
 CADVertexPFaceObject * DWGFileR2000::getVertexPFace( long dObjectSize, CADCommonED stCommonEntityData,
-                                                     const char * pabyInput, size_t& nBitOffsetFromStart )
+                                                     const DWGBuffer& oInput, size_t& nBitOffsetFromStart )
 {
     CADVertexPFaceObject * vertex = new CADVertexPFaceObject();
 
     vertex->setSize( dObjectSize );
     vertex->stCed = stCommonEntityData;
 
-    /*unsigned char Flags = */ReadCHAR( pabyInput, nBitOffsetFromStart );
-    CADVector vertPosition = ReadVector( pabyInput, nBitOffsetFromStart );
+    /*unsigned char Flags = */ReadCHAR( oInput, nBitOffsetFromStart );
+    CADVector vertPosition = ReadVector( oInput, nBitOffsetFromStart );
     vertex->vertPosition = vertPosition;
 
-    fillCommonEntityHandleData( vertex, pabyInput, nBitOffsetFromStart );
+    fillCommonEntityHandleData( vertex, oInput, nBitOffsetFromStart );
 
-    nBitOffsetFromStart += 8 - ( nBitOffsetFromStart % 8 ); // padding bits to next byte boundary
-    vertex->setCRC( ReadRAWSHORT( pabyInput, nBitOffsetFromStart ) );
+    AlignToByte( nBitOffsetFromStart ); // padding bits to next byte boundary
+    vertex->setCRC( ReadRAWSHORT( oInput, nBitOffsetFromStart ) );
 #ifdef _DEBUG
-    if( ( nBitOffsetFromStart / 8 ) != ( dObjectSize + 4 ) )
+    if( ( nBitOffsetFromStart / 8 ) != oInput.GetSize() )
         DebugMsg( "Assertion failed at %d in %s\nSize difference: %d\n", __LINE__, __FILE__,
-                  ( nBitOffsetFromStart / 8 - dObjectSize - 4 ) );
+                  static_cast<int>( nBitOffsetFromStart / 8 - oInput.GetSize() ) );
 #endif
     return vertex;
 }
 
-CADMTextObject * DWGFileR2000::getMText( long dObjectSize, CADCommonED stCommonEntityData, const char * pabyInput,
+CADMTextObject * DWGFileR2000::getMText( long dObjectSize, CADCommonED stCommonEntityData, const DWGBuffer& oInput,
                                          size_t& nBitOffsetFromStart )
 {
     CADMTextObject * text = new CADMTextObject();
@@ -3306,67 +3622,67 @@ CADMTextObject * DWGFileR2000::getMText( long dObjectSize, CADCommonED stCommonE
     text->setSize( dObjectSize );
     text->stCed = stCommonEntityData;
 
-    CADVector vertInsertionPoint = ReadVector( pabyInput, nBitOffsetFromStart );
+    CADVector vertInsertionPoint = ReadVector( oInput, nBitOffsetFromStart );
     text->vertInsertionPoint = vertInsertionPoint;
 
-    CADVector vectExtrusion = ReadVector( pabyInput, nBitOffsetFromStart );
+    CADVector vectExtrusion = ReadVector( oInput, nBitOffsetFromStart );
     text->vectExtrusion = vectExtrusion;
 
-    CADVector vectXAxisDir = ReadVector( pabyInput, nBitOffsetFromStart );
+    CADVector vectXAxisDir = ReadVector( oInput, nBitOffsetFromStart );
     text->vectXAxisDir = vectXAxisDir;
 
-    text->dfRectWidth        = ReadBITDOUBLE( pabyInput, nBitOffsetFromStart );
-    text->dfTextHeight       = ReadBITDOUBLE( pabyInput, nBitOffsetFromStart );
-    text->dAttachment        = ReadBITSHORT( pabyInput, nBitOffsetFromStart );
-    text->dDrawingDir        = ReadBITSHORT( pabyInput, nBitOffsetFromStart );
-    text->dfExtents          = ReadBITDOUBLE( pabyInput, nBitOffsetFromStart );
-    text->dfExtentsWidth     = ReadBITDOUBLE( pabyInput, nBitOffsetFromStart );
-    text->sTextValue         = ReadTV( pabyInput, nBitOffsetFromStart );
-    text->dLineSpacingStyle  = ReadBITSHORT( pabyInput, nBitOffsetFromStart );
-    text->dLineSpacingFactor = ReadBITDOUBLE( pabyInput, nBitOffsetFromStart );
-    text->bUnknownBit        = ReadBIT( pabyInput, nBitOffsetFromStart );
-
-    fillCommonEntityHandleData( text, pabyInput, nBitOffsetFromStart );
-
-    nBitOffsetFromStart += 8 - ( nBitOffsetFromStart % 8 );
-    text->setCRC( ReadRAWSHORT( pabyInput, nBitOffsetFromStart ) );
+    text->dfRectWidth        = ReadBITDOUBLE( oInput, nBitOffsetFromStart );
+    text->dfTextHeight       = ReadBITDOUBLE( oInput, nBitOffsetFromStart );
+    text->dAttachment        = ReadBITSHORT( oInput, nBitOffsetFromStart );
+    text->dDrawingDir        = ReadBITSHORT( oInput, nBitOffsetFromStart );
+    text->dfExtents          = ReadBITDOUBLE( oInput, nBitOffsetFromStart );
+    text->dfExtentsWidth     = ReadBITDOUBLE( oInput, nBitOffsetFromStart );
+    text->sTextValue         = ReadTV( oInput, nBitOffsetFromStart );
+    text->dLineSpacingStyle  = ReadBITSHORT( oInput, nBitOffsetFromStart );
+    text->dLineSpacingFactor = ReadBITDOUBLE( oInput, nBitOffsetFromStart );
+    text->bUnknownBit        = ReadBIT( oInput, nBitOffsetFromStart );
+
+    fillCommonEntityHandleData( text, oInput, nBitOffsetFromStart );
+
+    AlignToByte( nBitOffsetFromStart );
+    text->setCRC( ReadRAWSHORT( oInput, nBitOffsetFromStart ) );
 #ifdef _DEBUG
-    if( ( nBitOffsetFromStart / 8 ) != ( dObjectSize + 4 ) )
+    if( ( nBitOffsetFromStart / 8 ) != oInput.GetSize() )
         DebugMsg( "Assertion failed at %d in %s\nSize difference: %d\n", __LINE__, __FILE__,
-                  ( nBitOffsetFromStart / 8 - dObjectSize - 4 ) );
+                  static_cast<int>( nBitOffsetFromStart / 8 - oInput.GetSize() ) );
 #endif
     return text;
 }
 
 CADDimensionObject * DWGFileR2000::getDimension( short dObjectType, long dObjectSize, CADCommonED stCommonEntityData,
-                                                 const char * pabyInput, size_t& nBitOffsetFromStart )
+                                                 const DWGBuffer& oInput, size_t& nBitOffsetFromStart )
 {
     CADCommonDimensionData stCDD;
 
-    CADVector vectExtrusion = ReadVector( pabyInput, nBitOffsetFromStart );
+    CADVector vectExtrusion = ReadVector( oInput, nBitOffsetFromStart );
     stCDD.vectExtrusion = vectExtrusion;
 
-    CADVector vertTextMidPt = ReadRAWVector( pabyInput, nBitOffsetFromStart );
+    CADVector vertTextMidPt = ReadRAWVector( oInput, nBitOffsetFromStart );
     stCDD.vertTextMidPt = vertTextMidPt;
 
-    stCDD.dfElevation = ReadBITDOUBLE( pabyInput, nBitOffsetFromStart );
-    stCDD.dFlags      = ReadCHAR( pabyInput, nBitOffsetFromStart );
+    stCDD.dfElevation = ReadBITDOUBLE( oInput, nBitOffsetFromStart );
+    stCDD.dFlags      = ReadCHAR( oInput, nBitOffsetFromStart );
 
-    stCDD.sUserText      = ReadTV( pabyInput, nBitOffsetFromStart );
-    stCDD.dfTextRotation = ReadBITDOUBLE( pabyInput, nBitOffsetFromStart );
-    stCDD.dfHorizDir     = ReadBITDOUBLE( pabyInput, nBitOffsetFromStart );
+    stCDD.sUserText      = ReadTV( oInput, nBitOffsetFromStart );
+    stCDD.dfTextRotation = ReadBITDOUBLE( oInput, nBitOffsetFromStart );
+    stCDD.dfHorizDir     = ReadBITDOUBLE( oInput, nBitOffsetFromStart );
 
-    stCDD.dfInsXScale   = ReadBITDOUBLE( pabyInput, nBitOffsetFromStart );
-    stCDD.dfInsYScale   = ReadBITDOUBLE( pabyInput, nBitOffsetFromStart );
-    stCDD.dfInsZScale   = ReadBITDOUBLE( pabyInput, nBitOffsetFromStart );
-    stCDD.dfInsRotation = ReadBITDOUBLE( pabyInput, nBitOffsetFromStart );
+    stCDD.dfInsXScale   = ReadBITDOUBLE( oInput, nBitOffsetFromStart );
+    stCDD.dfInsYScale   = ReadBITDOUBLE( oInput, nBitOffsetFromStart );
+    stCDD.dfInsZScale   = ReadBITDOUBLE( oInput, nBitOffsetFromStart );
+    stCDD.dfInsRotation = ReadBITDOUBLE( oInput, nBitOffsetFromStart );
 
-    stCDD.dAttachmentPoint    = ReadBITSHORT( pabyInput, nBitOffsetFromStart );
-    stCDD.dLineSpacingStyle   = ReadBITSHORT( pabyInput, nBitOffsetFromStart );
-    stCDD.dfLineSpacingFactor = ReadBITDOUBLE( pabyInput, nBitOffsetFromStart );
-    stCDD.dfActualMeasurement = ReadBITDOUBLE( pabyInput, nBitOffsetFromStart );
+    stCDD.dAttachmentPoint    = ReadBITSHORT( oInput, nBitOffsetFromStart );
+    stCDD.dLineSpacingStyle   = ReadBITSHORT( oInput, nBitOffsetFromStart );
+    stCDD.dfLineSpacingFactor = ReadBITDOUBLE( oInput, nBitOffsetFromStart );
+    stCDD.dfActualMeasurement = ReadBITDOUBLE( oInput, nBitOffsetFromStart );
 
-    CADVector vert12Pt = ReadRAWVector( pabyInput, nBitOffsetFromStart );
+    CADVector vert12Pt = ReadRAWVector( oInput, nBitOffsetFromStart );
     stCDD.vert12Pt = vert12Pt;
 
     switch( dObjectType )
@@ -3379,28 +3695,28 @@ CADDimensionObject * DWGFileR2000::getDimension( short dObjectType, long dObject
             dimension->stCed = stCommonEntityData;
             dimension->cdd   = stCDD;
 
-            CADVector vert10pt = ReadVector( pabyInput, nBitOffsetFromStart );
+            CADVector vert10pt = ReadVector( oInput, nBitOffsetFromStart );
             dimension->vert10pt = vert10pt;
 
-            CADVector vert13pt = ReadVector( pabyInput, nBitOffsetFromStart );
+            CADVector vert13pt = ReadVector( oInput, nBitOffsetFromStart );
             dimension->vert13pt = vert13pt;
 
-            CADVector vert14pt = ReadVector( pabyInput, nBitOffsetFromStart );
+            CADVector vert14pt = ReadVector( oInput, nBitOffsetFromStart );
             dimension->vert14pt = vert14pt;
 
-            dimension->Flags2 = ReadCHAR( pabyInput, nBitOffsetFromStart );
+            dimension->Flags2 = ReadCHAR( oInput, nBitOffsetFromStart );
 
-            fillCommonEntityHandleData( dimension, pabyInput, nBitOffsetFromStart );
+            fillCommonEntityHandleData( dimension, oInput, nBitOffsetFromStart );
 
-            dimension->hDimstyle       = ReadHANDLE( pabyInput, nBitOffsetFromStart );
-            dimension->hAnonymousBlock = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+            dimension->hDimstyle       = ReadHANDLE( oInput, nBitOffsetFromStart );
+            dimension->hAnonymousBlock = ReadHANDLE( oInput, nBitOffsetFromStart );
 
-            nBitOffsetFromStart += 8 - ( nBitOffsetFromStart % 8 );
-            dimension->setCRC( ReadRAWSHORT( pabyInput, nBitOffsetFromStart ) );
+            AlignToByte( nBitOffsetFromStart );
+            dimension->setCRC( ReadRAWSHORT( oInput, nBitOffsetFromStart ) );
 #ifdef _DEBUG
-            if( ( nBitOffsetFromStart / 8 ) != ( dObjectSize + 4 ) )
+            if( ( nBitOffsetFromStart / 8 ) != oInput.GetSize() )
                 DebugMsg( "Assertion failed at %d in %s\nSize difference: %d\n", __LINE__, __FILE__,
-                          ( nBitOffsetFromStart / 8 - dObjectSize - 4 ) );
+                          static_cast<int>( nBitOffsetFromStart / 8 - oInput.GetSize() ) );
 #endif
             return dimension;
         }
@@ -3413,29 +3729,29 @@ CADDimensionObject * DWGFileR2000::getDimension( short dObjectType, long dObject
             dimension->stCed = stCommonEntityData;
             dimension->cdd   = stCDD;
 
-            CADVector vert13pt = ReadVector( pabyInput, nBitOffsetFromStart );
+            CADVector vert13pt = ReadVector( oInput, nBitOffsetFromStart );
             dimension->vert13pt = vert13pt;
 
-            CADVector vert14pt = ReadVector( pabyInput, nBitOffsetFromStart );
+            CADVector vert14pt = ReadVector( oInput, nBitOffsetFromStart );
             dimension->vert14pt = vert14pt;
 
-            CADVector vert10pt = ReadVector( pabyInput, nBitOffsetFromStart );
+            CADVector vert10pt = ReadVector( oInput, nBitOffsetFromStart );
             dimension->vert10pt = vert10pt;
 
-            dimension->dfExtLnRot = ReadBITDOUBLE( pabyInput, nBitOffsetFromStart );
-            dimension->dfDimRot   = ReadBITDOUBLE( pabyInput, nBitOffsetFromStart );
+            dimension->dfExtLnRot = ReadBITDOUBLE( oInput, nBitOffsetFromStart );
+            dimension->dfDimRot   = ReadBITDOUBLE( oInput, nBitOffsetFromStart );
 
-            fillCommonEntityHandleData( dimension, pabyInput, nBitOffsetFromStart );
+            fillCommonEntityHandleData( dimension, oInput, nBitOffsetFromStart );
 
-            dimension->hDimstyle       = ReadHANDLE( pabyInput, nBitOffsetFromStart );
-            dimension->hAnonymousBlock = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+            dimension->hDimstyle       = ReadHANDLE( oInput, nBitOffsetFromStart );
+            dimension->hAnonymousBlock = ReadHANDLE( oInput, nBitOffsetFromStart );
 
-            nBitOffsetFromStart += 8 - ( nBitOffsetFromStart % 8 );
-            dimension->setCRC( ReadRAWSHORT( pabyInput, nBitOffsetFromStart ) );
+            AlignToByte( nBitOffsetFromStart );
+            dimension->setCRC( ReadRAWSHORT( oInput, nBitOffsetFromStart ) );
 #ifdef _DEBUG
-            if( ( nBitOffsetFromStart / 8 ) != ( dObjectSize + 4 ) )
+            if( ( nBitOffsetFromStart / 8 ) != oInput.GetSize() )
                 DebugMsg( "Assertion failed at %d in %s\nSize difference: %d\n", __LINE__, __FILE__,
-                          ( nBitOffsetFromStart / 8 - dObjectSize - 4 ) );
+                          static_cast<int>( nBitOffsetFromStart / 8 - oInput.GetSize() ) );
 #endif
             return dimension;
         }
@@ -3448,28 +3764,28 @@ CADDimensionObject * DWGFileR2000::getDimension( short dObjectType, long dObject
             dimension->stCed = stCommonEntityData;
             dimension->cdd   = stCDD;
 
-            CADVector vert13pt = ReadVector( pabyInput, nBitOffsetFromStart );
+            CADVector vert13pt = ReadVector( oInput, nBitOffsetFromStart );
             dimension->vert13pt = vert13pt;
 
-            CADVector vert14pt = ReadVector( pabyInput, nBitOffsetFromStart );
+            CADVector vert14pt = ReadVector( oInput, nBitOffsetFromStart );
             dimension->vert14pt = vert14pt;
 
-            CADVector vert10pt = ReadVector( pabyInput, nBitOffsetFromStart );
+            CADVector vert10pt = ReadVector( oInput, nBitOffsetFromStart );
             dimension->vert10pt = vert10pt;
 
-            dimension->dfExtLnRot = ReadBITDOUBLE( pabyInput, nBitOffsetFromStart );
+            dimension->dfExtLnRot = ReadBITDOUBLE( oInput, nBitOffsetFromStart );
 
-            fillCommonEntityHandleData( dimension, pabyInput, nBitOffsetFromStart );
+            fillCommonEntityHandleData( dimension, oInput, nBitOffsetFromStart );
 
-            dimension->hDimstyle       = ReadHANDLE( pabyInput, nBitOffsetFromStart );
-            dimension->hAnonymousBlock = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+            dimension->hDimstyle       = ReadHANDLE( oInput, nBitOffsetFromStart );
+            dimension->hAnonymousBlock = ReadHANDLE( oInput, nBitOffsetFromStart );
 
-            nBitOffsetFromStart += 8 - ( nBitOffsetFromStart % 8 );
-            dimension->setCRC( ReadRAWSHORT( pabyInput, nBitOffsetFromStart ) );
+            AlignToByte( nBitOffsetFromStart );
+            dimension->setCRC( ReadRAWSHORT( oInput, nBitOffsetFromStart ) );
 #ifdef _DEBUG
-            if( ( nBitOffsetFromStart / 8 ) != ( dObjectSize + 4 ) )
+            if( ( nBitOffsetFromStart / 8 ) != oInput.GetSize() )
                 DebugMsg( "Assertion failed at %d in %s\nSize difference: %d\n", __LINE__, __FILE__,
-                          ( nBitOffsetFromStart / 8 - dObjectSize - 4 ) );
+                          static_cast<int>( nBitOffsetFromStart / 8 - oInput.GetSize() ) );
 #endif
             return dimension;
         }
@@ -3482,29 +3798,29 @@ CADDimensionObject * DWGFileR2000::getDimension( short dObjectType, long dObject
             dimension->stCed = stCommonEntityData;
             dimension->cdd   = stCDD;
 
-            CADVector vert10pt = ReadVector( pabyInput, nBitOffsetFromStart );
+            CADVector vert10pt = ReadVector( oInput, nBitOffsetFromStart );
             dimension->vert10pt = vert10pt;
 
-            CADVector vert13pt = ReadVector( pabyInput, nBitOffsetFromStart );
+            CADVector vert13pt = ReadVector( oInput, nBitOffsetFromStart );
             dimension->vert13pt = vert13pt;
 
-            CADVector vert14pt = ReadVector( pabyInput, nBitOffsetFromStart );
+            CADVector vert14pt = ReadVector( oInput, nBitOffsetFromStart );
             dimension->vert14pt = vert14pt;
 
-            CADVector vert15pt = ReadVector( pabyInput, nBitOffsetFromStart );
+            CADVector vert15pt = ReadVector( oInput, nBitOffsetFromStart );
             dimension->vert15pt = vert15pt;
 
-            fillCommonEntityHandleData( dimension, pabyInput, nBitOffsetFromStart );
+            fillCommonEntityHandleData( dimension, oInput, nBitOffsetFromStart );
 
-            dimension->hDimstyle       = ReadHANDLE( pabyInput, nBitOffsetFromStart );
-            dimension->hAnonymousBlock = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+            dimension->hDimstyle       = ReadHANDLE( oInput, nBitOffsetFromStart );
+            dimension->hAnonymousBlock = ReadHANDLE( oInput, nBitOffsetFromStart );
 
-            nBitOffsetFromStart += 8 - ( nBitOffsetFromStart % 8 );
-            dimension->setCRC( ReadRAWSHORT( pabyInput, nBitOffsetFromStart ) );
+            AlignToByte( nBitOffsetFromStart );
+            dimension->setCRC( ReadRAWSHORT( oInput, nBitOffsetFromStart ) );
 #ifdef _DEBUG
-            if( ( nBitOffsetFromStart / 8 ) != ( dObjectSize + 4 ) )
+            if( ( nBitOffsetFromStart / 8 ) != oInput.GetSize() )
                 DebugMsg( "Assertion failed at %d in %s\nSize difference: %d\n", __LINE__, __FILE__,
-                          ( nBitOffsetFromStart / 8 - dObjectSize - 4 ) );
+                          static_cast<int>( nBitOffsetFromStart / 8 - oInput.GetSize() ) );
 #endif
             return dimension;
         }
@@ -3517,32 +3833,32 @@ CADDimensionObject * DWGFileR2000::getDimension( short dObjectType, long dObject
             dimension->stCed = stCommonEntityData;
             dimension->cdd   = stCDD;
 
-            CADVector vert16pt = ReadVector( pabyInput, nBitOffsetFromStart );
+            CADVector vert16pt = ReadVector( oInput, nBitOffsetFromStart );
             dimension->vert16pt = vert16pt;
 
-            CADVector vert13pt = ReadVector( pabyInput, nBitOffsetFromStart );
+            CADVector vert13pt = ReadVector( oInput, nBitOffsetFromStart );
             dimension->vert13pt = vert13pt;
 
-            CADVector vert14pt = ReadVector( pabyInput, nBitOffsetFromStart );
+            CADVector vert14pt = ReadVector( oInput, nBitOffsetFromStart );
             dimension->vert14pt = vert14pt;
 
-            CADVector vert15pt = ReadVector( pabyInput, nBitOffsetFromStart );
+            CADVector vert15pt = ReadVector( oInput, nBitOffsetFromStart );
             dimension->vert15pt = vert15pt;
 
-            CADVector vert10pt = ReadVector( pabyInput, nBitOffsetFromStart );
+            CADVector vert10pt = ReadVector( oInput, nBitOffsetFromStart );
             dimension->vert10pt = vert10pt;
 
-            fillCommonEntityHandleData( dimension, pabyInput, nBitOffsetFromStart );
+            fillCommonEntityHandleData( dimension, oInput, nBitOffsetFromStart );
 
-            dimension->hDimstyle       = ReadHANDLE( pabyInput, nBitOffsetFromStart );
-            dimension->hAnonymousBlock = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+            dimension->hDimstyle       = ReadHANDLE( oInput, nBitOffsetFromStart );
+            dimension->hAnonymousBlock = ReadHANDLE( oInput, nBitOffsetFromStart );
 
-            nBitOffsetFromStart += 8 - ( nBitOffsetFromStart % 8 );
-            dimension->setCRC( ReadRAWSHORT( pabyInput, nBitOffsetFromStart ) );
+            AlignToByte( nBitOffsetFromStart );
+            dimension->setCRC( ReadRAWSHORT( oInput, nBitOffsetFromStart ) );
 #ifdef _DEBUG
-            if( ( nBitOffsetFromStart / 8 ) != ( dObjectSize + 4 ) )
+            if( ( nBitOffsetFromStart / 8 ) != oInput.GetSize() )
                 DebugMsg( "Assertion failed at %d in %s\nSize difference: %d\n", __LINE__, __FILE__,
-                          ( nBitOffsetFromStart / 8 - dObjectSize - 4 ) );
+                          static_cast<int>( nBitOffsetFromStart / 8 - oInput.GetSize() ) );
 #endif
             return dimension;
         }
@@ -3555,25 +3871,25 @@ CADDimensionObject * DWGFileR2000::getDimension( short dObjectType, long dObject
             dimension->stCed = stCommonEntityData;
             dimension->cdd   = stCDD;
 
-            CADVector vert10pt = ReadVector( pabyInput, nBitOffsetFromStart );
+            CADVector vert10pt = ReadVector( oInput, nBitOffsetFromStart );
             dimension->vert10pt = vert10pt;
 
-            CADVector vert15pt = ReadVector( pabyInput, nBitOffsetFromStart );
+            CADVector vert15pt = ReadVector( oInput, nBitOffsetFromStart );
             dimension->vert15pt = vert15pt;
 
-            dimension->dfLeaderLen = ReadBITDOUBLE( pabyInput, nBitOffsetFromStart );
+            dimension->dfLeaderLen = ReadBITDOUBLE( oInput, nBitOffsetFromStart );
 
-            fillCommonEntityHandleData( dimension, pabyInput, nBitOffsetFromStart );
+            fillCommonEntityHandleData( dimension, oInput, nBitOffsetFromStart );
 
-            dimension->hDimstyle       = ReadHANDLE( pabyInput, nBitOffsetFromStart );
-            dimension->hAnonymousBlock = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+            dimension->hDimstyle       = ReadHANDLE( oInput, nBitOffsetFromStart );
+            dimension->hAnonymousBlock = ReadHANDLE( oInput, nBitOffsetFromStart );
 
-            nBitOffsetFromStart += 8 - ( nBitOffsetFromStart % 8 );
-            dimension->setCRC( ReadRAWSHORT( pabyInput, nBitOffsetFromStart ) );
+            AlignToByte( nBitOffsetFromStart );
+            dimension->setCRC( ReadRAWSHORT( oInput, nBitOffsetFromStart ) );
 #ifdef _DEBUG
-            if( ( nBitOffsetFromStart / 8 ) != ( dObjectSize + 4 ) )
+            if( ( nBitOffsetFromStart / 8 ) != oInput.GetSize() )
                 DebugMsg( "Assertion failed at %d in %s\nSize difference: %d\n", __LINE__, __FILE__,
-                          ( nBitOffsetFromStart / 8 - dObjectSize - 4 ) );
+                          static_cast<int>( nBitOffsetFromStart / 8 - oInput.GetSize() ) );
 #endif
             return dimension;
         }
@@ -3586,25 +3902,25 @@ CADDimensionObject * DWGFileR2000::getDimension( short dObjectType, long dObject
             dimension->stCed = stCommonEntityData;
             dimension->cdd   = stCDD;
 
-            CADVector vert15pt = ReadVector( pabyInput, nBitOffsetFromStart );
+            CADVector vert15pt = ReadVector( oInput, nBitOffsetFromStart );
             dimension->vert15pt = vert15pt;
 
-            CADVector vert10pt = ReadVector( pabyInput, nBitOffsetFromStart );
+            CADVector vert10pt = ReadVector( oInput, nBitOffsetFromStart );
             dimension->vert10pt = vert10pt;
 
-            dimension->dfLeaderLen = ReadBITDOUBLE( pabyInput, nBitOffsetFromStart );
+            dimension->dfLeaderLen = ReadBITDOUBLE( oInput, nBitOffsetFromStart );
 
-            fillCommonEntityHandleData( dimension, pabyInput, nBitOffsetFromStart );
+            fillCommonEntityHandleData( dimension, oInput, nBitOffsetFromStart );
 
-            dimension->hDimstyle       = ReadHANDLE( pabyInput, nBitOffsetFromStart );
-            dimension->hAnonymousBlock = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+            dimension->hDimstyle       = ReadHANDLE( oInput, nBitOffsetFromStart );
+            dimension->hAnonymousBlock = ReadHANDLE( oInput, nBitOffsetFromStart );
 
-            nBitOffsetFromStart += 8 - ( nBitOffsetFromStart % 8 );
-            dimension->setCRC( ReadRAWSHORT( pabyInput, nBitOffsetFromStart ) );
+            AlignToByte( nBitOffsetFromStart );
+            dimension->setCRC( ReadRAWSHORT( oInput, nBitOffsetFromStart ) );
 #ifdef _DEBUG
-            if( ( nBitOffsetFromStart / 8 ) != ( dObjectSize + 4 ) )
+            if( ( nBitOffsetFromStart / 8 ) != oInput.GetSize() )
                 DebugMsg( "Assertion failed at %d in %s\nSize difference: %d\n", __LINE__, __FILE__,
-                          ( nBitOffsetFromStart / 8 - dObjectSize - 4 ) );
+                          static_cast<int>( nBitOffsetFromStart / 8 - oInput.GetSize() ) );
 #endif
             return dimension;
         }
@@ -3612,208 +3928,188 @@ CADDimensionObject * DWGFileR2000::getDimension( short dObjectType, long dObject
     return nullptr;
 }
 
-CADImageDefObject * DWGFileR2000::getImageDef( long dObjectSize, const char * pabyInput, size_t& nBitOffsetFromStart )
+CADImageDefObject * DWGFileR2000::getImageDef( long dObjectSize, const DWGBuffer& oInput, size_t& nBitOffsetFromStart )
 {
     CADImageDefObject * imagedef = new CADImageDefObject();
 
     imagedef->setSize( dObjectSize );
-    imagedef->nObjectSizeInBits = ReadRAWLONG( pabyInput, nBitOffsetFromStart );
-    imagedef->hObjectHandle     = ReadHANDLE8BLENGTH( pabyInput, nBitOffsetFromStart );
+    imagedef->nObjectSizeInBits = ReadRAWLONG( oInput, nBitOffsetFromStart );
+    imagedef->hObjectHandle     = ReadHANDLE8BLENGTH( oInput, nBitOffsetFromStart );
 
     short  dEEDSize = 0;
     CADEed dwgEed;
-    while( ( dEEDSize = ReadBITSHORT( pabyInput, nBitOffsetFromStart ) ) != 0 )
+    while( ( dEEDSize = ReadBITSHORT( oInput, nBitOffsetFromStart ) ) != 0 )
     {
         dwgEed.dLength      = dEEDSize;
-        dwgEed.hApplication = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+        dwgEed.hApplication = ReadHANDLE( oInput, nBitOffsetFromStart );
 
         for( short i = 0; i < dEEDSize; ++i )
         {
-            dwgEed.acData.push_back( ReadCHAR( pabyInput, nBitOffsetFromStart ) );
+            dwgEed.acData.push_back( ReadCHAR( oInput, nBitOffsetFromStart ) );
         }
 
         imagedef->aEED.push_back( dwgEed );
     }
 
-    imagedef->nNumReactors  = ReadBITLONG( pabyInput, nBitOffsetFromStart );
-    imagedef->dClassVersion = ReadBITLONG( pabyInput, nBitOffsetFromStart );
+    imagedef->nNumReactors  = ReadBITLONG( oInput, nBitOffsetFromStart );
+    imagedef->dClassVersion = ReadBITLONG( oInput, nBitOffsetFromStart );
 
-    imagedef->dfXImageSizeInPx = ReadRAWDOUBLE( pabyInput, nBitOffsetFromStart );
-    imagedef->dfYImageSizeInPx = ReadRAWDOUBLE( pabyInput, nBitOffsetFromStart );
+    imagedef->dfXImageSizeInPx = ReadRAWDOUBLE( oInput, nBitOffsetFromStart );
+    imagedef->dfYImageSizeInPx = ReadRAWDOUBLE( oInput, nBitOffsetFromStart );
 
-    imagedef->sFilePath = ReadTV( pabyInput, nBitOffsetFromStart );
-    imagedef->bIsLoaded = ReadBIT( pabyInput, nBitOffsetFromStart );
+    imagedef->sFilePath = ReadTV( oInput, nBitOffsetFromStart );
+    imagedef->bIsLoaded = ReadBIT( oInput, nBitOffsetFromStart );
 
-    imagedef->dResUnits = ReadCHAR( pabyInput, nBitOffsetFromStart );
+    imagedef->dResUnits = ReadCHAR( oInput, nBitOffsetFromStart );
 
-    imagedef->dfXPixelSize = ReadRAWDOUBLE( pabyInput, nBitOffsetFromStart );
-    imagedef->dfYPixelSize = ReadRAWDOUBLE( pabyInput, nBitOffsetFromStart );
+    imagedef->dfXPixelSize = ReadRAWDOUBLE( oInput, nBitOffsetFromStart );
+    imagedef->dfYPixelSize = ReadRAWDOUBLE( oInput, nBitOffsetFromStart );
 
-    imagedef->hParentHandle = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+    imagedef->hParentHandle = ReadHANDLE( oInput, nBitOffsetFromStart );
 
-    for( long i = 0; i < imagedef->nNumReactors; ++i )
-        imagedef->hReactors.push_back( ReadHANDLE( pabyInput, nBitOffsetFromStart ) );
+    for( long i = 0; i < imagedef->nNumReactors && !oInput.IsOverrun(); ++i )
+        imagedef->hReactors.push_back( ReadHANDLE( oInput, nBitOffsetFromStart ) );
 
-    imagedef->hXDictionary = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+    imagedef->hXDictionary = ReadHANDLE( oInput, nBitOffsetFromStart );
 
-    nBitOffsetFromStart += 8 - ( nBitOffsetFromStart % 8 );
-    imagedef->setCRC( ReadRAWSHORT( pabyInput, nBitOffsetFromStart ) );
+    AlignToByte( nBitOffsetFromStart );
+    imagedef->setCRC( ReadRAWSHORT( oInput, nBitOffsetFromStart ) );
 #ifdef _DEBUG
-    if( ( nBitOffsetFromStart / 8 ) != ( dObjectSize + 4 ) )
+    if( ( nBitOffsetFromStart / 8 ) != oInput.GetSize() )
         DebugMsg( "Assertion failed at %d in %s\nSize difference: %d\n", __LINE__, __FILE__,
-                  ( nBitOffsetFromStart / 8 - dObjectSize - 4 ) );
+                  static_cast<int>( nBitOffsetFromStart / 8 - oInput.GetSize() ) );
 #endif
 
     return imagedef;
 }
 
-CADImageDefReactorObject * DWGFileR2000::getImageDefReactor( long dObjectSize, const char * pabyInput,
+CADImageDefReactorObject * DWGFileR2000::getImageDefReactor( long dObjectSize, const DWGBuffer& oInput,
                                                              size_t& nBitOffsetFromStart )
 {
     CADImageDefReactorObject * imagedefreactor = new CADImageDefReactorObject();
 
     imagedefreactor->setSize( dObjectSize );
-    imagedefreactor->nObjectSizeInBits = ReadRAWLONG( pabyInput, nBitOffsetFromStart );
-    imagedefreactor->hObjectHandle     = ReadHANDLE8BLENGTH( pabyInput, nBitOffsetFromStart );
+    imagedefreactor->nObjectSizeInBits = ReadRAWLONG( oInput, nBitOffsetFromStart );
+    imagedefreactor->hObjectHandle     = ReadHANDLE8BLENGTH( oInput, nBitOffsetFromStart );
 
     short  dEEDSize = 0;
     CADEed dwgEed;
-    while( ( dEEDSize = ReadBITSHORT( pabyInput, nBitOffsetFromStart ) ) != 0 )
+    while( ( dEEDSize = ReadBITSHORT( oInput, nBitOffsetFromStart ) ) != 0 )
     {
         dwgEed.dLength      = dEEDSize;
-        dwgEed.hApplication = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+        dwgEed.hApplication = ReadHANDLE( oInput, nBitOffsetFromStart );
 
         for( short i = 0; i < dEEDSize; ++i )
         {
-            dwgEed.acData.push_back( ReadCHAR( pabyInput, nBitOffsetFromStart ) );
+            dwgEed.acData.push_back( ReadCHAR( oInput, nBitOffsetFromStart ) );
         }
 
         imagedefreactor->aEED.push_back( dwgEed );
     }
 
-    imagedefreactor->nNumReactors  = ReadBITLONG( pabyInput, nBitOffsetFromStart );
-    imagedefreactor->dClassVersion = ReadBITLONG( pabyInput, nBitOffsetFromStart );
+    imagedefreactor->nNumReactors  = ReadBITLONG( oInput, nBitOffsetFromStart );
+    imagedefreactor->dClassVersion = ReadBITLONG( oInput, nBitOffsetFromStart );
 
-    imagedefreactor->hParentHandle = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+    imagedefreactor->hParentHandle = ReadHANDLE( oInput, nBitOffsetFromStart );
 
-    for( long i = 0; i < imagedefreactor->nNumReactors; ++i )
-        imagedefreactor->hReactors.push_back( ReadHANDLE( pabyInput, nBitOffsetFromStart ) );
+    for( long i = 0; i < imagedefreactor->nNumReactors && !oInput.IsOverrun(); ++i )
+        imagedefreactor->hReactors.push_back( ReadHANDLE( oInput, nBitOffsetFromStart ) );
 
-    imagedefreactor->hXDictionary = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+    imagedefreactor->hXDictionary = ReadHANDLE( oInput, nBitOffsetFromStart );
 
-    nBitOffsetFromStart += 8 - ( nBitOffsetFromStart % 8 );
-    imagedefreactor->setCRC( ReadRAWSHORT( pabyInput, nBitOffsetFromStart ) );
+    AlignToByte( nBitOffsetFromStart );
+    imagedefreactor->setCRC( ReadRAWSHORT( oInput, nBitOffsetFromStart ) );
 #ifdef _DEBUG
-    if( ( nBitOffsetFromStart / 8 ) != ( dObjectSize + 4 ) )
+    if( ( nBitOffsetFromStart / 8 ) != oInput.GetSize() )
         DebugMsg( "Assertion failed at %d in %s\nSize difference: %d\n", __LINE__, __FILE__,
-                  ( nBitOffsetFromStart / 8 - dObjectSize - 4 ) );
+                  static_cast<int>( nBitOffsetFromStart / 8 - oInput.GetSize() ) );
 #endif
 
     return imagedefreactor;
 }
 
-CADXRecordObject * DWGFileR2000::getXRecord( long dObjectSize, const char * pabyInput, size_t& nBitOffsetFromStart )
+CADXRecordObject * DWGFileR2000::getXRecord( long dObjectSize, const DWGBuffer& oInput, size_t& nBitOffsetFromStart )
 {
     CADXRecordObject * xrecord = new CADXRecordObject();
 
     xrecord->setSize( dObjectSize );
-    xrecord->nObjectSizeInBits = ReadRAWLONG( pabyInput, nBitOffsetFromStart );
-    xrecord->hObjectHandle     = ReadHANDLE8BLENGTH( pabyInput, nBitOffsetFromStart );
+    xrecord->nObjectSizeInBits = ReadRAWLONG( oInput, nBitOffsetFromStart );
+    xrecord->hObjectHandle     = ReadHANDLE8BLENGTH( oInput, nBitOffsetFromStart );
 
     short  dEEDSize = 0;
     CADEed dwgEed;
-    while( ( dEEDSize = ReadBITSHORT( pabyInput, nBitOffsetFromStart ) ) != 0 )
+    while( ( dEEDSize = ReadBITSHORT( oInput, nBitOffsetFromStart ) ) != 0 )
     {
         dwgEed.dLength      = dEEDSize;
-        dwgEed.hApplication = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+        dwgEed.hApplication = ReadHANDLE( oInput, nBitOffsetFromStart );
 
         for( short i = 0; i < dEEDSize; ++i )
         {
-            dwgEed.acData.push_back( ReadCHAR( pabyInput, nBitOffsetFromStart ) );
+            dwgEed.acData.push_back( ReadCHAR( oInput, nBitOffsetFromStart ) );
         }
 
         xrecord->aEED.push_back( dwgEed );
     }
 
-    xrecord->nNumReactors  = ReadBITLONG( pabyInput, nBitOffsetFromStart );
-    xrecord->nNumDataBytes = ReadBITLONG( pabyInput, nBitOffsetFromStart );
+    xrecord->nNumReactors  = ReadBITLONG( oInput, nBitOffsetFromStart );
+    xrecord->nNumDataBytes = ReadBITLONG( oInput, nBitOffsetFromStart );
 
-    for( long i = 0; i < xrecord->nNumDataBytes; ++i )
+    for( long i = 0; i < xrecord->nNumDataBytes && !oInput.IsOverrun(); ++i )
     {
-        xrecord->abyDataBytes.push_back( ReadCHAR( pabyInput, nBitOffsetFromStart ) );
+        xrecord->abyDataBytes.push_back( ReadCHAR( oInput, nBitOffsetFromStart ) );
     }
 
-    xrecord->dCloningFlag = ReadBITSHORT( pabyInput, nBitOffsetFromStart );
-
-    short dIndicatorNumber = ReadRAWSHORT( pabyInput, nBitOffsetFromStart );
-    if( dIndicatorNumber == 1 )
-    {
-        unsigned char nStringSize = ReadCHAR( pabyInput, nBitOffsetFromStart );
-        /* char dCodePage   =  */ ReadCHAR( pabyInput, nBitOffsetFromStart );
-        for( unsigned char i = 0; i < nStringSize; ++i )
-        {
-            ReadCHAR( pabyInput, nBitOffsetFromStart );
-        }
-    } else if( dIndicatorNumber == 70 )
-    {
-        ReadRAWSHORT( pabyInput, nBitOffsetFromStart );
-    } else if( dIndicatorNumber == 10 )
-    {
-        ReadRAWDOUBLE( pabyInput, nBitOffsetFromStart );
-        ReadRAWDOUBLE( pabyInput, nBitOffsetFromStart );
-        ReadRAWDOUBLE( pabyInput, nBitOffsetFromStart );
-    } else if( dIndicatorNumber == 40 )
-    {
-        ReadRAWDOUBLE( pabyInput, nBitOffsetFromStart );
-    }
+    xrecord->dCloningFlag = ReadBITSHORT( oInput, nBitOffsetFromStart );
 
-    xrecord->hParentHandle = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+    xrecord->hParentHandle = ReadHANDLE( oInput, nBitOffsetFromStart );
 
-    for( long i = 0; i < xrecord->nNumReactors; ++i )
-        xrecord->hReactors.push_back( ReadHANDLE( pabyInput, nBitOffsetFromStart ) );
+    for( long i = 0; i < xrecord->nNumReactors && !oInput.IsOverrun(); ++i )
+        xrecord->hReactors.push_back( ReadHANDLE( oInput, nBitOffsetFromStart ) );
 
-    xrecord->hXDictionary = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+    xrecord->hXDictionary = ReadHANDLE( oInput, nBitOffsetFromStart );
 
-    while( nBitOffsetFromStart / 8 < ( ( size_t ) dObjectSize + 4 ) )
+    // Object id handles take the rest of the handle stream, up to the CRC
+    // (2 bytes of size + dObjectSize bytes of data).
+    while( nBitOffsetFromStart + 8 <= ( ( size_t ) dObjectSize + 2 ) * 8 )
     {
-        xrecord->hObjIdHandles.push_back( ReadHANDLE( pabyInput, nBitOffsetFromStart ) );
+        xrecord->hObjIdHandles.push_back( ReadHANDLE( oInput, nBitOffsetFromStart ) );
     }
 
-    nBitOffsetFromStart += 8 - ( nBitOffsetFromStart % 8 );
-    xrecord->setCRC( ReadRAWSHORT( pabyInput, nBitOffsetFromStart ) );
+    AlignToByte( nBitOffsetFromStart );
+    xrecord->setCRC( ReadRAWSHORT( oInput, nBitOffsetFromStart ) );
 #ifdef _DEBUG
-    if( ( nBitOffsetFromStart / 8 ) != ( dObjectSize + 4 ) )
+    if( ( nBitOffsetFromStart / 8 ) != oInput.GetSize() )
         DebugMsg( "Assertion failed at %d in %s\nSize difference: %d\n", __LINE__, __FILE__,
-                  ( nBitOffsetFromStart / 8 - dObjectSize - 4 ) );
+                  static_cast<int>( nBitOffsetFromStart / 8 - oInput.GetSize() ) );
 #endif
 
     return xrecord;
 }
 
-void DWGFileR2000::fillCommonEntityHandleData( CADEntityObject * pEnt, const char * pabyInput,
+void DWGFileR2000::fillCommonEntityHandleData( CADEntityObject * pEnt, const DWGBuffer& oInput,
                                                size_t& nBitOffsetFromStart )
 {
     if( pEnt->stCed.bbEntMode == 0 )
-        pEnt->stChed.hOwner = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+        pEnt->stChed.hOwner = ReadHANDLE( oInput, nBitOffsetFromStart );
 
-    for( long i = 0; i < pEnt->stCed.nNumReactors; ++i )
-        pEnt->stChed.hReactors.push_back( ReadHANDLE( pabyInput, nBitOffsetFromStart ) );
+    for( long i = 0; i < pEnt->stCed.nNumReactors && !oInput.IsOverrun(); ++i )
+        pEnt->stChed.hReactors.push_back( ReadHANDLE( oInput, nBitOffsetFromStart ) );
 
-    pEnt->stChed.hXDictionary = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+    pEnt->stChed.hXDictionary = ReadHANDLE( oInput, nBitOffsetFromStart );
 
     if( !pEnt->stCed.bNoLinks )
     {
-        pEnt->stChed.hPrevEntity = ReadHANDLE( pabyInput, nBitOffsetFromStart );
-        pEnt->stChed.hNextEntity = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+        pEnt->stChed.hPrevEntity = ReadHANDLE( oInput, nBitOffsetFromStart );
+        pEnt->stChed.hNextEntity = ReadHANDLE( oInput, nBitOffsetFromStart );
     }
 
-    pEnt->stChed.hLayer = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+    pEnt->stChed.hLayer = ReadHANDLE( oInput, nBitOffsetFromStart );
 
     if( pEnt->stCed.bbLTypeFlags == 0x03 )
-        pEnt->stChed.hLType = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+        pEnt->stChed.hLType = ReadHANDLE( oInput, nBitOffsetFromStart );
 
     if( pEnt->stCed.bbPlotStyleFlags == 0x03 )
-        pEnt->stChed.hPlotStyle = ReadHANDLE( pabyInput, nBitOffsetFromStart );
+        pEnt->stChed.hPlotStyle = ReadHANDLE( oInput, nBitOffsetFromStart );
 }
 
 DWGFileR2000::DWGFileR2000( CADFileIO * poFileIO ) : CADFile( poFileIO )
@@ -3831,35 +4127,35 @@ int DWGFileR2000::ReadSectionLocators()
     int   dImageSeeker, SLRecordsCount;
     short dCodePage;
 
-    pFileIO->Rewind();
+    long nOffset = 0;
     memset( abyBuf, 0, DWG_VERSION_STR_SIZE + 1 );
-    pFileIO->Read( abyBuf, DWG_VERSION_STR_SIZE );
+    nOffset += pFileIO->ReadAt( nOffset, abyBuf, DWG_VERSION_STR_SIZE );
     oHeader.addValue( CADHeader::ACADVER, abyBuf );
     memset( abyBuf, 0, 8 );
-    pFileIO->Read( abyBuf, 7 );
+    nOffset += pFileIO->ReadAt( nOffset, abyBuf, 7 );
     oHeader.addValue( CADHeader::ACADMAINTVER, abyBuf );
     // TODO: code can be much simplified if CADHandle will be used.
-    pFileIO->Read( & dImageSeeker, 4 );
+    nOffset += pFileIO->ReadAt( nOffset, & dImageSeeker, 4 );
     // to do so, == and ++ operators should be implemented.
     DebugMsg( "Image seeker read: %d\n", dImageSeeker );
     imageSeeker = dImageSeeker;
 
-    pFileIO->Seek( 2, CADFileIO::SeekOrigin::CUR ); // 19
-    pFileIO->Read( & dCodePage, 2 );
+    nOffset += 2; // 19
+    nOffset += pFileIO->ReadAt( nOffset, & dCodePage, 2 );
     oHeader.addValue( CADHeader::DWGCODEPAGE, dCodePage );
 
     DebugMsg( "DWG Code page: %d\n", dCodePage );
 
-    pFileIO->Read( & SLRecordsCount, 4 ); // 21
+    nOffset += pFileIO->ReadAt( nOffset, & SLRecordsCount, 4 ); // 21
     // Last vertex is reached. read it and break reading.
     DebugMsg( "Section locator records count: %d\n", SLRecordsCount );
 
     for( size_t i = 0; i < static_cast<size_t>(SLRecordsCount); ++i )
     {
         SectionLocatorRecord readedRecord;
-        pFileIO->Read( & readedRecord.byRecordNumber, 1 );
-        pFileIO->Read( & readedRecord.dSeeker, 4 );
-        pFileIO->Read( & readedRecord.dSize, 4 );
+        nOffset += pFileIO->ReadAt( nOffset, & readedRecord.byRecordNumber, 1 );
+        nOffset += pFileIO->ReadAt( nOffset, & readedRecord.dSeeker, 4 );
+        nOffset += pFileIO->ReadAt( nOffset, & readedRecord.dSize, 4 );
 
         sectionLocatorRecords.push_back( readedRecord );
         DebugMsg( "  Record #%d : %d %d\n", sectionLocatorRecords[i].byRecordNumber, sectionLocatorRecords[i].dSeeker,
@@ -3875,8 +4171,11 @@ CADDictionary DWGFileR2000::GetNOD()
 
     unique_ptr<CADDictionaryObject> spoNamedDictObj(
             ( CADDictionaryObject * ) GetObject( oTables.GetTableHandle( CADTables::NamedObjectsDict ).getAsLong() ) );
+    if( spoNamedDictObj == nullptr )
+        return stNOD;
 
-    for( size_t i = 0; i < spoNamedDictObj->sItemNames.size(); ++i )
+    for( size_t i = 0; i < spoNamedDictObj->sItemNames.size() &&
+                       i < spoNamedDictObj->hItemHandles.size(); ++i )
     {
         unique_ptr<CADObject> spoDictRecord( GetObject( spoNamedDictObj->hItemHandles[i].getAsLong() ) );
 
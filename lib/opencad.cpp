@@ -30,6 +30,8 @@
  *******************************************************************************/
 #include "opencad_api.h"
 #include "cadfilestreamio.h"
+#include "cadfilememoryio.h"
+#include "cadfilemmapio.h"
 #include "dwg/r2000.h"
 
 #include <cctype>
@@ -49,22 +51,27 @@ static int CheckCADFile(CADFileIO * pCADFileIO)
     if( pCADFileIO == nullptr )
         return 0;
 
+    // In-memory data may come without any name, only content tells its format.
     const char * pszFilePath = pCADFileIO->GetFilePath();
     size_t nPathLen = strlen( pszFilePath );
-
-    if( toupper( pszFilePath[nPathLen - 3] ) == 'D' &&
-        toupper( pszFilePath[nPathLen - 2] ) == 'X' &&
-        toupper( pszFilePath[nPathLen - 1] ) == 'F' )
-    {
-        //TODO: "AutoCAD Binary DXF"
-        std::cerr << "DXF ASCII and binary is not supported yet.";
-        return 0;
-    }
-    if( ! ( toupper( pszFilePath[nPathLen - 3] ) == 'D' &&
-            toupper( pszFilePath[nPathLen - 2] ) == 'W' &&
-            toupper( pszFilePath[nPathLen - 1] ) == 'G' ) )
+    if( nPathLen != 0 )
     {
-        return 0;
+        if( nPathLen >= 3 &&
+            toupper( pszFilePath[nPathLen - 3] ) == 'D' &&
+            toupper( pszFilePath[nPathLen - 2] ) == 'X' &&
+            toupper( pszFilePath[nPathLen - 1] ) == 'F' )
+        {
+            //TODO: "AutoCAD Binary DXF"
+            std::cerr << "DXF ASCII and binary is not supported yet.";
+            return 0;
+        }
+        if( ! ( nPathLen >= 3 &&
+                toupper( pszFilePath[nPathLen - 3] ) == 'D' &&
+                toupper( pszFilePath[nPathLen - 2] ) == 'W' &&
+                toupper( pszFilePath[nPathLen - 1] ) == 'G' ) )
+        {
+            return 0;
+        }
     }
 
     if( !pCADFileIO->IsOpened() )
@@ -75,6 +82,8 @@ static int CheckCADFile(CADFileIO * pCADFileIO)
     char pabyDWGVersion[DWG_VERSION_STR_SIZE + 1] = { 0 };
     pCADFileIO->Rewind ();
     pCADFileIO->Read( pabyDWGVersion, DWG_VERSION_STR_SIZE );
+    if( pabyDWGVersion[0] != 'A' || pabyDWGVersion[1] != 'C' )
+        return 0;
     return atoi( pabyDWGVersion + 2 );
 }
 
@@ -83,9 +92,11 @@ static int CheckCADFile(CADFileIO * pCADFileIO)
  * @param pCADFileIO CAD file reader pointer ownd by function
  * @param eOptions Open options
  * @param bReadUnsupportedGeometries Unsupported geoms will be returned as CADUnknown
+ * @param bUseObjectIndexCache Use object map sidecar cache, see CADFile::SetUseObjectIndexCache()
  * @return CADFile pointer or NULL if failed. The pointer have to be freed by user
  */
-CADFile * OpenCADFile( CADFileIO * pCADFileIO, enum CADFile::OpenOptions eOptions, bool bReadUnsupportedGeometries )
+static CADFile * OpenCADFile( CADFileIO * pCADFileIO, enum CADFile::OpenOptions eOptions,
+                              bool bReadUnsupportedGeometries, bool bUseObjectIndexCache )
 {
     int nCADFileVersion = CheckCADFile( pCADFileIO );
     CADFile * poCAD = nullptr;
@@ -101,6 +112,7 @@ CADFile * OpenCADFile( CADFileIO * pCADFileIO, enum CADFile::OpenOptions eOption
             return nullptr;
     }
 
+    poCAD->SetUseObjectIndexCache( bUseObjectIndexCache );
     gLastError = poCAD->ParseFile( eOptions, bReadUnsupportedGeometries );
     if( gLastError != CADErrorCodes::SUCCESS )
     {
@@ -111,6 +123,18 @@ CADFile * OpenCADFile( CADFileIO * pCADFileIO, enum CADFile::OpenOptions eOption
     return poCAD;
 }
 
+/**
+ * @brief Open CAD file
+ * @param pCADFileIO CAD file reader pointer ownd by function
+ * @param eOptions Open options
+ * @param bReadUnsupportedGeometries Unsupported geoms will be returned as CADUnknown
+ * @return CADFile pointer or NULL if failed. The pointer have to be freed by user
+ */
+CADFile * OpenCADFile( CADFileIO * pCADFileIO, enum CADFile::OpenOptions eOptions, bool bReadUnsupportedGeometries )
+{
+    return OpenCADFile( pCADFileIO, eOptions, bReadUnsupportedGeometries, false );
+}
+
 
 /**
  * @brief Get library version number as major * 10000 + minor * 100 + rev
@@ -140,13 +164,19 @@ int GetLastErrorCode()
 }
 
 /**
- * @brief GetDefaultFileIO return default file in/out class.
+ * @brief GetDefaultFileIO return default file in/out class. Memory mapped io is
+ * preferred, stream io is used if the file can't be mapped.
  * @param pszFileName CAD file path
  * @return CADFileIO pointer or null if error. The pointer have to be freed by
  * user
  */
 CADFileIO* GetDefaultFileIO( const char * pszFileName )
 {
+    CADFileMmapIO * poMmapIO = new CADFileMmapIO( pszFileName );
+    if( poMmapIO->Open( CADFileIO::OpenMode::read | CADFileIO::OpenMode::binary ) )
+        return poMmapIO;
+    delete poMmapIO;
+
     return new CADFileStreamIO( pszFileName );
 }
 
@@ -187,7 +217,50 @@ CADFile * OpenCADFile( const char * pszFileName, enum CADFile::OpenOptions eOpti
         return nullptr;
     }
 
-    return OpenCADFile( GetDefaultFileIO( pszFileName ), eOptions, bReadUnsupportedGeometries );
+    return OpenCADFile( GetDefaultFileIO( pszFileName ), eOptions, bReadUnsupportedGeometries, false );
+}
+
+/**
+ * @brief Open CAD file and keep its object map in a sidecar cache file
+ * @param pszFileName Path to CAD file
+ * @param eOptions Open options
+ * @param bReadUnsupportedGeometries Unsupported geoms will be returned as CADUnknown
+ * @param bUseObjectIndexCache Load the object map from pszFileName + ".ocadidx"
+ * if it is up to date, create it otherwise
+ * @return CADFile pointer or NULL if failed. The pointer have to be freed by user.
+ */
+CADFile * OpenCADFile( const char * pszFileName, enum CADFile::OpenOptions eOptions, bool bReadUnsupportedGeometries,
+                       bool bUseObjectIndexCache )
+{
+    if( pszFileName == NULL )
+    {
+        gLastError = CADErrorCodes::FILE_OPEN_FAILED;
+        return nullptr;
+    }
+
+    return OpenCADFile( GetDefaultFileIO( pszFileName ), eOptions, bReadUnsupportedGeometries,
+                        bUseObjectIndexCache );
+}
+
+/**
+ * @brief Open CAD file from memory
+ * @param pData Buffer with CAD file content. It is not copied and have to be
+ * kept by user until returned CADFile is freed
+ * @param nSize Buffer size in bytes
+ * @param eOptions Open options
+ * @param bReadUnsupportedGeometries Unsupported geoms will be returned as CADUnknown
+ * @return CADFile pointer or NULL if failed. The pointer have to be freed by user.
+ */
+CADFile * OpenCADFile( const void * pData, size_t nSize, enum CADFile::OpenOptions eOptions,
+                       bool bReadUnsupportedGeometries )
+{
+    if( pData == nullptr || nSize == 0 )
+    {
+        gLastError = CADErrorCodes::FILE_OPEN_FAILED;
+        return nullptr;
+    }
+
+    return OpenCADFile( new CADFileMemoryIO( pData, nSize ), eOptions, bReadUnsupportedGeometries, false );
 }
 
 #ifdef _DEBUG
@@ -1,5 +1,15 @@
 #include "gtest/gtest.h"
 #include "dwg/io.h"
+#include "cadobjectindex.h"
+#include "cadheader.h"
+#include "cadobjectpool.h"
+#include "opencad_api.h"
+
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <type_traits>
+#include <vector>
 
 /*                                                          */
 /*               ReadBITSHORT() tests packet.               */
@@ -13,7 +23,7 @@ TEST(bitshort, bitshort_full_offset0)
     buffer[0] = 0b00110000;
     buffer[1] = 0b11000011;
     buffer[2] = 0b11000000;
-    short a = ReadBITSHORT ( buffer, bitOffsetFromStart );
+    short a = ReadBITSHORT ( DWGBuffer ( buffer, sizeof (buffer) ), bitOffsetFromStart );
     ASSERT_EQ (4035, a);
 }
 
@@ -25,7 +35,7 @@ TEST(bitshort, bitshort_full_offset1)
     buffer[0] = 0b00011000;
     buffer[1] = 0b01100001;
     buffer[2] = 0b11100000;
-    short a = ReadBITSHORT ( buffer, bitOffsetFromStart );
+    short a = ReadBITSHORT ( DWGBuffer ( buffer, sizeof (buffer) ), bitOffsetFromStart );
     ASSERT_EQ (4035, a);
 }
 
@@ -37,7 +47,7 @@ TEST(bitshort, bitshort_unsigned_char_offset0)
     buffer[0] = 0b01100010;
     buffer[1] = 0b10110000;
     buffer[2] = 0b11000000;
-    short a = ReadBITSHORT ( buffer, bitOffsetFromStart );
+    short a = ReadBITSHORT ( DWGBuffer ( buffer, sizeof (buffer) ), bitOffsetFromStart );
     ASSERT_EQ (138, a);
 }
 
@@ -49,7 +59,7 @@ TEST(bitshort, bitshort_0_offset0)
     buffer[0] = 0b10000001;
     buffer[1] = 0b10000000;
     buffer[2] = 0b00000001;
-    short a = ReadBITSHORT ( buffer, bitOffsetFromStart );
+    short a = ReadBITSHORT ( DWGBuffer ( buffer, sizeof (buffer) ), bitOffsetFromStart );
     ASSERT_EQ (0, a);
 }
 
@@ -60,7 +70,7 @@ TEST(bitshort, bitshort_256_offset0)
     buffer[0] = 0b11000001;
     buffer[1] = 0b10000000;
     buffer[2] = 0b00000001;
-    short a = ReadBITSHORT ( buffer, bitOffsetFromStart );
+    short a = ReadBITSHORT ( DWGBuffer ( buffer, sizeof (buffer) ), bitOffsetFromStart );
     ASSERT_EQ (256, a);
 }
 
@@ -75,7 +85,7 @@ TEST(triplebits, triplebits_offset0)
     buffer[0] = 0b11000001;
     buffer[1] = 0b10000000;
     buffer[2] = 0b00000001;
-    char a = Read3B ( buffer, bitOffsetFromStart );
+    char a = Read3B ( DWGBuffer ( buffer, sizeof (buffer) ), bitOffsetFromStart );
     ASSERT_EQ (6, a);
 }
 
@@ -86,7 +96,7 @@ TEST(triplebits, triplebits_offset1)
     buffer[0] = 0b11000001;
     buffer[1] = 0b10000000;
     buffer[2] = 0b00000001;
-    char a = Read3B ( buffer, bitOffsetFromStart );
+    char a = Read3B ( DWGBuffer ( buffer, sizeof (buffer) ), bitOffsetFromStart );
     ASSERT_EQ (4, a);
 }
 
@@ -97,7 +107,7 @@ TEST(triplebits, triplebits_offset2)
     buffer[0] = 0b11000001;
     buffer[1] = 0b10000000;
     buffer[2] = 0b00000001;
-    char a = Read3B ( buffer, bitOffsetFromStart );
+    char a = Read3B ( DWGBuffer ( buffer, sizeof (buffer) ), bitOffsetFromStart );
     ASSERT_EQ (0, a);
 }
 
@@ -108,7 +118,7 @@ TEST(triplebits, triplebits_offset3)
     buffer[0] = 0b11000001;
     buffer[1] = 0b10000000;
     buffer[2] = 0b00000001;
-    char a = Read3B ( buffer, bitOffsetFromStart );
+    char a = Read3B ( DWGBuffer ( buffer, sizeof (buffer) ), bitOffsetFromStart );
     ASSERT_EQ (0, a);
 }
 
@@ -119,7 +129,7 @@ TEST(triplebits, triplebits_offset6)
     buffer[0] = 0b11000001;
     buffer[1] = 0b10000000;
     buffer[2] = 0b00000001;
-    char a = Read3B ( buffer, bitOffsetFromStart );
+    char a = Read3B ( DWGBuffer ( buffer, sizeof (buffer) ), bitOffsetFromStart );
     ASSERT_EQ (3, a);
 }
 
@@ -130,7 +140,7 @@ TEST(triplebits, triplebits_offset7)
     buffer[0] = 0b11000001;
     buffer[1] = 0b10000000;
     buffer[2] = 0b00000001;
-    char a = Read3B ( buffer, bitOffsetFromStart );
+    char a = Read3B ( DWGBuffer ( buffer, sizeof (buffer) ), bitOffsetFromStart );
     ASSERT_EQ (6, a);
 }
 
@@ -147,7 +157,7 @@ TEST(rawshort, rawshort_offset0)
     buffer[0] = 0b11100011;
     buffer[1] = 0b11111000;
     buffer[2] = 0b00000001;
-    short a = ReadRAWSHORT ( buffer, bitOffsetFromStart );
+    short a = ReadRAWSHORT ( DWGBuffer ( buffer, sizeof (buffer) ), bitOffsetFromStart );
     ASSERT_EQ (-1821, a);
 }
 
@@ -159,7 +169,7 @@ TEST(rawshort, rawshort_offset6)
     buffer[0] = 0b00000010;
     buffer[1] = 0b11110101;
     buffer[2] = 0b00100000;
-    short a = ReadRAWSHORT ( buffer, bitOffsetFromStart );
+    short a = ReadRAWSHORT ( DWGBuffer ( buffer, sizeof (buffer) ), bitOffsetFromStart );
     ASSERT_EQ (18621, a);
 }
 
@@ -171,6 +181,284 @@ TEST(rawshort, rawshort_offset7)
     buffer[0] = 0b00000001;
     buffer[1] = 0b10110001;
     buffer[2] = 0b01110001;
-    short a = ReadRAWSHORT ( buffer, bitOffsetFromStart );
+    short a = ReadRAWSHORT ( DWGBuffer ( buffer, sizeof (buffer) ), bitOffsetFromStart );
     ASSERT_EQ (-18216, a);
 }
+
+/*                                                          */
+/*               DWGBitReader tests packet.                 */
+/*                                                          */
+
+TEST(bitreader, sequential_read)
+{
+    // 101 + 1.5 as raw double (00 00 00 00 00 00 F8 3F)
+    char buffer[9];
+    buffer[0] = 0b10100000;
+    buffer[1] = 0b00000000;
+    buffer[2] = 0b00000000;
+    buffer[3] = 0b00000000;
+    buffer[4] = 0b00000000;
+    buffer[5] = 0b00000000;
+    buffer[6] = 0b00011111;
+    buffer[7] = 0b00000111;
+    buffer[8] = 0b11100000;
+    DWGBitReader reader ( DWGBuffer ( buffer, sizeof (buffer) ) );
+    ASSERT_TRUE (reader.ReadBIT ());
+    ASSERT_FALSE (reader.ReadBIT ());
+    ASSERT_TRUE (reader.ReadBIT ());
+    ASSERT_EQ (1.5, reader.ReadRAWDOUBLE ());
+    ASSERT_EQ (67, reader.GetBitOffset ());
+}
+
+TEST(bitreader, set_offset)
+{
+    char buffer[3];
+    // 10 11110101 00100000 = 18621
+    buffer[0] = 0b00000010;
+    buffer[1] = 0b11110101;
+    buffer[2] = 0b00100000;
+    DWGBitReader reader ( DWGBuffer ( buffer, sizeof (buffer) ), 6 );
+    ASSERT_EQ (18621, reader.ReadRAWSHORT ());
+    reader.SetBitOffset (6);
+    reader.SkipBits (2);
+    ASSERT_EQ (0b11110101, reader.ReadCHAR ());
+    ASSERT_EQ (16, reader.GetBitOffset ());
+}
+
+TEST(bitreader, same_as_functions)
+{
+    // functions read straight from the input, whole words in the middle and
+    // byte by byte at the end, they have to agree with the reader
+    char buffer[24];
+    for ( size_t i = 0; i < sizeof (buffer); ++i )
+        buffer[i] = static_cast<char>( i * 37 + 11 );
+    for ( size_t start = 0; start < 8 * 16; ++start )
+    {
+        DWGBuffer input ( buffer, sizeof (buffer) );
+        DWGBitReader reader ( input, start );
+        size_t offset = start;
+        ASSERT_EQ (reader.ReadBITSHORT (), ReadBITSHORT (input, offset));
+        ASSERT_EQ (reader.ReadBIT (), ReadBIT (input, offset));
+        ASSERT_EQ (reader.ReadRAWLONG (), ReadRAWLONG (input, offset));
+        ASSERT_EQ (reader.ReadRAWSHORT (), ReadRAWSHORT (input, offset));
+        ASSERT_EQ (reader.ReadHANDLE ().getAsLong (), ReadHANDLE (input, offset).getAsLong ());
+        ASSERT_EQ (reader.Read3B (), Read3B (input, offset));
+        ASSERT_EQ (reader.GetBitOffset (), offset);
+        ASSERT_EQ (reader.IsOverrun (), input.IsOverrun ());
+    }
+}
+
+TEST(dwgbuffer, overrun)
+{
+    char buffer[2];
+    buffer[0] = 0b00000001;
+    buffer[1] = 0b00000010;
+    DWGBuffer input ( buffer, 2 );
+    size_t offset = 0;
+    ASSERT_EQ (513, ReadRAWSHORT (input, offset));
+    ASSERT_FALSE (input.IsOverrun ());
+    ASSERT_EQ (0, ReadRAWLONG (input, offset));
+    ASSERT_TRUE (input.IsOverrun ());
+}
+
+TEST(objectindex, find)
+{
+    CADObjectIndex index;
+    index.Add (16, 1000);
+    index.Add (2, 200);
+    index.Add (5, 500);
+    index.Add (16, 1600);
+    index.Finalize ();
+    ASSERT_EQ (3, index.GetCount ());
+    long offset = 0;
+    ASSERT_TRUE (index.Find (16, offset));
+    ASSERT_EQ (1000, offset);
+    ASSERT_TRUE (index.Find (2, offset));
+    ASSERT_EQ (200, offset);
+    ASSERT_FALSE (index.Find (3, offset));
+    ASSERT_FALSE (index.Find (17, offset));
+    ASSERT_EQ (3, index.GetCount ());
+}
+
+TEST(objectindex, concurrent_save)
+{
+    CADObjectIndex index;
+    for ( long handle = 1; handle <= 1000; ++handle )
+        index.Add (handle, handle * 10);
+    index.Finalize ();
+    CADObjectIndex::CacheKey key = { 12345, 67890, 42 };
+    const std::string path = "./objectindex_concurrent.ocadidx";
+
+    // writers of the same cache don't share a temporary file
+    std::vector<char> saved (8, 0);
+    std::vector<std::thread> writers;
+    for ( size_t i = 0; i < saved.size (); ++i )
+        writers.push_back (std::thread ([&, i] { saved[i] = index.Save (path, key); }));
+    for ( std::thread& writer : writers )
+        writer.join ();
+    for ( char ok : saved )
+        ASSERT_TRUE (ok);
+
+    CADObjectIndex loaded;
+    ASSERT_TRUE (loaded.Load (path, key));
+    ASSERT_EQ (1000, loaded.GetCount ());
+    std::remove (path.c_str ());
+}
+
+TEST(mchar, five_bytes)
+{
+    // 0x12345678 takes 5 bytes, the sign is in bit 0x40 of the last one
+    const char buffer[] = { '\xf8', '\xac', '\xd1', '\x91', '\x01',
+                            '\xf8', '\xac', '\xd1', '\x91', '\x41' };
+    DWGBuffer input ( buffer, sizeof (buffer) );
+    size_t offset = 0;
+    ASSERT_EQ (0x12345678, ReadUMCHAR (input, offset));
+    ASSERT_EQ (40, offset);
+    ASSERT_EQ (-0x12345678, ReadMCHAR (input, offset));
+    ASSERT_EQ (80, offset);
+    ASSERT_FALSE (input.IsOverrun ());
+}
+
+TEST(mchar, pairs)
+{
+    const char buffer[] = { '\x01', '\xc8', '\x41',
+                            '\xf8', '\xac', '\xd1', '\x91', '\x01', '\x05',
+                            '\x80' };
+    std::vector<std::pair<long, long> > pairs;
+    ASSERT_TRUE (ReadUMCHARMCHARPairs (DWGBuffer (buffer, 9), 9, pairs));
+    ASSERT_EQ (2, pairs.size ());
+    ASSERT_EQ (1, pairs[0].first);
+    ASSERT_EQ (-200, pairs[0].second);
+    ASSERT_EQ (0x12345678, pairs[1].first);
+    ASSERT_EQ (5, pairs[1].second);
+
+    // last value doesn't end in the buffer
+    pairs.clear ();
+    DWGBuffer truncated ( buffer, sizeof (buffer) );
+    ASSERT_FALSE (ReadUMCHARMCHARPairs (truncated, sizeof (buffer), pairs));
+    ASSERT_TRUE (truncated.IsOverrun ());
+}
+
+TEST(mchar, unterminated)
+{
+    // continuation bit is set in all 8 bytes
+    const char buffer[] = { '\x81', '\x82', '\x83', '\x84', '\x85', '\x86', '\x87', '\x88',
+                            '\x01', '\x01', '\x01', '\x01', '\x01', '\x01', '\x01', '\x01' };
+    std::vector<std::pair<long, long> > pairs;
+    DWGBuffer first ( buffer, sizeof (buffer) );
+    ASSERT_FALSE (ReadUMCHARMCHARPairs (first, sizeof (buffer), pairs));
+    ASSERT_TRUE (first.IsOverrun ());
+
+    // second value of a pair
+    const char pair_buffer[] = { '\x01', '\x81', '\x82', '\x83', '\x84', '\x85', '\x86', '\x87', '\x88',
+                                 '\x01' };
+    ASSERT_FALSE (ReadUMCHARMCHARPairs (DWGBuffer (pair_buffer, sizeof (pair_buffer)), 1, pairs));
+    ASSERT_TRUE (pairs.empty ());
+
+    DWGBuffer input ( buffer, sizeof (buffer) );
+    size_t offset = 0;
+    ASSERT_EQ (0, ReadUMCHAR (input, offset));
+    ASSERT_TRUE (input.IsOverrun ());
+}
+
+TEST(handle, inline_value)
+{
+    ASSERT_TRUE (std::is_trivially_copyable<CADHandle>::value);
+
+    CADHandle handle;
+    ASSERT_TRUE (handle.isNull ());
+    handle.addOffset (0x01);
+    handle.addOffset (0x2c);
+    ASSERT_FALSE (handle.isNull ());
+    ASSERT_EQ (0x012c, handle.getAsLong ());
+
+    CADHandle copy = handle;
+    ASSERT_EQ (0x012c, copy.getAsLong ());
+
+    CADHandle offset (0x0C);
+    offset.addOffset (0x2c);
+    ASSERT_EQ (0x0100, offset.getAsLong (handle));
+
+    // only the lowest bytes of an oversized handle are kept
+    CADHandle oversized;
+    for (size_t i = 0; i < sizeof (long) + 2; ++i)
+        oversized.addOffset (static_cast<unsigned char>(i == sizeof (long) + 1 ? 0x7f : 0));
+    ASSERT_EQ (0x7f, oversized.getAsLong ());
+}
+
+static std::atomic<int> decoded_values_count (0);
+
+static CADVariant DecodeTestValue (const char * data, size_t, size_t offset, short type)
+{
+    ++decoded_values_count;
+    return type == 1 ? CADVariant (static_cast<short>(data[offset / 8])) : CADVariant ();
+}
+
+TEST(header, raw_values)
+{
+    std::vector<char> raw = { 5, 7 };
+    CADHeader header;
+    header.setRawData (std::move (raw), DecodeTestValue);
+    ASSERT_EQ (CADErrorCodes::SUCCESS, header.addRawValue (CADHeader::EXTMAX, 8, 1));
+    ASSERT_EQ (CADErrorCodes::SUCCESS, header.addValue (CADHeader::ACADVER, "AC1015"));
+    ASSERT_EQ (CADErrorCodes::SUCCESS, header.addRawValue (CADHeader::EXTMIN, 0, 1));
+    ASSERT_EQ (CADErrorCodes::VALUE_EXISTS, header.addValue (CADHeader::EXTMIN, 1));
+
+    ASSERT_EQ (3, header.getSize ());
+    ASSERT_EQ (5, header.getValue (CADHeader::EXTMIN).getDecimal ());
+    ASSERT_EQ (7, header.getValue (CADHeader::EXTMAX).getDecimal ());
+    ASSERT_EQ ("AC1015", header.getValue (CADHeader::ACADVER).getString ());
+    ASSERT_EQ (CADVariant::DataType::INVALID, header.getValue (CADHeader::INSBASE).getType ());
+
+    // codes are listed in ascending order
+    ASSERT_EQ (CADHeader::ACADVER, header.getCode (0));
+    ASSERT_EQ (CADHeader::EXTMAX, header.getCode (1));
+    ASSERT_EQ (CADHeader::EXTMIN, header.getCode (2));
+
+    // raw values are decoded once, concurrent readers too
+    decoded_values_count = 0;
+    CADHeader shared;
+    std::vector<char> shared_raw = { 5, 7 };
+    shared.setRawData (std::move (shared_raw), DecodeTestValue);
+    shared.addRawValue (CADHeader::EXTMIN, 0, 1);
+    shared.addRawValue (CADHeader::EXTMAX, 8, 1);
+    ASSERT_EQ (5, shared.getValue (CADHeader::EXTMIN).getDecimal ());
+    std::vector<std::thread> threads;
+    std::atomic<int> mismatches (0);
+    for ( int i = 0; i < 4; ++i )
+    {
+        threads.emplace_back ([&shared, &mismatches]
+        {
+            for ( int j = 0; j < 100; ++j )
+            {
+                if ( shared.getValue (CADHeader::EXTMIN).getDecimal () != 5 ||
+                     shared.getValue (CADHeader::EXTMAX).getDecimal () != 7 )
+                    ++mismatches;
+            }
+        });
+    }
+    for ( std::thread& thread : threads )
+        thread.join ();
+    ASSERT_EQ (0, mismatches);
+    ASSERT_GE (decoded_values_count, 2);
+    ASSERT_LE (decoded_values_count, 5);
+}
+
+TEST(objectpool, reuse)
+{
+    void * block = CADObjectPool::Allocate (200);
+    ASSERT_NE (nullptr, block);
+    CADObjectPool::Free (block, 200);
+    // freed block is handed out to the next object of the same size class
+    void * reused = CADObjectPool::Allocate (250);
+    // pool is off by default and with address sanitizer
+    if ( CADObjectPool::IsEnabled () )
+    {
+        ASSERT_EQ (block, reused);
+    }
+    CADObjectPool::Free (reused, 250);
+
+    void * big = CADObjectPool::Allocate (100000);
+    ASSERT_NE (nullptr, big);
+    CADObjectPool::Free (big, 100000);
+}
@@ -0,0 +1,59 @@
+#include "gtest/gtest.h"
+#include "cadobjectpool.h"
+
+#include <thread>
+#include <vector>
+
+// Built with the pool compiled in, see objectpool_test in CMakeLists.txt.
+// Address sanitizer still turns the pool off.
+
+TEST(objectpool, enabled_reuse)
+{
+    if ( !CADObjectPool::IsEnabled () )
+        return;
+
+    void * block = CADObjectPool::Allocate (200);
+    ASSERT_NE (nullptr, block);
+    CADObjectPool::Free (block, 200);
+    void * reused = CADObjectPool::Allocate (250);
+    ASSERT_EQ (block, reused);
+    // other size class gets other block
+    void * small = CADObjectPool::Allocate (10);
+    ASSERT_NE (reused, small);
+    CADObjectPool::Free (small, 10);
+    CADObjectPool::Free (reused, 250);
+
+    void * big = CADObjectPool::Allocate (100000);
+    ASSERT_NE (nullptr, big);
+    CADObjectPool::Free (big, 100000);
+}
+
+TEST(objectpool, enabled_threads)
+{
+    // blocks freed by a thread and by other thread than the allocating one
+    const size_t blocks_count = 2000;
+    std::vector<void *> blocks (blocks_count);
+    std::thread allocating ([&blocks]
+    {
+        for ( size_t i = 0; i < blocks.size (); ++i )
+        {
+            blocks[i] = CADObjectPool::Allocate (i % 900 + 1);
+            static_cast<char *>( blocks[i] )[i % 900] = 1;
+        }
+    });
+    allocating.join ();
+
+    std::vector<std::thread> threads;
+    for ( size_t t = 0; t < 4; ++t )
+    {
+        threads.emplace_back ([&blocks, t]
+        {
+            for ( size_t i = t; i < blocks.size (); i += 4 )
+                CADObjectPool::Free (blocks[i], i % 900 + 1);
+            for ( size_t i = 0; i < 500; ++i )
+                CADObjectPool::Free (CADObjectPool::Allocate (i + 1), i + 1);
+        });
+    }
+    for ( std::thread& thread : threads )
+        thread.join ();
+}
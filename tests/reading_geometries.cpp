@@ -1,6 +1,20 @@
 #include "gtest/gtest.h"
 #include "opencad_api.h"
 #include "cadgeometry.h"
+#include "cadfilestreamio.h"
+#include "cadfilememoryio.h"
+#include "dwg/r2000.h"
+
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
 
 // Following test demonstrates reading only actual geometries (deleted skipped).
 
@@ -31,6 +45,153 @@ TEST(reading_geometries, 24127_circles_128_lines)
     delete openedDwg;
 }
 
+TEST(reading_geometries, 24127_circles_128_lines_parallel)
+{
+    auto openedDwg = OpenCADFile ("./data/r2000/24127_circles_128_lines.dwg",
+                                   CADFile::OpenOptions::READ_FAST);
+    ASSERT_NE (openedDwg, nullptr);
+
+    std::atomic<int> circles_count( 0 );
+    std::atomic<int> lines_count( 0 );
+    int result = openedDwg->ReadAllGeometries (4,
+        [&]( size_t, size_t, CADGeometry * geom )
+        {
+            if ( geom->getType() == CADGeometry::GeometryType::CIRCLE )
+                ++circles_count;
+            else if ( geom->getType() == CADGeometry::GeometryType::LINE )
+                ++lines_count;
+            delete geom;
+        });
+
+    ASSERT_EQ (result, CADErrorCodes::SUCCESS);
+    ASSERT_EQ (circles_count, 24127);
+    ASSERT_EQ (lines_count, 128);
+    delete openedDwg;
+}
+
+TEST(reading_geometries, 24127_circles_128_lines_parallel_exception)
+{
+    auto openedDwg = OpenCADFile ("./data/r2000/24127_circles_128_lines.dwg",
+                                   CADFile::OpenOptions::READ_FAST);
+    ASSERT_NE (openedDwg, nullptr);
+
+    // exception of any worker reaches the caller after all workers stop
+    std::atomic<int> read_count( 0 );
+    ASSERT_THROW (openedDwg->ReadAllGeometries (4,
+        [&]( size_t, size_t index, CADGeometry * geom )
+        {
+            delete geom;
+            if ( ++read_count > 1000 || index % 5000 == 4999 )
+                throw std::runtime_error ("stop");
+        }), std::runtime_error);
+
+    // file can still be read after it
+    read_count = 0;
+    int result = openedDwg->ReadAllGeometries (4,
+        [&]( size_t, size_t, CADGeometry * geom )
+        {
+            ++read_count;
+            delete geom;
+        });
+    ASSERT_EQ (result, CADErrorCodes::SUCCESS);
+    ASSERT_EQ (read_count, 24127 + 128);
+    delete openedDwg;
+}
+
+TEST(reading_geometries, 24127_circles_128_lines_index_cache)
+{
+    const char * path = "./data/r2000/24127_circles_128_lines.dwg";
+    const std::string cache_path = std::string (path) + ".ocadidx";
+    std::remove (cache_path.c_str ());
+
+    for ( int pass = 0; pass < 2; ++pass )
+    {
+        auto openedDwg = OpenCADFile (path, CADFile::OpenOptions::READ_FAST,
+                                      false, true);
+        ASSERT_NE (openedDwg, nullptr);
+        ASSERT_TRUE (std::ifstream (cache_path.c_str ()).good ());
+
+        auto circles_count = 0;
+        CADLayer &layer = openedDwg->GetLayer (0);
+        for ( size_t i = 0; i < layer.getGeometryCount (); ++i )
+        {
+            CADGeometry * geom = layer.getGeometry (i);
+            if ( geom->getType() == CADGeometry::GeometryType::CIRCLE )
+                ++circles_count;
+            delete geom;
+        }
+        ASSERT_EQ (circles_count, 24127);
+        delete openedDwg;
+    }
+
+    std::remove (cache_path.c_str ());
+}
+
+TEST(reading_geometries, 24127_circles_128_lines_cursor)
+{
+    auto openedDwg = OpenCADFile ("./data/r2000/24127_circles_128_lines.dwg",
+                                   CADFile::OpenOptions::READ_FAST);
+    ASSERT_NE (openedDwg, nullptr);
+
+    auto circles_count = 0;
+    auto lines_count = 0;
+    size_t layer_index = 0;
+    CADFile::EntityCursor cursor (openedDwg);
+    while ( CADGeometry * geom = cursor.Next (layer_index) )
+    {
+        ASSERT_EQ (layer_index, 0);
+        if ( geom->getType() == CADGeometry::GeometryType::CIRCLE )
+            ++circles_count;
+        else if ( geom->getType() == CADGeometry::GeometryType::LINE )
+            ++lines_count;
+        delete geom;
+    }
+    ASSERT_EQ (cursor.Next (layer_index), nullptr);
+
+    ASSERT_EQ (circles_count, 24127);
+    ASSERT_EQ (lines_count, 128);
+    delete openedDwg;
+}
+
+TEST(reading_geometries, 24127_circles_128_lines_filter)
+{
+    auto openedDwg = OpenCADFile ("./data/r2000/24127_circles_128_lines.dwg",
+                                   CADFile::OpenOptions::READ_FAST);
+    ASSERT_NE (openedDwg, nullptr);
+    openedDwg->SetGeometryFilter ({ CADObject::LINE }, { "0" });
+
+    CADLayer &layer = openedDwg->GetLayer (0);
+    ASSERT_EQ (layer.getGeometryCount (), 128);
+    for ( size_t i = 0; i < layer.getGeometryCount (); ++i )
+    {
+        CADGeometry * geom = layer.getGeometry (i);
+        ASSERT_EQ (geom->getType(), CADGeometry::GeometryType::LINE);
+        delete geom;
+    }
+
+    auto lines_count = 0;
+    size_t layer_index = 0;
+    CADFile::EntityCursor cursor (openedDwg);
+    while ( CADGeometry * geom = cursor.Next (layer_index) )
+    {
+        ASSERT_EQ (geom->getType(), CADGeometry::GeometryType::LINE);
+        ++lines_count;
+        delete geom;
+    }
+    ASSERT_EQ (lines_count, 128);
+    delete openedDwg;
+
+    // layer filter
+    openedDwg = OpenCADFile ("./data/r2000/24127_circles_128_lines.dwg",
+                             CADFile::OpenOptions::READ_FAST);
+    ASSERT_NE (openedDwg, nullptr);
+    openedDwg->SetGeometryFilter ({}, { "no such layer" });
+    ASSERT_EQ (openedDwg->GetLayer (0).getGeometryCount (), 0);
+    CADFile::EntityCursor empty_cursor (openedDwg);
+    ASSERT_EQ (empty_cursor.Next (layer_index), nullptr);
+    delete openedDwg;
+}
+
 
 TEST(reading_geometries, 256_polylines_7vertexes)
 {
@@ -151,6 +312,128 @@ TEST(reading_geometries, six_3dpolylines)
     delete openedDwg;
 }
 
+TEST(reading_geometries, six_3dpolylines_object_cache)
+{
+    auto openedDwg = OpenCADFile ( "./data/r2000/six_3dpolylines.dwg",
+                                    CADFile::OpenOptions::READ_FAST) ;
+    ASSERT_NE (openedDwg, nullptr);
+    CADLayer &layer = openedDwg->GetLayer (0);
+
+    std::vector<size_t> vertex_counts;
+    for ( int pass = 0; pass < 2; ++pass )
+    {
+        size_t hits = openedDwg->GetObjectCacheHits ();
+        for ( size_t i = 0; i < layer.getGeometryCount (); ++i )
+        {
+            CADPolyline3D * polyline3D = static_cast<CADPolyline3D*>(layer.getGeometry (i));
+            if ( pass == 0 )
+            {
+                vertex_counts.push_back (polyline3D->getVertexCount ());
+            }
+            else
+            {
+                ASSERT_EQ (vertex_counts[i], polyline3D->getVertexCount ());
+            }
+            delete polyline3D;
+        }
+        // second pass is served from cache
+        if ( pass == 1 )
+        {
+            ASSERT_GT (openedDwg->GetObjectCacheHits (), hits + 6);
+        }
+    }
+
+    openedDwg->SetObjectCacheSize (0);
+    size_t misses = openedDwg->GetObjectCacheMisses ();
+    delete layer.getGeometry (0);
+    ASSERT_GT (openedDwg->GetObjectCacheMisses (), misses);
+    delete openedDwg;
+}
+
+// Gives access to the object map, to damage objects of the file
+class ObjectMapFile : public DWGFileR2000
+{
+public:
+    explicit ObjectMapFile (CADFileIO * poFileIO) : DWGFileR2000 (poFileIO)
+    {
+    }
+
+    // File offsets of the last vertexes of the 3D polylines
+    std::vector<long> GetLastVertexOffsets ()
+    {
+        std::vector<long> offsets;
+        for ( const CADObjectIndex::Entry& entry : oObjectIndex.GetEntries () )
+        {
+            std::unique_ptr<CADObject> object (GetObject (entry.nHandle));
+            if ( object == nullptr || object->getType () != CADObject::POLYLINE3D )
+                continue;
+            CADPolyline3DObject * polyline =
+                    static_cast<CADPolyline3DObject *>(object.get ());
+            long offset = 0;
+            if ( oObjectIndex.Find (polyline->hVertexes[1].getAsLong (), offset) )
+                offsets.push_back (offset);
+        }
+        return offsets;
+    }
+};
+
+TEST(reading_geometries, six_3dpolylines_truncated_vertex)
+{
+    std::ifstream input ("./data/r2000/six_3dpolylines.dwg", std::ios::binary);
+    std::vector<char> data ((std::istreambuf_iterator<char> (input)),
+                             std::istreambuf_iterator<char> ());
+    ASSERT_FALSE (data.empty ());
+
+    std::vector<size_t> vertex_counts;
+    std::vector<long> offsets;
+    {
+        ObjectMapFile file (new CADFileMemoryIO (data.data (), data.size ()));
+        ASSERT_EQ (file.ParseFile (CADFile::OpenOptions::READ_FAST), CADErrorCodes::SUCCESS);
+        CADLayer &layer = file.GetLayer (0);
+        for ( size_t i = 0; i < layer.getGeometryCount (); ++i )
+        {
+            std::unique_ptr<CADGeometry> geometry (layer.getGeometry (i));
+            ASSERT_NE (geometry, nullptr);
+            vertex_counts.push_back (
+                static_cast<CADPolyline3D *>(geometry.get ())->getVertexCount ());
+        }
+        offsets = file.GetLastVertexOffsets ();
+    }
+    ASSERT_EQ (offsets.size (), vertex_counts.size ());
+
+    // Object sizes which run far past the end of the file
+    for ( long offset : offsets )
+    {
+        ASSERT_LT (offset + 4, static_cast<long>(data.size ()));
+        data[offset] = data[offset + 1] = data[offset + 2] = '\xFF';
+        data[offset + 3] = '\x7F';
+    }
+
+    auto openedDwg = OpenCADFile (data.data (), data.size (),
+                                  CADFile::OpenOptions::READ_FAST);
+    ASSERT_NE (openedDwg, nullptr);
+    CADLayer &layer = openedDwg->GetLayer (0);
+    ASSERT_EQ (layer.getGeometryCount (), vertex_counts.size ());
+    for ( size_t i = 0; i < layer.getGeometryCount (); ++i )
+    {
+        std::unique_ptr<CADGeometry> geometry (layer.getGeometry (i));
+        ASSERT_NE (geometry, nullptr);
+        ASSERT_EQ (static_cast<CADPolyline3D *>(geometry.get ())->getVertexCount (),
+                   vertex_counts[i] - 1);
+    }
+
+    size_t cursor_count = 0;
+    size_t layer_index = 0;
+    CADFile::EntityCursor cursor (openedDwg);
+    while ( CADGeometry * geom = cursor.Next (layer_index) )
+    {
+        ++cursor_count;
+        delete geom;
+    }
+    ASSERT_EQ (cursor_count, vertex_counts.size ());
+    delete openedDwg;
+}
+
 TEST(reading_circles, triplet)
 {
     auto openedDwg = OpenCADFile ("./data/r2000/triple_circles.dwg",
@@ -299,3 +582,619 @@ TEST(reading_geometries, 1arc)
     delete opened_dwg;
 }
 
+TEST(reading_geometries, 256_polylines_stream_io)
+{
+    // Same file as above, but read through stream io instead of the default
+    // memory mapped one.
+    auto opened_dwg = OpenCADFile (new CADFileStreamIO ("./data/r2000/256_lwpolylines_7vertexes.dwg"),
+                                   CADFile::OpenOptions::READ_FAST);
+    ASSERT_NE (opened_dwg, nullptr);
+    auto lwplines_count = 0;
+
+    CADLayer &layer = opened_dwg->GetLayer (0);
+    CADGeometry * geom;
+    for ( size_t i = 0; i < layer.getGeometryCount (); ++i )
+    {
+        geom = layer.getGeometry (i);
+        if ( geom->getType() == CADGeometry::LWPOLYLINE )
+        {
+            ++lwplines_count;
+
+            CADLWPolyline * poly = static_cast<CADLWPolyline*>(geom);
+            ASSERT_EQ( poly->getVertexCount(), 7);
+        }
+        delete geom;
+    }
+
+    ASSERT_EQ (256, lwplines_count);
+    delete opened_dwg;
+}
+
+
+TEST(reading_geometries, 24127_circles_128_lines_batch)
+{
+    // Stream io reads objects through the batch read window, memory mapped
+    // one directly.
+    auto openedDwg = OpenCADFile (new CADFileStreamIO ("./data/r2000/24127_circles_128_lines.dwg"),
+                                  CADFile::OpenOptions::READ_FAST);
+    ASSERT_NE (openedDwg, nullptr);
+    CADLayer &layer = openedDwg->GetLayer (0);
+
+    // reversed and repeated indexes
+    std::vector<size_t> indexes;
+    for ( size_t i = layer.getGeometryCount (); i > 0; i -= 7 )
+        indexes.push_back (i - 1);
+    indexes.push_back (0);
+    indexes.push_back (0);
+
+    std::vector<CADGeometry *> geoms = layer.getGeometries (indexes);
+    ASSERT_EQ (geoms.size (), indexes.size ());
+    for ( size_t i = 0; i < indexes.size (); ++i )
+    {
+        ASSERT_NE (geoms[i], nullptr);
+        CADGeometry * geom = layer.getGeometry (indexes[i]);
+        ASSERT_EQ (geoms[i]->getType (), geom->getType ());
+        if ( geom->getType () == CADGeometry::GeometryType::CIRCLE )
+        {
+            CADVector center = static_cast<CADCircle *>(geom)->getPosition ();
+            CADVector batch_center = static_cast<CADCircle *>(geoms[i])->getPosition ();
+            ASSERT_DOUBLE_EQ (center.getX (), batch_center.getX ());
+            ASSERT_DOUBLE_EQ (center.getY (), batch_center.getY ());
+        }
+        delete geom;
+        delete geoms[i];
+    }
+    delete openedDwg;
+}
+
+TEST(reading_geometries, 24127_circles_128_lines_shared_stream_io)
+{
+    // Several threads read through one stream io without own copies of it,
+    // object reads use positional ReadAt() instead of Seek() + Read().
+    auto openedDwg = OpenCADFile (new CADFileStreamIO ("./data/r2000/24127_circles_128_lines.dwg"),
+                                  CADFile::OpenOptions::READ_FAST);
+    ASSERT_NE (openedDwg, nullptr);
+    CADLayer &layer = openedDwg->GetLayer (0);
+
+    std::atomic<int> circles_count( 0 );
+    std::atomic<int> lines_count( 0 );
+    const size_t nThreads = 4;
+    const size_t nCount = layer.getGeometryCount ();
+    std::vector<std::thread> threads;
+    for ( size_t t = 0; t < nThreads; ++t )
+    {
+        threads.push_back (std::thread ([&, t]()
+        {
+            for ( size_t i = t * nCount / nThreads; i < (t + 1) * nCount / nThreads; ++i )
+            {
+                CADGeometry * geom = layer.getGeometry (i);
+                if ( geom == nullptr )
+                    continue;
+                if ( geom->getType() == CADGeometry::GeometryType::CIRCLE )
+                    ++circles_count;
+                else if ( geom->getType() == CADGeometry::GeometryType::LINE )
+                    ++lines_count;
+                delete geom;
+            }
+        }));
+    }
+    for ( std::thread& thread : threads )
+        thread.join ();
+
+    ASSERT_EQ (circles_count, 24127);
+    ASSERT_EQ (lines_count, 128);
+    delete openedDwg;
+}
+
+TEST(reading_geometries, 24127_circles_128_lines_memory_io)
+{
+    // File content comes from memory, e.g. a request body, not from the disk.
+    std::ifstream file ("./data/r2000/24127_circles_128_lines.dwg", std::ios::binary);
+    std::vector<char> data ((std::istreambuf_iterator<char> (file)),
+                             std::istreambuf_iterator<char> ());
+    ASSERT_FALSE (data.empty ());
+
+    auto openedDwg = OpenCADFile (data.data (), data.size (), CADFile::OpenOptions::READ_FAST);
+    ASSERT_NE (openedDwg, nullptr);
+    auto circles_count = 0;
+    auto lines_count = 0;
+
+    CADLayer &layer = openedDwg->GetLayer (0);
+    for ( size_t i = 0; i < layer.getGeometryCount (); ++i )
+    {
+        CADGeometry * geom = layer.getGeometry (i);
+        if ( geom->getType() == CADGeometry::GeometryType::CIRCLE )
+            ++circles_count;
+        else if ( geom->getType() == CADGeometry::GeometryType::LINE )
+            ++lines_count;
+        delete geom;
+    }
+
+    ASSERT_EQ (circles_count, 24127);
+    ASSERT_EQ (lines_count, 128);
+    delete openedDwg;
+
+    // not a DWG
+    std::vector<char> garbage (data.size (), 'x');
+    ASSERT_EQ (OpenCADFile (garbage.data (), garbage.size (), CADFile::OpenOptions::READ_FAST), nullptr);
+    ASSERT_EQ (GetLastErrorCode (), CADErrorCodes::UNSUPPORTED_VERSION);
+}
+
+TEST(reading_geometries, bounding_boxes)
+{
+    // quarter arc from 0 to 90 degrees crosses no other axis
+    CADArc arc;
+    arc.setPosition (CADVector (10, 10, 0));
+    arc.setRadius (2);
+    arc.setStartingAngle (0);
+    arc.setEndingAngle (std::acos (0.0));
+    CADBoundingBox box = arc.getBoundingBox ();
+    ASSERT_NEAR (box.getMin ().getX (), 10, 1e-9);
+    ASSERT_NEAR (box.getMin ().getY (), 10, 1e-9);
+    ASSERT_NEAR (box.getMax ().getX (), 12, 1e-9);
+    ASSERT_NEAR (box.getMax ().getY (), 12, 1e-9);
+
+    // half circle bulge from (1, 0) to (-1, 0) goes up to (0, 1)
+    CADLWPolyline poly;
+    poly.addVertex (CADVector (1, 0));
+    poly.addVertex (CADVector (-1, 0));
+    poly.setBulges ({ 1.0, 0.0 });
+    box = poly.getBoundingBox ();
+    ASSERT_GE (box.getMax ().getY (), 1.0);
+    ASSERT_LE (box.getMin ().getY (), 0.0);
+
+    CADUnknown unknown;
+    ASSERT_TRUE (unknown.getBoundingBox ().isEmpty ());
+}
+
+TEST(reading_geometries, 24127_circles_128_lines_query)
+{
+    auto openedDwg = OpenCADFile ("./data/r2000/24127_circles_128_lines.dwg",
+                                  CADFile::OpenOptions::READ_FAST);
+    ASSERT_NE (openedDwg, nullptr);
+    CADLayer &layer = openedDwg->GetLayer (0);
+
+    // whole drawing box, then its lower left quarter
+    CADBoundingBox all;
+    for ( size_t i = 0; i < layer.getGeometryCount (); ++i )
+    {
+        CADGeometry * geom = layer.getGeometry (i);
+        all.addBox (geom->getBoundingBox ());
+        delete geom;
+    }
+    ASSERT_EQ (layer.queryIndexes (all).size (), layer.getGeometryCount ());
+
+    CADVector min = all.getMin ();
+    CADVector max = all.getMax ();
+    CADBoundingBox tile (min, CADVector ((min.getX () + max.getX ()) / 2,
+                                         (min.getY () + max.getY ()) / 2, max.getZ ()));
+    std::vector<size_t> expected;
+    for ( size_t i = 0; i < layer.getGeometryCount (); ++i )
+    {
+        CADGeometry * geom = layer.getGeometry (i);
+        if ( geom->getBoundingBox ().intersectsXY (tile) )
+            expected.push_back (i);
+        delete geom;
+    }
+    ASSERT_FALSE (expected.empty ());
+    ASSERT_LT (expected.size (), layer.getGeometryCount ());
+    ASSERT_EQ (layer.queryIndexes (tile), expected);
+
+    std::vector<CADGeometry *> geoms = layer.query (tile);
+    ASSERT_EQ (geoms.size (), expected.size ());
+    for ( CADGeometry * geom : geoms )
+    {
+        ASSERT_NE (geom, nullptr);
+        ASSERT_TRUE (geom->getBoundingBox ().intersectsXY (tile));
+        delete geom;
+    }
+    delete openedDwg;
+}
+
+TEST(reading_geometries, triple_circles_model_space_block)
+{
+    auto openedDwg = OpenCADFile ("./data/r2000/triple_circles.dwg",
+                                  CADFile::OpenOptions::READ_FAST);
+    ASSERT_NE (openedDwg, nullptr);
+    openedDwg->SetExpandBlockReferences (false);
+
+    CADLayer &layer = openedDwg->GetLayer (0);
+    ASSERT_EQ (layer.getBlockReferenceCount (), 0);
+
+    // model space is a block too, its geometries are decoded once
+    long modelSpace = openedDwg->getTables ().GetTableHandle (
+                CADTables::BlockRecordModelSpace ).getAsLong ();
+    std::shared_ptr<const CADBlock> block = openedDwg->GetBlock (modelSpace);
+    ASSERT_NE (block, nullptr);
+    ASSERT_EQ (block, openedDwg->GetBlock (modelSpace));
+    ASSERT_STREQ (block->getName ().c_str (), "*Model_Space");
+    ASSERT_EQ (block->getGeometryCount (), layer.getGeometryCount ());
+    ASSERT_EQ (block->getBlockReferenceCount (), 0);
+
+    const CADGeometry * geometry = block->getGeometry (0);
+    ASSERT_EQ (geometry->getType (), CADGeometry::GeometryType::CIRCLE);
+    ASSERT_NEAR (static_cast<const CADCircle *>( geometry )->getRadius (), 16.6, 0.0001);
+
+    // a layer isn't a block
+    ASSERT_EQ (openedDwg->GetBlock (layer.getHandle ()), nullptr);
+    delete openedDwg;
+}
+
+TEST(reading_geometries, matrix_transform)
+{
+    // block reference: scale, then rotate, then move to insertion point
+    Matrix mat;
+    mat.translate (CADVector (10, 20, 5));
+    mat.rotate (std::acos (0.0));
+    mat.scale (CADVector (2, 3, 1));
+    CADVector pt = mat.multiply (CADVector (1, 1, 0));
+    ASSERT_NEAR (pt.getX (), 7, 1e-9);
+    ASSERT_NEAR (pt.getY (), 22, 1e-9);
+    ASSERT_NEAR (pt.getZ (), 5, 1e-9);
+
+    // batch transform gives the same as one by one
+    CADLWPolyline poly;
+    for( int i = 0; i < 7; ++i )
+        poly.addVertex (CADVector (i, i * i));
+    poly.transform (mat);
+    for( size_t i = 0; i < poly.getVertexCount (); ++i )
+    {
+        CADVector expected = mat.multiply (CADVector (i, i * i));
+        ASSERT_NEAR (poly.getVertex (i).getX (), expected.getX (), 1e-9);
+        ASSERT_NEAR (poly.getVertex (i).getY (), expected.getY (), 1e-9);
+        ASSERT_NEAR (poly.getVertex (i).getZ (), expected.getZ (), 1e-9);
+    }
+
+    // extrusion opposite to Z axis mirrors X
+    Matrix mirror;
+    mirror.extrude (CADVector (0, 0, -1));
+    pt = mirror.multiply (CADVector (1, 2, 3));
+    ASSERT_NEAR (pt.getX (), -1, 1e-9);
+    ASSERT_NEAR (pt.getY (), 2, 1e-9);
+    ASSERT_NEAR (pt.getZ (), -3, 1e-9);
+}
+
+TEST(reading_geometries, 256_polylines_2d_vertexes)
+{
+    ASSERT_TRUE (std::is_trivially_copyable<CADVector>::value);
+    ASSERT_EQ (sizeof (CADVector), 3 * sizeof (double));
+
+    auto opened_dwg = OpenCADFile ("./data/r2000/256_lwpolylines_7vertexes.dwg",
+                                   CADFile::OpenOptions::READ_FAST);
+    ASSERT_NE (opened_dwg, nullptr);
+    std::unique_ptr<CADGeometry> geom (opened_dwg->GetLayer (0).getGeometry (0));
+    ASSERT_EQ (geom->getType (), CADGeometry::LWPOLYLINE);
+    CADLWPolyline * poly = static_cast<CADLWPolyline *>( geom.get () );
+    ASSERT_FALSE (poly->getBHasZ ());
+
+    // copies of vertex arrays are plain memory copies
+    CADLWPolyline copy (*poly);
+    ASSERT_EQ (copy.getVertexCount (), poly->getVertexCount ());
+    ASSERT_TRUE (copy.getVertex (3) == poly->getVertex (3));
+
+    Matrix mat;
+    mat.translate (CADVector (0, 0, 10));
+    poly->transform (mat);
+    ASSERT_TRUE (poly->getBHasZ ());
+    ASSERT_NEAR (poly->getVertex (0).getZ (), 10, 1e-9);
+    delete opened_dwg;
+}
+
+TEST(reading_geometries, 256_polylines_const_accessors)
+{
+    auto opened_dwg = OpenCADFile ("./data/r2000/256_lwpolylines_7vertexes.dwg",
+                                   CADFile::OpenOptions::READ_FAST);
+    ASSERT_NE (opened_dwg, nullptr);
+    CADLayer &layer = opened_dwg->GetLayer (0);
+
+    // layer containers are handed out without copying
+    ASSERT_EQ (&layer.getGeometryTypes (), &layer.getGeometryTypes ());
+    ASSERT_EQ (&layer.getAttributesTags (), &layer.getAttributesTags ());
+
+    std::unique_ptr<CADGeometry> geom (layer.getGeometry (0));
+    ASSERT_EQ (geom->getType (), CADGeometry::LWPOLYLINE);
+    CADLWPolyline * poly = static_cast<CADLWPolyline *>( geom.get () );
+    const std::vector<CADVector>& vertexes = poly->getVertexes ();
+    ASSERT_EQ (vertexes.size (), poly->getVertexCount ());
+    ASSERT_EQ (&vertexes[0], &poly->getVertex (0));
+    ASSERT_EQ (&poly->getBulges (), &poly->getBulges ());
+
+    // moved in containers keep their storage
+    std::vector<double> bulges (vertexes.size (), 0.5);
+    const double * data = bulges.data ();
+    poly->setBulges (std::move (bulges));
+    ASSERT_EQ (poly->getBulges ().data (), data);
+    ASSERT_TRUE (poly->hasBulges ());
+    delete opened_dwg;
+}
+
+// Drawing kept in memory, for the cases there is no test file for. Model
+// space holds a reference of block "outer" and a point, the block holds a
+// reference of block "inner" and a point, the inner block holds two points.
+class NestedBlocksFile : public CADFile
+{
+public:
+    NestedBlocksFile (const CADVector& outerBasePoint = CADVector (),
+                      const CADVector& innerBasePoint = CADVector ())
+        : CADFile (nullptr)
+    {
+        CADLayerControlObject layers;
+        layers.hLayers.push_back (Handle (LAYER));
+        Add (LAYER_CONTROL, layers);
+
+        CADLayerObject layer;
+        layer.hObjectHandle = Handle (LAYER);
+        layer.sLayerName = "0";
+        Add (LAYER, layer);
+
+        AddBlock (MODEL_SPACE, "*Model_Space", CADVector (), OUTER_INSERT, MODEL_POINT);
+        AddInsert (OUTER_INSERT, MODEL_POINT, OUTER_BLOCK, CADVector (100, 200, 0), 0, CADVector (2, 2, 2));
+        AddPoint (MODEL_POINT, 0, CADVector (100, 0, 0));
+
+        AddBlock (OUTER_BLOCK, "outer", outerBasePoint, INNER_INSERT, OUTER_POINT);
+        AddInsert (INNER_INSERT, OUTER_POINT, INNER_BLOCK, CADVector (0, 10, 0), std::acos (0.0),
+                   CADVector (1, 1, 1));
+        AddPoint (OUTER_POINT, 0, CADVector (1, 0, 0));
+
+        AddBlock (INNER_BLOCK, "inner", innerBasePoint, INNER_POINT1, INNER_POINT2);
+        AddPoint (INNER_POINT1, INNER_POINT2, CADVector (1, 0, 0));
+        AddPoint (INNER_POINT2, 0, CADVector (0, 1, 0));
+
+        oTables.AddTable (CADTables::LayersTable, Handle (LAYER_CONTROL));
+        oTables.AddTable (CADTables::BlockRecordModelSpace, Handle (MODEL_SPACE));
+        ReadTables (CADFile::OpenOptions::READ_ALL);
+    }
+
+    virtual CADDictionary GetNOD () override { return CADDictionary (); }
+
+protected:
+    enum
+    {
+        LAYER_CONTROL = 1, LAYER, MODEL_SPACE, OUTER_INSERT, MODEL_POINT, OUTER_BLOCK,
+        INNER_INSERT, OUTER_POINT, INNER_BLOCK, INNER_POINT1, INNER_POINT2
+    };
+
+    static CADHandle Handle (long handle)
+    {
+        CADHandle out (4);
+        if ( handle != 0 )
+            out.addOffset (static_cast<unsigned char>( handle ));
+        return out;
+    }
+
+    template<class T> void Add (long handle, const T& object)
+    {
+        objects[handle] = [object] { return new T (object); };
+    }
+
+    template<class T> void AddEntity (long handle, long next, T& entity)
+    {
+        entity.stCed.hObjectHandle = Handle (handle);
+        entity.stCed.bbEntMode = 2;
+        entity.stCed.bNoLinks = false;
+        entity.stChed.hLayer = Handle (LAYER);
+        entity.stChed.hNextEntity = Handle (next);
+        Add (handle, entity);
+    }
+
+    void AddBlock (long handle, const char * name, const CADVector& basePoint, long first, long last)
+    {
+        CADBlockHeaderObject block;
+        block.hObjectHandle = Handle (handle);
+        block.sEntryName = name;
+        block.vertBasePoint = basePoint;
+        block.hEntities.push_back (Handle (first));
+        block.hEntities.push_back (Handle (last));
+        Add (handle, block);
+    }
+
+    void AddInsert (long handle, long next, long block, const CADVector& insertionPoint, double rotation,
+                    const CADVector& scales)
+    {
+        CADInsertObject insert;
+        insert.vertInsertionPoint = insertionPoint;
+        insert.vertScales = scales;
+        insert.dfRotation = rotation;
+        insert.vectExtrusion = CADVector (0, 0, 1);
+        insert.bHasAttribs = false;
+        insert.hBlockHeader = Handle (block);
+        AddEntity (handle, next, insert);
+    }
+
+    void AddPoint (long handle, long next, const CADVector& position)
+    {
+        CADPointObject point;
+        point.vertPosition = position;
+        AddEntity (handle, next, point);
+    }
+
+    virtual CADObject * GetObject (long handle, bool) override
+    {
+        auto iter = objects.find (handle);
+        return iter == objects.end () ? nullptr : iter->second ();
+    }
+
+    virtual bool ProbeEntity (long handle, CADEntityProbe& probe) override
+    {
+        std::unique_ptr<CADObject> object (GetObject (handle, true));
+        if ( object == nullptr || !isCommonEntityType (object->getType ()) )
+            return false;
+        const CADEntityObject * entity = static_cast<const CADEntityObject *>( object.get () );
+        probe.eType = entity->getType ();
+        probe.nHandle = handle;
+        probe.nOwner = 0;
+        probe.nLayer = entity->stChed.hLayer.getAsLong ();
+        probe.nNextEntity = entity->stChed.hNextEntity.getAsLong ();
+        probe.bNoLinks = entity->stCed.bNoLinks;
+        return true;
+    }
+
+    virtual CADGeometry * GetGeometry (size_t, long handle, long) override
+    {
+        std::unique_ptr<CADObject> object (GetObject (handle, false));
+        if ( object == nullptr || object->getType () != CADObject::POINT )
+            return nullptr;
+        return new CADPoint3D (static_cast<CADPointObject *>( object.get () )->vertPosition, 0);
+    }
+
+    virtual std::vector<CADAttrib> GetBlockReferenceAttributes (size_t, long) override
+    {
+        return std::vector<CADAttrib> ();
+    }
+
+    virtual int ReadSectionLocators () override { return CADErrorCodes::SUCCESS; }
+    virtual int ReadHeader (OpenOptions) override { return CADErrorCodes::SUCCESS; }
+    virtual int ReadClasses (OpenOptions) override { return CADErrorCodes::SUCCESS; }
+    virtual int CreateFileMap () override { return CADErrorCodes::SUCCESS; }
+
+    std::map<long, std::function<CADObject * ()>> objects;
+};
+
+static void AssertPointsNear (const std::vector<CADVector>& expected, std::vector<CADGeometry *>& geoms)
+{
+    ASSERT_EQ (geoms.size (), expected.size ());
+    for ( size_t i = 0; i < geoms.size (); ++i )
+    {
+        ASSERT_EQ (geoms[i]->getType (), CADGeometry::POINT);
+        CADVector position = static_cast<CADPoint3D *>( geoms[i] )->getPosition ();
+        ASSERT_NEAR (position.getX (), expected[i].getX (), 1e-9);
+        ASSERT_NEAR (position.getY (), expected[i].getY (), 1e-9);
+        ASSERT_NEAR (position.getZ (), expected[i].getZ (), 1e-9);
+    }
+}
+
+static std::vector<CADGeometry *> ReadLayerGeometries (CADFile& file)
+{
+    std::vector<CADGeometry *> geoms;
+    CADLayer &layer = file.GetLayer (0);
+    for ( size_t i = 0; i < layer.getGeometryCount (); ++i )
+        geoms.push_back (layer.getGeometry (i));
+    return geoms;
+}
+
+static std::vector<CADGeometry *> ReadCursorGeometries (CADFile& file)
+{
+    std::vector<CADGeometry *> geoms;
+    size_t layer_index = 0;
+    CADFile::EntityCursor cursor (&file);
+    while ( CADGeometry * geom = cursor.Next (layer_index) )
+        geoms.push_back (geom);
+    return geoms;
+}
+
+TEST(reading_geometries, nested_block_references)
+{
+    // Outer reference moves by (100, 200) and scales by 2, inner one rotates
+    // by 90 degrees and moves by (0, 10) within the outer block.
+    const std::vector<CADVector> expected = {
+        CADVector (100, 222, 0), CADVector (98, 220, 0),
+        CADVector (102, 200, 0), CADVector (100, 0, 0) };
+
+    NestedBlocksFile file;
+    ASSERT_EQ (file.GetLayersCount (), 1);
+    std::vector<CADGeometry *> geoms = ReadLayerGeometries (file);
+    AssertPointsNear (expected, geoms);
+    for ( CADGeometry * geom : geoms )
+        delete geom;
+
+    geoms = ReadCursorGeometries (file);
+    AssertPointsNear (expected, geoms);
+    for ( CADGeometry * geom : geoms )
+        delete geom;
+}
+
+// Puts the second point of the inner block on a layer missing from the table
+class UnknownLayerBlocksFile : public NestedBlocksFile
+{
+public:
+    size_t inner_point1_layer = 0;
+    size_t inner_point2_layer = 0;
+
+    std::shared_ptr<const CADBlock> GetInnerBlock ()
+    {
+        return GetBlock (Handle (INNER_BLOCK).getAsLong ());
+    }
+
+protected:
+    virtual CADObject * GetObject (long handle, bool handles_only) override
+    {
+        CADObject * object = NestedBlocksFile::GetObject (handle, handles_only);
+        if ( object != nullptr && handle == INNER_POINT2 )
+            static_cast<CADEntityObject *>( object )->stChed.hLayer = Handle (99);
+        return object;
+    }
+
+    virtual CADGeometry * GetGeometry (size_t layer, long handle, long block_ref) override
+    {
+        if ( handle == INNER_POINT1 )
+            inner_point1_layer = layer;
+        else if ( handle == INNER_POINT2 )
+            inner_point2_layer = layer;
+        return NestedBlocksFile::GetGeometry (layer, handle, block_ref);
+    }
+};
+
+TEST(reading_geometries, block_entity_layers)
+{
+    // layers and cursor place block entities on the layer of the reference
+    const std::vector<CADVector> expected = {
+        CADVector (100, 222, 0), CADVector (98, 220, 0),
+        CADVector (102, 200, 0), CADVector (100, 0, 0) };
+
+    UnknownLayerBlocksFile file;
+    std::vector<CADGeometry *> geoms = ReadLayerGeometries (file);
+    AssertPointsNear (expected, geoms);
+    for ( CADGeometry * geom : geoms )
+        delete geom;
+
+    // the block keeps the entity which has no layer in the table
+    std::shared_ptr<const CADBlock> block = file.GetInnerBlock ();
+    ASSERT_NE (block, nullptr);
+    ASSERT_EQ (block->getGeometryCount (), 2);
+    ASSERT_EQ (file.inner_point1_layer, 0);
+    ASSERT_EQ (file.inner_point2_layer, file.GetLayersCount ());
+}
+
+TEST(reading_geometries, matrix_multiply)
+{
+    Matrix outer;
+    outer.translate (CADVector (100, 200, 0));
+    outer.scale (CADVector (2, 2, 2));
+    Matrix inner;
+    inner.translate (CADVector (0, 10, 0));
+    inner.rotate (std::acos (0.0));
+
+    CADVector pt = outer.multiply (inner).multiply (CADVector (0, 1, 3));
+    CADVector expected = outer.multiply (inner.multiply (CADVector (0, 1, 3)));
+    ASSERT_NEAR (pt.getX (), expected.getX (), 1e-9);
+    ASSERT_NEAR (pt.getY (), expected.getY (), 1e-9);
+    ASSERT_NEAR (pt.getZ (), expected.getZ (), 1e-9);
+}
+
+TEST(reading_geometries, block_base_point)
+{
+    // base points of the blocks are moved to the insertion points
+    const std::vector<CADVector> expected = {
+        CADVector (100, 222, 0), CADVector (98, 220, 0),
+        CADVector (100, 200, 0), CADVector (100, 0, 0) };
+
+    NestedBlocksFile file (CADVector (1, 0, 0), CADVector (0, 1, 0));
+    std::vector<CADGeometry *> geoms = ReadLayerGeometries (file);
+    AssertPointsNear (expected, geoms);
+    for ( CADGeometry * geom : geoms )
+        delete geom;
+
+    geoms = ReadCursorGeometries (file);
+    AssertPointsNear (expected, geoms);
+    for ( CADGeometry * geom : geoms )
+        delete geom;
+
+    NestedBlocksFile references (CADVector (1, 0, 0), CADVector (0, 1, 0));
+    references.SetExpandBlockReferences (false);
+    CADLayer &layer = references.GetLayer (0);
+    ASSERT_EQ (layer.getBlockReferenceCount (), 1);
+    CADVector pt = layer.getBlockReference (0).getTransformation ().multiply (CADVector (1, 0, 0));
+    ASSERT_NEAR (pt.getX (), 100, 1e-9);
+    ASSERT_NEAR (pt.getY (), 200, 1e-9);
+    ASSERT_NEAR (pt.getZ (), 0, 1e-9);
+}